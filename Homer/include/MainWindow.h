@@ -148,6 +148,7 @@ private:
     void initializeFeatureDisablers(QStringList &pArguments);
     void initializeDebugging(QStringList &pArguments);
     void ShowFfmpegCaps(QStringList &pArguments);
+    void RunNAPIBenchmark(QStringList &pArguments);
     void initializeConferenceManagement();
     void initializeVideoAudioIO();
     void initializeColoring();
@@ -453,7 +453,7 @@ bool FileTransfer::SendPacket(char* pData, unsigned int pSize)
 {
     bool tResult = false;
 
-    int64_t tTime = Time::GetTimeStamp();
+    int64_t tTime = Time::GetMonotonicTimeStamp();
     if (mSocketToPeer != NULL)
     {
         mSocketToPeer->write(pData, (int)pSize);
@@ -465,7 +465,7 @@ bool FileTransfer::SendPacket(char* pData, unsigned int pSize)
     }else
         LOG(LOG_ERROR, "Invalid socket to peer");
     #ifdef FTM_DEBUG_TIMING
-        int64_t tTime2 = Time::GetTimeStamp();
+        int64_t tTime2 = Time::GetMonotonicTimeStamp();
         LOG(LOG_VERBOSE, "       sending a packet of %u bytes took %"PRId64" us", pSize, tTime2 - tTime);
     #endif
 
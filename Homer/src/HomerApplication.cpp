@@ -172,6 +172,10 @@ void HomerApplication::initializeLogging()
         }
     }
 
+    // deliver log messages by a separate logger thread
+    if (mArguments.contains("-DebugAsync"))
+        LOGGER.StartAsyncLogging();
+
     MainWindow::removeArguments(mArguments, "-Debug");
 }
 
@@ -44,6 +44,7 @@
 #include <Widgets/OverviewThreadsWidget.h>
 #include <Logger.h>
 #include <Meeting.h>
+#include <NAPIBenchmark.h>
 #include <MediaSourcePortAudio.h>
 #include <MediaSourcePulseAudio.h>
 #include <MediaSourceV4L2.h>
@@ -134,6 +135,8 @@ MainWindow::MainWindow(QStringList pArguments, QString pAbsBinPath) :
     initializeFeatureDisablers(pArguments);
     // show ffmpeg data
     ShowFfmpegCaps(pArguments);
+    // compare NAPI implementations
+    RunNAPIBenchmark(pArguments);
 
     // audio playback - start sound
     #ifndef DEBUG_VERSION
@@ -507,6 +510,14 @@ void MainWindow::ShowFfmpegCaps(QStringList &pArguments)
     removeArguments(pArguments, "-List");
 }
 
+void MainWindow::RunNAPIBenchmark(QStringList &pArguments)
+{
+    if (pArguments.contains("-BenchmarkNAPI"))
+        NAPIBenchmark::RunAll();
+
+    removeArguments(pArguments, "-BenchmarkNAPI");
+}
+
 void MainWindow::initializeDebugging(QStringList &pArguments)
 {
     LOG(LOG_VERBOSE, "Initialization of debugging..");
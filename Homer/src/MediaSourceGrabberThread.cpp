@@ -650,7 +650,7 @@ void MediaSourceGrabberThread::CalculateFrameRate(float *pFrameRate)
     // calculate FPS
     if ((pFrameRate != NULL) && (mFrameTimestamps.size() > 1))
     {
-        int64_t tCurrentTime = Time::GetTimeStamp();
+        int64_t tCurrentTime = Time::GetMonotonicTimeStamp();
         int64_t tMeasurementStartTime = mFrameTimestamps.first();
         int tMeasuredValues = mFrameTimestamps.size() - 1;
         double tMeasuredTimeDifference = ((double)tCurrentTime - tMeasurementStartTime) / 1000000;
@@ -1602,8 +1602,8 @@ void AudioWorkerThread::run()
                     if(tFrameNumber > 3)
                     {
                         //HINT: locking is done via mDeliverMutex!
-                        mFrameTimestamps.push_back(Time::GetTimeStamp());
-                        //LOG(LOG_WARN, "Time %"PRId64"", Time::GetTimeStamp());
+                        mFrameTimestamps.push_back(Time::GetMonotonicTimeStamp());
+                        //LOG(LOG_WARN, "Time %"PRId64"", Time::GetMonotonicTimeStamp());
                         while (mFrameTimestamps.size() > SPS_MEASUREMENT_STEPS)
                             mFrameTimestamps.removeFirst();
                     }
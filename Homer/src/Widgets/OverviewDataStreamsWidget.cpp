@@ -89,8 +89,8 @@ void OverviewDataStreamsWidget::initializeGUI()
     setupUi(this);
 
     // hide id column
-    mTwAudio->setColumnHidden(12, true);
-    mTwAudio->sortItems(12);
+    mTwAudio->setColumnHidden(13, true);
+    mTwAudio->sortItems(13);
     mTwAudio->horizontalHeader()->resizeSection(0, mTwAudio->horizontalHeader()->sectionSize(0) * 3);
     for (int i = 1; i < 5; i++)
         mTwAudio->horizontalHeader()->resizeSection(i, mTwAudio->horizontalHeader()->sectionSize(i) * 2);
@@ -99,8 +99,8 @@ void OverviewDataStreamsWidget::initializeGUI()
     mTwAudio->horizontalHeader()->resizeSection(11, mTwAudio->horizontalHeader()->sectionSize(10) * 2);
 
     // hide id column
-    mTwVideo->setColumnHidden(12, true);
-    mTwVideo->sortItems(12);
+    mTwVideo->setColumnHidden(13, true);
+    mTwVideo->sortItems(13);
     mTwVideo->horizontalHeader()->resizeSection(0, mTwVideo->horizontalHeader()->sectionSize(0) * 3);
     for (int i = 1; i < 5; i++)
         mTwVideo->horizontalHeader()->resizeSection(i, mTwVideo->horizontalHeader()->sectionSize(i) * 2);
@@ -395,7 +395,7 @@ void OverviewDataStreamsWidget::SaveCompleteStatistic()
     //#####################################################
     //### write header to csv
     //#####################################################
-    QString tHeader = "Type,MinSize,MaxSize,AvgSize,Size,Packets,LostPackets,Direction,Rate,MomRate\n";
+    QString tHeader = "Type,MinSize,MaxSize,AvgSize,Size,Packets,LostPackets,Direction,Rate,MomRate,CopiedSize,JitterBufferDepth,LatePackets,ReorderedPackets,RecoveredPackets,UnrecoverablePackets,EstimatedBitRate,RoundTripTime,Jitter,ReportedLoss,KeyFrameRequests,KeyFrameDelay,DroppedPackets,PacingDelay,DroppedNonReferenceFrames,DroppedReferenceFrames,DroppedBrokenReferenceFrames,DroppedAudioFrames\n";
     if (!tFile.write(tHeader.toStdString().c_str(), tHeader.size()))
         return;
 
@@ -429,7 +429,25 @@ void OverviewDataStreamsWidget::SaveCompleteStatistic()
             else
                 tLine += "incoming,";
             tLine += QString("%1,").arg(tStatValues.AvgDataRate);
-            tLine += QString("%1").arg(tStatValues.MomentAvgDataRate);
+            tLine += QString("%1,").arg(tStatValues.MomentAvgDataRate);
+            tLine += QString("%1,").arg(tStatValues.CopiedByteCount);
+            tLine += QString("%1,").arg(tStatValues.JitterBufferDepth);
+            tLine += QString("%1,").arg(tStatValues.LatePacketCount);
+            tLine += QString("%1,").arg(tStatValues.ReorderedPacketCount);
+            tLine += QString("%1,").arg(tStatValues.RecoveredPacketCount);
+            tLine += QString("%1,").arg(tStatValues.UnrecoverablePacketCount);
+            tLine += QString("%1,").arg(tStatValues.EstimatedBitRate);
+            tLine += QString("%1,").arg(tStatValues.RoundTripTime);
+            tLine += QString("%1,").arg(tStatValues.Jitter);
+            tLine += QString("%1,").arg(tStatValues.ReportedLoss);
+            tLine += QString("%1,").arg(tStatValues.KeyFrameRequestCount);
+            tLine += QString("%1,").arg(tStatValues.KeyFrameDelay);
+            tLine += QString("%1,").arg(tStatValues.DroppedPacketCount);
+            tLine += QString("%1,").arg(tStatValues.PacingDelay);
+            tLine += QString("%1,").arg(tStatValues.DroppedFrameCount[FRAME_DROP_NON_REFERENCE]);
+            tLine += QString("%1,").arg(tStatValues.DroppedFrameCount[FRAME_DROP_REFERENCE]);
+            tLine += QString("%1,").arg(tStatValues.DroppedFrameCount[FRAME_DROP_BROKEN_REFERENCE]);
+            tLine += QString("%1").arg(tStatValues.DroppedFrameCount[FRAME_DROP_AUDIO]);
             tLine += "\n";
 
             //#######################
@@ -490,7 +508,18 @@ void OverviewDataStreamsWidget::FillRow(QTableWidget *pTable, int pRow, PacketSt
     pTable->item(pRow, 9)->setTextAlignment(Qt::AlignCenter|Qt::AlignVCenter);
     FillCellText(pTable, pRow, 10, Int2ByteExpression(tStatValues.MomentAvgDataRate) + " bytes/s");
     FillCellText(pTable, pRow, 11, Int2ByteExpression(tStatValues.AvgDataRate) + " bytes/s");
-    FillCellText(pTable, pRow, 12, Int2ByteExpression(pRow));
+    // reception quality as reported by RTCP receiver reports, the RTT is only known by senders
+    QString tQuality;
+    if (tStatValues.RoundTripTime >= 0)
+        tQuality += "RTT " + QString("%1").arg(tStatValues.RoundTripTime) + " ms, ";
+    if (tStatValues.Jitter >= 0)
+        tQuality += "jitter " + QString("%1").arg(tStatValues.Jitter) + " ms, ";
+    if (tStatValues.ReportedLoss >= 0)
+        tQuality += "loss " + QString("%1").arg(tStatValues.ReportedLoss, 0, 'f', 1) + " %";
+    if (tQuality == "")
+        tQuality = "-";
+    FillCellText(pTable, pRow, 12, tQuality);
+    FillCellText(pTable, pRow, 13, Int2ByteExpression(pRow));
 
 	if (pTable->item(pRow, 7) != NULL)
         if (tStatValues.Outgoing)
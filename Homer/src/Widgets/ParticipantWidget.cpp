@@ -127,7 +127,7 @@ ParticipantWidget::ParticipantWidget(enum SessionType pSessionType, MainWindow *
     mAudioSource = NULL;
     mFullscreeMovieControlWidget = NULL;
     mSessionTransport = CONF.GetSipListenerTransport();
-    mTimeOfLastAVSynch = Time::GetTimeStamp();
+    mTimeOfLastAVSynch = Time::GetMonotonicTimeStamp();
     mCallBox = NULL;
     mVideoSourceMuxer = NULL;
     mAudioSourceMuxer = NULL;
@@ -1538,14 +1538,14 @@ void ParticipantWidget::ResetAVSync()
     LOG(LOG_VERBOSE, "Reseting A/V sync.");
 
     // avoid A/V sync. in the near future
-    mTimeOfLastAVSynch = Time::GetTimeStamp();
+    mTimeOfLastAVSynch = Time::GetMonotonicTimeStamp();
     mAVAsyncCounterSinceLastSynchronization = 0;
 }
 
 void ParticipantWidget::AVSync()
 {
     #ifdef PARTICIPANT_WIDGET_AV_SYNC
-        int64_t tCurTime = Time::GetTimeStamp();
+        int64_t tCurTime = Time::GetMonotonicTimeStamp();
         if ((tCurTime - mTimeOfLastAVSynch  >= AV_SYNC_MIN_PERIOD * 1000))
         {
             float tBufferTime = 0;
@@ -311,10 +311,10 @@ void VideoWidget::SendActivityToSystem()
 {
     if (sLastSendActivityToSystem == 0)
     {// first call
-        sLastSendActivityToSystem = Time::GetTimeStamp();
+        sLastSendActivityToSystem = Time::GetMonotonicTimeStamp();
     }else
     {// 1+ call
-        int64_t tTime = Time::GetTimeStamp();
+        int64_t tTime = Time::GetMonotonicTimeStamp();
         if (tTime < sLastSendActivityToSystem + VIDEO_WIDGET_MIN_TIME_PERIOD_BETWEEN_ACTIVITY_SIMULATION * 1000)
         {
             //LOG(LOG_VERBOSE, "SendActivityToSystem() will be skipped, because min. period is %"PRId64" ms and last call was only %"PRId64" ms ago", (int64_t)VIDEO_WIDGET_MIN_TIME_PERIOD_BETWEEN_ACTIVITY_SIMULATION, (tTime - sLastSendActivityToSystem) / 1000);
@@ -1139,7 +1139,7 @@ void VideoWidget::ShowFrame(void* pBuffer)
     //### draw status text per OSD
     //#############################################################
     // are we a fullscreen widget?
-    if ((IsFullScreen()) && (mOsdStatusMessage != "") && (Time::GetTimeStamp() < mOsdStatusMessageTimeout))
+    if ((IsFullScreen()) && (mOsdStatusMessage != "") && (Time::GetMonotonicTimeStamp() < mOsdStatusMessageTimeout))
     {
         // define font for OSD text
         QFont tFont1 = QFont("Arial", 26, QFont::Light);
@@ -1293,7 +1293,7 @@ bool VideoWidget::SetOriginalResolution()
 void VideoWidget::ShowOsdMessage(QString pText)
 {
 	mOsdStatusMessage = pText;
-	mOsdStatusMessageTimeout = Time::GetTimeStamp() + VIDEO_WIDGET_OSD_PERIOD * 1000 * 1000;
+	mOsdStatusMessageTimeout = Time::GetMonotonicTimeStamp() + VIDEO_WIDGET_OSD_PERIOD * 1000 * 1000;
 }
 
 VideoWorkerThread* VideoWidget::GetWorker()
@@ -2803,8 +2803,8 @@ void VideoWorkerThread::run()
                     if(tFrameNumber > 3)
                     {
                         //HINT: locking is done via mDeliverMutex!
-                        mFrameTimestamps.push_back(Time::GetTimeStamp());
-                        //LOG(LOG_WARN, "Time %"PRId64"", Time::GetTimeStamp());
+                        mFrameTimestamps.push_back(Time::GetMonotonicTimeStamp());
+                        //LOG(LOG_WARN, "Time %"PRId64"", Time::GetMonotonicTimeStamp());
                         while (mFrameTimestamps.size() > FPS_MEASUREMENT_STEPS)
                             mFrameTimestamps.removeFirst();
                     }
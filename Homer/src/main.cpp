@@ -26,6 +26,7 @@
 
 #include <HBTime.h>
 #include <HBThread.h>
+#include <HBMemoryProfiler.h>
 #include <HomerApplication.h>
 #include <Logger.h>
 #include <Configuration.h>
@@ -557,6 +558,7 @@ int WINAPI WinMain(HINSTANCE pInstance,	HINSTANCE pPrevInstance, LPSTR pCmdLine,
 		printf("   -DebugLevel=<level>                 defines the level of debug outputs, possible values are: \"Error, Info, Verbose, World\"\n");
 		printf("   -DebugOutputFile=<file>             write verbose debug data to the given file\n");
 		printf("   -DebugOutputNetwork=<host>:<port>   send verbose debug data to the given target host and port, UDP is used for message transport\n");
+		printf("   -DebugAsync                         deliver debug outputs by a separate thread, messages are dropped if it falls behind\n");
 		printf("\n");
 		printf("Options for feature selection:\n");
 		printf("   -Disable=AudioCapture               disable audio capture from devices\n");
@@ -569,6 +571,7 @@ int WINAPI WinMain(HINSTANCE pInstance,	HINSTANCE pPrevInstance, LPSTR pCmdLine,
 		printf("   -ListAudioCodecs                    list all supported audio codecs of the used libavcodec\n");
 		printf("   -ListInputFormats                   list all supported input formats of the used libavformat\n");
 		printf("   -ListOutputFormats                  list all supported output formats of the used libavformat\n");
+		printf("   -BenchmarkNAPI                      measure the packet rate of all available NAPI implementations via the loopback interface\n");
 		printf("   -ShowBroadcastInFullScreen          show the broadcast view in fullscreen mode\n");
 		printf("   -ShowPreviewInFullScreen            show the preview view in fullscreen mode\n");
 		printf("   -ShowPreviewNetworkStreams          show a preview of network streams\n");
@@ -604,5 +607,11 @@ int WINAPI WinMain(HINSTANCE pInstance,	HINSTANCE pPrevInstance, LPSTR pCmdLine,
     LOGEX(HomerApplication, LOG_VERBOSE, "Executing Qt main window");
     tApp->exec();
 
+    // summary of the allocation profiler, if it is compiled in
+    MemoryProfiler::LogReport();
+
+    // deliver the remaining debug outputs
+    LOGGER.Deinit();
+
     return 0;
 }
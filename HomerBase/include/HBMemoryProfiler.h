@@ -0,0 +1,123 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: header for the allocation profiler
+ * Since:   2026-10-16
+ */
+
+#ifndef _BASE_MEMORY_PROFILER_
+#define _BASE_MEMORY_PROFILER_
+
+#include <stdint.h>
+#include <string>
+#include <list>
+#include <vector>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates the allocation profiler, it interposes malloc()/free() and av_malloc() and is only available for Linux with glibc
+//#define HB_PROFILE_MEMORY
+
+// on average, one allocation per this amount of allocated bytes is sampled together with its call stack
+#define HB_MEMORY_PROFILER_SAMPLE_INTERVAL                      (256 * 1024)
+
+// max. number of caller frames which are stored for a sampled allocation
+#define HB_MEMORY_PROFILER_STACK_DEPTH                          6
+
+// max. number of threads with own counters, further threads are accounted together
+#define HB_MEMORY_PROFILER_MAX_THREADS                          256
+
+// max. number of distinct call stacks
+#define HB_MEMORY_PROFILER_MAX_CALL_SITES                       2048
+
+// max. number of sampled allocations which are alive at the same time
+#define HB_MEMORY_PROFILER_MAX_SAMPLES                          16384
+
+///////////////////////////////////////////////////////////////////////////////
+
+// counters of one thread, they include all allocations since process start
+struct MemoryThreadProfile
+{
+    int             ThreadId; // -1 for the threads without own counters
+    uint64_t        Allocations;
+    uint64_t        Frees;
+    uint64_t        AllocatedBytes;
+    uint64_t        FreedBytes; // blocks can be freed by another thread than the allocating one
+    float           AllocationsPerSecond; // since the previous query
+};
+
+typedef std::list<MemoryThreadProfile>  MemoryThreadProfiles;
+
+// sampled allocations of one call stack, the byte values are estimated from the samples
+struct MemoryCallSiteProfile
+{
+    std::vector<std::string> Stack; // innermost caller first
+    std::string     Module; // of the innermost caller outside of libc, libstdc++ and libgcc
+    uint64_t        Samples;
+    uint64_t        AllocatedBytes;
+    uint64_t        LiveBytes;
+};
+
+typedef std::list<MemoryCallSiteProfile>  MemoryCallSiteProfiles;
+
+// live heap of one module, estimated from the sampled allocations
+struct MemoryModuleProfile
+{
+    std::string     Module;
+    uint64_t        LiveBytes;
+};
+
+typedef std::list<MemoryModuleProfile>  MemoryModuleProfiles;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The per-thread counters are always updated if the profiler is compiled in,
+ * the sampling of call stacks has to be activated. The calls of av_malloc(),
+ * av_mallocz() and av_realloc() are accounted with the caller of these
+ * functions as call site. This requires that libHomerBase precedes libc and
+ * libavutil in the symbol lookup order, which is the case for binaries which
+ * are linked against libHomerBase.
+ */
+class MemoryProfiler
+{
+public:
+    static bool IsAvailable();
+    static void Activate(); // starts the sampling of call stacks
+    static void Deactivate();
+    static bool IsActive();
+
+    static MemoryThreadProfiles GetThreadProfiles();
+    static bool GetThreadProfile(int pThreadId, MemoryThreadProfile &pProfile); // without the allocation rate
+    static MemoryCallSiteProfiles GetCallSiteProfiles(); // sorted by allocated bytes
+    static MemoryModuleProfiles GetModuleProfiles(); // sorted by live bytes
+    static uint64_t GetLiveBytes(); // allocated minus freed bytes since process start
+    static void LogReport(unsigned int pMaxCallSites = 10);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
@@ -41,6 +41,8 @@
 #endif
 
 #include <string>
+#include <list>
+#include <stdint.h>
 
 namespace Homer { namespace Base {
 
@@ -49,6 +51,25 @@ namespace Homer { namespace Base {
 // the following de/activates debugging of mutexes
 //#define HB_DEBUG_MUTEX
 
+// the following de/activates the contention profiling of named mutexes
+//#define HB_PROFILE_MUTEX
+
+///////////////////////////////////////////////////////////////////////////////
+
+// accumulated values of all mutexes with the same name
+struct MutexProfile
+{
+    std::string     Name;
+    uint64_t        Acquisitions;
+    uint64_t        ContendedAcquisitions; // the mutex was held by another thread
+    int64_t         WaitTime; // in ns, sum over all contended acquisitions
+    int64_t         MaxHoldTime; // in ns
+};
+
+typedef std::list<MutexProfile>  MutexProfiles;
+
+struct MutexProfileData;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class Mutex
@@ -65,14 +86,24 @@ public:
     /* for debbuging */
     void AssignName(std::string pName);
 
+    /* contention profiling, only available with HB_PROFILE_MUTEX */
+    static MutexProfiles GetProfiles();
+    static void ResetProfiles();
+
 private:
 friend class Condition;
 
     bool tryLock(int pMSecs = 0);
+    bool profiledLock(int pTimeout);
+    /* hold times of a mutex which is released while waiting for a condition */
+    void profileRelease(); // ends the current hold time
+    void profileAcquire(); // counts an acquisition and starts a new hold time
 
     OS_DEP_MUTEX    mMutex;
     int             mOwnerThreadId;
     std::string     mName;
+    MutexProfileData *mProfile;
+    int64_t         mLockTime; // in ns, start of the current hold time
 };
 
 ///////////////////////////////////////////////////////////////////////////////
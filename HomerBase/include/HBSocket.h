@@ -108,6 +108,25 @@ union SocketAddressDescriptor
 #define UDP_HEADER_SIZE							8 // fixed size
 #define UDP_LITE_HEADER_SIZE					8 // fixed size
 
+// maximum number of datagrams which are handed over to the kernel within one system call
+#define SOCKET_BATCH_SIZE_MAX                   64
+
+// maximum number of datagrams which are merged into one message for UDP segmentation offload (limit of the Linux kernel)
+#define SOCKET_SEGMENTS_MAX                     64
+// maximum size of all datagrams which are merged into one message for UDP segmentation offload
+#define SOCKET_SEGMENTATION_SIZE_MAX            (60 * 1024)
+// receive buffers for coalesced datagrams should have this size, otherwise the kernel truncates the data
+#define SOCKET_COALESCED_BUFFER_SIZE            (64 * 1024)
+
+// descriptor of one datagram for batched transmission
+struct SocketDatagram
+{
+    void                    *Buffer;
+    ssize_t                 BufferSize; // sending: size of data, receiving: size of buffer
+    ssize_t                 DataSize; // receiving: size of received data
+    ssize_t                 SegmentSize; // receiving: size of each datagram if the kernel coalesced several datagrams in the buffer (only the last one may be shorter), otherwise 0
+};
+
 #define IS_IPV6_ADDRESS(x) (x.find(':') != string::npos)
 #define IS_IPV4_MAPPED_IPV6_ADDRESS(x) (IS_IPV6_ADDRESS(x) && (x.find('::fff:') == 0))
 #define IS_ANY_ADDRESS(x) ((x == "0.0.0.0") || (x = "'::ffff:0.0.0.0") || (x == "::"))
@@ -137,6 +156,12 @@ public:
     void SetPeerHost(std::string pHost);
     void SetPeerPort(unsigned int pPort);
 
+    /* fixed peer for UDP/UDP-Lite: the address is resolved only once and the peer-bound Send() avoids any string handling and locking,
+     * if pConnect is set the socket is connected and receives only datagrams from this peer (don't use it for sockets shared with a receiver) */
+    bool BindPeer(std::string pTargetHost, unsigned int pTargetPort, bool pConnect = true);
+    void UnbindPeer();
+    bool IsPeerBound();
+
     /* QoS interface */
     static bool IsQoSSupported();
     static void DisableQoSSupport();
@@ -152,11 +177,34 @@ public:
     /* transmission */
     void StopReceiving();
     bool Send(std::string pTargetHost, unsigned int pTargetPort, void *pBuffer, ssize_t pBufferSize);
+    bool Send(void *pBuffer, ssize_t pBufferSize); // sends to the bound peer, see BindPeer()
     bool Receive(std::string &pSourceHost, unsigned int &pSourcePort, void *pBuffer, ssize_t &pBufferSize);
+    /* batched transmission of datagrams: uses sendmmsg/recvmmsg if available, otherwise falls back to one system call per datagram */
+    bool SendBatch(std::string pTargetHost, unsigned int pTargetPort, SocketDatagram *pDatagrams, int pDatagramCount);
+    bool SendBatch(SocketDatagram *pDatagrams, int pDatagramCount); // sends to the bound peer, see BindPeer()
+    int ReceiveBatch(std::string &pSourceHost, unsigned int &pSourcePort, SocketDatagram *pDatagrams, int pDatagramCount, bool pNonBlocking = false); // returns the number of received datagrams or -1 in case of an error, non-blocking calls may return 0
+    /* UDP segmentation offloads (Linux only): SendBatch() hands over trains of equally sized datagrams as one message (GSO),
+     * ReceiveBatch() may deliver several coalesced datagrams within one buffer (GRO), see SocketDatagram::SegmentSize,
+     * the receive offload needs buffers of SOCKET_COALESCED_BUFFER_SIZE and is only respected by ReceiveBatch() */
+    bool EnableSendOffload(bool pActive = true);
+    bool EnableReceiveOffload(bool pActive = true);
+    bool IsSendOffloadActive();
+    bool IsReceiveOffloadActive();
     int GetSendBufferSize();
     bool SetSendBufferSize(int pSize);
     int GetReceiveBufferSize();
     bool SetReceiveBufferSize(int pSize);
+    /* Linux only: the local queues deliver packets of sockets with a higher priority (0..6) first, e.g., audio ahead of video */
+    bool SetSendPriority(int pPriority);
+
+    /* multicast support for IPv4 and IPv6 groups, the socket has to use the network type of the group,
+     * interfaces are given by their name (e.g., "eth0"), an empty name selects the default interface of the system */
+    static bool IsMulticastAddress(std::string pAddress);
+    bool SetMulticastTtl(int pTtl); // TTL (IPv4) or hop limit (IPv6) of sent multicast packets, 1 keeps them inside the local network
+    bool SetMulticastInterface(std::string pInterface); // outgoing interface of sent multicast packets
+    bool SetMulticastLoop(bool pActive = true); // deliver sent multicast packets to the receivers at the local host, too
+    bool JoinMulticastGroup(std::string pGroup, std::string pInterface = "");
+    bool LeaveMulticastGroup(std::string pGroup, std::string pInterface = "");
 
     /* transport layer support */
     static bool IsTransportSupported(enum TransportType pType);
@@ -186,6 +234,9 @@ private:
     bool CreateSocket(enum NetworkType pIpVersion = SOCKET_IPv6);
     bool BindSocket(unsigned int pPort = 0, unsigned int pProbeStepping = 1, unsigned int pHighesPossiblePort = 0);
     static void CloseSocket(int pHandle);
+    bool ChangeMulticastMembership(std::string pGroup, std::string pInterface, bool pJoin);
+    /* hands over datagrams via sendmmsg(), the target address may be NULL for connected sockets, returns false in case of an error */
+    bool SendDatagrams(SocketAddressDescriptor *pAddressDescriptor, unsigned int pAddressDescriptorSize, SocketDatagram *pDatagrams, int pDatagramCount, int &pSentDatagrams, bool &pComplete);
 
     QoSSettings			mQoSSettings;
     int 			    mUdpLiteChecksumCoverage;
@@ -199,11 +250,18 @@ private:
     bool                mIsClientSocket;
     bool 				mNonBlockingMode;
     bool				mWasClosed;
+    bool                mSendOffload;
+    bool                mReceiveOffload;
 
     /* peer data */
     std::string         mPeerHost;
     unsigned int        mPeerPort;
     Mutex               mPeerDataMutex; // mutual exclusion of concurrent access to data about peer at remote side
+    /* bound peer */
+    bool                mPeerBound;
+    bool                mPeerConnected;
+    SocketAddressDescriptor mPeerAddressDescriptor;
+    unsigned int        mPeerAddressDescriptorSize;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
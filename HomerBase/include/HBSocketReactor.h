@@ -0,0 +1,136 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Socket reactor which demultiplexes incoming data of many sockets to a small set of I/O threads
+ * Since:   2026-10-16
+ */
+
+#ifndef _BASE_SOCKET_REACTOR_
+#define _BASE_SOCKET_REACTOR_
+
+#include <HBMutex.h>
+#include <HBSocket.h>
+#include <HBThread.h>
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of socket events
+//#define HBSR_DEBUG_EVENTS
+
+#define SVC_SOCKET_REACTOR SocketReactor::GetInstance()
+
+// max. number of I/O threads, the reactor uses one thread per CPU core up to this limit
+#define SOCKET_REACTOR_THREADS_MAX                  4
+
+// max. number of socket events which are fetched by an I/O thread within one system call
+#define SOCKET_REACTOR_EVENTS_MAX                   16
+
+// period for checking if the I/O threads are still needed
+#define SOCKET_REACTOR_WAIT_TIMEOUT                 250 // ms
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SocketReactorHandler
+{
+public:
+    virtual ~SocketReactorHandler() { }
+
+    /* called by an I/O thread if data is available at the socket, the socket isn't reported again until this call returns,
+     * returns false if the socket shouldn't be observed anymore */
+    virtual bool SocketReadable(Socket *pSocket) = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SocketReactor;
+
+class SocketReactorThread:
+    public Thread
+{
+public:
+    SocketReactorThread(SocketReactor *pReactor);
+    virtual ~SocketReactorThread();
+
+private:
+    virtual void* Run(void* pArgs = NULL);
+
+    SocketReactor       *mReactor;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct SocketReactorEntry
+{
+    Socket                  *ObservedSocket;
+    SocketReactorHandler    *Handler;
+    int                     HandlerThreadId; // thread which executes the handler at the moment, 0 if none
+    bool                    Removed;
+};
+
+typedef std::map<uint64_t, SocketReactorEntry> SocketReactorEntries;
+typedef std::vector<SocketReactorThread*> SocketReactorThreads;
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SocketReactor
+{
+public:
+    /// The default constructor
+    SocketReactor();
+
+    /// The destructor.
+    virtual ~SocketReactor();
+
+    static SocketReactor& GetInstance();
+
+    /* epoll based, only available for Linux */
+    bool IsAvailable();
+
+    /* registration interface */
+    bool RegisterSocket(Socket *pSocket, SocketReactorHandler *pHandler);
+    bool UnregisterSocket(Socket *pSocket); // waits until a running handler call has finished, may also be called by the handler itself
+
+private:
+    friend class SocketReactorThread;
+
+    bool Init();
+    void ProcessEvents();
+
+    int                     mEpollHandle;
+    bool                    mReactorNeeded;
+    uint64_t                mNextEntryId;
+    SocketReactorEntries    mEntries;
+    SocketReactorThreads    mThreads;
+    Mutex                   mEntriesMutex;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
@@ -50,9 +50,11 @@ public:
 
     bool ValidTimeStamp();
     void InvalidateTimeStamp();
-    int64_t UpdateTimeStamp(); // in s
+    int64_t UpdateTimeStamp(); // monotonic time in s
     int64_t TimeDiffInUSecs(Time *pTime);
-    static int64_t GetTimeStamp(); // in s
+    static int64_t GetTimeStamp(); // wall clock in s, jumps if the system time is adjusted
+    static int64_t GetMonotonicTime(); // in ns, unaffected by adjustments of the system time, for measuring durations and pacing
+    static int64_t GetMonotonicTimeStamp(); // GetMonotonicTime() in s
     static bool GetNow(int *pDay = NULL, int *pMonth = NULL, int *pYear = NULL, int *pHour = NULL, int *pMin = NULL, int *pSec = NULL);
 
     Time& operator=(const Time &pTime);
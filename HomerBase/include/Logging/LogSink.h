@@ -43,6 +43,7 @@ public:
     virtual ~LogSink();
 
     virtual void ProcessMessage(int pLevel, std::string pTime, std::string pSource, int pLine, std::string pMessage) = 0;
+    virtual void Flush(); // writes buffered messages, called after each message or in bounded intervals by the logger thread
 
     std::string GetId() { return mLogSinkId; }
 
@@ -45,6 +45,7 @@ public:
     virtual ~LogSinkFile();
 
     virtual void ProcessMessage(int pLevel, std::string pTime, std::string pSource, int pLine, std::string pMessage);
+    virtual void Flush();
 
 private:
     std::string         mFileName;
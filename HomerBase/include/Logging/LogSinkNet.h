@@ -35,6 +35,11 @@ namespace Homer { namespace Base {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// max. size of a datagram with coalesced messages, a single larger message is sent alone
+#define LOG_SINK_NET_MAX_DATAGRAM_SIZE                      1280
+
+///////////////////////////////////////////////////////////////////////////////
+
 class LogSinkNet:
     public LogSink
 {
@@ -46,12 +51,14 @@ public:
     virtual ~LogSinkNet();
 
     virtual void ProcessMessage(int pLevel, std::string pTime, std::string pSource, int pLine, std::string pMessage);
+    virtual void Flush(); // sends the coalesced messages
 
 private:
     std::string         mTargetHost;
     unsigned short      mTargetPort;
     Socket 				*mDataSocket;
     bool                mBrokenPipe;
+    std::string         mPendingData; // coalesced messages of the next datagram
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -35,6 +35,8 @@
 #include <sstream>
 #include <HBReflection.h>
 #include <HBMutex.h>
+#include <HBThread.h>
+#include <stdint.h>
 
 // 32/64 bit compatible macros for printing format specifiers
 #ifndef PRIu64
@@ -79,6 +81,14 @@ inline std::string toString(T const& value_)
     return ss.str();
 }
 
+// resolves the object name once per static type of the given object pointer, which is all GetObjectNameStr() depends on
+template <typename T>
+inline const std::string& GetObjectNameCached(T pObject)
+{
+    static const std::string sObjectName = GetObjectNameStr(pObject);
+    return sObjectName;
+}
+
 inline bool IsLetter(char *pChar)
 {
     if (pChar == NULL)
@@ -89,6 +99,9 @@ inline bool IsLetter(char *pChar)
 
 typedef std::list<LogSink*>        LogSinksList;
 
+struct LogRing;
+typedef std::list<LogRing*>        LogRingsList;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define         LOG_OFF                         0
@@ -98,13 +111,27 @@ typedef std::list<LogSink*>        LogSinksList;
 #define         LOG_VERBOSE                     4
 #define         LOG_WORLD                       5
 
+// messages above this level are removed at compile time, e.g., -DLOG_COMPILE_LEVEL=LOG_INFO
+#ifndef LOG_COMPILE_LEVEL
+#define         LOG_COMPILE_LEVEL               LOG_WORLD
+#endif
+
+// asynchronous logging
+#define         LOGGER_ASYNC_RING_SIZE          128 // records per producing thread, further records are dropped and counted
+#define         LOGGER_ASYNC_SOURCE_SIZE        128 // longer sources are truncated
+#define         LOGGER_ASYNC_MESSAGE_SIZE       1024 // longer messages are truncated
+#define         LOGGER_ASYNC_PERIOD             10 // ms between two runs of the logger thread
+#define         LOGGER_ASYNC_FLUSH_INTERVAL     250 // max. time in ms until a written message is flushed by the log sinks
+
 #define         LOGGER                          Logger::GetInstance()
+// checks if a message of the given level would be processed, the arguments of a disabled message aren't evaluated
+#define         LOG_ENABLED(Level)              (((Level) <= LOG_COMPILE_LEVEL) && (Logger::IsLevelEnabled(Level)))
 // standard logging macro
-#define         LOG(Level, ...)                 LOGGER.AddMessage(Level, GetObjectNameStr(this).c_str(), __LINE__, __VA_ARGS__)
+#define         LOG(Level, ...)                 do{ if (LOG_ENABLED(Level)) LOGGER.AddMessage(Level, GetObjectNameCached(this).c_str(), __LINE__, __VA_ARGS__); }while(0)
 // remote logging with given source file and line number
-#define         LOG_REMOTE(Level, Source, Line, ...)   LOGGER.AddMessage(Level, Source.c_str(), Line, __VA_ARGS__)
+#define         LOG_REMOTE(Level, Source, Line, ...)   do{ if (LOG_ENABLED(Level)) LOGGER.AddMessage(Level, Source.c_str(), Line, __VA_ARGS__); }while(0)
 // static logging
-#define         LOGEX(FromWhere, Level, ...)    LOGGER.AddMessage(Level, ("static:" + GetObjectNameStr(FromWhere) + ":" + GetShortFileName(__FILE__)).c_str(), __LINE__, __VA_ARGS__)
+#define         LOGEX(FromWhere, Level, ...)    do{ if (LOG_ENABLED(Level)) { static const std::string sLogExSource = "static:" + GetObjectNameStr(FromWhere) + ":" + GetShortFileName(__FILE__); LOGGER.AddMessage(Level, sLogExSource.c_str(), __LINE__, __VA_ARGS__); } }while(0)
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -125,12 +152,29 @@ public:
     void AddMessage(int pLevel, const char *pSource, int pLine, const char* pFormat, ...);
     void SetLogLevel(int pLevel);
     int GetLogLevel();
+    static inline bool IsLevelEnabled(int pLevel) { return (pLevel <= sMessageLevel); } // single compare, no lock
 
     void RegisterLogSink(LogSink *pLogSink);
     void UnregisterLogSink(LogSink *pLogSink);
 
+    /* asynchronous logging: the calling thread only formats the message, the logger thread delivers it */
+    bool StartAsyncLogging();
+    void StopAsyncLogging(); // delivers all queued messages
+    bool IsAsyncLogging();
+    uint64_t GetDroppedMessages();
+
 private:
+    friend class LoggerThread;
+
+    void DeliverMessage(int pLevel, std::string pSource, int pLine, std::string pMessage);
     void RelayMessageToLogSinks(int pLevel, std::string pTime, std::string pSource, int pLine, std::string pMessage);
+    void FlushLogSinks();
+    LogRing* GetLogRing();
+    bool ProcessLogRings(); // returns true if at least one message was delivered
+    void AsyncLoggingMain();
+    void UpdateMessageLevel();
+
+    static volatile int sMessageLevel; // highest level which reaches the console or a log sink
 
     Mutex       mLoggerMutex, mLogSinksMutex;
     LogSinksList mLogSinks;
@@ -142,6 +186,12 @@ private:
     int         mLastLine;
     int         mRepetitionCount;
     LogSinkConsole *mLogSinkConsole;
+    /* asynchronous logging */
+    volatile bool mAsyncLogging;
+    Thread      *mLoggerThread;
+    Mutex       mLogRingsMutex;
+    LogRingsList mLogRings;
+    uint64_t    mDroppedMessages;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -54,6 +54,19 @@ using namespace std;
 #define UDPLITE_RECV_CSCOV     		                     11
 #endif
 
+// definitions for UDP segmentation offloads (Linux only)
+#ifndef SOL_UDP
+#define SOL_UDP                                          17
+#endif
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT                                     103
+#endif
+
+#ifndef UDP_GRO
+#define UDP_GRO                                         104
+#endif
+
 //define IPV6_V6ONLY for MinGW/MSYS
 //HINT: strange API because Windows screams for RFCs 3493 and 3542 meanwhile Linux takes another way by defining IPV6_ONLY with value 26
 #ifdef __MINGW32__
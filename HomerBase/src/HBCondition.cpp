@@ -28,11 +28,7 @@
 #include <HBCondition.h>
 #include <HBThread.h>
 
-#ifdef APPLE
-// to get current time stamp
-#include <mach/clock.h>
-#include <mach/mach.h>
-#endif
+#include <time.h>
 
 namespace Homer { namespace Base {
 
@@ -40,11 +36,39 @@ using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#if defined(LINUX) || defined(APPLE) || defined(BSD)
+// timeouts are based on the monotonic clock, hence adjustments of the system time don't shorten or extend them
+#if defined(APPLE)
+    // OS X doesn't support pthread_condattr_setclock(), a relative timeout is used instead
+    #define TimedWait(Condition, Mutex, Timeout)        pthread_cond_timedwait_relative_np(Condition, Mutex, Timeout)
+#else
+    #define TimedWait(Condition, Mutex, Timeout)        pthread_cond_timedwait(Condition, Mutex, Timeout)
+#endif
+
+static bool InitCondition(pthread_cond_t *pCondition)
+{
+    bool tResult = false;
+    pthread_condattr_t tAttributes;
+
+    if (pthread_condattr_init(&tAttributes) != 0)
+        return false;
+    #if defined(LINUX) || defined(BSD)
+        pthread_condattr_setclock(&tAttributes, CLOCK_MONOTONIC);
+    #endif
+    tResult = (pthread_cond_init(pCondition, &tAttributes) == 0);
+    pthread_condattr_destroy(&tAttributes);
+
+    return tResult;
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
 Condition::Condition()
 {
 	bool tResult = false;
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
-		tResult = (pthread_cond_init(&mCondition, NULL) == 0);
+		tResult = InitCondition(&mCondition);
 	#endif
 	#if defined(WINDOWS)
 		mCondition = CreateEvent(NULL, true, false, NULL);
@@ -79,21 +103,16 @@ bool Condition::Wait(Mutex *pMutex, int pMSecs)
 
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
         struct timespec tTimeout;
-        struct timespec tTimeout1;
 
         #if defined(LINUX) || defined(BSD)
-            if (clock_gettime(CLOCK_REALTIME, &tTimeout) == -1)
+            // absolute deadline based on the clock of the condition
+            if (clock_gettime(CLOCK_MONOTONIC, &tTimeout) == -1)
                 LOG(LOG_ERROR, "Failed to get time from clock");
         #endif
         #if defined(APPLE)
-            // apple specific implementation for clock_gettime()
-            clock_serv_t tCalenderClock;
-            mach_timespec_t tMachTimeSpec;
-            host_get_clock_service(mach_host_self(), CALENDAR_CLOCK, &tCalenderClock);
-            clock_get_time(tCalenderClock, &tMachTimeSpec);
-            mach_port_deallocate(mach_task_self(), tCalenderClock);
-            tTimeout.tv_sec = tMachTimeSpec.tv_sec;
-            tTimeout.tv_nsec = tMachTimeSpec.tv_nsec;
+            // relative timeout
+            tTimeout.tv_sec = 0;
+            tTimeout.tv_nsec = 0;
         #endif
         int tTime = pMSecs;
 
@@ -117,18 +136,24 @@ bool Condition::Wait(Mutex *pMutex, int pMSecs)
         }
 
         if (pMutex)
+        {
+            bool tResult;
+            // the mutex is released while waiting and obtained again afterwards
+            pMutex->profileRelease();
             if (pMSecs > 0)
-                return !pthread_cond_timedwait(&mCondition, &pMutex->mMutex, &tTimeout);
+                tResult = !TimedWait(&mCondition, &pMutex->mMutex, &tTimeout);
             else
-                return !pthread_cond_wait(&mCondition, &pMutex->mMutex);
-        else
+                tResult = !pthread_cond_wait(&mCondition, &pMutex->mMutex);
+            pMutex->profileAcquire();
+            return tResult;
+        }else
         {
         	bool tResult = false;
             pthread_mutex_t tMutex = PTHREAD_MUTEX_INITIALIZER;
             pthread_mutex_lock(&tMutex);
             if (pMSecs > 0)
             {
-                int tRes = pthread_cond_timedwait(&mCondition, &tMutex, &tTimeout);
+                int tRes = TimedWait(&mCondition, &tMutex, &tTimeout);
 				switch(tRes)
 				{
 					case EDEADLK:
@@ -219,7 +244,7 @@ bool Condition::Signal()
 bool Condition::Reset()
 {
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
-        return (pthread_cond_init(&mCondition, NULL) == 0);
+        return InitCondition(&mCondition);
 	#endif
 	#if defined(WINDOWS)
 		return (ResetEvent(mCondition) != 0);
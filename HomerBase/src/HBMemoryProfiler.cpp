@@ -0,0 +1,831 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of the allocation profiler
+ * Since:   2026-10-16
+ */
+
+#include <Logger.h>
+#include <HBMemoryProfiler.h>
+#include <HBTime.h>
+
+#include <map>
+#include <algorithm>
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+#include <malloc.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <cxxabi.h>
+#endif
+
+namespace Homer { namespace Base {
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+
+/*
+ * HINT: The interposed functions are called before and during the static
+ *       initialization, hence this part uses only zero initialized static
+ *       data and must never allocate memory while it holds the spin lock.
+ */
+
+// sampled blocks get this marker at the end of their usable size, it avoids a table lookup for each free()
+#define MEMORY_PROFILER_MARKER                  0x4862536d706c6564ULL
+#define MEMORY_PROFILER_MARKER_SIZE             sizeof(uint64_t)
+
+struct ThreadCounters
+{
+    volatile int        ThreadId; // 0 for unused slots
+    volatile uint64_t   Allocations;
+    volatile uint64_t   Frees;
+    volatile uint64_t   AllocatedBytes;
+    volatile uint64_t   FreedBytes;
+    /* allocation rate */
+    uint64_t            LastAllocations;
+    int64_t             LastQueryTime;
+};
+
+struct CallSite
+{
+    void                *Stack[HB_MEMORY_PROFILER_STACK_DEPTH];
+    int                 Depth; // 0 for unused entries
+    uint64_t            Samples;
+    uint64_t            AllocatedBytes;
+    uint64_t            LiveBytes;
+};
+
+struct Sample
+{
+    void                *Block; // NULL for unused entries
+    int                 CallSite;
+    uint64_t            Weight;
+};
+
+// the last slot is shared by all threads without an own one
+static ThreadCounters sThreadCounters[HB_MEMORY_PROFILER_MAX_THREADS + 1];
+static CallSite sCallSites[HB_MEMORY_PROFILER_MAX_CALL_SITES];
+static Sample sSamples[HB_MEMORY_PROFILER_MAX_SAMPLES];
+static volatile int sLiveSamples = 0;
+static volatile uint64_t sDroppedSamples = 0;
+static volatile int sProfilerLock = 0;
+static volatile bool sActive = false;
+
+// the initial-exec model avoids that the first access of a thread allocates its TLS block via malloc()
+#define MEMORY_PROFILER_TLS __thread __attribute__((tls_model("initial-exec")))
+
+static MEMORY_PROFILER_TLS ThreadCounters *sCurrentThreadCounters = NULL;
+static MEMORY_PROFILER_TLS int64_t sSampleCountdown = 0;
+static MEMORY_PROFILER_TLS uint32_t sSampleRandom = 0;
+static MEMORY_PROFILER_TLS bool sInProfiler = false; // avoids recursive sampling, e.g., if backtrace() allocates memory
+static MEMORY_PROFILER_TLS void *sCaller = NULL; // set by the av_*() wrappers for the nested libc allocation
+
+static void LockProfiler()
+{
+    while (__sync_lock_test_and_set(&sProfilerLock, 1))
+        sched_yield();
+}
+
+static void UnlockProfiler()
+{
+    __sync_lock_release(&sProfilerLock);
+}
+
+static ThreadCounters* GetThreadCounters()
+{
+    ThreadCounters *tResult = sCurrentThreadCounters;
+
+    if (tResult == NULL)
+    {
+        int tThreadId = (int)syscall(SYS_gettid);
+        tResult = &sThreadCounters[HB_MEMORY_PROFILER_MAX_THREADS];
+        // the kernel reuses thread IDs, in this case the counters of the former thread are continued
+        for (int i = 0; i < HB_MEMORY_PROFILER_MAX_THREADS; i++)
+        {
+            int tSlotThreadId = sThreadCounters[i].ThreadId;
+            if ((tSlotThreadId == tThreadId) || ((tSlotThreadId == 0) && (__sync_bool_compare_and_swap(&sThreadCounters[i].ThreadId, 0, tThreadId))))
+            {
+                tResult = &sThreadCounters[i];
+                break;
+            }
+        }
+        sCurrentThreadCounters = tResult;
+    }
+
+    return tResult;
+}
+
+static void AccountAllocation(void *pBlock)
+{
+    if (pBlock == NULL)
+        return;
+
+    ThreadCounters *tCounters = GetThreadCounters();
+    uint64_t tSize = malloc_usable_size(pBlock);
+    if (tCounters != &sThreadCounters[HB_MEMORY_PROFILER_MAX_THREADS])
+    {
+        tCounters->Allocations++;
+        tCounters->AllocatedBytes += tSize;
+    }else
+    {
+        __sync_add_and_fetch(&tCounters->Allocations, 1);
+        __sync_add_and_fetch(&tCounters->AllocatedBytes, tSize);
+    }
+}
+
+static void AccountFree(uint64_t pSize)
+{
+    ThreadCounters *tCounters = GetThreadCounters();
+    if (tCounters != &sThreadCounters[HB_MEMORY_PROFILER_MAX_THREADS])
+    {
+        tCounters->Frees++;
+        tCounters->FreedBytes += pSize;
+    }else
+    {
+        __sync_add_and_fetch(&tCounters->Frees, 1);
+        __sync_add_and_fetch(&tCounters->FreedBytes, pSize);
+    }
+}
+
+// reverts AccountFree() for a block which is still alive
+static void RevertFree(uint64_t pSize)
+{
+    ThreadCounters *tCounters = GetThreadCounters();
+    if (tCounters != &sThreadCounters[HB_MEMORY_PROFILER_MAX_THREADS])
+    {
+        tCounters->Frees--;
+        tCounters->FreedBytes -= pSize;
+    }else
+    {
+        __sync_sub_and_fetch(&tCounters->Frees, 1);
+        __sync_sub_and_fetch(&tCounters->FreedBytes, pSize);
+    }
+}
+
+static inline unsigned int HashPointer(void *pPointer, unsigned int pTableSize)
+{
+    return (unsigned int)((((uintptr_t)pPointer >> 4) * 2654435761UL) % pTableSize);
+}
+
+// decides if the next allocation is sampled, returns its weight or 0
+static uint64_t SampleAllocation(size_t pSize)
+{
+    if ((!sActive) || (sInProfiler))
+        return 0;
+
+    sSampleCountdown -= pSize;
+    if (sSampleCountdown > 0)
+        return 0;
+
+    // the random distance to the next sample avoids aliasing with periodic allocation patterns, the remainder is carried over to keep the estimation unbiased
+    uint64_t tResult = 0;
+    if (sSampleRandom == 0)
+        sSampleRandom = (uint32_t)(uintptr_t)&sSampleRandom | 1;
+    while (sSampleCountdown <= 0)
+    {
+        sSampleRandom ^= sSampleRandom << 13;
+        sSampleRandom ^= sSampleRandom >> 17;
+        sSampleRandom ^= sSampleRandom << 5;
+        sSampleCountdown += HB_MEMORY_PROFILER_SAMPLE_INTERVAL / 2 + sSampleRandom % HB_MEMORY_PROFILER_SAMPLE_INTERVAL;
+        tResult += HB_MEMORY_PROFILER_SAMPLE_INTERVAL;
+    }
+
+    return tResult;
+}
+
+static int FindCallSite(void **pStack, int pDepth)
+{
+    unsigned int tHash = 0;
+    for (int i = 0; i < pDepth; i++)
+        tHash ^= HashPointer(pStack[i], HB_MEMORY_PROFILER_MAX_CALL_SITES) + i;
+    tHash %= HB_MEMORY_PROFILER_MAX_CALL_SITES;
+
+    for (int i = 0; i < HB_MEMORY_PROFILER_MAX_CALL_SITES; i++)
+    {
+        CallSite *tCallSite = &sCallSites[(tHash + i) % HB_MEMORY_PROFILER_MAX_CALL_SITES];
+        if (tCallSite->Depth == 0)
+        {
+            memcpy(tCallSite->Stack, pStack, pDepth * sizeof(void*));
+            tCallSite->Depth = pDepth;
+            return (tHash + i) % HB_MEMORY_PROFILER_MAX_CALL_SITES;
+        }
+        if ((tCallSite->Depth == pDepth) && (memcmp(tCallSite->Stack, pStack, pDepth * sizeof(void*)) == 0))
+            return (tHash + i) % HB_MEMORY_PROFILER_MAX_CALL_SITES;
+    }
+
+    return -1;
+}
+
+static void RecordSample(void *pBlock, uint64_t pWeight, void *pCaller)
+{
+    if (pBlock == NULL)
+        return;
+
+    sInProfiler = true;
+
+    // the stack starts at the caller of the interposed function
+    void *tFrames[HB_MEMORY_PROFILER_STACK_DEPTH + 8];
+    void *tStack[HB_MEMORY_PROFILER_STACK_DEPTH];
+    int tFrameCount = backtrace(tFrames, HB_MEMORY_PROFILER_STACK_DEPTH + 8);
+    int tFirstFrame = 0;
+    while ((tFirstFrame < tFrameCount) && (tFrames[tFirstFrame] != pCaller))
+        tFirstFrame++;
+    int tDepth = 0;
+    if (tFirstFrame < tFrameCount)
+    {
+        while ((tDepth < HB_MEMORY_PROFILER_STACK_DEPTH) && (tFirstFrame + tDepth < tFrameCount))
+        {
+            tStack[tDepth] = tFrames[tFirstFrame + tDepth];
+            tDepth++;
+        }
+    }else
+    {// tail calls hide the caller from backtrace()
+        tStack[0] = pCaller;
+        tDepth = 1;
+    }
+
+    LockProfiler();
+    int tCallSite = FindCallSite(tStack, tDepth);
+    bool tRecorded = false;
+    if ((tCallSite != -1) && (sLiveSamples < HB_MEMORY_PROFILER_MAX_SAMPLES * 3 / 4))
+    {
+        unsigned int tIndex = HashPointer(pBlock, HB_MEMORY_PROFILER_MAX_SAMPLES);
+        while (sSamples[tIndex].Block != NULL)
+            tIndex = (tIndex + 1) % HB_MEMORY_PROFILER_MAX_SAMPLES;
+        sSamples[tIndex].Block = pBlock;
+        sSamples[tIndex].CallSite = tCallSite;
+        sSamples[tIndex].Weight = pWeight;
+        sLiveSamples++;
+        sCallSites[tCallSite].Samples++;
+        sCallSites[tCallSite].AllocatedBytes += pWeight;
+        sCallSites[tCallSite].LiveBytes += pWeight;
+        // only blocks with a stored sample get the marker, otherwise free() would search the table in vain
+        uint64_t tMarker = MEMORY_PROFILER_MARKER;
+        memcpy((char*)pBlock + malloc_usable_size(pBlock) - MEMORY_PROFILER_MARKER_SIZE, &tMarker, MEMORY_PROFILER_MARKER_SIZE);
+        tRecorded = true;
+    }
+    UnlockProfiler();
+
+    if (!tRecorded)
+        __sync_add_and_fetch(&sDroppedSamples, 1);
+
+    sInProfiler = false;
+}
+
+// accounts the release of a block and removes its sample, returns the usable size
+static size_t ReleaseBlock(void *pBlock)
+{
+    if (pBlock == NULL)
+        return 0;
+
+    size_t tSize = malloc_usable_size(pBlock);
+    AccountFree(tSize);
+
+    if ((sLiveSamples == 0) || (tSize < MEMORY_PROFILER_MARKER_SIZE))
+        return tSize;
+    uint64_t tMarker;
+    memcpy(&tMarker, (char*)pBlock + tSize - MEMORY_PROFILER_MARKER_SIZE, MEMORY_PROFILER_MARKER_SIZE);
+    if (tMarker != MEMORY_PROFILER_MARKER)
+        return tSize;
+
+    // the marker could also be part of the application data, hence the sample table decides
+    LockProfiler();
+    unsigned int tIndex = HashPointer(pBlock, HB_MEMORY_PROFILER_MAX_SAMPLES);
+    while ((sSamples[tIndex].Block != NULL) && (sSamples[tIndex].Block != pBlock))
+        tIndex = (tIndex + 1) % HB_MEMORY_PROFILER_MAX_SAMPLES;
+    if (sSamples[tIndex].Block == pBlock)
+    {
+        sCallSites[sSamples[tIndex].CallSite].LiveBytes -= sSamples[tIndex].Weight;
+        sSamples[tIndex].Block = NULL;
+        sLiveSamples--;
+        memset((char*)pBlock + tSize - MEMORY_PROFILER_MARKER_SIZE, 0, MEMORY_PROFILER_MARKER_SIZE);
+
+        // move the following entries of the probe sequence into the gap
+        unsigned int tGap = tIndex;
+        unsigned int tNext = (tIndex + 1) % HB_MEMORY_PROFILER_MAX_SAMPLES;
+        while (sSamples[tNext].Block != NULL)
+        {
+            unsigned int tHome = HashPointer(sSamples[tNext].Block, HB_MEMORY_PROFILER_MAX_SAMPLES);
+            if ((tNext - tHome + HB_MEMORY_PROFILER_MAX_SAMPLES) % HB_MEMORY_PROFILER_MAX_SAMPLES >= (tNext - tGap + HB_MEMORY_PROFILER_MAX_SAMPLES) % HB_MEMORY_PROFILER_MAX_SAMPLES)
+            {
+                sSamples[tGap] = sSamples[tNext];
+                sSamples[tNext].Block = NULL;
+                tGap = tNext;
+            }
+            tNext = (tNext + 1) % HB_MEMORY_PROFILER_MAX_SAMPLES;
+        }
+    }
+    UnlockProfiler();
+
+    return tSize;
+}
+
+static string DescribeAddress(void *pAddress, string *pModule = NULL)
+{
+    Dl_info tInfo;
+    char tBuffer[64];
+    string tResult;
+
+    if ((dladdr(pAddress, &tInfo) == 0) || (tInfo.dli_fname == NULL))
+    {
+        snprintf(tBuffer, sizeof(tBuffer), "%p", pAddress);
+        if (pModule != NULL)
+            *pModule = "unknown";
+        return tBuffer;
+    }
+
+    string tModule = tInfo.dli_fname;
+    size_t tPos = tModule.rfind('/');
+    if (tPos != string::npos)
+        tModule = tModule.substr(tPos + 1);
+    if (pModule != NULL)
+        *pModule = tModule;
+
+    if (tInfo.dli_sname != NULL)
+    {
+        int tStatus = 0;
+        char *tDemangled = abi::__cxa_demangle(tInfo.dli_sname, NULL, NULL, &tStatus);
+        tResult = (tStatus == 0) ? tDemangled : tInfo.dli_sname;
+        free(tDemangled);
+        snprintf(tBuffer, sizeof(tBuffer), "+0x%lx", (unsigned long)((char*)pAddress - (char*)tInfo.dli_saddr));
+    }else
+        snprintf(tBuffer, sizeof(tBuffer), "%p", pAddress);
+
+    return tResult + tBuffer + " (" + tModule + ")";
+}
+
+// allocations through operator new or strdup() are attributed to the module which calls the runtime library
+static bool IsRuntimeModule(const string &pModule)
+{
+    return ((pModule.find("libc.so") == 0) || (pModule.find("libc-") == 0) || (pModule.find("libstdc++.so") == 0) || (pModule.find("libgcc_s.so") == 0));
+}
+
+static bool CompareCallSiteProfiles(const MemoryCallSiteProfile &pFirst, const MemoryCallSiteProfile &pSecond)
+{
+    return pFirst.AllocatedBytes > pSecond.AllocatedBytes;
+}
+
+static bool CompareModuleProfiles(const MemoryModuleProfile &pFirst, const MemoryModuleProfile &pSecond)
+{
+    return pFirst.LiveBytes > pSecond.LiveBytes;
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool MemoryProfiler::IsAvailable()
+{
+    #if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+        return true;
+    #else
+        return false;
+    #endif
+}
+
+void MemoryProfiler::Activate()
+{
+    #if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+        if (sActive)
+            return;
+
+        // the first call of backtrace() loads libgcc_s and allocates memory, this shouldn't happen within an interposed function
+        void *tFrames[1];
+        backtrace(tFrames, 1);
+
+        LOGEX(MemoryProfiler, LOG_WARN, "Activating allocation profiler with a sample interval of %d bytes", HB_MEMORY_PROFILER_SAMPLE_INTERVAL);
+        sActive = true;
+    #endif
+}
+
+void MemoryProfiler::Deactivate()
+{
+    #if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+        if (!sActive)
+            return;
+
+        // the live samples are kept, their blocks are still accounted when they are freed
+        LOGEX(MemoryProfiler, LOG_WARN, "Deactivating allocation profiler, %"PRIu64" samples were dropped", (uint64_t)sDroppedSamples);
+        sActive = false;
+    #endif
+}
+
+bool MemoryProfiler::IsActive()
+{
+    #if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+        return sActive;
+    #else
+        return false;
+    #endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MemoryThreadProfiles MemoryProfiler::GetThreadProfiles()
+{
+    MemoryThreadProfiles tResult;
+
+    #if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+        int64_t tNow = Time::GetMonotonicTime();
+        for (int i = 0; i <= HB_MEMORY_PROFILER_MAX_THREADS; i++)
+        {
+            ThreadCounters *tCounters = &sThreadCounters[i];
+            if ((i < HB_MEMORY_PROFILER_MAX_THREADS) ? (tCounters->ThreadId == 0) : (tCounters->Allocations == 0))
+                continue;
+
+            MemoryThreadProfile tProfile;
+            tProfile.ThreadId = (i < HB_MEMORY_PROFILER_MAX_THREADS) ? tCounters->ThreadId : -1;
+            tProfile.Allocations = tCounters->Allocations;
+            tProfile.Frees = tCounters->Frees;
+            tProfile.AllocatedBytes = tCounters->AllocatedBytes;
+            tProfile.FreedBytes = tCounters->FreedBytes;
+            tProfile.AllocationsPerSecond = 0;
+            if ((tCounters->LastQueryTime != 0) && (tNow > tCounters->LastQueryTime))
+                tProfile.AllocationsPerSecond = (float)(tProfile.Allocations - tCounters->LastAllocations) * 1000 * 1000 * 1000 / (tNow - tCounters->LastQueryTime);
+            tCounters->LastAllocations = tProfile.Allocations;
+            tCounters->LastQueryTime = tNow;
+            tResult.push_back(tProfile);
+        }
+    #endif
+
+    return tResult;
+}
+
+bool MemoryProfiler::GetThreadProfile(int pThreadId, MemoryThreadProfile &pProfile)
+{
+    #if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+        for (int i = 0; i < HB_MEMORY_PROFILER_MAX_THREADS; i++)
+        {
+            ThreadCounters *tCounters = &sThreadCounters[i];
+            if (tCounters->ThreadId == pThreadId)
+            {
+                pProfile.ThreadId = pThreadId;
+                pProfile.Allocations = tCounters->Allocations;
+                pProfile.Frees = tCounters->Frees;
+                pProfile.AllocatedBytes = tCounters->AllocatedBytes;
+                pProfile.FreedBytes = tCounters->FreedBytes;
+                pProfile.AllocationsPerSecond = 0;
+                return true;
+            }
+        }
+    #endif
+
+    return false;
+}
+
+MemoryCallSiteProfiles MemoryProfiler::GetCallSiteProfiles()
+{
+    MemoryCallSiteProfiles tResult;
+
+    #if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+        // the copy is allocated before the spin lock is taken and isn't sampled
+        sInProfiler = true;
+        CallSite *tCallSites = (CallSite*)malloc(sizeof(sCallSites));
+        sInProfiler = false;
+        if (tCallSites == NULL)
+            return tResult;
+        LockProfiler();
+        memcpy(tCallSites, sCallSites, sizeof(sCallSites));
+        UnlockProfiler();
+
+        for (int i = 0; i < HB_MEMORY_PROFILER_MAX_CALL_SITES; i++)
+        {
+            if (tCallSites[i].Depth == 0)
+                continue;
+
+            MemoryCallSiteProfile tProfile;
+            for (int j = 0; j < tCallSites[i].Depth; j++)
+            {
+                string tModule;
+                tProfile.Stack.push_back(DescribeAddress(tCallSites[i].Stack[j], &tModule));
+                if ((j == 0) || (IsRuntimeModule(tProfile.Module)))
+                    tProfile.Module = tModule;
+            }
+            tProfile.Samples = tCallSites[i].Samples;
+            tProfile.AllocatedBytes = tCallSites[i].AllocatedBytes;
+            tProfile.LiveBytes = tCallSites[i].LiveBytes;
+            tResult.push_back(tProfile);
+        }
+        free(tCallSites);
+
+        tResult.sort(CompareCallSiteProfiles);
+    #endif
+
+    return tResult;
+}
+
+MemoryModuleProfiles MemoryProfiler::GetModuleProfiles()
+{
+    MemoryModuleProfiles tResult;
+
+    #if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+        map<string, uint64_t> tModules;
+        MemoryCallSiteProfiles tCallSites = GetCallSiteProfiles();
+        MemoryCallSiteProfiles::iterator tIt;
+        for (tIt = tCallSites.begin(); tIt != tCallSites.end(); tIt++)
+            tModules[tIt->Module] += tIt->LiveBytes;
+
+        map<string, uint64_t>::iterator tModuleIt;
+        for (tModuleIt = tModules.begin(); tModuleIt != tModules.end(); tModuleIt++)
+        {
+            MemoryModuleProfile tProfile;
+            tProfile.Module = tModuleIt->first;
+            tProfile.LiveBytes = tModuleIt->second;
+            tResult.push_back(tProfile);
+        }
+
+        tResult.sort(CompareModuleProfiles);
+    #endif
+
+    return tResult;
+}
+
+uint64_t MemoryProfiler::GetLiveBytes()
+{
+    uint64_t tResult = 0;
+
+    #if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+        uint64_t tAllocatedBytes = 0, tFreedBytes = 0;
+        for (int i = 0; i <= HB_MEMORY_PROFILER_MAX_THREADS; i++)
+        {
+            tAllocatedBytes += sThreadCounters[i].AllocatedBytes;
+            tFreedBytes += sThreadCounters[i].FreedBytes;
+        }
+        if (tAllocatedBytes > tFreedBytes)
+            tResult = tAllocatedBytes - tFreedBytes;
+    #endif
+
+    return tResult;
+}
+
+void MemoryProfiler::LogReport(unsigned int pMaxCallSites)
+{
+    if (!IsAvailable())
+        return;
+
+    LOGEX(MemoryProfiler, LOG_INFO, "Live heap: %"PRIu64" bytes", GetLiveBytes());
+
+    MemoryThreadProfiles tThreads = GetThreadProfiles();
+    MemoryThreadProfiles::iterator tThreadIt;
+    for (tThreadIt = tThreads.begin(); tThreadIt != tThreads.end(); tThreadIt++)
+        LOGEX(MemoryProfiler, LOG_INFO, "Thread %d: %"PRIu64" allocations (%.1f/s), %"PRIu64" frees, %"PRIu64" bytes allocated, %"PRIu64" bytes freed", tThreadIt->ThreadId, tThreadIt->Allocations, tThreadIt->AllocationsPerSecond, tThreadIt->Frees, tThreadIt->AllocatedBytes, tThreadIt->FreedBytes);
+
+    MemoryModuleProfiles tModules = GetModuleProfiles();
+    MemoryModuleProfiles::iterator tModuleIt;
+    for (tModuleIt = tModules.begin(); tModuleIt != tModules.end(); tModuleIt++)
+        LOGEX(MemoryProfiler, LOG_INFO, "Module %s: ~%"PRIu64" live bytes", tModuleIt->Module.c_str(), tModuleIt->LiveBytes);
+
+    MemoryCallSiteProfiles tCallSites = GetCallSiteProfiles();
+    MemoryCallSiteProfiles::iterator tCallSiteIt;
+    unsigned int tCount = 0;
+    for (tCallSiteIt = tCallSites.begin(); (tCallSiteIt != tCallSites.end()) && (tCount < pMaxCallSites); tCallSiteIt++, tCount++)
+    {
+        string tStack;
+        vector<string>::iterator tFrameIt;
+        for (tFrameIt = tCallSiteIt->Stack.begin(); tFrameIt != tCallSiteIt->Stack.end(); tFrameIt++)
+            tStack += ((tStack != "") ? " <- " : "") + *tFrameIt;
+        LOGEX(MemoryProfiler, LOG_INFO, "Call site with %"PRIu64" samples, ~%"PRIu64" bytes allocated, ~%"PRIu64" live bytes: %s", tCallSiteIt->Samples, tCallSiteIt->AllocatedBytes, tCallSiteIt->LiveBytes, tStack.c_str());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(LINUX) && defined(HB_PROFILE_MEMORY)
+
+using namespace Homer::Base;
+
+/*
+ * Interposed functions of libc and libavutil, the originals are called via
+ * their glibc aliases and dlsym(RTLD_NEXT), respectively.
+ */
+extern "C" {
+
+void *__libc_malloc(size_t pSize);
+void *__libc_calloc(size_t pCount, size_t pSize);
+void *__libc_realloc(void *pBlock, size_t pSize);
+void __libc_free(void *pBlock);
+void *__libc_memalign(size_t pAlignment, size_t pSize);
+void *__libc_valloc(size_t pSize);
+
+#define MEMORY_PROFILER_CALLER ((sCaller != NULL) ? sCaller : __builtin_return_address(0))
+
+void *malloc(size_t pSize) __THROW
+{
+    uint64_t tWeight = SampleAllocation(pSize);
+    void *tResult = __libc_malloc((tWeight > 0) ? pSize + MEMORY_PROFILER_MARKER_SIZE : pSize);
+    AccountAllocation(tResult);
+    if (tWeight > 0)
+        RecordSample(tResult, tWeight, MEMORY_PROFILER_CALLER);
+
+    return tResult;
+}
+
+void *calloc(size_t pCount, size_t pSize) __THROW
+{
+    if ((pSize != 0) && (pCount > (size_t)-1 / pSize))
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+    uint64_t tWeight = SampleAllocation(pCount * pSize);
+    void *tResult = (tWeight > 0) ? __libc_calloc(1, pCount * pSize + MEMORY_PROFILER_MARKER_SIZE) : __libc_calloc(pCount, pSize);
+    AccountAllocation(tResult);
+    if (tWeight > 0)
+        RecordSample(tResult, tWeight, MEMORY_PROFILER_CALLER);
+
+    return tResult;
+}
+
+void *realloc(void *pBlock, size_t pSize) __THROW
+{
+    if (pBlock == NULL)
+    {
+        uint64_t tWeight = SampleAllocation(pSize);
+        void *tResult = __libc_malloc((tWeight > 0) ? pSize + MEMORY_PROFILER_MARKER_SIZE : pSize);
+        AccountAllocation(tResult);
+        if (tWeight > 0)
+            RecordSample(tResult, tWeight, MEMORY_PROFILER_CALLER);
+        return tResult;
+    }
+    if (pSize == 0)
+    {
+        ReleaseBlock(pBlock);
+        __libc_free(pBlock);
+        return NULL;
+    }
+
+    // a reallocation is accounted like a release of the old block and an allocation of the new one
+    uint64_t tWeight = SampleAllocation(pSize);
+    size_t tOldSize = ReleaseBlock(pBlock);
+    void *tResult = __libc_realloc(pBlock, (tWeight > 0) ? pSize + MEMORY_PROFILER_MARKER_SIZE : pSize);
+    if (tResult == NULL)
+    {// the old block is still alive, only its sample is lost
+        RevertFree(tOldSize);
+        return NULL;
+    }
+    AccountAllocation(tResult);
+    if (tWeight > 0)
+        RecordSample(tResult, tWeight, MEMORY_PROFILER_CALLER);
+
+    return tResult;
+}
+
+void *reallocarray(void *pBlock, size_t pCount, size_t pSize) __THROW
+{
+    if ((pSize != 0) && (pCount > (size_t)-1 / pSize))
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return realloc(pBlock, pCount * pSize);
+}
+
+void free(void *pBlock) __THROW
+{
+    if (pBlock == NULL)
+        return;
+
+    ReleaseBlock(pBlock);
+    __libc_free(pBlock);
+}
+
+void *memalign(size_t pAlignment, size_t pSize) __THROW
+{
+    uint64_t tWeight = SampleAllocation(pSize);
+    void *tResult = __libc_memalign(pAlignment, (tWeight > 0) ? pSize + MEMORY_PROFILER_MARKER_SIZE : pSize);
+    AccountAllocation(tResult);
+    if (tWeight > 0)
+        RecordSample(tResult, tWeight, MEMORY_PROFILER_CALLER);
+
+    return tResult;
+}
+
+void *aligned_alloc(size_t pAlignment, size_t pSize) __THROW
+{
+    return memalign(pAlignment, pSize);
+}
+
+int posix_memalign(void **pBlock, size_t pAlignment, size_t pSize) __THROW
+{
+    if ((pAlignment % sizeof(void*) != 0) || ((pAlignment & (pAlignment - 1)) != 0) || (pAlignment == 0))
+        return EINVAL;
+
+    uint64_t tWeight = SampleAllocation(pSize);
+    void *tResult = __libc_memalign(pAlignment, (tWeight > 0) ? pSize + MEMORY_PROFILER_MARKER_SIZE : pSize);
+    if (tResult == NULL)
+        return ENOMEM;
+    AccountAllocation(tResult);
+    if (tWeight > 0)
+        RecordSample(tResult, tWeight, MEMORY_PROFILER_CALLER);
+    *pBlock = tResult;
+
+    return 0;
+}
+
+void *valloc(size_t pSize) __THROW
+{
+    void *tResult = __libc_valloc(pSize);
+    AccountAllocation(tResult);
+
+    return tResult;
+}
+
+/*
+ * av_free() uses free() and doesn't need an own wrapper. The wrappers only set
+ * the call site for the nested allocation, which is done via posix_memalign()
+ * or realloc(), because libavutil binds its own internal calls directly.
+ */
+typedef void* (*AvMallocFunction)(size_t pSize);
+typedef void* (*AvReallocFunction)(void *pBlock, size_t pSize);
+
+static AvMallocFunction sAvMalloc = NULL;
+static AvMallocFunction sAvMallocz = NULL;
+static AvReallocFunction sAvRealloc = NULL;
+
+void *av_malloc(size_t pSize)
+{
+    if (sAvMalloc == NULL)
+        sAvMalloc = (AvMallocFunction)dlsym(RTLD_NEXT, "av_malloc");
+    if (sAvMalloc == NULL)
+        return NULL;
+
+    bool tOuterCall = (sCaller == NULL);
+    if (tOuterCall)
+        sCaller = __builtin_return_address(0);
+    void *tResult = sAvMalloc(pSize);
+    if (tOuterCall)
+        sCaller = NULL;
+
+    return tResult;
+}
+
+void *av_mallocz(size_t pSize)
+{
+    if (sAvMallocz == NULL)
+        sAvMallocz = (AvMallocFunction)dlsym(RTLD_NEXT, "av_mallocz");
+    if (sAvMallocz == NULL)
+        return NULL;
+
+    bool tOuterCall = (sCaller == NULL);
+    if (tOuterCall)
+        sCaller = __builtin_return_address(0);
+    void *tResult = sAvMallocz(pSize);
+    if (tOuterCall)
+        sCaller = NULL;
+
+    return tResult;
+}
+
+void *av_realloc(void *pBlock, size_t pSize)
+{
+    if (sAvRealloc == NULL)
+        sAvRealloc = (AvReallocFunction)dlsym(RTLD_NEXT, "av_realloc");
+    if (sAvRealloc == NULL)
+        return NULL;
+
+    bool tOuterCall = (sCaller == NULL);
+    if (tOuterCall)
+        sCaller = __builtin_return_address(0);
+    void *tResult = sAvRealloc(pBlock, pSize);
+    if (tOuterCall)
+        sCaller = NULL;
+
+    return tResult;
+}
+
+} // extern "C"
+
+#endif
@@ -28,6 +28,9 @@
 #include <HBMutex.h>
 #include <HBThread.h>
 #include <HBSystem.h>
+#include <HBTime.h>
+
+#include <map>
 
 #ifdef APPLE
 // to get current time stamp
@@ -41,10 +44,72 @@ using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+struct MutexProfileData
+{
+    volatile uint64_t   Acquisitions;
+    volatile uint64_t   ContendedAcquisitions;
+    volatile int64_t    WaitTime;
+    volatile int64_t    MaxHoldTime;
+};
+
+#ifdef HB_PROFILE_MUTEX
+typedef map<string, MutexProfileData*> MutexProfilesMap;
+
+// mutexes are also created during static initialization, hence the registry is created on demand and protected by a spin lock
+static MutexProfilesMap *sMutexProfiles = NULL;
+static volatile int sMutexProfilesLock = 0;
+
+static void LockMutexProfiles()
+{
+    while (__sync_lock_test_and_set(&sMutexProfilesLock, 1))
+        Thread::Suspend(1);
+}
+
+static void UnlockMutexProfiles()
+{
+    __sync_lock_release(&sMutexProfilesLock);
+}
+
+static MutexProfileData* GetMutexProfileData(const string &pName)
+{
+    MutexProfileData *tResult = NULL;
+
+    if (pName == "")
+        return NULL;
+
+    LockMutexProfiles();
+    if (sMutexProfiles == NULL)
+        sMutexProfiles = new MutexProfilesMap();
+    MutexProfilesMap::iterator tIt = sMutexProfiles->find(pName);
+    if (tIt != sMutexProfiles->end())
+    {
+        tResult = tIt->second;
+    }else
+    {
+        tResult = new MutexProfileData();
+        tResult->Acquisitions = 0;
+        tResult->ContendedAcquisitions = 0;
+        tResult->WaitTime = 0;
+        tResult->MaxHoldTime = 0;
+        (*sMutexProfiles)[pName] = tResult;
+    }
+    UnlockMutexProfiles();
+
+    return tResult;
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
 Mutex::Mutex(string pName)
 {
     mName = pName;
     mOwnerThreadId = -1;
+    mProfile = NULL;
+    mLockTime = 0;
+    #ifdef HB_PROFILE_MUTEX
+        mProfile = GetMutexProfileData(mName);
+    #endif
     bool tResult = false;
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
 		tResult = (pthread_mutex_init(&mMutex, NULL) == 0);
@@ -92,29 +157,111 @@ bool Mutex::lock(int pTimeout)
         exit(1);
     }
 
-    mOwnerThreadId = tThreadId;
+    bool tResult = false;
 
+    #ifdef HB_PROFILE_MUTEX
+        if (mProfile != NULL)
+            tResult = profiledLock(pTimeout);
+        else
+    #endif
     if (pTimeout > 0)
     {
-        return tryLock(pTimeout);
+        tResult = tryLock(pTimeout);
     }else
     {
         #if defined(LINUX) || defined(APPLE) || defined(BSD)
-            return !pthread_mutex_lock(&mMutex);
+            tResult = !pthread_mutex_lock(&mMutex);
         #endif
 		#if defined(WINDOWS)
-            return (WaitForSingleObject(mMutex, INFINITE) != WAIT_FAILED);
+            tResult = (WaitForSingleObject(mMutex, INFINITE) != WAIT_FAILED);
         #endif
     }
 
-    LOG(LOG_ERROR, "We should never reach this point");
-    return false;
+    // the owner is set only if the mutex was obtained, otherwise a failed timed lock would look like a recursive one later
+    if (tResult)
+        mOwnerThreadId = tThreadId;
+
+    return tResult;
+}
+
+bool Mutex::profiledLock(int pTimeout)
+{
+    bool tResult = false;
+    bool tContended = false;
+    int64_t tWaitStart = 0;
+
+    // first try without waiting
+    #if defined(LINUX) || defined(APPLE) || defined(BSD)
+        tResult = !pthread_mutex_trylock(&mMutex);
+    #endif
+    #if defined(WINDOWS)
+        tResult = (WaitForSingleObject(mMutex, 0) == WAIT_OBJECT_0);
+    #endif
+
+    if (!tResult)
+    {// another thread holds the mutex
+        tContended = true;
+        tWaitStart = Time::GetMonotonicTime();
+        if (pTimeout > 0)
+        {
+            tResult = tryLock(pTimeout);
+        }else
+        {
+            #if defined(LINUX) || defined(APPLE) || defined(BSD)
+                tResult = !pthread_mutex_lock(&mMutex);
+            #endif
+            #if defined(WINDOWS)
+                tResult = (WaitForSingleObject(mMutex, INFINITE) != WAIT_FAILED);
+            #endif
+        }
+    }
+
+    int64_t tNow = Time::GetMonotonicTime();
+    if (tContended)
+    {
+        __sync_add_and_fetch(&mProfile->ContendedAcquisitions, 1);
+        __sync_add_and_fetch(&mProfile->WaitTime, tNow - tWaitStart);
+    }
+    if (tResult)
+    {
+        __sync_add_and_fetch(&mProfile->Acquisitions, 1);
+        mLockTime = tNow;
+    }
+
+    return tResult;
+}
+
+void Mutex::profileRelease()
+{
+    #ifdef HB_PROFILE_MUTEX
+        if ((mProfile != NULL) && (mLockTime != 0))
+        {
+            int64_t tHoldTime = Time::GetMonotonicTime() - mLockTime;
+            mLockTime = 0;
+            int64_t tMaxHoldTime = mProfile->MaxHoldTime;
+            while ((tHoldTime > tMaxHoldTime) && (!__sync_bool_compare_and_swap(&mProfile->MaxHoldTime, tMaxHoldTime, tHoldTime)))
+                tMaxHoldTime = mProfile->MaxHoldTime;
+        }
+    #endif
+}
+
+void Mutex::profileAcquire()
+{
+    #ifdef HB_PROFILE_MUTEX
+        if (mProfile != NULL)
+        {
+            __sync_add_and_fetch(&mProfile->Acquisitions, 1);
+            mLockTime = Time::GetMonotonicTime();
+        }
+    #endif
 }
 
 bool Mutex::unlock()
 {
     mOwnerThreadId = -1;
 
+    profileRelease();
+
     #if defined(LINUX) || defined(APPLE) || defined(BSD)
 		return !pthread_mutex_unlock(&mMutex);
 	#endif
@@ -240,6 +387,54 @@ bool Mutex::tryLock(int pMSecs)
 void Mutex::AssignName(string pName)
 {
     mName = pName;
+    #ifdef HB_PROFILE_MUTEX
+        mProfile = GetMutexProfileData(mName);
+    #endif
+}
+
+MutexProfiles Mutex::GetProfiles()
+{
+    MutexProfiles tResult;
+
+    #ifdef HB_PROFILE_MUTEX
+        LockMutexProfiles();
+        if (sMutexProfiles != NULL)
+        {
+            MutexProfilesMap::iterator tIt;
+            for (tIt = sMutexProfiles->begin(); tIt != sMutexProfiles->end(); tIt++)
+            {
+                MutexProfile tProfile;
+                tProfile.Name = tIt->first;
+                tProfile.Acquisitions = tIt->second->Acquisitions;
+                tProfile.ContendedAcquisitions = tIt->second->ContendedAcquisitions;
+                tProfile.WaitTime = tIt->second->WaitTime;
+                tProfile.MaxHoldTime = tIt->second->MaxHoldTime;
+                tResult.push_back(tProfile);
+            }
+        }
+        UnlockMutexProfiles();
+    #endif
+
+    return tResult;
+}
+
+void Mutex::ResetProfiles()
+{
+    #ifdef HB_PROFILE_MUTEX
+        LockMutexProfiles();
+        if (sMutexProfiles != NULL)
+        {
+            MutexProfilesMap::iterator tIt;
+            for (tIt = sMutexProfiles->begin(); tIt != sMutexProfiles->end(); tIt++)
+            {
+                tIt->second->Acquisitions = 0;
+                tIt->second->ContendedAcquisitions = 0;
+                tIt->second->WaitTime = 0;
+                tIt->second->MaxHoldTime = 0;
+            }
+        }
+        UnlockMutexProfiles();
+    #endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -42,6 +42,9 @@
 #ifndef WINDOWS
 #include <unistd.h>
 #endif
+#if defined(LINUX) || defined(APPLE) || defined(BSD)
+#include <net/if.h>
+#endif
 
 namespace Homer { namespace Base {
 
@@ -73,6 +76,22 @@ int sIPv6Supported = -1;
 int sUDPliteSupported = -1;
 int sDCCPSupported = -1;
 int sSCTPSupported = -1;
+#if defined(LINUX)
+    int sBatchTransmissionSupported = true; // sendmmsg()/recvmmsg() available, will be reset at runtime if the kernel doesn't support them
+#else
+    int sBatchTransmissionSupported = false;
+#endif
+int sUDPSendOffloadSupported = -1;
+int sUDPReceiveOffloadSupported = -1;
+
+#if defined(LINUX)
+// control message buffer for the segment size of UDP segmentation offloads
+union SocketSegmentationControl
+{
+    struct cmsghdr  Header;
+    char            Buffer[CMSG_SPACE(sizeof(int))];
+};
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -90,6 +109,11 @@ void Socket::SetDefaults(enum TransportType pTransportType)
     mTcpClientSockeHandle = -1;
     mPeerHost = "";
     mPeerPort = 0;
+    mPeerBound = false;
+    mPeerConnected = false;
+    mPeerAddressDescriptorSize = 0;
+    mSendOffload = false;
+    mReceiveOffload = false;
     mUdpLiteChecksumCoverage = UDP_LITE_HEADER_SIZE;
 
     #if defined(WINDOWS) || defined(APPLE) || defined(BSD)
@@ -588,11 +612,14 @@ bool Socket::Send(string pTargetHost, unsigned int pTargetPort, void *pBuffer, s
 		case SOCKET_UDP_LITE:
             // continue as it was UDP sending
 		case SOCKET_UDP:
+		    // an explicit target address dissolves the association with a bound peer
+		    if (mPeerConnected)
+		        UnbindPeer();
 		    mPeerDataMutex.lock();
 		    mPeerHost = pTargetHost;
 		    mPeerPort = pTargetPort;
 		    mPeerDataMutex.unlock();
-	        tTime = Time::GetTimeStamp();
+	        tTime = Time::GetMonotonicTimeStamp();
             #if defined(LINUX)
 				tSent = sendto(mSocketHandle, pBuffer, (size_t)pBufferSize, MSG_NOSIGNAL, &tAddressDescriptor.sa, tAddressDescriptorSize);
 			#endif
@@ -603,7 +630,7 @@ bool Socket::Send(string pTargetHost, unsigned int pTargetPort, void *pBuffer, s
 				tSent = sendto(mSocketHandle, (const char*)pBuffer, (int)pBufferSize, 0, &tAddressDescriptor.sa, (int)tAddressDescriptorSize);
 			#endif
             #ifdef HBS_DEBUG_TIMING
-                tTime2 = Time::GetTimeStamp();
+                tTime2 = Time::GetMonotonicTimeStamp();
                 LOG(LOG_VERBOSE, "Sending %d bytes to network via UDP took %"PRId64" us", (int)pBufferSize, tTime2 - tTime);
             #endif
 			break;
@@ -680,6 +707,138 @@ bool Socket::Send(string pTargetHost, unsigned int pTargetPort, void *pBuffer, s
     return tResult;
 }
 
+bool Socket::Send(void *pBuffer, ssize_t pBufferSize)
+{
+    int                 tSent = 0;
+    bool                tResult = false;
+
+    if (mWasClosed)
+        return false;
+
+    if (!mPeerBound)
+    {
+        LOG(LOG_ERROR, "Socket %d isn't bound to a peer", mSocketHandle);
+        return false;
+    }
+
+    for (int tTry = 0; tTry < 2; tTry++)
+    {
+        if (mPeerConnected)
+        {
+            #if defined(LINUX)
+                tSent = send(mSocketHandle, pBuffer, (size_t)pBufferSize, MSG_NOSIGNAL);
+            #endif
+            #if defined(APPLE) || defined(BSD)
+                tSent = send(mSocketHandle, pBuffer, (size_t)pBufferSize, 0);
+            #endif
+            #if defined(WINDOWS)
+                tSent = send(mSocketHandle, (const char*)pBuffer, (int)pBufferSize, 0);
+            #endif
+        }else
+        {
+            #if defined(LINUX)
+                tSent = sendto(mSocketHandle, pBuffer, (size_t)pBufferSize, MSG_NOSIGNAL, &mPeerAddressDescriptor.sa, mPeerAddressDescriptorSize);
+            #endif
+            #if defined(APPLE) || defined(BSD)
+                tSent = sendto(mSocketHandle, pBuffer, (size_t)pBufferSize, 0, &mPeerAddressDescriptor.sa, mPeerAddressDescriptorSize);
+            #endif
+            #if defined(WINDOWS)
+                tSent = sendto(mSocketHandle, (const char*)pBuffer, (int)pBufferSize, 0, &mPeerAddressDescriptor.sa, (int)mPeerAddressDescriptorSize);
+            #endif
+        }
+
+        // a connected socket reports ICMP "port unreachable" of former datagrams, ignore this like for unconnected sockets
+        if ((tSent < 0) && (mPeerConnected) && (errno == ECONNREFUSED))
+            continue;
+
+        break;
+    }
+
+    if (tSent < 0)
+    {
+        LOG(LOG_ERROR, "Error when sending data via socket %d because of \"%s\"(%d)", mSocketHandle, strerror(errno), errno);
+    }else
+    {
+        if (tSent < (int)pBufferSize)
+        {
+            LOG(LOG_ERROR, "Insufficient data on socket %d was sent", mSocketHandle);
+        }else
+        {
+            #ifdef HBS_DEBUG_PACKETS
+                LOG(LOG_VERBOSE, "Sent %d bytes via socket %d to bound peer", tSent, mSocketHandle);
+            #endif
+            tResult = true;
+        }
+    }
+
+    return tResult;
+}
+
+bool Socket::BindPeer(string pTargetHost, unsigned int pTargetPort, bool pConnect)
+{
+    if (mWasClosed)
+        return false;
+
+    if (mSocketHandle == -1)
+    {
+        LOG(LOG_ERROR, "Invalid socket handle");
+        return false;
+    }
+
+    if ((mSocketTransportType != SOCKET_UDP) && (mSocketTransportType != SOCKET_UDP_LITE))
+    {
+        LOG(LOG_VERBOSE, "Binding of a peer is only supported for UDP and UDP-Lite sockets");
+        return false;
+    }
+
+    UnbindPeer();
+
+    if (!FillAddrDescriptor(pTargetHost, pTargetPort, &mPeerAddressDescriptor, mPeerAddressDescriptorSize))
+    {
+        LOG(LOG_ERROR ,"Could not process the peer address of socket %d", mSocketHandle);
+        return false;
+    }
+
+    if (pConnect)
+    {
+        if (connect(mSocketHandle, &mPeerAddressDescriptor.sa, mPeerAddressDescriptorSize) < 0)
+            LOG(LOG_WARN, "Failed to connect socket %d to %s<%u> because \"%s\"(%d), using unconnected socket instead", mSocketHandle, pTargetHost.c_str(), pTargetPort, strerror(errno), errno);
+        else
+            mPeerConnected = true;
+    }
+
+    mPeerDataMutex.lock();
+    mPeerHost = pTargetHost;
+    mPeerPort = pTargetPort;
+    mPeerDataMutex.unlock();
+
+    mPeerBound = true;
+
+    LOG(LOG_VERBOSE, "Bound %s socket %d to peer %s<%u>%s", TransportType2String(mSocketTransportType).c_str(), mSocketHandle, pTargetHost.c_str(), pTargetPort, mPeerConnected ? " (connected)" : "");
+
+    return true;
+}
+
+void Socket::UnbindPeer()
+{
+    if (mPeerConnected)
+    {
+        // dissolve the association by connecting to AF_UNSPEC, some systems report EAFNOSUPPORT even in case of success
+        SocketAddressDescriptor tAddressDescriptor;
+        memset(&tAddressDescriptor, 0, sizeof(tAddressDescriptor));
+        tAddressDescriptor.sa.sa_family = AF_UNSPEC;
+        connect(mSocketHandle, &tAddressDescriptor.sa, sizeof(tAddressDescriptor.sa));
+        LOG(LOG_VERBOSE, "Dissolved association of socket %d with its peer", mSocketHandle);
+    }
+    mPeerConnected = false;
+    mPeerBound = false;
+}
+
+bool Socket::IsPeerBound()
+{
+    return mPeerBound;
+}
+
 bool Socket::Receive(string &pSourceHost, unsigned int &pSourcePort, void *pBuffer, ssize_t &pBufferSize)
 {
     ssize_t                 tReceivedBytes = 0;
@@ -826,6 +985,420 @@ bool Socket::Receive(string &pSourceHost, unsigned int &pSourcePort, void *pBuff
     return tResult;
 }
 
+bool Socket::SendBatch(string pTargetHost, unsigned int pTargetPort, SocketDatagram *pDatagrams, int pDatagramCount)
+{
+    bool                tResult = true;
+
+    if (mWasClosed)
+        return false;
+
+    if (mSocketHandle == -1)
+    {
+        LOG(LOG_ERROR, "Invalid socket handle");
+        return false;
+    }
+
+    if ((sBatchTransmissionSupported) && ((mSocketTransportType == SOCKET_UDP) || (mSocketTransportType == SOCKET_UDP_LITE)))
+    {
+        SocketAddressDescriptor tAddressDescriptor;
+        unsigned int        tAddressDescriptorSize;
+        int                 tSentDatagrams = 0;
+
+        if (!FillAddrDescriptor(pTargetHost, pTargetPort, &tAddressDescriptor, tAddressDescriptorSize))
+        {
+            LOG(LOG_ERROR ,"Could not process the target address of socket %d", mSocketHandle);
+            return false;
+        }
+
+        // an explicit target address dissolves the association with a bound peer
+        if (mPeerConnected)
+            UnbindPeer();
+
+        mPeerDataMutex.lock();
+        mPeerHost = pTargetHost;
+        mPeerPort = pTargetPort;
+        mPeerDataMutex.unlock();
+
+        if (!SendDatagrams(&tAddressDescriptor, tAddressDescriptorSize, pDatagrams, pDatagramCount, tSentDatagrams, tResult))
+            return false;
+
+        #ifdef HBS_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Sent %d datagrams via socket %d to %s<%u>", tSentDatagrams, mSocketHandle, pTargetHost.c_str(), pTargetPort);
+        #endif
+
+        if (tSentDatagrams >= pDatagramCount)
+            return tResult;
+
+        pDatagrams += tSentDatagrams;
+        pDatagramCount -= tSentDatagrams;
+    }
+
+    // fall back to one system call per datagram
+    for (int i = 0; i < pDatagramCount; i++)
+    {
+        if (!Send(pTargetHost, pTargetPort, pDatagrams[i].Buffer, pDatagrams[i].BufferSize))
+            return false;
+    }
+
+    return tResult;
+}
+
+bool Socket::SendBatch(SocketDatagram *pDatagrams, int pDatagramCount)
+{
+    bool                tResult = true;
+
+    if (mWasClosed)
+        return false;
+
+    if (!mPeerBound)
+    {
+        LOG(LOG_ERROR, "Socket %d isn't bound to a peer", mSocketHandle);
+        return false;
+    }
+
+    if (sBatchTransmissionSupported)
+    {
+        int                 tSentDatagrams = 0;
+
+        if (!SendDatagrams(mPeerConnected ? NULL : &mPeerAddressDescriptor, mPeerAddressDescriptorSize, pDatagrams, pDatagramCount, tSentDatagrams, tResult))
+            return false;
+
+        #ifdef HBS_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Sent %d datagrams via socket %d to bound peer", tSentDatagrams, mSocketHandle);
+        #endif
+
+        if (tSentDatagrams >= pDatagramCount)
+            return tResult;
+
+        pDatagrams += tSentDatagrams;
+        pDatagramCount -= tSentDatagrams;
+    }
+
+    // fall back to one system call per datagram
+    for (int i = 0; i < pDatagramCount; i++)
+    {
+        if (!Send(pDatagrams[i].Buffer, pDatagrams[i].BufferSize))
+            return false;
+    }
+
+    return tResult;
+}
+
+bool Socket::SendDatagrams(SocketAddressDescriptor *pAddressDescriptor, unsigned int pAddressDescriptorSize, SocketDatagram *pDatagrams, int pDatagramCount, int &pSentDatagrams, bool &pComplete)
+{
+    pSentDatagrams = 0;
+
+    #if defined(LINUX)
+        struct mmsghdr      tMessages[SOCKET_BATCH_SIZE_MAX];
+        struct iovec        tIoVecs[SOCKET_BATCH_SIZE_MAX];
+        SocketSegmentationControl tControls[SOCKET_BATCH_SIZE_MAX];
+        int                 tMessageDatagrams[SOCKET_BATCH_SIZE_MAX];
+        size_t              tMessageSizes[SOCKET_BATCH_SIZE_MAX];
+
+        while (pSentDatagrams < pDatagramCount)
+        {
+            int tBatchSize = pDatagramCount - pSentDatagrams;
+            if (tBatchSize > SOCKET_BATCH_SIZE_MAX)
+                tBatchSize = SOCKET_BATCH_SIZE_MAX;
+
+            // each message carries one datagram or, with active segmentation offload, a train of datagrams
+            int tMessageCount = 0;
+            memset(tMessages, 0, sizeof(struct mmsghdr) * tBatchSize);
+            for (int i = 0; i < tBatchSize; tMessageCount++)
+            {
+                struct msghdr *tMessage = &tMessages[tMessageCount].msg_hdr;
+                size_t tSegmentSize = (size_t)pDatagrams[pSentDatagrams + i].BufferSize;
+                int tSegments = 1;
+
+                tIoVecs[i].iov_base = pDatagrams[pSentDatagrams + i].Buffer;
+                tIoVecs[i].iov_len = tSegmentSize;
+                tMessageSizes[tMessageCount] = tSegmentSize;
+                if ((mSendOffload) && (tSegmentSize > 0))
+                {
+                    // the kernel splits the message into segments of equal size, only the last segment may be shorter
+                    while ((i + tSegments < tBatchSize) && (tSegments < SOCKET_SEGMENTS_MAX))
+                    {
+                        size_t tNextSize = (size_t)pDatagrams[pSentDatagrams + i + tSegments].BufferSize;
+                        if ((tNextSize == 0) || (tNextSize > tSegmentSize) || (tMessageSizes[tMessageCount] + tNextSize > SOCKET_SEGMENTATION_SIZE_MAX))
+                            break;
+                        tIoVecs[i + tSegments].iov_base = pDatagrams[pSentDatagrams + i + tSegments].Buffer;
+                        tIoVecs[i + tSegments].iov_len = tNextSize;
+                        tMessageSizes[tMessageCount] += tNextSize;
+                        tSegments++;
+                        if (tNextSize < tSegmentSize)
+                            break;
+                    }
+                }
+                // a connected socket doesn't need a target address
+                if (pAddressDescriptor != NULL)
+                {
+                    tMessage->msg_name = &pAddressDescriptor->sa;
+                    tMessage->msg_namelen = pAddressDescriptorSize;
+                }
+                tMessage->msg_iov = &tIoVecs[i];
+                tMessage->msg_iovlen = tSegments;
+                if (tSegments > 1)
+                {
+                    tMessage->msg_control = tControls[tMessageCount].Buffer;
+                    tMessage->msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+                    struct cmsghdr *tControl = CMSG_FIRSTHDR(tMessage);
+                    tControl->cmsg_level = SOL_UDP;
+                    tControl->cmsg_type = UDP_SEGMENT;
+                    tControl->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                    *(uint16_t*)CMSG_DATA(tControl) = (uint16_t)tSegmentSize;
+                }
+                tMessageDatagrams[tMessageCount] = tSegments;
+                i += tSegments;
+            }
+
+            // the kernel may send only a part of the batch, continue with the remaining messages
+            int tSentMessages = 0;
+            bool tRefusalIgnored = false;
+            while (tSentMessages < tMessageCount)
+            {
+                int tSent = sendmmsg(mSocketHandle, &tMessages[tSentMessages], (unsigned int)(tMessageCount - tSentMessages), MSG_NOSIGNAL);
+                if (tSent < 0)
+                {
+                    if (errno == ENOSYS)
+                    {
+                        LOG(LOG_WARN, "Kernel doesn't support sendmmsg(), falling back to one system call per datagram");
+                        sBatchTransmissionSupported = false;
+                        return true;
+                    }
+                    if (errno == EINTR)
+                        continue;
+                    // a connected socket reports ICMP "port unreachable" of former datagrams, ignore this like for unconnected sockets
+                    if ((errno == ECONNREFUSED) && (pAddressDescriptor == NULL) && (!tRefusalIgnored))
+                    {
+                        tRefusalIgnored = true;
+                        continue;
+                    }
+                    // the segmentation offload was rejected, e.g., because the network device can't calculate checksums or a segment exceeds the MTU
+                    if ((tMessageDatagrams[tSentMessages] > 1) && ((errno == EIO) || (errno == EINVAL) || (errno == ENOPROTOOPT) || (errno == EOPNOTSUPP)))
+                    {
+                        LOG(LOG_WARN, "Segmentation offload failed on socket %d because of \"%s\"(%d), falling back to one message per datagram", mSocketHandle, strerror(errno), errno);
+                        mSendOffload = false;
+                        break;
+                    }
+                    LOG(LOG_ERROR, "Error when sending %d messages via socket %d because of \"%s\"(%d)", tMessageCount - tSentMessages, mSocketHandle, strerror(errno), errno);
+                    return false;
+                }
+                for (int i = tSentMessages; i < tSentMessages + tSent; i++)
+                {
+                    if (tMessages[i].msg_len < (unsigned int)tMessageSizes[i])
+                    {
+                        LOG(LOG_ERROR, "Insufficient data on socket %d was sent", mSocketHandle);
+                        pComplete = false;
+                    }
+                    pSentDatagrams += tMessageDatagrams[i];
+                }
+                tSentMessages += tSent;
+            }
+        }
+    #endif
+
+    return true;
+}
+
+int Socket::ReceiveBatch(string &pSourceHost, unsigned int &pSourcePort, SocketDatagram *pDatagrams, int pDatagramCount, bool pNonBlocking)
+{
+    int                 tResult = -1;
+
+    if (pDatagramCount < 1)
+        return 0;
+
+    if (mWasClosed)
+        return -1;
+
+    if (mSocketHandle == -1)
+    {
+        LOG(LOG_ERROR, "Invalid socket handle");
+        return -1;
+    }
+
+    #if defined(LINUX)
+        if ((sBatchTransmissionSupported) && ((mSocketTransportType == SOCKET_UDP) || (mSocketTransportType == SOCKET_UDP_LITE)))
+        {
+            SocketAddressDescriptor tAddressDescriptors[SOCKET_BATCH_SIZE_MAX];
+            struct mmsghdr      tMessages[SOCKET_BATCH_SIZE_MAX];
+            struct iovec        tIoVecs[SOCKET_BATCH_SIZE_MAX];
+            SocketSegmentationControl tControls[SOCKET_BATCH_SIZE_MAX];
+
+            if (pDatagramCount > SOCKET_BATCH_SIZE_MAX)
+                pDatagramCount = SOCKET_BATCH_SIZE_MAX;
+
+            memset(tMessages, 0, sizeof(struct mmsghdr) * pDatagramCount);
+            for (int i = 0; i < pDatagramCount; i++)
+            {
+                tIoVecs[i].iov_base = pDatagrams[i].Buffer;
+                tIoVecs[i].iov_len = (size_t)pDatagrams[i].BufferSize;
+                tMessages[i].msg_hdr.msg_name = &tAddressDescriptors[i].sa;
+                tMessages[i].msg_hdr.msg_namelen = sizeof(tAddressDescriptors[i].sa_stor);
+                tMessages[i].msg_hdr.msg_iov = &tIoVecs[i];
+                tMessages[i].msg_hdr.msg_iovlen = 1;
+                if (mReceiveOffload)
+                {
+                    tMessages[i].msg_hdr.msg_control = tControls[i].Buffer;
+                    tMessages[i].msg_hdr.msg_controllen = sizeof(tControls[i].Buffer);
+                }
+                pDatagrams[i].DataSize = 0;
+                pDatagrams[i].SegmentSize = 0;
+            }
+
+            // block until at least one datagram is available, afterwards take everything which is already queued
+            do{
+                tResult = recvmmsg(mSocketHandle, tMessages, (unsigned int)pDatagramCount, pNonBlocking ? MSG_DONTWAIT : MSG_WAITFORONE, NULL);
+            }while((tResult < 0) && (errno == EINTR) && (!mWasClosed));
+
+            // nothing available: a readiness notification may be spurious, e.g., in case of a dropped datagram with corrupted checksum
+            if ((tResult < 0) && (pNonBlocking) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+                return 0;
+
+            if (tResult >= 0)
+            {
+                for (int i = 0; i < tResult; i++)
+                {
+                    pDatagrams[i].DataSize = (ssize_t)tMessages[i].msg_len;
+                    if (tMessages[i].msg_len == (unsigned int)pDatagrams[i].BufferSize)
+                        LOG(LOG_WARN, "Entire buffer of %d bytes was used, maybe given application buffer is too small?", (int)tMessages[i].msg_len);
+
+                    // the kernel reports the original datagram size if it has coalesced several datagrams
+                    if ((mReceiveOffload) && (tMessages[i].msg_hdr.msg_controllen > 0))
+                    {
+                        for (struct cmsghdr *tControl = CMSG_FIRSTHDR(&tMessages[i].msg_hdr); tControl != NULL; tControl = CMSG_NXTHDR(&tMessages[i].msg_hdr, tControl))
+                        {
+                            if ((tControl->cmsg_level == SOL_UDP) && (tControl->cmsg_type == UDP_GRO))
+                            {
+                                int tSegmentSize = *(int*)CMSG_DATA(tControl);
+                                if ((tSegmentSize > 0) && (tSegmentSize < pDatagrams[i].DataSize))
+                                    pDatagrams[i].SegmentSize = (ssize_t)tSegmentSize;
+                            }
+                        }
+                    }
+                }
+
+                // the source of a batch is described by its last datagram
+                if (tResult > 0)
+                {
+                    mPeerDataMutex.lock();
+                    mPeerHost = GetAddrFromDescriptor(&tAddressDescriptors[tResult - 1], &mPeerPort);
+                    if (mPeerHost == "")
+                        LOG(LOG_ERROR ,"Could not determine the UDP/UDP-Lite source address for socket %d", mSocketHandle);
+                    pSourceHost = mPeerHost;
+                    pSourcePort = mPeerPort;
+                    mPeerDataMutex.unlock();
+                }
+                #ifdef HBS_DEBUG_PACKETS
+                    LOG(LOG_VERBOSE, "Received %d datagrams via socket %d at local port %d", tResult, mSocketHandle, mLocalPort);
+                #endif
+
+                return tResult;
+            }
+
+            if (errno != ENOSYS)
+            {
+                if ((errno != 0) && (!mWasClosed))
+                    LOG(LOG_ERROR, "Error when receiving data via socket %d at port %u because of \"%s\"(%d)", mSocketHandle, mLocalPort, strerror(errno), errno);
+                if (mSocketNetworkType == SOCKET_IPv6)
+                    pSourceHost = "::";
+                else
+                    pSourceHost = "0.0.0.0";
+                pSourcePort = 0;
+                pDatagrams[0].DataSize = -1;
+
+                return -1;
+            }
+
+            LOG(LOG_WARN, "Kernel doesn't support recvmmsg(), falling back to one system call per datagram");
+            sBatchTransmissionSupported = false;
+            // Receive() can't report coalesced datagrams
+            if (mReceiveOffload)
+                EnableReceiveOffload(false);
+        }
+    #endif
+
+    // fall back to one system call per datagram
+    pDatagrams[0].SegmentSize = 0;
+    pDatagrams[0].DataSize = pDatagrams[0].BufferSize;
+    if (Receive(pSourceHost, pSourcePort, pDatagrams[0].Buffer, pDatagrams[0].DataSize))
+        tResult = 1;
+
+    return tResult;
+}
+
+bool Socket::EnableSendOffload(bool pActive)
+{
+    if (!pActive)
+    {
+        mSendOffload = false;
+        return true;
+    }
+
+    // UDP-Lite packets can't be segmented by the kernel because of their partial checksum
+    if ((mSocketHandle == -1) || (mSocketTransportType != SOCKET_UDP) || (!sBatchTransmissionSupported) || (sUDPSendOffloadSupported == false))
+        return false;
+
+    #if defined(LINUX)
+        // probe the kernel support, the segment size is given per message, hence the socket default stays 0
+        int tSegmentSize = 0;
+        if (setsockopt(mSocketHandle, SOL_UDP, UDP_SEGMENT, (char*)&tSegmentSize, sizeof(tSegmentSize)) < 0)
+        {
+            LOG(LOG_WARN, "Kernel doesn't support UDP segmentation offload, falling back to one message per datagram");
+            sUDPSendOffloadSupported = false;
+            return false;
+        }
+        sUDPSendOffloadSupported = true;
+        mSendOffload = true;
+        LOG(LOG_VERBOSE, "Activated UDP segmentation offload for socket %d", mSocketHandle);
+    #endif
+
+    return mSendOffload;
+}
+
+bool Socket::EnableReceiveOffload(bool pActive)
+{
+    if ((mSocketHandle == -1) || (mSocketTransportType != SOCKET_UDP))
+        return false;
+
+    if (pActive == mReceiveOffload)
+        return true;
+
+    // only recvmmsg() delivers the size of coalesced datagrams
+    if ((pActive) && ((!sBatchTransmissionSupported) || (sUDPReceiveOffloadSupported == false)))
+        return false;
+
+    #if defined(LINUX)
+        int tValue = pActive;
+        if (setsockopt(mSocketHandle, SOL_UDP, UDP_GRO, (char*)&tValue, sizeof(tValue)) < 0)
+        {
+            if (pActive)
+            {
+                LOG(LOG_WARN, "Kernel doesn't support UDP receive offload, falling back to one buffer per datagram");
+                sUDPReceiveOffloadSupported = false;
+            }else
+                LOG(LOG_ERROR, "Failed to deactivate UDP receive offload for socket %d", mSocketHandle);
+            return false;
+        }
+        sUDPReceiveOffloadSupported = true;
+        mReceiveOffload = pActive;
+        LOG(LOG_VERBOSE, "%s UDP receive offload for socket %d", pActive ? "Activated" : "Deactivated", mSocketHandle);
+
+        return true;
+    #else
+        return false;
+    #endif
+}
+
+bool Socket::IsSendOffloadActive()
+{
+    return mSendOffload;
+}
+
+bool Socket::IsReceiveOffloadActive()
+{
+    return mReceiveOffload;
+}
+
 int Socket::GetSendBufferSize()
 {
     int tResult = -1;
@@ -928,6 +1501,234 @@ bool Socket::SetReceiveBufferSize(int pSize)
 	#endif
 }
 
+bool Socket::SetSendPriority(int pPriority)
+{
+    if (mSocketHandle == -1)
+    {
+        LOG(LOG_ERROR, "Socket is invalid");
+        return false;
+    }
+
+    #if defined(LINUX)
+        // priorities above 6 need CAP_NET_ADMIN
+        if (setsockopt(mSocketHandle, SOL_SOCKET, SO_PRIORITY, (char*)&pPriority, sizeof(pPriority)) < 0)
+        {
+            LOG(LOG_WARN, "Failed to set send priority %d on socket %d because %s(%d)", pPriority, mSocketHandle, strerror(errno), errno);
+            return false;
+        }
+        LOG(LOG_VERBOSE, "Set send priority of socket %d to %d", mSocketHandle, pPriority);
+        return true;
+    #else
+        return false;
+    #endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool Socket::IsMulticastAddress(string pAddress)
+{
+    if (IS_IPV6_ADDRESS(pAddress))
+    {// ff00::/8
+        struct in6_addr tAddress;
+        if (inet_pton(AF_INET6, pAddress.c_str(), &tAddress) <= 0)
+            return false;
+        return (tAddress.s6_addr[0] == 0xFF);
+    }else
+    {// 224.0.0.0/4
+        struct in_addr tAddress;
+        if (inet_pton(AF_INET, pAddress.c_str(), &tAddress) <= 0)
+            return false;
+        return ((ntohl(tAddress.s_addr) & 0xF0000000) == 0xE0000000);
+    }
+}
+
+bool Socket::SetMulticastTtl(int pTtl)
+{
+    int tResult;
+
+    if (mSocketHandle == -1)
+    {
+        LOG(LOG_ERROR, "Socket is invalid");
+        return false;
+    }
+
+    if ((pTtl < 0) || (pTtl > 255))
+    {
+        LOG(LOG_ERROR, "Invalid multicast TTL %d", pTtl);
+        return false;
+    }
+
+    if (mSocketNetworkType == SOCKET_IPv6)
+    {
+        int tHops = pTtl;
+        tResult = setsockopt(mSocketHandle, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, (char*)&tHops, sizeof(tHops));
+    }else
+    {
+        #if defined(APPLE) || defined(BSD)
+            unsigned char tTtl = (unsigned char)pTtl;
+        #else
+            int tTtl = pTtl;
+        #endif
+        tResult = setsockopt(mSocketHandle, IPPROTO_IP, IP_MULTICAST_TTL, (char*)&tTtl, sizeof(tTtl));
+    }
+    if (tResult < 0)
+    {
+        LOG(LOG_ERROR, "Failed to set multicast TTL %d on socket %d because %s(%d)", pTtl, mSocketHandle, strerror(errno), errno);
+        return false;
+    }
+
+    LOG(LOG_VERBOSE, "Set multicast TTL of socket %d to %d", mSocketHandle, pTtl);
+    return true;
+}
+
+bool Socket::SetMulticastInterface(string pInterface)
+{
+    if (mSocketHandle == -1)
+    {
+        LOG(LOG_ERROR, "Socket is invalid");
+        return false;
+    }
+
+    #if defined(LINUX) || defined(APPLE) || defined(BSD)
+        unsigned int tInterfaceIndex = 0;
+        int tResult;
+
+        if (pInterface != "")
+        {
+            tInterfaceIndex = if_nametoindex(pInterface.c_str());
+            if (tInterfaceIndex == 0)
+            {
+                LOG(LOG_ERROR, "Unknown network interface %s", pInterface.c_str());
+                return false;
+            }
+        }
+
+        if (mSocketNetworkType == SOCKET_IPv6)
+        {
+            tResult = setsockopt(mSocketHandle, IPPROTO_IPV6, IPV6_MULTICAST_IF, (char*)&tInterfaceIndex, sizeof(tInterfaceIndex));
+        }else
+        {
+            #if defined(LINUX)
+                struct ip_mreqn tRequest;
+                memset(&tRequest, 0, sizeof(tRequest));
+                tRequest.imr_ifindex = (int)tInterfaceIndex;
+                tResult = setsockopt(mSocketHandle, IPPROTO_IP, IP_MULTICAST_IF, (char*)&tRequest, sizeof(tRequest));
+            #else
+                LOG(LOG_WARN, "Selection of the outgoing interface for IPv4 multicast isn't supported on this platform");
+                return false;
+            #endif
+        }
+        if (tResult < 0)
+        {
+            LOG(LOG_ERROR, "Failed to set multicast interface %s on socket %d because %s(%d)", pInterface.c_str(), mSocketHandle, strerror(errno), errno);
+            return false;
+        }
+
+        LOG(LOG_VERBOSE, "Set multicast interface of socket %d to %s", mSocketHandle, (pInterface != "") ? pInterface.c_str() : "default");
+        return true;
+    #else
+        LOG(LOG_WARN, "Selection of the outgoing multicast interface isn't supported on this platform");
+        return false;
+    #endif
+}
+
+bool Socket::SetMulticastLoop(bool pActive)
+{
+    int tResult;
+
+    if (mSocketHandle == -1)
+    {
+        LOG(LOG_ERROR, "Socket is invalid");
+        return false;
+    }
+
+    if (mSocketNetworkType == SOCKET_IPv6)
+    {
+        unsigned int tLoop = pActive ? 1 : 0;
+        tResult = setsockopt(mSocketHandle, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, (char*)&tLoop, sizeof(tLoop));
+    }else
+    {
+        #if defined(APPLE) || defined(BSD)
+            unsigned char tLoop = pActive ? 1 : 0;
+        #else
+            int tLoop = pActive ? 1 : 0;
+        #endif
+        tResult = setsockopt(mSocketHandle, IPPROTO_IP, IP_MULTICAST_LOOP, (char*)&tLoop, sizeof(tLoop));
+    }
+    if (tResult < 0)
+    {
+        LOG(LOG_ERROR, "Failed to %s multicast loop on socket %d because %s(%d)", pActive ? "activate" : "deactivate", mSocketHandle, strerror(errno), errno);
+        return false;
+    }
+
+    return true;
+}
+
+bool Socket::JoinMulticastGroup(string pGroup, string pInterface)
+{
+    return ChangeMulticastMembership(pGroup, pInterface, true);
+}
+
+bool Socket::LeaveMulticastGroup(string pGroup, string pInterface)
+{
+    return ChangeMulticastMembership(pGroup, pInterface, false);
+}
+
+bool Socket::ChangeMulticastMembership(string pGroup, string pInterface, bool pJoin)
+{
+    if (mSocketHandle == -1)
+    {
+        LOG(LOG_ERROR, "Socket is invalid");
+        return false;
+    }
+
+    if (!IsMulticastAddress(pGroup))
+    {
+        LOG(LOG_ERROR, "%s is no multicast group", pGroup.c_str());
+        return false;
+    }
+
+    if ((mSocketTransportType != SOCKET_UDP) && (mSocketTransportType != SOCKET_UDP_LITE))
+    {
+        LOG(LOG_ERROR, "Multicast is only supported for UDP and UDP-Lite sockets");
+        return false;
+    }
+
+    #if defined(LINUX) || defined(APPLE) || defined(BSD)
+        // the protocol independent interface supports both IP versions, an IPv6 socket may also join an IPv4 group
+        struct group_req tRequest;
+        SocketAddressDescriptor tAddressDescriptor;
+        unsigned int tAddressDescriptorSize;
+
+        memset(&tRequest, 0, sizeof(tRequest));
+        if (pInterface != "")
+        {
+            tRequest.gr_interface = if_nametoindex(pInterface.c_str());
+            if (tRequest.gr_interface == 0)
+            {
+                LOG(LOG_ERROR, "Unknown network interface %s", pInterface.c_str());
+                return false;
+            }
+        }
+        memset(&tAddressDescriptor, 0, sizeof(tAddressDescriptor));
+        if (!FillAddrDescriptor(pGroup, 0, &tAddressDescriptor, tAddressDescriptorSize))
+            return false;
+        memcpy(&tRequest.gr_group, &tAddressDescriptor, tAddressDescriptorSize);
+
+        if (setsockopt(mSocketHandle, (mSocketNetworkType == SOCKET_IPv6) ? IPPROTO_IPV6 : IPPROTO_IP, pJoin ? MCAST_JOIN_GROUP : MCAST_LEAVE_GROUP, (char*)&tRequest, sizeof(tRequest)) < 0)
+        {
+            LOG(LOG_ERROR, "Failed to %s multicast group %s at interface %s with socket %d because %s(%d)", pJoin ? "join" : "leave", pGroup.c_str(), (pInterface != "") ? pInterface.c_str() : "default", mSocketHandle, strerror(errno), errno);
+            return false;
+        }
+
+        LOG(LOG_VERBOSE, "Socket %d %s multicast group %s at interface %s", mSocketHandle, pJoin ? "joined" : "left", pGroup.c_str(), (pInterface != "") ? pInterface.c_str() : "default");
+        return true;
+    #else
+        LOG(LOG_ERROR, "Multicast group membership isn't supported on this platform");
+        return false;
+    #endif
+}
+
 bool Socket::IsQoSSupported()
 {
     return (sQoSSupported == 1);
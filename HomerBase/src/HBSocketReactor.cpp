@@ -0,0 +1,361 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of socket reactor as singleton
+ * Since:   2026-10-16
+*/
+#include <Header_Windows.h>
+#include <HBSocketReactor.h>
+#include <HBSystem.h>
+
+#include <Logger.h>
+
+#include <string.h>
+#include <errno.h>
+#if defined(LINUX)
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+namespace Homer { namespace Base {
+
+using namespace std;
+
+SocketReactor sSocketReactor;
+
+///////////////////////////////////////////////////////////////////////////////
+
+SocketReactorThread::SocketReactorThread(SocketReactor *pReactor)
+{
+    mReactor = pReactor;
+}
+
+SocketReactorThread::~SocketReactorThread()
+{
+
+}
+
+void* SocketReactorThread::Run(void* pArgs)
+{
+    LOG(LOG_VERBOSE, "Socket reactor thread started");
+
+    mReactor->ProcessEvents();
+
+    LOG(LOG_VERBOSE, "Socket reactor thread finished");
+
+    return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SocketReactor::SocketReactor()
+{
+    mEpollHandle = -1;
+    mReactorNeeded = false;
+    mNextEntryId = 1;
+}
+
+SocketReactor::~SocketReactor()
+{
+    SocketReactorThreads::iterator tIt;
+
+    // tell I/O threads: they aren't needed anymore, they recognize this after SOCKET_REACTOR_WAIT_TIMEOUT at the latest
+    mReactorNeeded = false;
+
+    for (tIt = mThreads.begin(); tIt != mThreads.end(); tIt++)
+    {
+        (*tIt)->StopThread(2 * SOCKET_REACTOR_WAIT_TIMEOUT);
+        delete (*tIt);
+    }
+    mThreads.clear();
+
+    #if defined(LINUX)
+        if (mEpollHandle != -1)
+            close(mEpollHandle);
+    #endif
+}
+
+SocketReactor& SocketReactor::GetInstance()
+{
+    return sSocketReactor;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SocketReactor::IsAvailable()
+{
+    #if defined(LINUX)
+        return true;
+    #else
+        return false;
+    #endif
+}
+
+// HINT: has to be called with locked mEntriesMutex
+bool SocketReactor::Init()
+{
+    if (mEpollHandle != -1)
+        return true;
+
+    #if defined(LINUX)
+        mEpollHandle = epoll_create(SOCKET_REACTOR_EVENTS_MAX);
+        if (mEpollHandle < 0)
+        {
+            LOG(LOG_ERROR, "Failed to create epoll instance because of \"%s\"(%d)", strerror(errno), errno);
+            mEpollHandle = -1;
+            return false;
+        }
+
+        // one I/O thread per CPU core
+        int tThreadCount = System::GetMachineCores();
+        if (tThreadCount > SOCKET_REACTOR_THREADS_MAX)
+            tThreadCount = SOCKET_REACTOR_THREADS_MAX;
+        if (tThreadCount < 1)
+            tThreadCount = 1;
+
+        mReactorNeeded = true;
+        for (int i = 0; i < tThreadCount; i++)
+        {
+            SocketReactorThread *tThread = new SocketReactorThread(this);
+            if (tThread->StartThread())
+                mThreads.push_back(tThread);
+            else
+            {
+                LOG(LOG_ERROR, "Failed to start socket reactor thread %d", i);
+                delete tThread;
+            }
+        }
+
+        LOG(LOG_VERBOSE, "Socket reactor started with %d I/O threads", (int)mThreads.size());
+
+        return (mThreads.size() > 0);
+    #else
+        return false;
+    #endif
+}
+
+bool SocketReactor::RegisterSocket(Socket *pSocket, SocketReactorHandler *pHandler)
+{
+    SocketReactorEntries::iterator tIt;
+    bool tResult = false;
+
+    if ((pSocket == NULL) || (pHandler == NULL))
+        return false;
+
+    if (!IsAvailable())
+        return false;
+
+    // lock
+    mEntriesMutex.lock();
+
+    for (tIt = mEntries.begin(); tIt != mEntries.end(); tIt++)
+    {
+        if ((tIt->second.ObservedSocket == pSocket) && (!tIt->second.Removed))
+        {
+            LOG(LOG_WARN, "Socket %d is already registered", pSocket->GetHandle());
+
+            // unlock
+            mEntriesMutex.unlock();
+
+            return false;
+        }
+    }
+
+    if (Init())
+    {
+        #if defined(LINUX)
+            uint64_t tEntryId = mNextEntryId++;
+            struct epoll_event tEvent;
+            memset(&tEvent, 0, sizeof(tEvent));
+            // one shot: only one I/O thread at a time handles a socket, the socket is re-armed after its handler has returned
+            tEvent.events = EPOLLIN | EPOLLONESHOT;
+            tEvent.data.u64 = tEntryId;
+            if (epoll_ctl(mEpollHandle, EPOLL_CTL_ADD, pSocket->GetHandle(), &tEvent) == 0)
+            {
+                SocketReactorEntry tEntry;
+                tEntry.ObservedSocket = pSocket;
+                tEntry.Handler = pHandler;
+                tEntry.HandlerThreadId = 0;
+                tEntry.Removed = false;
+                mEntries[tEntryId] = tEntry;
+                tResult = true;
+                LOG(LOG_VERBOSE, "Registered socket %d, observing %d sockets", pSocket->GetHandle(), (int)mEntries.size());
+            }else
+                LOG(LOG_ERROR, "Failed to register socket %d because of \"%s\"(%d)", pSocket->GetHandle(), strerror(errno), errno);
+        #endif
+    }
+
+    // unlock
+    mEntriesMutex.unlock();
+
+    return tResult;
+}
+
+bool SocketReactor::UnregisterSocket(Socket *pSocket)
+{
+    SocketReactorEntries::iterator tIt;
+    uint64_t tEntryId = 0;
+
+    if (pSocket == NULL)
+        return false;
+
+    // lock
+    mEntriesMutex.lock();
+
+    for (tIt = mEntries.begin(); tIt != mEntries.end(); tIt++)
+    {
+        if ((tIt->second.ObservedSocket == pSocket) && (!tIt->second.Removed))
+        {
+            tEntryId = tIt->first;
+            break;
+        }
+    }
+
+    if (tEntryId == 0)
+    {
+        // unlock
+        mEntriesMutex.unlock();
+
+        return false;
+    }
+
+    #if defined(LINUX)
+        // the socket may already be closed, in this case the kernel has removed it automatically
+        struct epoll_event tEvent;
+        memset(&tEvent, 0, sizeof(tEvent));
+        epoll_ctl(mEpollHandle, EPOLL_CTL_DEL, pSocket->GetHandle(), &tEvent);
+    #endif
+
+    LOG(LOG_VERBOSE, "Unregistered socket %d", pSocket->GetHandle());
+
+    if (tIt->second.HandlerThreadId == 0)
+    {
+        mEntries.erase(tIt);
+
+        // unlock
+        mEntriesMutex.unlock();
+
+        return true;
+    }
+
+    // the I/O thread deletes the entry after the handler has returned
+    tIt->second.Removed = true;
+
+    if (tIt->second.HandlerThreadId == Thread::GetTId())
+    {// called by the handler itself
+        // unlock
+        mEntriesMutex.unlock();
+
+        return true;
+    }
+
+    // unlock
+    mEntriesMutex.unlock();
+
+    // wait for the end of the running handler call
+    bool tHandlerRunning = true;
+    while (tHandlerRunning)
+    {
+        Thread::Suspend(1000);
+
+        mEntriesMutex.lock();
+        tHandlerRunning = (mEntries.find(tEntryId) != mEntries.end());
+        mEntriesMutex.unlock();
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SocketReactor::ProcessEvents()
+{
+    #if defined(LINUX)
+        struct epoll_event tEvents[SOCKET_REACTOR_EVENTS_MAX];
+        SocketReactorEntries::iterator tIt;
+
+        while (mReactorNeeded)
+        {
+            int tEventCount = epoll_wait(mEpollHandle, tEvents, SOCKET_REACTOR_EVENTS_MAX, SOCKET_REACTOR_WAIT_TIMEOUT);
+            if (tEventCount < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                LOG(LOG_ERROR, "Failed to wait for socket events because of \"%s\"(%d)", strerror(errno), errno);
+                break;
+            }
+
+            for (int i = 0; i < tEventCount; i++)
+            {
+                uint64_t tEntryId = tEvents[i].data.u64;
+
+                mEntriesMutex.lock();
+
+                // the socket could have been unregistered in the meantime
+                tIt = mEntries.find(tEntryId);
+                if ((tIt == mEntries.end()) || (tIt->second.Removed))
+                {
+                    mEntriesMutex.unlock();
+                    continue;
+                }
+                tIt->second.HandlerThreadId = Thread::GetTId();
+                Socket *tSocket = tIt->second.ObservedSocket;
+                SocketReactorHandler *tHandler = tIt->second.Handler;
+
+                mEntriesMutex.unlock();
+
+                #ifdef HBSR_DEBUG_EVENTS
+                    LOG(LOG_VERBOSE, "Socket %d is readable, events: 0x%x", tSocket->GetHandle(), tEvents[i].events);
+                #endif
+
+                bool tObserveFurther = tHandler->SocketReadable(tSocket);
+
+                mEntriesMutex.lock();
+
+                // entries are only deleted by other threads if no handler is running, hence the iterator is still valid
+                tIt->second.HandlerThreadId = 0;
+                if (tIt->second.Removed)
+                {
+                    mEntries.erase(tIt);
+                }else
+                {
+                    if (tObserveFurther)
+                    {
+                        struct epoll_event tEvent;
+                        memset(&tEvent, 0, sizeof(tEvent));
+                        tEvent.events = EPOLLIN | EPOLLONESHOT;
+                        tEvent.data.u64 = tEntryId;
+                        if (epoll_ctl(mEpollHandle, EPOLL_CTL_MOD, tSocket->GetHandle(), &tEvent) != 0)
+                            LOG(LOG_ERROR, "Failed to re-arm socket %d because of \"%s\"(%d)", tSocket->GetHandle(), strerror(errno), errno);
+                    }else
+                        LOG(LOG_VERBOSE, "Socket %d isn't observed anymore", tSocket->GetHandle());
+                }
+
+                mEntriesMutex.unlock();
+            }
+        }
+    #endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
@@ -27,13 +27,11 @@
 #include <HBThread.h>
 #include <HBMutex.h>
 #include <HBSystem.h>
+#include <HBMemoryProfiler.h>
 #include <Logger.h>
 
 #include <Header_Windows.h>
 
-#if defined(LINUX)
-#include <malloc.h>
-#endif
 #include <string.h>
 #include <stdlib.h>
 #include <cstdio>
@@ -74,96 +72,24 @@ Thread::~Thread()
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#if defined(LINUX)
-// store the original malloc hook
-static void *(*sOriginalMallocHook)(size_t, const void *);
-
-std::map<int, unsigned long> sMemAllocations;
-Mutex sMallocDebuggerMutex("MallocDebuggerMutex");
-
-static void* malloc_hook(size_t pSize, const void* pCaller)
-{
-    int tThreadID = Thread::GetTId();
-    std::map<int, unsigned long>::iterator tIt;
-    void *tResult;
-
-    sMallocDebuggerMutex.lock();
-
-    // set original malloc hook
-    __malloc_hook = sOriginalMallocHook;
-
-    // re-call malloc()
-    tResult = malloc(pSize);
-
-    // account memory allocation
-    if(tResult != NULL)
-    {
-        /*
-         * update map about memory allocations
-         */
-        unsigned long tAllocatedMemForCurrentThread = 0;
-        tIt = sMemAllocations.find(tThreadID);
-        if (tIt != sMemAllocations.end())
-            tAllocatedMemForCurrentThread = tIt->second;
-        tAllocatedMemForCurrentThread += pSize;
-        sMemAllocations[tThreadID] = tAllocatedMemForCurrentThread;
-
-        // print debug output
-//        if(pSize > 32768)
-//            LOGEX(Thread, LOG_ERROR, "malloc(%u) called for thread %d from %p returns %p => %lu", (unsigned int) pSize, Thread::GetTId(), pCaller, tResult, tAllocatedMemForCurrentThread);
-    }
-
-    // restore our own hook
-    __malloc_hook = malloc_hook;
-
-    sMallocDebuggerMutex.unlock();
-
-    return tResult;
-}
-
 void Thread::ActiveMemoryDebugger()
 {
-    #ifdef DEBUG_VERSION
-        LOGEX(Thread, LOG_WARN, "Activating malloc() hook");
-        printf("Activating malloc() hook\n");
-
-        // store the original malloc hook
-        sOriginalMallocHook = __malloc_hook;
-
-        // set our own malloc hook
-        __malloc_hook = malloc_hook;
-    #endif
+    MemoryProfiler::Activate();
 }
 
-unsigned long Thread::GetMemoryAllocationSize(int pThreadID)
+void Thread::DeactivateMemoryDebugger()
 {
-    std::map<int, unsigned long>::iterator tIt;
-    uint64_t tResult = 0;
-
-    sMallocDebuggerMutex.lock();
-    tIt = sMemAllocations.find(pThreadID);
-    if (tIt != sMemAllocations.end())
-        tResult = tIt->second;
-    sMallocDebuggerMutex.unlock();
-
-    return tResult;
+    MemoryProfiler::Deactivate();
 }
 
-#else
-
-void Thread::ActiveMemoryDebugger()
-{
-
-}
 unsigned long Thread::GetMemoryAllocationSize(int pThreadID)
 {
-	return 0;
-}
-#endif
+    MemoryThreadProfile tProfile;
 
-void Thread::DeactivateMemoryDebugger()
-{
+    if (!MemoryProfiler::GetThreadProfile(pThreadID, tProfile))
+        return 0;
 
+    return (unsigned long)tProfile.AllocatedBytes;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -190,11 +116,29 @@ void Thread::Suspend(unsigned int pUSecs)
 	#endif
 }
 
+#if defined(LINUX) || defined(APPLE)
+// the thread ID is determined once per thread via a system call, further requests use the thread specific copy
+static pthread_key_t sThreadIdKey;
+static pthread_once_t sThreadIdKeyOnce = PTHREAD_ONCE_INIT;
+
+static void CreateThreadIdKey()
+{
+    pthread_key_create(&sThreadIdKey, NULL);
+}
+#endif
+
 int Thread::GetTId()
 {
+    #if defined(LINUX) || defined(APPLE)
+		pthread_once(&sThreadIdKeyOnce, CreateThreadIdKey);
+		intptr_t tCachedThreadId = (intptr_t)pthread_getspecific(sThreadIdKey);
+		if (tCachedThreadId != 0)
+			return (int)tCachedThreadId;
+		int tThreadId = 0;
+	#endif
     #if defined(LINUX)
 		// some magic from the depth of linux sources
-		return syscall(__NR_gettid);
+		tThreadId = syscall(__NR_gettid);
 	#endif
     #if defined(APPLE)
 		thread_info_data_t tThreadInfoData;
@@ -204,10 +148,15 @@ int Thread::GetTId()
 		if (thread_info(mach_thread_self(), THREAD_IDENTIFIER_INFO, (thread_info_t)tThreadInfoData, &tThreadInfoSize) != KERN_SUCCESS)
 		{
 			LOGEX(Thread, LOG_ERROR, "Failed to call thread_info()");
+			return 0;
 		}
 		tThreadIdentInfo = (thread_identifier_info_t)tThreadInfoData;
-		return (int)tThreadIdentInfo->thread_id;
+		tThreadId = (int)tThreadIdentInfo->thread_id;
     #endif
+    #if defined(LINUX) || defined(APPLE)
+		pthread_setspecific(sThreadIdKey, (void*)(intptr_t)tThreadId);
+		return tThreadId;
+	#endif
     #if defined(BSD)
 		return (int)pthread_self();
     #endif
@@ -34,6 +34,10 @@
 #include <sys/time.h>
 #endif
 
+#ifdef APPLE
+#include <mach/mach_time.h>
+#endif
+
 #include <Header_Windows.h>
 
 namespace Homer { namespace Base {
@@ -95,9 +99,41 @@ int64_t Time::GetTimeStamp()
 	return tResult;
 }
 
+int64_t Time::GetMonotonicTime()
+{
+	int64_t tResult = 0;
+    #if defined(LINUX) || defined(BSD)
+		struct timespec tTimeSpec;
+		clock_gettime(CLOCK_MONOTONIC, &tTimeSpec);
+		tResult = (int64_t)1000 * 1000 * 1000 * tTimeSpec.tv_sec + tTimeSpec.tv_nsec;
+	#endif
+
+	#ifdef APPLE
+		static mach_timebase_info_data_t sTimebaseInfo = {0, 0};
+		if (sTimebaseInfo.denom == 0)
+			mach_timebase_info(&sTimebaseInfo);
+		tResult = (int64_t)(mach_absolute_time() * sTimebaseInfo.numer / sTimebaseInfo.denom);
+	#endif
+
+	#ifdef WINDOWS
+		LARGE_INTEGER tFrequency, tCounter;
+		QueryPerformanceFrequency(&tFrequency);
+		QueryPerformanceCounter(&tCounter);
+		// split the conversion to avoid an overflow of the counter multiplied by 10^9
+		tResult = (int64_t)(tCounter.QuadPart / tFrequency.QuadPart) * 1000 * 1000 * 1000 + (int64_t)(tCounter.QuadPart % tFrequency.QuadPart) * 1000 * 1000 * 1000 / tFrequency.QuadPart;
+	#endif
+
+	return tResult;
+}
+
+int64_t Time::GetMonotonicTimeStamp()
+{
+	return GetMonotonicTime() / 1000;
+}
+
 int64_t Time::UpdateTimeStamp()
 {
-	mTimeStamp = GetTimeStamp();
+	mTimeStamp = GetMonotonicTimeStamp();
     return mTimeStamp;
 }
 
@@ -41,4 +41,10 @@ LogSink::~LogSink()
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void LogSink::Flush()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 }} //namespace
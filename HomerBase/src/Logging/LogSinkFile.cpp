@@ -49,6 +49,7 @@ LogSinkFile::LogSinkFile(string pFileName)
     ProcessMessage(LOG_VERBOSE, "", "", 0, "======================================");
     ProcessMessage(LOG_VERBOSE, "", "", 0, "========> LOGGING START POINT <=======");
     ProcessMessage(LOG_VERBOSE, "", "", 0, "======================================");
+    Flush();
     printf("Logging debug output to file \"%s\"\n", pFileName.c_str());
 }
 
@@ -82,10 +83,15 @@ void LogSinkFile::ProcessMessage(int pLevel, string pTime, string pSource, int p
                     fprintf(mFile, "(%s) WORLD: %s(%d): %s\n", pTime.c_str(), pSource.c_str(), pLine, pMessage.c_str());
                     break;
         }
-        fflush(mFile);
     }
 }
 
+void LogSinkFile::Flush()
+{
+    if (mFile != NULL)
+        fflush(mFile);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 }} //namespace
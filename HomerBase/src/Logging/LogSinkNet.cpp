@@ -51,6 +51,7 @@ LogSinkNet::LogSinkNet(string pTargetHost, unsigned short pTargetPort)
 
 LogSinkNet::~LogSinkNet()
 {
+    Flush();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -78,6 +79,20 @@ void LogSinkNet::ProcessMessage(int pLevel, string pTime, string pSource, int pL
     tData += "LINE=" + toString(pLine) + "\n";
     tData += "MESSAGE=" + pMessage + "\n";
 
+    // coalesce messages until the datagram would become too large
+    if ((mPendingData.size() > 0) && (mPendingData.size() + tData.size() > LOG_SINK_NET_MAX_DATAGRAM_SIZE))
+        Flush();
+    mPendingData += tData;
+}
+
+void LogSinkNet::Flush()
+{
+    if ((mDataSocket == NULL) || (mBrokenPipe) || (mPendingData.size() == 0))
+        return;
+
+    string tData = mPendingData;
+    mPendingData = "";
+
     if (!mDataSocket->Send(mTargetHost, mTargetPort, (void*)tData.c_str(), (ssize_t)tData.size()))
     {
         LOG(LOG_ERROR, "Error when sending data through UDP socket to %s:%u, will skip further transmissions", mTargetHost.c_str(), mTargetPort);
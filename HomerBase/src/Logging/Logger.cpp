@@ -31,6 +31,7 @@
 
 #include <Logger.h>
 #include <HBReflection.h>
+#include <HBThread.h>
 #include <HBTime.h>
 
 #include <stdarg.h>
@@ -55,6 +56,65 @@ using namespace std;
 
 Logger sLogger;
 bool sLoggerReady = false;
+volatile int Logger::sMessageLevel = LOG_ERROR;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// pre-formatted message of a producing thread
+struct LogRecord
+{
+    int         Level;
+    int         Line;
+    char        Source[LOGGER_ASYNC_SOURCE_SIZE];
+    char        Message[LOGGER_ASYNC_MESSAGE_SIZE];
+};
+
+// lock-free queue of one producing thread, it is read by the logger thread only
+struct LogRing
+{
+    LogRecord   Records[LOGGER_ASYNC_RING_SIZE];
+    volatile unsigned int WriteCount; // changed by the producing thread only
+    volatile unsigned int ReadCount; // changed by the logger thread only
+    volatile int Dropped; // changed by the producing thread only
+    int         ReportedDropped; // used by the logger thread only
+    int         ThreadId;
+    volatile bool Orphaned; // the producing thread has terminated
+};
+
+// thread specific pointer to the log ring of the calling thread
+#if defined(LINUX) || defined(APPLE) || defined(BSD)
+static pthread_key_t sLogRingKey;
+static pthread_once_t sLogRingKeyOnce = PTHREAD_ONCE_INIT;
+
+static void DestroyLogRingKey(void *pLogRing)
+{
+    // the logger thread deletes the ring after it has delivered the remaining records
+    ((LogRing*)pLogRing)->Orphaned = true;
+}
+
+static void CreateLogRingKey()
+{
+    pthread_key_create(&sLogRingKey, DestroyLogRingKey);
+}
+#endif
+#if defined(WINDOWS)
+// TLS slots don't inform about terminated threads, hence the rings are kept until the process terminates
+static DWORD sLogRingKey = TLS_OUT_OF_INDEXES;
+#endif
+
+class LoggerThread:
+    public Thread
+{
+public:
+    LoggerThread() { }
+    virtual ~LoggerThread() { }
+
+    virtual void* Run(void* pArgs = NULL)
+    {
+        LOGGER.AsyncLoggingMain();
+        return NULL;
+    }
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -70,6 +130,10 @@ Logger::Logger()
 	mLoggerMutex.AssignName("LoggerMutex");
 	mLogSinksMutex.AssignName("LogSinksMutex");
     mLogSinkConsole = new LogSinkConsole();
+    mAsyncLogging = false;
+    mLoggerThread = NULL;
+    mDroppedMessages = 0;
+    mLogRingsMutex.AssignName("LogRingsMutex");
 }
 
 Logger::~Logger()
@@ -119,6 +183,7 @@ void Logger::RegisterLogSink(LogSink* pLogSink)
     {
         mLogSinks.push_back(pLogSink);
         mRegisteredSinks++;
+        UpdateMessageLevel();
     }
 
     // unlock
@@ -158,6 +223,7 @@ void Logger::UnregisterLogSink(LogSink* pLogSink)
             tFound = true;
             mLogSinks.erase(tIt);
             mRegisteredSinks--;
+            UpdateMessageLevel();
             break;
         }
     }
@@ -197,6 +263,9 @@ void Logger::RelayMessageToLogSinks(int pLevel, string pTime, string pSource, in
         for (tIt = mLogSinks.begin(); tIt != mLogSinks.end(); tIt++)
         {
             (*tIt)->ProcessMessage(pLevel, pTime, pSource, pLine, pMessage);
+            // the logger thread flushes in bounded intervals
+            if (!mAsyncLogging)
+                (*tIt)->Flush();
         }
     }
 
@@ -204,6 +273,31 @@ void Logger::RelayMessageToLogSinks(int pLevel, string pTime, string pSource, in
     mLogSinksMutex.unlock();
 }
 
+void Logger::UpdateMessageLevel()
+{
+    // log sinks get messages of all levels
+    if (mRegisteredSinks > 0)
+        sMessageLevel = LOG_WORLD;
+    else
+        sMessageLevel = mLogLevel;
+}
+
+void Logger::FlushLogSinks()
+{
+    LogSinksList::iterator tIt;
+
+    // lock
+    mLogSinksMutex.lock();
+
+    for (tIt = mLogSinks.begin(); tIt != mLogSinks.end(); tIt++)
+    {
+        (*tIt)->Flush();
+    }
+
+    // unlock
+    mLogSinksMutex.unlock();
+}
+
 void Logger::SetColoring(bool pState)
 {
     mLogSinkConsole->SetColoring(pState);
@@ -225,18 +319,53 @@ void Logger::AddMessage(int pLevel, const char *pSource, int pLine, const char*
     }
 
     va_list tVArgs;
+
+    if (mAsyncLogging)
+    {
+        LogRing *tRing = GetLogRing();
+        if (tRing != NULL)
+        {
+            if (tRing->WriteCount - tRing->ReadCount >= LOGGER_ASYNC_RING_SIZE)
+            {// ring is full: drop the message, the logger thread reports the count
+                tRing->Dropped++;
+                return;
+            }
+
+            // format the message directly into the free record
+            LogRecord *tRecord = &tRing->Records[tRing->WriteCount % LOGGER_ASYNC_RING_SIZE];
+            tRecord->Level = pLevel;
+            tRecord->Line = pLine;
+            strncpy(tRecord->Source, pSource, LOGGER_ASYNC_SOURCE_SIZE - 1);
+            tRecord->Source[LOGGER_ASYNC_SOURCE_SIZE - 1] = 0;
+            va_start(tVArgs, pFormat);
+            vsnprintf(tRecord->Message, LOGGER_ASYNC_MESSAGE_SIZE, pFormat, tVArgs);
+            va_end(tVArgs);
+            tRecord->Message[LOGGER_ASYNC_MESSAGE_SIZE - 1] = 0;
+
+            // publish the record after it is completely written
+            __sync_synchronize();
+            tRing->WriteCount++;
+            return;
+        }
+    }
+
     char tMessageBuffer[4 * 1024];
 
     va_start(tVArgs, pFormat);
     vsprintf(tMessageBuffer, pFormat, tVArgs);
     va_end(tVArgs);
 
+    DeliverMessage(pLevel, toString(pSource), pLine, toString(tMessageBuffer));
+}
+
+void Logger::DeliverMessage(int pLevel, string pSource, int pLine, string pMessage)
+{
     string tFinalSource, tFinalTime, tFinalMessage;
     int tHour, tMin, tSec;
     Time::GetNow(0, 0, 0, &tHour, &tMin, &tSec);
     tFinalTime = (tHour < 10 ? "0" : "") + toString(tHour) + ":" + (tMin < 10 ? "0" : "") + toString(tMin) + "." + (tSec < 10 ? "0" : "") + toString(tSec);
-    tFinalSource = toString(pSource);
-    tFinalMessage = toString(tMessageBuffer);
+    tFinalSource = pSource;
+    tFinalMessage = pMessage;
 
     // lock
     if (mLoggerMutex.lock(250))
@@ -264,7 +393,7 @@ void Logger::AddMessage(int pLevel, const char *pSource, int pLine, const char*
     {
         if ((pLevel <= mLogLevel) && (pLevel > LOG_OFF))
         {
-        	printf("LOGGER: system load is high, skipped locking at %s for %s(%d) and message \"%s\", will ignore this.\n", tFinalTime.c_str(), pSource, pLine, tFinalMessage.c_str());
+        	printf("LOGGER: system load is high, skipped locking at %s for %s(%d) and message \"%s\", will ignore this.\n", tFinalTime.c_str(), tFinalSource.c_str(), pLine, tFinalMessage.c_str());
         }
     }
 }
@@ -276,6 +405,7 @@ void Logger::Init(int pLevel)
 
 void Logger::Deinit()
 {
+    StopAsyncLogging();
 }
 
 void Logger::SetLogLevel(int pLevel)
@@ -312,6 +442,10 @@ void Logger::SetLogLevel(int pLevel)
                 mLogLevel = LOG_OFF;
                 break;
     }
+
+    mLogSinksMutex.lock();
+    UpdateMessageLevel();
+    mLogSinksMutex.unlock();
 }
 
 int Logger::GetLogLevel()
@@ -327,4 +461,191 @@ int Logger::GetLogLevel()
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool Logger::StartAsyncLogging()
+{
+    if( !sLoggerReady)
+    {
+        printf("Tried to start asynchronous logging when logger isn't available yet\n");
+        return false;
+    }
+
+    if (mLoggerThread != NULL)
+        return true;
+
+    #if defined(LINUX) || defined(APPLE) || defined(BSD)
+        pthread_once(&sLogRingKeyOnce, CreateLogRingKey);
+    #endif
+    #if defined(WINDOWS)
+        if (sLogRingKey == TLS_OUT_OF_INDEXES)
+            sLogRingKey = TlsAlloc();
+        if (sLogRingKey == TLS_OUT_OF_INDEXES)
+        {
+            LOG(LOG_ERROR, "Couldn't allocate TLS slot for asynchronous logging");
+            return false;
+        }
+    #endif
+
+    mLoggerThread = new LoggerThread();
+    mAsyncLogging = true;
+    if (!mLoggerThread->StartThread())
+    {
+        mAsyncLogging = false;
+        delete mLoggerThread;
+        mLoggerThread = NULL;
+        LOG(LOG_ERROR, "Couldn't start logger thread, will log synchronously");
+        return false;
+    }
+
+    LOG(LOG_VERBOSE, "Asynchronous logging started");
+
+    return true;
+}
+
+void Logger::StopAsyncLogging()
+{
+    if (mLoggerThread == NULL)
+        return;
+
+    LOG(LOG_VERBOSE, "Stopping asynchronous logging, %"PRIu64" messages were dropped", mDroppedMessages);
+
+    // further messages are delivered synchronously, the logger thread delivers the queued ones before it terminates
+    mAsyncLogging = false;
+    mLoggerThread->StopThread();
+    delete mLoggerThread;
+    mLoggerThread = NULL;
+
+    // messages which were queued while the logger thread terminated
+    ProcessLogRings();
+    FlushLogSinks();
+}
+
+bool Logger::IsAsyncLogging()
+{
+    return mAsyncLogging;
+}
+
+uint64_t Logger::GetDroppedMessages()
+{
+    return mDroppedMessages;
+}
+
+LogRing* Logger::GetLogRing()
+{
+    LogRing *tResult = NULL;
+
+    #if defined(LINUX) || defined(APPLE) || defined(BSD)
+        tResult = (LogRing*)pthread_getspecific(sLogRingKey);
+    #endif
+    #if defined(WINDOWS)
+        tResult = (LogRing*)TlsGetValue(sLogRingKey);
+    #endif
+
+    if (tResult == NULL)
+    {// first message of this thread: create its ring
+        tResult = new LogRing();
+        tResult->WriteCount = 0;
+        tResult->ReadCount = 0;
+        tResult->Dropped = 0;
+        tResult->ReportedDropped = 0;
+        tResult->ThreadId = Thread::GetTId();
+        tResult->Orphaned = false;
+
+        #if defined(LINUX) || defined(APPLE) || defined(BSD)
+            pthread_setspecific(sLogRingKey, tResult);
+        #endif
+        #if defined(WINDOWS)
+            TlsSetValue(sLogRingKey, tResult);
+        #endif
+
+        mLogRingsMutex.lock();
+        mLogRings.push_back(tResult);
+        mLogRingsMutex.unlock();
+    }
+
+    return tResult;
+}
+
+bool Logger::ProcessLogRings()
+{
+    LogRingsList::iterator tIt;
+    bool tResult = false;
+
+    // lock
+    mLogRingsMutex.lock();
+
+    tIt = mLogRings.begin();
+    while (tIt != mLogRings.end())
+    {
+        LogRing *tRing = *tIt;
+
+        // read the orphan state before the last records, the terminated thread doesn't add further ones
+        bool tOrphaned = tRing->Orphaned;
+        __sync_synchronize();
+
+        while (tRing->ReadCount != tRing->WriteCount)
+        {
+            // read the record after it was published
+            __sync_synchronize();
+            LogRecord *tRecord = &tRing->Records[tRing->ReadCount % LOGGER_ASYNC_RING_SIZE];
+            DeliverMessage(tRecord->Level, tRecord->Source, tRecord->Line, tRecord->Message);
+            // free the record after it was delivered
+            __sync_synchronize();
+            tRing->ReadCount++;
+            tResult = true;
+        }
+
+        int tDropped = tRing->Dropped;
+        if (tDropped != tRing->ReportedDropped)
+        {
+            mDroppedMessages += tDropped - tRing->ReportedDropped;
+            DeliverMessage(LOG_WARN, GetObjectNameCached(this), __LINE__, "Dropped " + toString(tDropped - tRing->ReportedDropped) + " log messages of thread " + toString(tRing->ThreadId) + " because its log queue was full");
+            tRing->ReportedDropped = tDropped;
+            tResult = true;
+        }
+
+        if (tOrphaned)
+        {
+            delete tRing;
+            tIt = mLogRings.erase(tIt);
+        }else
+            tIt++;
+    }
+
+    // unlock
+    mLogRingsMutex.unlock();
+
+    return tResult;
+}
+
+void Logger::AsyncLoggingMain()
+{
+    int64_t tLastFlushTime = Time::GetMonotonicTimeStamp();
+    bool tUnflushedMessages = false;
+
+    // messages of the log sinks are queued while the log rings are locked, hence the ring of this thread has to exist before
+    GetLogRing();
+
+    while (mAsyncLogging)
+    {
+        if (ProcessLogRings())
+            tUnflushedMessages = true;
+
+        // flush in bounded intervals instead of after each message
+        if ((tUnflushedMessages) && (Time::GetMonotonicTimeStamp() - tLastFlushTime >= LOGGER_ASYNC_FLUSH_INTERVAL * 1000))
+        {
+            FlushLogSinks();
+            tUnflushedMessages = false;
+            tLastFlushTime = Time::GetMonotonicTimeStamp();
+        }
+
+        Thread::Suspend(LOGGER_ASYNC_PERIOD * 1000);
+    }
+
+    // deliver the remaining messages
+    ProcessLogRings();
+    FlushLogSinks();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 }} //namespace
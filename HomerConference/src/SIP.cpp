@@ -645,11 +645,11 @@ void* SIP::Run(void*)
                     nua_shutdown(mSipContext->SipListener[i].Nua);
             }
 
-            int64_t tTime = Time::GetTimeStamp();
+            int64_t tTime = Time::GetMonotonicTimeStamp();
             // wait for shutdown of NUA stack
             while (mSipStackOnline)
             {
-            	if (Time::GetTimeStamp() - tTime > SHUTDOWN_REQUEST_TIMEOUT * 1000 * 1000)
+            	if (Time::GetMonotonicTimeStamp() - tTime > SHUTDOWN_REQUEST_TIMEOUT * 1000 * 1000)
             	{
             		LOG(LOG_ERROR, "Timeout of %d seconds occurred during SIP stack shutdown", SHUTDOWN_REQUEST_TIMEOUT);
             		break;
@@ -43,6 +43,7 @@ namespace Homer { namespace Monitor {
 // reference buffer size for average data rate measurement (current value!)
 #define STATISTIC_MOMENT_DATARATE_REFERENCE_SIZE                   8
 #define STATISTIC_MOMENT_DATARATE_HISTORY                     5 * 1000 * 1000 // limits the measurement array
+#define STATISTIC_BIT_RATE_ESTIMATE_HISTORY                   1000 // only the latest estimates are kept
 
 //#define STATISTIC_DEBUG_TIMING
 
@@ -57,6 +58,16 @@ enum DataType
 	DATA_TYPE_GENDATA
 };
 
+// why were whole frames of an outgoing stream dropped?
+enum FrameDropReason
+{
+    FRAME_DROP_NON_REFERENCE = 0,   // overload, no other frame depends on it
+    FRAME_DROP_REFERENCE,           // heavy overload, breaks the reference chain until the next key frame
+    FRAME_DROP_BROKEN_REFERENCE,    // depends on a dropped frame
+    FRAME_DROP_AUDIO,               // overload of an audio stream
+    FRAME_DROP_REASONS
+};
+
 struct PacketStatisticDescriptor{
     bool Outgoing;
     int  MinPacketSize;
@@ -64,6 +75,21 @@ struct PacketStatisticDescriptor{
     int  PacketCount;
     int64_t ByteCount;
     uint64_t LostPacketCount;
+    int64_t CopiedByteCount;
+    int  JitterBufferDepth;
+    uint64_t LatePacketCount;
+    uint64_t ReorderedPacketCount;
+    uint64_t RecoveredPacketCount;
+    uint64_t UnrecoverablePacketCount;
+    int  EstimatedBitRate;
+    int  RoundTripTime;
+    int  Jitter;
+    float ReportedLoss;
+    uint64_t KeyFrameRequestCount;
+    int  KeyFrameDelay;
+    uint64_t DroppedPacketCount;
+    int  PacingDelay;
+    uint64_t DroppedFrameCount[FRAME_DROP_REASONS];
     int  AvgPacketSize;
     int  AvgDataRate;
     int  MomentAvgDataRate;
@@ -97,12 +123,29 @@ public:
     int GetMinPacketSize();
     int GetMaxPacketSize();
     uint64_t GetLostPacketCount();
+    int64_t GetCopiedByteCount(); // bytes which were copied in user space while the stream data was processed
+    int GetJitterBufferDepth(); // packets which currently wait in the receiver's jitter buffer
+    uint64_t GetLatePacketCount(); // packets which arrived after they were declared as lost
+    uint64_t GetReorderedPacketCount(); // packets which arrived out of order and were reordered
+    uint64_t GetRecoveredPacketCount(); // lost packets which were recovered by FEC
+    uint64_t GetUnrecoverablePacketCount(); // lost packets which couldn't be recovered by FEC
+    int GetEstimatedBitRate(); // available bit rate in bit/s as estimated by congestion control, -1 if unknown
+    int GetRoundTripTime(); // in ms as reported by RTCP, -1 if unknown
+    int GetJitter(); // interarrival jitter in ms as reported by RTCP, -1 if unknown
+    float GetReportedLoss(); // in percent as reported by RTCP, -1 if unknown
+    uint64_t GetKeyFrameRequestCount(); // key frame requests from receivers
+    int GetKeyFrameDelay(); // time in ms from the last key frame request until the key frame was sent, -1 if unknown
+    uint64_t GetDroppedPacketCount(); // packets which were dropped because the queue of the stream was full
+    int GetPacingDelay(); // avg. time in us which outgoing packets waited in the send queue, -1 if unknown
+    uint64_t GetDroppedFrameCount(enum FrameDropReason pReason); // whole outgoing frames which were dropped by the sender
+    static std::string FrameDropReason2String(enum FrameDropReason pReason);
 
     /* get statistic values */
     PacketStatisticDescriptor GetPacketStatistic();
 
     /* history */
     DataRateHistory GetDataRateHistory();
+    DataRateHistory GetBitRateEstimateHistory(); // in bit/s
 
     /* classification */
     void AssignStreamName(std::string pName);
@@ -123,6 +166,15 @@ public:
 protected:
     /* update internal states */
     void AnnouncePacket(int pSize /* in bytes */); // timestamp is auto generated
+    void AnnounceCopiedBytes(int pSize /* in bytes */);
+    void SetJitterBufferStatistic(int pDepth, uint64_t pLatePacketCount, uint64_t pReorderedPacketCount);
+    void SetFecStatistic(uint64_t pRecoveredPacketCount, uint64_t pUnrecoverablePacketCount);
+    void AnnounceBitRateEstimate(int pBitRate /* in bit/s */);
+    void SetReceptionQuality(int pRoundTripTime /* in ms */, int pJitter /* in ms */, float pLoss /* in percent */);
+    void SetKeyFrameStatistic(uint64_t pRequestCount, int pDelay /* in ms */);
+    void AnnounceDroppedPackets(int pCount);
+    void SetPacingStatistic(int pDelay /* in us */);
+    void AnnounceDroppedFrame(enum FrameDropReason pReason);
     /* identification */
     void ClassifyStream(enum DataType pDataType = DATA_TYPE_UNKNOWN, enum TransportType pTransportType  = SOCKET_TRANSPORT_TYPE_INVALID, enum NetworkType pNetworkType = SOCKET_RAWNET);
     void SetOutgoingStream();
@@ -144,6 +196,21 @@ private:
     int64_t       mStartTimeStamp;
     int64_t       mEndTimeStamp;
     uint64_t      mLostPacketCount;
+    volatile int64_t mCopiedByteCount; // updated by several threads without locking
+    int           mJitterBufferDepth;
+    uint64_t      mLatePacketCount;
+    uint64_t      mReorderedPacketCount;
+    uint64_t      mRecoveredPacketCount;
+    uint64_t      mUnrecoverablePacketCount;
+    int           mEstimatedBitRate;
+    int           mRoundTripTime;
+    int           mJitter;
+    float         mReportedLoss;
+    uint64_t      mKeyFrameRequestCount;
+    int           mKeyFrameDelay;
+    uint64_t      mDroppedPacketCount;
+    int           mPacingDelay;
+    uint64_t      mDroppedFrameCount[FRAME_DROP_REASONS];
     Time          mLastTime;
     Statistics mStatistics;
     Mutex         mStatisticsMutex;
@@ -156,6 +223,7 @@ private:
     DataRateHistory mDataRateHistory;
     Mutex         mDataRateHistoryMutex;
     bool          mFirstDataRateHistoryLoss;
+    DataRateHistory mBitRateEstimateHistory;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -42,6 +42,8 @@ PacketStatistic::PacketStatistic(std::string pName)
 {
 	mStreamDataType = DATA_TYPE_UNKNOWN;
 	mStreamOutgoing = false;
+	mStatisticsMutex.AssignName("PacketStatisticMutex");
+	mDataRateHistoryMutex.AssignName("DataRateHistoryMutex");
 	ResetPacketStatistic();
     AssignStreamName(pName);
     if (SVC_PACKET_STATISTIC.RegisterPacketStatistic(this) != this)
@@ -88,7 +90,7 @@ void PacketStatistic::AnnouncePacket(int pSize)
             break;
     }
 
-    mEndTimeStamp = Time::GetTimeStamp();
+    mEndTimeStamp = Time::GetMonotonicTimeStamp();
     if (mStartTimeStamp == 0)
         mStartTimeStamp = mEndTimeStamp;
 
@@ -96,7 +98,7 @@ void PacketStatistic::AnnouncePacket(int pSize)
     tStatEntry.PacketSize = pSize;
     tStatEntry.Timestamp = mEndTimeStamp;
 
-    int64_t tTime = Time::GetTimeStamp();
+    int64_t tTime = Time::GetMonotonicTimeStamp();
     // lock
     mStatisticsMutex.lock();
     
@@ -136,18 +138,18 @@ void PacketStatistic::AnnouncePacket(int pSize)
     mStatisticsMutex.unlock();
 
     #ifdef STATISTIC_DEBUG_TIMING
-        int64_t tTime2 = Time::GetTimeStamp();
+        int64_t tTime2 = Time::GetMonotonicTimeStamp();
         LOG(LOG_VERBOSE, "PacketStatistic::Lock1 took %"PRId64" us", tTime2 - tTime);
     #endif
 
     DataRateHistoryDescriptor tHistEntry;
     tHistEntry.TimeStamp = mEndTimeStamp - mStartTimeStamp;
-    tHistEntry.Time = mEndTimeStamp;
+    tHistEntry.Time = Time::GetTimeStamp(); // absolute time for the export of the history
     tHistEntry.DataRate = GetMomentAvgDataRate();
 
-    tTime = Time::GetTimeStamp();
+    tTime = Time::GetMonotonicTimeStamp();
     mDataRateHistoryMutex.lock();
-    int64_t tTime3 = Time::GetTimeStamp();
+    int64_t tTime3 = Time::GetMonotonicTimeStamp();
 
     if (mDataRateHistory.size() > STATISTIC_MOMENT_DATARATE_HISTORY)
     {
@@ -161,13 +163,19 @@ void PacketStatistic::AnnouncePacket(int pSize)
 
     mDataRateHistoryMutex.unlock();
     #ifdef STATISTIC_DEBUG_TIMING
-        tTime2 = Time::GetTimeStamp();
+        tTime2 = Time::GetMonotonicTimeStamp();
         LOG(LOG_VERBOSE, "PacketStatistic::Lock2 took %"PRId64" us", tTime2 - tTime);
-        tTime2 = Time::GetTimeStamp();
+        tTime2 = Time::GetMonotonicTimeStamp();
         LOG(LOG_VERBOSE, "PacketStatistic::Lock2-mutex took %"PRId64" us", tTime3 - tTime);
     #endif
 }
 
+void PacketStatistic::AnnounceCopiedBytes(int pSize)
+{
+    if (pSize > 0)
+        __sync_fetch_and_add(&mCopiedByteCount, (int64_t)pSize);
+}
+
 void PacketStatistic::ResetPacketStatistic()
 {
     // lock
@@ -180,9 +188,26 @@ void PacketStatistic::ResetPacketStatistic()
     mMinPacketSize = INT_MAX;
     mMaxPacketSize = 0;
     mLostPacketCount = 0;
+    mCopiedByteCount = 0;
+    mJitterBufferDepth = 0;
+    mLatePacketCount = 0;
+    mReorderedPacketCount = 0;
+    mRecoveredPacketCount = 0;
+    mUnrecoverablePacketCount = 0;
+    mEstimatedBitRate = -1;
+    mRoundTripTime = -1;
+    mJitter = -1;
+    mReportedLoss = -1;
+    mKeyFrameRequestCount = 0;
+    mKeyFrameDelay = -1;
+    mDroppedPacketCount = 0;
+    mPacingDelay = -1;
+    for (int i = 0; i < FRAME_DROP_REASONS; i++)
+        mDroppedFrameCount[i] = 0;
 
     mDataRateHistoryMutex.lock();
     mDataRateHistory.clear();
+    mBitRateEstimateHistory.clear();
     mDataRateHistoryMutex.unlock();
 
     mFirstDataRateHistoryLoss = true;
@@ -198,6 +223,63 @@ void PacketStatistic::SetLostPacketCount(uint64_t pPacketCount)
     mLostPacketCount = pPacketCount;
 }
 
+void PacketStatistic::SetJitterBufferStatistic(int pDepth, uint64_t pLatePacketCount, uint64_t pReorderedPacketCount)
+{
+    mJitterBufferDepth = pDepth;
+    mLatePacketCount = pLatePacketCount;
+    mReorderedPacketCount = pReorderedPacketCount;
+}
+
+void PacketStatistic::SetFecStatistic(uint64_t pRecoveredPacketCount, uint64_t pUnrecoverablePacketCount)
+{
+    mRecoveredPacketCount = pRecoveredPacketCount;
+    mUnrecoverablePacketCount = pUnrecoverablePacketCount;
+}
+
+void PacketStatistic::AnnounceBitRateEstimate(int pBitRate)
+{
+    DataRateHistoryDescriptor tHistEntry;
+    tHistEntry.Time = Time::GetTimeStamp(); // absolute time for the export of the history
+    tHistEntry.TimeStamp = (mStartTimeStamp != 0) ? Time::GetMonotonicTimeStamp() - mStartTimeStamp : 0;
+    tHistEntry.DataRate = pBitRate;
+
+    mEstimatedBitRate = pBitRate;
+
+    mDataRateHistoryMutex.lock();
+    mBitRateEstimateHistory.push_back(tHistEntry);
+    while (mBitRateEstimateHistory.size() > STATISTIC_BIT_RATE_ESTIMATE_HISTORY)
+        mBitRateEstimateHistory.erase(mBitRateEstimateHistory.begin());
+    mDataRateHistoryMutex.unlock();
+}
+
+void PacketStatistic::SetReceptionQuality(int pRoundTripTime, int pJitter, float pLoss)
+{
+    mRoundTripTime = pRoundTripTime;
+    mJitter = pJitter;
+    mReportedLoss = pLoss;
+}
+
+void PacketStatistic::SetKeyFrameStatistic(uint64_t pRequestCount, int pDelay)
+{
+    mKeyFrameRequestCount = pRequestCount;
+    mKeyFrameDelay = pDelay;
+}
+
+void PacketStatistic::AnnounceDroppedPackets(int pCount)
+{
+    mDroppedPacketCount += pCount;
+}
+
+void PacketStatistic::SetPacingStatistic(int pDelay)
+{
+    mPacingDelay = pDelay;
+}
+
+void PacketStatistic::AnnounceDroppedFrame(enum FrameDropReason pReason)
+{
+    mDroppedFrameCount[pReason]++;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 int PacketStatistic::GetAvgPacketSize()
@@ -251,7 +333,7 @@ int PacketStatistic::GetMomentAvgDataRate()
 
     if (mStatistics.size() > 1)
     {
-        int64_t tCurrentTime = Time::GetTimeStamp();
+        int64_t tCurrentTime = Time::GetMonotonicTimeStamp();
         int64_t tMeasurementStartTime = mStatistics.front().Timestamp;
         int64_t tMeasurementStartByteCount = mStatistics.front().ByteCount;
         int tMeasuredValues = STATISTIC_MOMENT_DATARATE_REFERENCE_SIZE - 1;
@@ -296,6 +378,98 @@ uint64_t PacketStatistic::GetLostPacketCount()
     return mLostPacketCount;
 }
 
+int64_t PacketStatistic::GetCopiedByteCount()
+{
+    return __sync_fetch_and_add(&mCopiedByteCount, 0);
+}
+
+int PacketStatistic::GetJitterBufferDepth()
+{
+    return mJitterBufferDepth;
+}
+
+uint64_t PacketStatistic::GetLatePacketCount()
+{
+    return mLatePacketCount;
+}
+
+uint64_t PacketStatistic::GetReorderedPacketCount()
+{
+    return mReorderedPacketCount;
+}
+
+uint64_t PacketStatistic::GetRecoveredPacketCount()
+{
+    return mRecoveredPacketCount;
+}
+
+uint64_t PacketStatistic::GetUnrecoverablePacketCount()
+{
+    return mUnrecoverablePacketCount;
+}
+
+int PacketStatistic::GetEstimatedBitRate()
+{
+    return mEstimatedBitRate;
+}
+
+int PacketStatistic::GetRoundTripTime()
+{
+    return mRoundTripTime;
+}
+
+int PacketStatistic::GetJitter()
+{
+    return mJitter;
+}
+
+float PacketStatistic::GetReportedLoss()
+{
+    return mReportedLoss;
+}
+
+uint64_t PacketStatistic::GetKeyFrameRequestCount()
+{
+    return mKeyFrameRequestCount;
+}
+
+int PacketStatistic::GetKeyFrameDelay()
+{
+    return mKeyFrameDelay;
+}
+
+uint64_t PacketStatistic::GetDroppedPacketCount()
+{
+    return mDroppedPacketCount;
+}
+
+int PacketStatistic::GetPacingDelay()
+{
+    return mPacingDelay;
+}
+
+uint64_t PacketStatistic::GetDroppedFrameCount(enum FrameDropReason pReason)
+{
+    return mDroppedFrameCount[pReason];
+}
+
+string PacketStatistic::FrameDropReason2String(enum FrameDropReason pReason)
+{
+    switch(pReason)
+    {
+        case FRAME_DROP_NON_REFERENCE:
+            return "non-reference frame";
+        case FRAME_DROP_REFERENCE:
+            return "reference frame";
+        case FRAME_DROP_BROKEN_REFERENCE:
+            return "broken reference";
+        case FRAME_DROP_AUDIO:
+            return "audio frame";
+        default:
+            return "unknown";
+    }
+}
+
 void PacketStatistic::AssignStreamName(std::string pName)
 {
 	mName = pName;
@@ -400,6 +574,22 @@ PacketStatisticDescriptor PacketStatistic::GetPacketStatistic()
 	tStat.PacketCount = GetPacketCount();
 	tStat.ByteCount = GetByteCount();
 	tStat.LostPacketCount = GetLostPacketCount();
+	tStat.CopiedByteCount = GetCopiedByteCount();
+	tStat.JitterBufferDepth = GetJitterBufferDepth();
+	tStat.LatePacketCount = GetLatePacketCount();
+	tStat.ReorderedPacketCount = GetReorderedPacketCount();
+	tStat.RecoveredPacketCount = GetRecoveredPacketCount();
+	tStat.UnrecoverablePacketCount = GetUnrecoverablePacketCount();
+	tStat.EstimatedBitRate = GetEstimatedBitRate();
+	tStat.RoundTripTime = GetRoundTripTime();
+	tStat.Jitter = GetJitter();
+	tStat.ReportedLoss = GetReportedLoss();
+	tStat.KeyFrameRequestCount = GetKeyFrameRequestCount();
+	tStat.KeyFrameDelay = GetKeyFrameDelay();
+	tStat.DroppedPacketCount = GetDroppedPacketCount();
+	tStat.PacingDelay = GetPacingDelay();
+    for (int i = 0; i < FRAME_DROP_REASONS; i++)
+        tStat.DroppedFrameCount[i] = GetDroppedFrameCount((enum FrameDropReason)i);
 	tStat.AvgPacketSize = GetAvgPacketSize();
 	tStat.AvgDataRate = GetAvgDataRate();
     tStat.MomentAvgDataRate = GetMomentAvgDataRate();
@@ -420,6 +610,19 @@ DataRateHistory PacketStatistic::GetDataRateHistory()
     return tResult;
 }
 
+DataRateHistory PacketStatistic::GetBitRateEstimateHistory()
+{
+    DataRateHistory tResult;
+
+    mDataRateHistoryMutex.lock();
+
+    tResult = mBitRateEstimateHistory;
+
+    mDataRateHistoryMutex.unlock();
+
+    return tResult;
+}
+
 void PacketStatistic::SetOutgoingStream()
 {
     mStreamOutgoing = true;
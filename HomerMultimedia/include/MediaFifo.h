@@ -68,6 +68,10 @@ public:
     virtual int ReadFifoExclusive(char **pBuffer, int &pBufferSize, int64_t &pBufferTimestamp); // avoids memory copy, returns a pointer to memory
     virtual void ReadFifoExclusiveFinished(int pEntryPointer);
 
+    virtual int WriteFifoExclusive(char **pBuffer, int &pBufferSize); // avoids memory copy, returns a pointer to a free slot and its capacity
+    virtual void WriteFifoExclusiveFinished(int pEntryPointer, int pBufferSize, int64_t pBufferTimestamp);
+    virtual void WriteFifoExclusiveCanceled(int pEntryPointer); // gives back a slot which wasn't filled, has to be the latest one
+
     virtual int GetEntrySize();
     virtual int GetUsage();
     virtual int GetSize();
@@ -0,0 +1,113 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: lock-free single-producer/single-consumer FIFO for media data
+ * Since:   2026-10-16
+ */
+
+#ifndef _MULTIMEDIA_MEDIA_FIFO_SPSC_
+#define _MULTIMEDIA_MEDIA_FIFO_SPSC_
+
+#include <MediaFifo.h>
+
+#include <string>
+#include <stdint.h>
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of received packets
+//#define MFS_DEBUG
+
+// default max. time a producer waits for free space before the new chunk is dropped
+#define MEDIA_FIFO_SPSC_FULL_TIMEOUT                         250 // ms
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Ring buffer for exactly one writer thread and one reader thread.
+ * Data chunks are transported without any mutex on the fast path: the
+ * producer leases a slot via WriteFifoExclusive() and commits it with
+ * WriteFifoExclusiveFinished(), the consumer borrows a slot via
+ * ReadFifoExclusive() and releases it with ReadFifoExclusiveFinished().
+ * The reader may borrow several entries before it releases them in the
+ * same order. In the same way, the writer may lease several slots before
+ * it commits them in the order of leasing, unused slots are given back via
+ * WriteFifoExclusiveCanceled() starting with the latest one.
+ * The mutex of the base class is only used for sleeping if the ring is
+ * empty (reader) or full (writer).
+ *
+ * Empty chunks are out-of-band wake-up signals and may be written by any
+ * thread, e.g., for stopping a reader. ClearFifo() may be called by any
+ * thread, too, the request is executed by the reader.
+ */
+class MediaFifoSpsc:
+    public MediaFifo
+{
+public:
+    MediaFifoSpsc(int pFifoSize, int pFifoEntrySize, std::string pName = "");
+    virtual ~MediaFifoSpsc();
+
+    virtual void WriteFifo(char* pBuffer, int pBufferSize, int64_t pBufferTimestamp);
+    virtual void ReadFifo(char *pBuffer, int &pBufferSize, int64_t &pBufferTimestamp); // memory copy, returns entire memory
+    virtual void ClearFifo();
+
+    virtual int ReadFifoExclusive(char **pBuffer, int &pBufferSize, int64_t &pBufferTimestamp); // avoids memory copy, returns a pointer to memory
+    virtual void ReadFifoExclusiveFinished(int pEntryPointer);
+
+    virtual int WriteFifoExclusive(char **pBuffer, int &pBufferSize); // avoids memory copy, returns a pointer to a free slot or -1 if the FIFO stays full
+    virtual void WriteFifoExclusiveFinished(int pEntryPointer, int pBufferSize, int64_t pBufferTimestamp);
+    virtual void WriteFifoExclusiveCanceled(int pEntryPointer); // gives back a slot which wasn't filled, has to be the latest one
+
+    virtual int GetUsage();
+
+    void SetFullTimeout(int pTimeout); // in ms, 0 lets WriteFifoExclusive() fail immediately if the FIFO is full
+    bool WaitForInput(int pTimeout); // in ms, only for the reader, returns true if an entry or a wake up signal is available
+
+private:
+    int RingDistance(int pFrom, int pTo);
+    int RingAdvance(int pPosition);
+    int RingRetreat(int pPosition);
+    void ExecuteClearRequest();
+    void WakeUpReader();
+    void WakeUpWriter();
+
+    /* ring positions are running from 0 to 2*size-1 to distinguish "full" from "empty" */
+    volatile int        mSpscWritePos;
+    int                 mSpscLeasePos; // only used by the writer
+    volatile int        mSpscReadPos;
+    volatile int        mSpscBorrowPos;
+    volatile int        mReaderWaiting;
+    volatile int        mWriterWaiting;
+    volatile int        mWakeUpRequests;
+    volatile int        mClearRequested;
+    volatile int        mClearPos;
+    int                 mFullTimeout;
+    Condition           mFifoSpaceCondition;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespace
+
+#endif
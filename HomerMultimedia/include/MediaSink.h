@@ -34,6 +34,8 @@
 
 namespace Homer { namespace Multimedia {
 
+class RTPPacketizer;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 enum MediaSinkType
@@ -43,6 +45,14 @@ enum MediaSinkType
     MEDIA_SINK_AUDIO
 };
 
+// what happens if the queue of a media sink is full, the relaying thread is shared by all media sinks of a media source
+enum MediaSinkQueuePolicy
+{
+    MEDIA_SINK_QUEUE_DROP_NEWEST = 0, // the new packet is dropped, the relaying thread never waits
+    MEDIA_SINK_QUEUE_DROP_QUEUED, // the queued packets are dropped, the reader restarts with the next packet
+    MEDIA_SINK_QUEUE_WAIT // the relaying thread waits for free space for a limited time
+};
+
 class MediaSink:
     public Homer::Monitor::PacketStatistic
 {
@@ -52,10 +62,29 @@ public:
 
     virtual ~MediaSink();
 
-    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, std::string pStreamName = "") = 0;
+    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, const std::string &pStreamName = "") = 0;
     virtual void UpdateSynchronization(int64_t pReferenceNtpTimestamp, int64_t pReferenceFrameTimestamp);
     virtual void SetActivation(bool pState);
 
+    /* congestion control */
+    virtual int GetTargetBitRate(); // bit rate which the path to the receiver can carry in bit/s, -1 if unknown
+
+    /* key frame requests */
+    void RequestKeyFrame(); // may be called by any thread, e.g., if a receiver has lost its synchronization
+    int64_t GetKeyFrameRequestTime(); // time in us of the pending key frame request, 0 if there is none
+    virtual bool IsWaitingForKeyFrame(); // an active sink which drops all packets until the next key frame
+
+    /* queue overflow handling */
+    virtual void SetQueuePolicy(enum MediaSinkQueuePolicy pPolicy);
+    enum MediaSinkQueuePolicy GetQueuePolicy();
+    static std::string QueuePolicy2String(enum MediaSinkQueuePolicy pPolicy);
+
+    /* shared RTP packetization */
+    void SetRtpPacketizer(RTPPacketizer *pPacketizer); // set by the media source around ProcessPacket(), NULL if the sink has to packetize on its own
+
+    /* selective forwarding */
+    virtual void ForwardRtpPacket(char *pPacket, int pPacketSize, enum AVCodecID pCodecId); // a received RTP packet which is forwarded without decoding, ignored by sinks without RTP support
+
     std::string GetId();
 
     /* FPS limitation */
@@ -64,6 +93,7 @@ public:
 
 protected:
     bool BelowMaxFps(int pFrameNumber);
+    void AnnounceKeyFrame(); // a key frame passed the sink, this answers the pending key frame request
 
     bool                mMediaSinkOpened;
     bool                mSinkIsActive;
@@ -75,6 +105,12 @@ protected:
     int                 mMaxFps;
     int                 mMaxFpsFrameNumberLastFragment;
     int64_t             mMaxFpsTimestampLastFragment;
+    RTPPacketizer       *mRtpPacketizer;
+    enum MediaSinkQueuePolicy mQueuePolicy;
+    /* key frame requests */
+    int64_t             mKeyFrameRequestTime;
+    uint64_t            mKeyFrameRequestCount;
+    Mutex               mKeyFrameRequestMutex;
 };
 
 typedef std::vector<MediaSink*>        MediaSinks;
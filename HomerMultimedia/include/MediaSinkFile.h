@@ -31,6 +31,7 @@
 
 #include <MediaSinkNet.h>
 #include <RTP.h>
+#include <HBThread.h>
 
 namespace Homer { namespace Multimedia {
 
@@ -39,10 +40,18 @@ namespace Homer { namespace Multimedia {
 // the following de/activates debugging of received packets
 //#define MSIF_DEBUG_PACKETS
 
+// max. time until written packets are flushed to the file
+#define MEDIA_SINK_FILE_FLUSH_PERIOD                            1000 // ms
+
 ///////////////////////////////////////////////////////////////////////////////
 
+/*
+ * The relaying thread only queues the packets, they are written to the file
+ * by a separate writer thread. Hence, a slow file system doesn't delay the
+ * other media sinks of the media source.
+ */
 class MediaSinkFile:
-    public MediaSinkMem
+    public MediaSinkMem, public Thread
 {
 
 public:
@@ -50,11 +59,16 @@ public:
 
     virtual ~MediaSinkFile();
 
-protected:
-    virtual void WriteFragment(char* pData, unsigned int pSize);
+    virtual void StopProcessing();
 
 private:
+    /* writer thread */
+    virtual void* Run(void* pArgs = NULL);
+    void StartWriter();
+    void StopWriter();
+
     std::string         mSinkFile;
+    bool                mWriterNeeded;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
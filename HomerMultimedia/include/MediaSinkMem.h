@@ -29,9 +29,13 @@
 
 #include <string>
 
-#include <MediaFifo.h>
+#include <MediaFifoSpsc.h>
 #include <MediaSink.h>
 #include <RTP.h>
+#include <RTPPacketHistory.h>
+#include <RTPFecEncoder.h>
+#include <RTPCongestionControl.h>
+#include <RTPForwarder.h>
 
 namespace Homer { namespace Multimedia {
 
@@ -53,7 +57,8 @@ public:
 
     virtual ~MediaSinkMem();
 
-    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, std::string pStreamName = "");
+    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, const std::string &pStreamName = "");
+    virtual bool IsWaitingForKeyFrame();
     virtual void UpdateSynchronization(int64_t pReferenceNtpTimestamp, int64_t pReferenceFrameTimestamp);
 
     virtual int GetFragmentBufferCounter();
@@ -62,13 +67,37 @@ public:
     virtual void ReadFragment(char *pData, int &pDataSize, int64_t &pFragmentNumber);
     virtual void StopProcessing();
 
+    /* queue overflow handling */
+    virtual void SetQueuePolicy(enum MediaSinkQueuePolicy pPolicy);
+
+    /* RTP loss recovery */
+    void SetFecProtection(int pMaxOverhead, bool pAdaptive = true); // overhead in percent, 0 deactivates FEC, adaptive mode follows the loss which is reported by NACKs
+    int GetFecProtection(); // current overhead in percent
+
+    /* congestion control */
+    virtual int GetTargetBitRate();
+
+    /* selective forwarding */
+    virtual void ForwardRtpPacket(char *pPacket, int pPacketSize, enum AVCodecID pCodecId);
+    void SetForwardingLayer(enum RTPForwarderLayer pLayer);
+    enum RTPForwarderLayer GetForwardingLayer();
+
 protected:
     virtual void WriteFragment(char* pData, unsigned int pSize, int64_t pFragmentNumber);
 
+    /* selective forwarding */
+    virtual bool AnnounceForwardedFrame(enum RTPForwarderFrameType pType); // returns false if the frame has to be dropped
+
     /* RTP stream handling */
     virtual bool OpenStreamer(AVStream *pStream, std::string pStreamName);
     virtual bool CloseStreamer();
 
+    /* RTP loss recovery */
+    virtual void RtcpReceivedNack(unsigned short *pSequenceNumbers, int pCount);
+    virtual void RtcpReceivedReport(RtcpReportBlock *pReport, int64_t pArrivalTime);
+    virtual void RtcpReceivedKeyFrameRequest(unsigned int pRequesterIdentifier, int pFirSequenceNumber);
+    void SendRetransmissions();
+
 protected:
     /* timstampes from higher layer */
     int64_t             mLastPacketPts;
@@ -83,10 +112,18 @@ protected:
     enum AVCodecID      mIncomingAVStreamCodecID;
     AVStream*           mIncomingAVStream;
     AVCodecContext*     mIncomingAVStreamCodecContext;
+    RTPPacketHistory    *mPacketHistory; // only for video streams
+    RTPFecEncoder       *mFecEncoder;
+    RTPCongestionControl *mCongestionControl; // only for video streams
+    RTPForwarder        *mForwarder; // created by the first forwarded packet
+    enum RTPForwarderLayer mForwardingLayer;
     /* general stream handling */
     bool                mWaitUntillFirstKeyFrame;
+    unsigned int        mLastFirRequesterIdentifier;
+    int                 mLastFirSequenceNumber;
     /* queue handling */
-    MediaFifo           *mSinkFifo;
+    MediaFifoSpsc       *mSinkFifo;
+    bool                mSinkFifoOverflow;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
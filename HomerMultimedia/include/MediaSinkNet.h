@@ -32,6 +32,7 @@
 #include <HBSocket.h>
 #include <HBThread.h>
 #include <MediaSinkMem.h>
+#include <RTPPacer.h>
 
 #include <string>
 
@@ -48,6 +49,29 @@ namespace Homer { namespace Multimedia {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// default TTL/hop limit of multicast streams, keeps them inside the local network
+#define MSIN_MULTICAST_TTL                      1
+
+///////////////////////////////////////////////////////////////////////////////
+
+// importance of a frame in case of an overload of the send queue
+enum MediaSinkNetFrameType
+{
+    MSIN_FRAME_KEY = 0,
+    MSIN_FRAME_REFERENCE,
+    MSIN_FRAME_NON_REFERENCE,
+    MSIN_FRAME_AUDIO
+};
+
+// leads the packets of a frame within the send queue
+struct MediaSinkNetFrame
+{
+    int64_t                     QueueTime; // in us
+    enum MediaSinkNetFrameType  Type;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 class MediaSinkNet:
     public MediaSinkMem, public Thread
 {
@@ -57,29 +81,48 @@ public:
     MediaSinkNet(string pTarget, Requirements *pTransportRequirements, enum MediaSinkType pType, bool pRtpActivated);
     // constructor to send media data via the same port of an existing already allocated socket object (can be used in conferences to support NAT traversal)
     MediaSinkNet(std::string pTargetHost, unsigned int pTargetPort, Socket* pLocalSocket, enum MediaSinkType pType, bool pRtpActivated);
+    // constructor to send media data to an IPv4/IPv6 multicast group via an own socket, one stream serves any number of receivers in the local network
+    MediaSinkNet(std::string pTargetGroup, unsigned int pTargetPort, enum TransportType pTransportType, enum MediaSinkType pType, bool pRtpActivated, int pTtl = MSIN_MULTICAST_TTL, std::string pInterface = "");
 
     virtual ~MediaSinkNet();
 
-    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, std::string pStreamName = "");
+    virtual void ProcessPacket(AVPacket *pAVPacket, AVStream *pStream = NULL, const std::string &pStreamName = "");
 
     /* network oriented ID */
     static std::string CreateId(std::string pHost, std::string pPort, enum TransportType pSocketTransportType = SOCKET_TRANSPORT_TYPE_INVALID, bool pRtpActivated = true);
 
     virtual void StopProcessing();
 
+    /* pacing of sent packets */
+    void SetPacing(int pRateFactor, int pBurstSize = RTP_PACER_BURST_SIZE, int pMaxDelay = RTP_PACER_MAX_DELAY); // factor of the target bit rate in percent (0 deactivates pacing), burst in bytes, delay in ms
+
 protected:
     virtual void WriteFragment(char* pData, unsigned int pSize, int64_t pFragmentNumber);
 
+    /* selective forwarding */
+    virtual bool AnnounceForwardedFrame(enum RTPForwarderFrameType pType);
+
 private:
     /* sender thread */
     virtual void* Run(void* pArgs = NULL);
     void StartSender();
     void StopSender();
 
+    /* frame based overload handling */
+    enum MediaSinkNetFrameType ClassifyFrame(AVPacket *pAVPacket, AVStream *pStream);
+    static bool IsNonReferenceFrame(enum AVCodecID pCodecId, unsigned char *pData, int pDataSize);
+    bool QueueFrame(enum MediaSinkNetFrameType pType); // returns false if the frame has to be dropped
+    bool DropQueuedFrame(MediaSinkNetFrame *pFrame, int64_t pNow); // sender thread, decides at the head of the queue
+
     /* sending one single fragment of an (rtp) packet stream */
     virtual void SendPacket(char* pData, unsigned int pSize);
+    /* sending several fragments at once, uses batched socket I/O if possible */
+    void SendPackets(SocketDatagram *pDatagrams, int pDatagramCount);
+    /* sending several fragments spread over time by the pacer, the queue times are in us */
+    void SendPacketsPaced(SocketDatagram *pDatagrams, int64_t *pQueueTimes, int pDatagramCount);
 
     void BasicInit(string pTargetHost, unsigned int pTargetPort);
+    void InitDataSocket(enum MediaSinkType pType, bool pConnect);
 
     /* general transport */
     bool                mSenderNeeded;
@@ -87,8 +130,15 @@ private:
     bool                mBrokenPipe;
     bool                mStreamedTransport;
     char                *mStreamFragmentCopyBuffer;
+    RTPPacer            *mPacer;
+    /* frame based overload handling */
+    bool                mQueueReferenceChainBroken; // producer side
+    bool                mSendReferenceChainBroken; // sender side
+    bool                mSendFrameDropped; // the packets of the current frame are dropped
     /* Berkeley sockets based transport */
     Socket              *mDataSocket;
+    bool                mDataSocketOwned; // multicast streams use an own socket
+    bool                mPeerBound;
     /* NAPI based transport */
     IConnection         *mNAPIDataSocket;
     bool                mNAPIUsed;
@@ -34,6 +34,7 @@
 #include <MediaSink.h>
 #include <MediaFilter.h>
 #include <HBMutex.h>
+#include <HBCondition.h>
 
 #include <vector>
 #include <string>
@@ -67,6 +68,10 @@ namespace Homer { namespace Multimedia {
 #define MEDIA_SOURCE_SAMPLES_MULTI_BUFFER_SIZE                    (4 * MEDIA_SOURCE_SAMPLES_BUFFER_SIZE)
 #define MEDIA_SOURCE_SAMPLE_BUFFER_PER_CHANNEL                    8192
 
+// relaying
+#define MEDIA_SOURCE_RELAY_STREAM_NAME_REFRESH                    1000 // ms, the media sinks need the device name only for their stream description
+#define MEDIA_SOURCE_RELAY_RELEASE_WARN_PERIOD                    1000 // ms, unregistering waits until all relaying threads have released the removed media sinks
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /* video */
@@ -162,6 +167,13 @@ struct MetaDataEntry
 
 typedef std::vector<MetaDataEntry> MetaData;
 
+// immutable copy of the registered media sinks, the relaying threads use it without the registration mutex
+struct MediaSinksSnapshot
+{
+    MediaSinks          Sinks;
+    int                 References; // the media source holds one reference to its current snapshot
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // possible GrabChunk results
@@ -172,8 +184,8 @@ typedef std::vector<MetaDataEntry> MetaData;
 
 // event handling
 #define MarkOpenGrabDeviceSuccessful()                      EventOpenGrabDeviceSuccessful(GetObjectNameStr(this).c_str(), __LINE__)
-#define MarkGrabChunkSuccessful(ChunkNumber)                EventGrabChunkSuccessful(GetObjectNameStr(this).c_str(), __LINE__, ChunkNumber)
-#define MarkGrabChunkFailed(Reason)                         EventGrabChunkFailed(GetObjectNameStr(this).c_str(), __LINE__, Reason)
+#define MarkGrabChunkSuccessful(ChunkNumber)                EventGrabChunkSuccessful(GetObjectNameCached(this), __LINE__, ChunkNumber)
+#define MarkGrabChunkFailed(Reason)                         EventGrabChunkFailed(GetObjectNameCached(this), __LINE__, Reason)
 
 // ffmpeg helpers
 #define DescribeInput(CodecId, Format)                      FfmpegDescribeInput(GetObjectNameStr(this).c_str(), __LINE__, CodecId, Format)
@@ -312,6 +324,8 @@ public:
     // register/unregister: Berkeley sockets based media sinks
         MediaSinkNet* RegisterMediaSink(std::string pTargetHost, unsigned int pTargetPort, Socket* pSocket, bool pRtpActivation, int pMaxFps = 0 /* max. fps */);
         bool UnregisterMediaSink(std::string pTargetHost, unsigned int pTargetPort, bool pAutoDelete = true);
+    // register: multicast based media sinks with an own socket, unregistering is done via the group and the port
+        MediaSinkNet* RegisterMediaSink(std::string pTargetGroup, unsigned int pTargetPort, enum TransportType pTransportType, bool pRtpActivation, int pMaxFps = 0 /* max. fps */, int pTtl = MSIN_MULTICAST_TTL, std::string pInterface = "");
     // register/unregister: GAPI based network sinks
         MediaSinkNet* RegisterMediaSink(string pTarget, Requirements *pTransportRequirements, bool pRtpActivation, int pMaxFps = 0 /* max. fps */);
         bool UnregisterMediaSink(std::string pTarget, Requirements *pTransportRequirements, bool pAutoDelete = true);
@@ -412,6 +426,10 @@ protected:
     /* internal interface for packet relaying */
     virtual void RelayAVPacketToMediaSinks(AVPacket *pAVPacket);
     virtual void RelaySyncTimestampToMediaSinks(int64_t pReferenceNtpTimestamp, int64_t pReferenceFrameTimestamp);
+    MediaSinksSnapshot* AcquireMediaSinks(); // never waits for a registration, the result has to be given back via ReleaseMediaSinks()
+    void ReleaseMediaSinks(MediaSinksSnapshot *pSnapshot);
+    void PublishMediaSinks(bool pWaitForRelaying = false); // has to be called with locked mMediaSinksMutex after mMediaSinks was changed
+    std::string GetRelayStreamName(); // cached device name for the relaying threads
 
     /* internal interface for stream recordring */
     void RecordFrame(AVFrame *pSourceFrame);
@@ -431,8 +449,8 @@ protected:
 
     /* event handling */
     void EventOpenGrabDeviceSuccessful(std::string pSource, int pLine);
-    void EventGrabChunkSuccessful(std::string pSource, int pLine, int pChunkNumber);
-    void EventGrabChunkFailed(std::string pSource, int pLine, std::string pReason);
+    void EventGrabChunkSuccessful(const std::string &pSource, int pLine, int pChunkNumber);
+    void EventGrabChunkFailed(const std::string &pSource, int pLine, const std::string &pReason);
 
     /* FFMPEG helpers */
     bool FfmpegDescribeInput(string pSource/* caller source */, int pLine /* caller line */, AVCodecID pCodecId, AVInputFormat **pFormat);
@@ -523,8 +541,13 @@ protected:
     float               mMarkerRelY;
     bool                mMarkerActivated;
     /* relaying */
-    MediaSinks          mMediaSinks;
-    Mutex               mMediaSinksMutex;
+    MediaSinks          mMediaSinks; // changes are published to the relaying threads via PublishMediaSinks()
+    Mutex               mMediaSinksMutex; // serializes the changes of mMediaSinks
+    MediaSinksSnapshot  *mMediaSinksSnapshot;
+    Mutex               mMediaSinksSnapshotMutex; // protects only the snapshot pointer, the reference counters and the cached relay stream name
+    Condition           mMediaSinksSnapshotReleased;
+    std::string         mRelayStreamName;
+    int64_t             mRelayStreamNameTimestamp;
     /* filtering */
     MediaFilters        mMediaFilters;
     Mutex               mMediaFiltersMutex;
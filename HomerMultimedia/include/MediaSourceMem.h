@@ -31,6 +31,8 @@
 #include <MediaFifo.h>
 #include <MediaSource.h>
 #include <RTP.h>
+#include <RTPJitterBuffer.h>
+#include <RTPFecDecoder.h>
 #include <VideoScaler.h>
 
 #include <HBThread.h>
@@ -95,6 +97,14 @@ public:
     virtual int GetChunkDropCounter();
     virtual int GetFragmentBufferCounter();
     virtual int GetFragmentBufferSize();
+    /* RTP reordering */
+    void SetJitterBufferActivation(bool pActive);
+    void SetJitterBufferWindow(int pMinWindow, int pMaxWindow); // in ms
+    /* RTP loss recovery */
+    void SetRetransmissionRequestActivation(bool pActive); // NACKs for missing video packets, needs an active jitter buffer
+    /* selective forwarding */
+    virtual void SetSelectiveForwarding(bool pActive); // the received RTP packets are forwarded to the registered media sinks without decoding, the decoder runs only if the stream is grabbed locally
+    bool IsSelectiveForwarding();
 
     virtual int CalculateFrameBufferSize(); // calculates a good value for frame queue
     virtual int GetFrameBufferCounter(); // returns the currently used number of entries in the frame queue
@@ -148,6 +158,11 @@ public:
 
     // send input to the media source
     void WriteFragment(char *pBuffer, int pBufferSize, int64_t pFragmentNumber);
+    /* zero-copy input: lease fragment buffers, fill them and commit them in the order of leasing, unused buffers are canceled starting with the latest one */
+    int LeaseFragmentBuffer(char **pBuffer, int &pBufferSize); // returns the leased entry or -1 if no buffer is available
+    void CommitFragmentBuffer(int pEntry, int pBufferSize, int64_t pFragmentNumber);
+    void CancelFragmentBuffer(int pEntry);
+    void SetFragmentBufferBlocking(bool pBlocking); // false lets LeaseFragmentBuffer() fail immediately if the FIFO is full
 
 protected:
     /* internal video resolution switch */
@@ -155,6 +170,18 @@ protected:
 
     static int GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBufferSize);
     virtual void ReadFragment(char *pBuffer, int &pBufferSize, int64_t &pFragmentNumber);
+    int ReadFragmentExclusive(char **pBuffer, int &pBufferSize, int64_t &pFragmentNumber); // avoids memory copy, the returned entry has to be released via ReadFragmentExclusiveFinished()
+    void ReadFragmentExclusiveFinished(int pEntry);
+    int ReadFragmentFromJitterBuffer(char **pBuffer, int &pBufferSize, int64_t &pFragmentNumber); // reorders RTP packets and recovers lost ones, returns a FIFO entry, a jitter buffer entry or a recovered packet
+    void UpdateJitterBufferStatistic();
+    void UpdateFecStatistic();
+    void RequestRetransmissions(); // sends a NACK for the missing packets in front of the jitter buffer
+    void SendReceiverReport(); // sends an RTCP receiver report to the remote sender if the report period has elapsed
+    void CheckKeyFrameNeed(); // requests a key frame from the remote sender at start and after unrecoverable packet loss
+    bool RequestKeyFrame(bool pFullIntraRequest); // sends an RTCP FIR or PLI to the remote sender, returns false if the request was suppressed
+    virtual bool SendFeedback(char *pData, int pDataSize); // sends RTCP feedback to the remote sender, returns false if no back channel exists
+    void ForwardFragment(char *pBuffer, int pBufferSize); // called by the writer of the fragment FIFO
+    bool DecoderNeedsFragments(); // the stream is grabbed locally
 
     bool IsAcceptableStartFrame(AVFrame *pFrame);
     virtual bool InputIsPicture();
@@ -189,7 +216,6 @@ protected:
 
     unsigned long       mFragmentNumber;
     char                *mStreamPacketBuffer;
-    char                *mFragmentBuffer;
     int                 mResXLastGrabbedFrame, mResYLastGrabbedFrame;
     bool                mRtpActivated;
     bool                mOpenInputStream;
@@ -213,6 +239,18 @@ protected:
     Mutex               mDecoderSeekMutex;
     MediaFifo           *mDecoderFragmentFifo;
     Mutex               mDecoderFragmentFifoDestructionMutex;
+    RTPJitterBuffer     *mJitterBuffer; // only used by the reader of the fragment FIFO
+    bool                mJitterBufferActive;
+    bool                mRetransmissionRequestsActive;
+    RTPFecDecoder       *mFecDecoder; // only used by the reader of the fragment FIFO
+    int64_t             mReceiverReportLastTime; // only used by the reader of the fragment FIFO
+    int64_t             mKeyFrameRequestLastTime; // used by the reader of the fragment FIFO, in forwarding mode also by its writer
+    Mutex               mKeyFrameRequestMutex; // serializes RequestKeyFrame()
+    bool                mKeyFrameRequestSent; // was the initial FIR sent or did a key frame arrive before? set by the reader of the fragment FIFO and in forwarding mode also by its writer
+    unsigned int        mKeyFrameRequestLostPackets; // lost packets at the time of the last PLI
+    int64_t             mKeyFrameJoinTime; // when the first fragment was read, only used by the reader of the fragment FIFO
+    bool                mSelectiveForwarding;
+    unsigned int        mForwardedSourceIdentifier; // remote sender of the forwarded packets, only used by the writer of the fragment FIFO
     MediaFifo           *mDecoderFifo; // for frames
     int                 mDecoderExpectedMaxOutputPerInputFrame; // how many output frames can be calculated of one input frame?
     /* decoder thread seeking */
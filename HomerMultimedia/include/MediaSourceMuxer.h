@@ -34,9 +34,11 @@
 #include <MediaSource.h>
 #include <MediaFifo.h>
 #include <RTP.h>
+#include <RTPPacketizer.h>
 
 #include <vector>
 #include <string>
+#include <map>
 
 using namespace Homer::Base;
 
@@ -57,6 +59,22 @@ namespace Homer { namespace Multimedia {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// an encoded video packet since the last key frame, its data is stored in the GOP cache buffer
+struct GopCacheEntry
+{
+    int         Offset; // within the GOP cache buffer
+    int         Size;
+    int64_t     Pts;
+    int64_t     Dts;
+    int         Duration;
+    int         Flags;
+};
+
+typedef std::vector<GopCacheEntry>          GopCacheEntries;
+typedef std::map<MediaSink*, int>           GopCachePositions; // next cache entry for each media sink which is primed
+
+///////////////////////////////////////////////////////////////////////////////
+
 class MediaSourceMuxer:
     public MediaSource, public Thread
 {
@@ -109,6 +127,8 @@ public:
     static bool IsOutputCodecSupported(std::string pStreamCodec);
     bool SetOutputStreamPreferences(std::string pStreamCodec, int pMediaStreamQuality, int pBitRate, int pMaxPacketSize = 1300 /* works only with RTP packetizing */, bool pDoReset = false, int pResX = 352, int pResY = 288, int pMaxFps = 0);
     enum AVCodecID GetStreamCodecId() { return mStreamCodecId; } // used in RTSPListenerMediaSession
+    void SetCongestionControlActivation(bool pState); // the video encoder follows the bit rate which is estimated by the media sinks, other encoders than libx264 only reduce the frame rate
+    void SetGopCacheActivation(bool pState); // newly activated media sinks start with the cached packets since the last key frame
 
     /* frame stats */
     virtual bool SupportsDecoderFrameStatistics();
@@ -216,6 +236,17 @@ private:
     bool BelowMaxFps(int pFrameNumber);
     int64_t CalculateEncoderPts(int pFrameNumber);
 
+    /* congestion control */
+    void AdaptToCongestion();
+
+    /* key frame requests */
+    bool KeyFrameRequested(); // returns true if the next video frame has to be encoded as key frame
+
+    /* GOP cache */
+    virtual void RelayAVPacketToMediaSinks(AVPacket *pAVPacket);
+    void StoreInGopCache(AVPacket *pAVPacket);
+    void ResetGopCache();
+
     /* transcoder */
     virtual void* Run(void* pArgs = NULL); // transcoder main loop
     void StartEncoder();
@@ -234,6 +265,19 @@ private:
     int                 mStreamBitRate;
     int 				mStreamMaxFps;
     int64_t				mStreamMaxFps_LastFrame_Timestamp;
+    int                 mStreamAdaptiveFps; // reduced frame rate during congestion, 0 if inactive
+    bool                mCongestionControlActivated;
+    int64_t             mCongestionControlLastUpdate;
+    int64_t             mKeyFrameForcedLastTime;
+    /* GOP cache, only used by the encoder thread */
+    bool                mGopCacheActivated;
+    bool                mGopCacheValid; // does the cache start with a key frame and contain all packets since then?
+    char                *mGopCacheBuffer;
+    int                 mGopCacheBufferUsage; // in bytes
+    GopCacheEntries     mGopCacheEntries;
+    GopCachePositions   mGopCachePositions;
+    /* shared RTP packetizer */
+    RTPPacketizer       *mRtpPacketizer; // used by the encoder thread only
     bool                mStreamActivated;
     char                *mStreamPacketBuffer;
     /* relaying: skip audio silence */
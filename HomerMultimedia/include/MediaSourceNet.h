@@ -63,6 +63,8 @@ public:
     /// The constructor
     MediaSourceNet(Socket *pDataSocket);
     MediaSourceNet(unsigned int pPortNumber, enum TransportType pTransportType);
+    // joins an IPv4/IPv6 multicast group, an empty interface name selects the default interface of the system
+    MediaSourceNet(std::string pMulticastGroup, unsigned int pPortNumber, enum TransportType pTransportType, std::string pInterface = "");
     MediaSourceNet(std::string pLocalName, Requirements *pTransportRequirements);
 
     /// The destructor
@@ -77,7 +79,13 @@ public:
     virtual bool OpenAudioGrabDevice(int pSampleRate = 44100, int pChannels = 2);
     virtual bool CloseGrabDevice();
 
+    /* selective forwarding */
+    virtual void SetSelectiveForwarding(bool pActive);
+
 protected:
+    /* RTCP feedback via the receiving socket */
+    virtual bool SendFeedback(char *pData, int pDataSize);
+
     /* network socket listener thread */
     friend class NetworkListener;
 
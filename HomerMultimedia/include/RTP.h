@@ -30,7 +30,10 @@
 #include <Header_Ffmpeg.h>
 #include <PacketStatistic.h>
 
+#include <HBMutex.h>
+
 #include <sys/types.h>
+#include <map>
 #include <string>
 
 namespace Homer { namespace Multimedia {
@@ -62,9 +65,42 @@ enum RtcpType{
     RTCP_RECEIVER_REPORT = 201,
     RTCP_SOURCE_DESCRIPTION = 202,
     RTCP_BYE = 203,
-    RTCP_APP = 204
+    RTCP_APP = 204,
+    RTCP_TRANSPORT_FEEDBACK = 205, // RFC 4585
+    RTCP_PAYLOAD_FEEDBACK = 206 // RFC 4585
 };
 
+// feedback message types of transport layer feedback
+#define RTCP_FEEDBACK_FMT_NACK                1 // generic NACK
+
+// feedback message types of payload specific feedback
+#define RTCP_FEEDBACK_FMT_PLI                 1 // picture loss indication
+#define RTCP_FEEDBACK_FMT_FIR                 4 // full intra request, RFC 5104
+
+// size of a PLI packet: header, SSRC of packet sender and SSRC of media source
+#define RTCP_PLI_SIZE                         12
+
+// size of a FIR packet with one FCI entry: header, SSRC of packet sender, unused SSRC of media source, SSRC of media sender and sequence number
+#define RTCP_FIR_SIZE                         20
+
+// max. number of FCI entries (PID + BLP) within one generic NACK, each entry covers up to 17 sequence numbers
+#define RTCP_NACK_ENTRIES_MAX                 16
+
+// max. size of a generic NACK packet: header, SSRC of packet sender, SSRC of media source and one 32 bit entry per FCI entry
+#define RTCP_NACK_SIZE_MAX                    (12 + 4 * RTCP_NACK_ENTRIES_MAX)
+
+// size of a receiver report with one report block: header, SSRC of packet sender and 24 bytes report block
+#define RTCP_RECEIVER_REPORT_SIZE             32
+
+// how many sent sender reports are remembered for the RTT calculation based on receiver reports?
+#define RTCP_SENDER_REPORT_HISTORY            8
+
+// payload type of XOR based FEC packets (RFC 5109), they are sent within the media stream but use their own sequence numbers
+#define RTP_PAYLOAD_TYPE_FEC                  125
+
+// size of the FEC header and the ULP level 0 header with a 16 bit mask (RFC 5109, section 7.3 and 7.4)
+#define RTP_FEC_HEADER_SIZE                   14
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // ########################## RTCP ###########################################
@@ -112,9 +148,38 @@ union RtcpHeader{
         unsigned int Packets;               /* packet count */
         unsigned int Octets;                /* byte count */
     }Feedback;
+    struct{ // send within media stream as intermediate packets, RFC 4585
+        unsigned int Length:16;             /* length of report */
+        unsigned int Type:8;                /* Payload type (PT) */
+        unsigned int Fmt:5;                 /* Feedback message type (FMT) */
+        unsigned int Padding:1;             /* padding flag */
+        unsigned int Version:2;             /* protocol version */
+        unsigned int Ssrc;                  /* synchronization source of packet sender */
+        unsigned int MediaSsrc;             /* synchronization source of media source */
+        unsigned int Fci[4];                /* feedback control information, for generic NACK: 16 bit packet ID + 16 bit bitmask of following lost packets */
+    }TransportFeedback;
     uint32_t Data[7];
 };
 
+// report block of a receiver report, RFC 3550, chapter 6.4.2
+struct RtcpReportBlock{
+    unsigned int Ssrc;                      /* synchronization source of media source */
+    unsigned int FractionLost;              /* lost packets since last report, fixed point number with binary point at the left edge */
+    int CumulativeLost;                     /* lost packets since start of reception */
+    unsigned int HighestSequenceNumber;     /* extended highest received sequence number */
+    unsigned int Jitter;                    /* interarrival jitter in timestamp units */
+    unsigned int Lsr;                       /* middle 32 bits of the NTP timestamp of the last sender report */
+    unsigned int Dlsr;                      /* delay since last sender report in units of 1/65536 seconds */
+};
+
+// sent sender report, used to calculate the RTT from receiver reports
+struct RtcpSentSenderReport{
+    uint32_t Ntp;                           /* middle 32 bits of the NTP timestamp */
+    int64_t  Time;                          /* local time when the report was sent in us */
+};
+
+typedef std::map<unsigned int, class RTP*> RtcpFeedbackReceivers;
+
 // calculate the size of an RTCP header: "size of structure"
 #define RTCP_HEADER_SIZE                      sizeof(RtcpHeader)
 
@@ -173,6 +238,7 @@ public:
     /* RTP packetizing/parsing */
     void SetExternallyNegotiatedPayloadID(unsigned int pNewID); //should be called before the first frame packet gets packetized
     bool RtpCreate(AVPacket *pAVPacket, char *&pResultingOutputData, unsigned int &pResultingOutputDataSize);
+    bool RtpAdopt(char *pSharedData, unsigned int pSharedDataSize, uint64_t pSharedTimestampOffset, char *&pResultingOutputData, unsigned int &pResultingOutputDataSize); // takes over the RTP packets of a shared packetizer and rewrites the sender specific header fields
 
     unsigned int GetLostPacketsFromRTP();
     static void LogRtpHeader(RtpHeader *pRtpHeader);
@@ -191,6 +257,13 @@ public:
     static void LogRtcpHeader(RtcpHeader *pRtcpHeader, uint64_t pTimestampOffset = 0);
     bool RtcpParseSenderDescription(char *&pData, int &pDataSize);
     bool RtcpParseSenderReport(char *&pData, int &pDataSize, unsigned int &pPackets, unsigned int &pOctets);
+    static bool RtcpParseTransportFeedback(char *&pData, int &pDataSize); // delivers the feedback to the local sender which is addressed by it
+    int RtcpCreateNack(char *pData, unsigned int pMediaSourceIdentifier, unsigned short *pSequenceNumbers, int pCount); // sequence numbers have to be sorted, the buffer needs RTCP_NACK_SIZE_MAX bytes, returns the packet size
+    static bool RtcpParseReceiverReport(char *&pData, int &pDataSize); // delivers the report blocks to the local senders which are addressed by them
+    int RtcpCreateReceiverReport(char *pData); // the buffer needs RTCP_RECEIVER_REPORT_SIZE bytes, returns the packet size or 0 if nothing was received yet
+    static bool RtcpParsePayloadFeedback(char *&pData, int &pDataSize); // delivers key frame requests to the local senders which are addressed by them
+    int RtcpCreatePli(char *pData, unsigned int pMediaSourceIdentifier); // the buffer needs RTCP_PLI_SIZE bytes, returns the packet size
+    int RtcpCreateFir(char *pData, unsigned int pMediaSourceIdentifier); // the buffer needs RTCP_FIR_SIZE bytes, returns the packet size, each call creates a new request
 
 protected:
     uint64_t GetCurrentPtsFromRTP(); // returns the timestamp of the last received RTP packet
@@ -198,16 +271,33 @@ protected:
     void SetSynchronizationReferenceForRTP(uint64_t pReferenceNtpTime, uint64_t pReferencePts);
     unsigned int GetSourceIdentifierFromRTP(); // returns the RTP source identifier
     bool HasSourceChangedFromRTP(); // return if RTP source identifier has changed and resets the flag
+    uint64_t GetLocalTimestampOffset(); // offset between the sent RTP timestamps and the clock rate adapted codec timestamps
+    unsigned int CreateLocalSourceIdentifier(); // for streams which aren't created by the RTP encoder, e.g., forwarded ones
 
     /* for clock rate adaption, e.g., 8, 16, 90 kHz */
     float CalculateClockRateFactor();
 
+    /* RTCP feedback for the local sender, RFC 4585 */
+    void RtcpRegisterFeedbackReceiver(); // uses the current local source identifier
+    void RtcpUnregisterFeedbackReceiver();
+    virtual void RtcpReceivedNack(unsigned short *pSequenceNumbers, int pCount); // called by the thread which has received the feedback
+    virtual void RtcpReceivedReport(RtcpReportBlock *pReport, int64_t pArrivalTime); // called by the thread which has received the feedback
+    virtual void RtcpReceivedKeyFrameRequest(unsigned int pRequesterIdentifier, int pFirSequenceNumber); // called by the thread which has received the feedback, the sequence number is -1 for a PLI
+    int RtcpCalculateRtt(RtcpReportBlock *pReport, int64_t pArrivalTime); // in ms, -1 if the referenced sender report is unknown
+    int RtcpCalculateJitter(RtcpReportBlock *pReport); // in ms
+
+    /* RTCP reception statistic for receiver reports, RFC 3550, appendix A.3 and A.8 */
+    void RtcpAnnounceArrival(char *pPacket, int pPacketSize, int64_t pArrivalTime); // the packet is still in network byte order, has to be called in arrival order
+    int RtcpGetReceptionJitter(); // in ms
+    float RtcpGetReceptionLoss(); // in percent, measured within the period of the last receiver report
+
     void Init();
 
 private:
     void AnnounceLostPackets(uint64_t pCount);
 
     void RtcpPatchLiveSenderReport(char *pHeader, uint32_t pTimestamp);
+    void RtcpStoreSentSenderReport(uint32_t pNtpHigh, uint32_t pNtpLow);
 
     /* internal RTP packetizer for h.261 */
     bool OpenRtpEncoderH261(std::string pTargetHost, unsigned int pTargetPort, AVStream *pInnerStream);
@@ -274,13 +364,40 @@ private:
     uint64_t            mH261SentNtpTimeBase;
     int                 mH261SenderReports;
     bool                mH261FirstPacket;
+    /* adopted RTP packets of a shared packetizer */
+    bool                mRtpAdoptionStarted;
+    unsigned short int  mRtpAdoptionSequenceNumber;
+    uint32_t            mRtpAdoptionLastTimestamp;
+    uint32_t            mRtpAdoptionPackets;
+    uint32_t            mRtpAdoptionOctets;
     /* RTCP */
     Mutex               mSynchDataMutex;
+    unsigned int        mRtcpFeedbackReceiverIdentifier; // 0 if not registered
+    static RtcpFeedbackReceivers sRtcpFeedbackReceivers;
+    static Mutex        sRtcpFeedbackReceiversMutex;
     uint64_t            mRtcpLastRemoteNtpTime; // (NTP timestamp)
     uint64_t            mRtcpLastRemoteTimestamp; // PTS value (without clock rata adaption!)
     unsigned int        mRtcpLastRemotePackets; // sent packets, reported via RTCP
     unsigned int        mRtcpLastRemoteOctets; // sent bytes, reported via RTCP
     uint64_t            mRtcpLastReceivedPackets;
+    RtcpSentSenderReport mRtcpSentSenderReports[RTCP_SENDER_REPORT_HISTORY];
+    int                 mRtcpSentSenderReportIndex;
+    Mutex               mRtcpSentSenderReportsMutex;
+    unsigned int        mRtcpFirSequenceNumber; // of the last sent FIR
+    /* RTCP reception statistic */
+    bool                mRtcpReceptionStarted;
+    unsigned int        mRtcpReceptionSourceIdentifier;
+    unsigned short int  mRtcpReceptionMaxSequenceNumber;
+    uint32_t            mRtcpReceptionSequenceNumberCycles; // shifted count of sequence number wraparounds
+    uint32_t            mRtcpReceptionBaseSequenceNumber;
+    uint32_t            mRtcpReceptionPackets;
+    uint32_t            mRtcpReceptionExpectedPrior;
+    uint32_t            mRtcpReceptionPacketsPrior;
+    uint32_t            mRtcpReceptionLastTransit; // in timestamp units
+    uint32_t            mRtcpReceptionJitter; // in timestamp units, scaled by 16
+    unsigned int        mRtcpReceptionFractionLost;
+    uint32_t            mRtcpLastSenderReportNtp; // middle 32 bits of the NTP timestamp
+    int64_t             mRtcpLastSenderReportArrival; // in us
     /* packet statistic */
     int64_t             mRTCPPacketCounter;
     int64_t             mRTPPacketCounter;
@@ -0,0 +1,153 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: sender side congestion control for RTP streams
+ * Since:   2026-10-16
+ */
+
+#ifndef _MULTIMEDIA_RTP_CONGESTION_CONTROL_
+#define _MULTIMEDIA_RTP_CONGESTION_CONTROL_
+
+#include <HBMutex.h>
+
+#include <stdint.h>
+
+using namespace Homer::Base;
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of the congestion control
+//#define RTP_CONGESTION_CONTROL_DEBUG
+
+// default borders of the target bit rate
+#define RTP_CONGESTION_CONTROL_MIN_BIT_RATE                 (64 * 1000) // bit/s
+#define RTP_CONGESTION_CONTROL_MAX_BIT_RATE                 (20 * 1000 * 1000) // bit/s
+
+// how often is the target bit rate updated?
+#define RTP_CONGESTION_CONTROL_PERIOD                       500 // ms
+
+// loss borders: below the low one the rate may increase, above the high one it is decreased
+#define RTP_CONGESTION_CONTROL_LOSS_LOW                     2 // percent
+#define RTP_CONGESTION_CONTROL_LOSS_HIGH                    10 // percent
+
+// multiplicative increase and decrease
+#define RTP_CONGESTION_CONTROL_INCREASE                     8 // percent per second
+#define RTP_CONGESTION_CONTROL_DECREASE                     85 // percent of the actually sent rate
+#define RTP_CONGESTION_CONTROL_MAX_PROBING                  150 // percent of the actually sent rate, the rate isn't increased beyond it
+
+// delay gradient: number of delay samples and the growth within them which indicates an overuse
+#define RTP_CONGESTION_CONTROL_DELAY_SAMPLES                16
+#define RTP_CONGESTION_CONTROL_DELAY_THRESHOLD              30 // ms
+#define RTP_CONGESTION_CONTROL_DELAY_MAX_AGE                2000 // ms, older samples don't describe the current state
+
+// usage of the local send queue which indicates an overuse of the uplink
+#define RTP_CONGESTION_CONTROL_QUEUE_THRESHOLD              50 // percent
+
+///////////////////////////////////////////////////////////////////////////////
+
+enum CongestionSignal
+{
+    CONGESTION_UNDERUSE = -1,   // queues are draining
+    CONGESTION_NORMAL,
+    CONGESTION_OVERUSE          // queues are growing
+};
+
+struct CongestionDelaySample
+{
+    int64_t     Time; // in us
+    int64_t     Delay; // in us
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Estimates the bit rate which a receiver's path can carry. Two controllers
+ * work in parallel and the lower rate wins: the loss based one decreases the
+ * rate proportionally to the reported loss, the delay based one detects
+ * growing queues from the gradient of the delay samples (e.g., the RTT) and
+ * from the usage of the local send queue. In the latter case the rate drops
+ * below the actually sent rate to let the queues drain.
+ * Without any congestion the rate increases slowly, but not far beyond the
+ * actually sent rate, hence an encoder which needs less data can't make the
+ * estimate drift away.
+ * AnnounceSentPacket(), AnnounceQueueUsage() and Update() have to be called
+ * by the sending thread, the feedback may be announced by any thread.
+ */
+class RTPCongestionControl
+{
+public:
+    RTPCongestionControl();
+    virtual ~RTPCongestionControl();
+
+    void SetBitRateLimits(int pMinBitRate, int pMaxBitRate); // in bit/s
+    void Reset(int pStartBitRate); // in bit/s
+
+    /* sending thread */
+    void AnnounceSentPacket(int pSize);
+    void AnnounceQueueUsage(int pUsage, int pSize); // entries of the send queue
+    bool Update(int64_t pNow); // returns true if the target bit rate was changed
+
+    /* feedback */
+    void AnnounceLostPackets(int pCount);
+    void AnnounceReportedLoss(int pLoss); // in percent, e.g., from RTCP receiver reports
+    void AnnounceDelay(int64_t pDelay, int64_t pNow); // an RTT sample in us, e.g., from RTCP receiver reports
+
+    /* state */
+    int GetTargetBitRate(); // in bit/s
+    int GetSentBitRate(); // in bit/s
+    int GetLoss(); // smoothed, in percent
+    int GetDelayGradient(); // delay growth in ms within the sample window
+    enum CongestionSignal GetSignal();
+
+private:
+    enum CongestionSignal DetectOveruse(int64_t pNow);
+
+    Mutex               mMutex;
+    int                 mMinBitRate;
+    int                 mMaxBitRate;
+    int                 mTargetBitRate;
+    int64_t             mLastUpdate;
+    /* measurement of the current period */
+    int64_t             mSentBytes;
+    int                 mSentPackets;
+    int                 mLostPackets;
+    int                 mReportedLoss; // max. reported loss in percent, -1 if nothing was reported
+    int                 mMaxQueueUsage; // in percent
+    /* delay samples, ring buffer */
+    CongestionDelaySample mDelaySamples[RTP_CONGESTION_CONTROL_DELAY_SAMPLES];
+    int                 mDelaySampleCount;
+    int                 mDelaySampleHead;
+    /* state */
+    int                 mSentBitRate;
+    int                 mLoss;
+    int                 mDelayGradient; // in ms
+    enum CongestionSignal mSignal;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
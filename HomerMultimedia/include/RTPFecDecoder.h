@@ -0,0 +1,102 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: recovery of lost RTP packets by XOR based forward error correction
+ * Since:   2026-10-16
+ */
+
+#ifndef _MULTIMEDIA_RTP_FEC_DECODER_
+#define _MULTIMEDIA_RTP_FEC_DECODER_
+
+#include <stdint.h>
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of the FEC recovery
+//#define RTP_FEC_DECODER_DEBUG
+
+// max. number of received packets which are stored for a recovery, has to be a divisor of 65536
+#define RTP_FEC_DECODER_CAPACITY                            64
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct FecDecoderSlot
+{
+    char            *Data;
+    int             Size;
+    unsigned short  SequenceNumber;
+    bool            Used;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Recovers a lost RTP packet from the FEC packet (RFC 5109) of its group and
+ * the other received packets of this group. The received packets have to be
+ * stored before the RTP parser modifies them. This is done only after the
+ * first FEC packet was seen, hence senders without FEC cause no copy effort.
+ * A group with more than one lost packet can't be recovered, its lost packets
+ * are counted as unrecoverable.
+ * All functions have to be called from the same thread, the statistic
+ * getters may be called from any thread.
+ */
+class RTPFecDecoder
+{
+public:
+    RTPFecDecoder(int pPacketSize, int pCapacity = RTP_FEC_DECODER_CAPACITY);
+    virtual ~RTPFecDecoder();
+
+    void Reset();
+
+    /* input */
+    static bool IsFecPacket(char *pPacket, int pPacketSize);
+    void StorePacket(char *pPacket, int pPacketSize);
+
+    /* output */
+    bool RecoverPacket(char *pFecPacket, int pFecPacketSize, char **pPacket, int &pPacketSize); // returns true if a lost packet was recovered, it is valid until the next call
+    void AnnounceLateRecovery(); // the recovered packet was already skipped by the receiver
+
+    /* state */
+    bool IsActive();
+    uint64_t GetRecoveredPackets();
+    uint64_t GetUnrecoverablePackets();
+
+private:
+    FecDecoderSlot      *mSlots;
+    char                *mSlotMemory;
+    char                *mRecoveredPacket;
+    int                 mCapacity;
+    int                 mPacketSize;
+    bool                mActive;
+    /* statistic */
+    uint64_t            mRecoveredPackets;
+    uint64_t            mUnrecoverablePackets;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
@@ -0,0 +1,119 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: XOR based forward error correction for sent RTP packets
+ * Since:   2026-10-16
+ */
+
+#ifndef _MULTIMEDIA_RTP_FEC_ENCODER_
+#define _MULTIMEDIA_RTP_FEC_ENCODER_
+
+#include <HBMutex.h>
+
+#include <stdint.h>
+
+using namespace Homer::Base;
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of the FEC generation
+//#define RTP_FEC_ENCODER_DEBUG
+
+// max. number of media packets which are protected by one FEC packet, limited by the 16 bit mask of the ULP level header
+#define RTP_FEC_GROUP_SIZE_MAX                              16
+
+// number of sent media packets after which the protection level is adapted to the reported loss
+#define RTP_FEC_ADAPTION_PERIOD                             256
+
+// the protection overhead (in percent) is set to this multiple of the reported loss (in percent)
+#define RTP_FEC_LOSS_FACTOR                                 3
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Generates one FEC packet (RFC 5109) for each group of consecutive media
+ * packets. The FEC payload is the XOR of the protected packets, hence a
+ * receiver can reconstruct exactly one lost packet per group. The group size
+ * is given by the allowed overhead, e.g., 20 percent result in groups of five
+ * packets. A group is closed early at the end of a frame if it is already
+ * half filled, which limits the recovery delay.
+ * In adaptive mode the overhead follows the loss which is reported by the
+ * receiver via NACKs and the configured value is only the maximum. As long as
+ * no loss was reported at all, the receiver possibly doesn't send feedback
+ * and the configured protection is used.
+ * AddPacket() has to be called by the sending thread, AnnounceLoss() may be
+ * called by any thread.
+ */
+class RTPFecEncoder
+{
+public:
+    RTPFecEncoder(int pPacketSize);
+    virtual ~RTPFecEncoder();
+
+    void SetProtection(int pMaxOverhead, bool pAdaptive); // overhead in percent, 0 deactivates FEC
+    void Reset();
+
+    /* sending thread */
+    bool AddPacket(char *pPacket, int pPacketSize, char **pFecPacket, int &pFecPacketSize); // returns true if a FEC packet has to be sent, it is valid until the next call
+
+    /* feedback */
+    void AnnounceLoss(int pLostPackets);
+
+    /* state */
+    bool IsActive();
+    int GetProtection(); // current overhead in percent
+    int GetLoss(); // smoothed loss in percent
+    uint64_t GetFecPackets();
+
+private:
+    void StartGroup(unsigned short pSequenceNumber);
+    void AdaptGroupSize();
+
+    char                *mFecPacket;
+    int                 mPacketSize;
+    Mutex               mMutex;
+    /* configuration */
+    int                 mMaxOverhead;
+    bool                mAdaptive;
+    int                 mGroupSize;
+    /* current group */
+    int                 mGroupPackets;
+    unsigned short      mGroupBase;
+    int                 mGroupProtectionLength;
+    unsigned short      mFecSequenceNumber;
+    /* loss estimation */
+    int                 mLostPackets;
+    int                 mSentPackets;
+    int                 mLoss; // smoothed, in percent
+    bool                mLossReported;
+    /* statistic */
+    uint64_t            mFecPackets;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
@@ -0,0 +1,155 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: selective forwarding of received RTP packets to one receiver
+ * Since:   2026-10-16
+ */
+
+#ifndef _MULTIMEDIA_RTP_FORWARDER_
+#define _MULTIMEDIA_RTP_FORWARDER_
+
+#include <Header_Ffmpeg.h>
+
+#include <stdint.h>
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of forwarded packets
+//#define RTP_FORWARDER_DEBUG
+
+// timestamp gap (in RTP clock ticks) between the last forwarded packet of a source and the first one of its successor, one frame period at 25 fps for the 90 kHz video clock
+#define RTP_FORWARDER_SOURCE_SWITCH_GAP                     3600
+
+// frames which arrive earlier than this percentage of the frame period of the max. FPS are thinned out
+#define RTP_FORWARDER_FPS_TOLERANCE                         90
+
+///////////////////////////////////////////////////////////////////////////////
+
+// frames which are forwarded to a receiver
+enum RTPForwarderLayer
+{
+    RTP_FORWARDER_LAYER_BASE = 0, // key and reference frames only, no other frame depends on the dropped ones
+    RTP_FORWARDER_LAYER_ALL // all frames, non-reference frames are dropped only to reach the max. FPS of the receiver
+};
+
+// importance of a forwarded frame
+enum RTPForwarderFrameType
+{
+    RTP_FORWARDER_FRAME_KEY = 0,
+    RTP_FORWARDER_FRAME_REFERENCE,
+    RTP_FORWARDER_FRAME_NON_REFERENCE,
+    RTP_FORWARDER_FRAME_AUDIO
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Rewrites the received RTP packets of a remote sender for one receiver
+ * without decoding them. The forwarded stream uses an own source identifier,
+ * a continuous sequence number space without the gaps of dropped packets and
+ * a continuous timestamp space if the remote sender changes its source.
+ * Gaps of packets which were lost before they reached us remain visible for
+ * the receiver. Sender reports within the stream are adapted, other RTCP
+ * packets and FEC packets of the remote sender are dropped because they
+ * refer to the original sequence numbers.
+ * For H.264, MPEG-4 and MPEG-1/2 video the frame types are taken from the
+ * payload. Frames which are thinned out, either by the selected layer or by
+ * the max. FPS of the receiver, lose only their non-reference data, hence the
+ * receiver is able to decode the remaining frames. For these codecs the
+ * forwarder starts with the next key frame. Other codecs are forwarded
+ * completely.
+ * All functions except SetLayer() have to be called by the forwarding thread.
+ */
+class RTPForwarder
+{
+public:
+    RTPForwarder(int pPacketSize, bool pVideo);
+    virtual ~RTPForwarder();
+
+    void SetSourceIdentifier(unsigned int pSourceIdentifier); // source identifier of the forwarded stream
+    void SetLayer(enum RTPForwarderLayer pLayer);
+    enum RTPForwarderLayer GetLayer();
+    void Reset(); // the next packet is forwarded like the first one of a new source
+
+    /* forwarding thread */
+    bool Forward(char *pPacket, int pPacketSize, enum AVCodecID pCodecId, int pMaxFps, int64_t pArrivalTime, char **pResult, int &pResultSize); // returns true if the packet has to be sent, the result is valid until the next call
+    void DropFrame(); // the receiver can't take the frame of the last forwarded packet, its remaining packets are dropped, too
+    bool IsFrameStart(); // the last forwarded packet is the first one of its frame
+    bool IsKeyFrame(); // the last forwarded packet starts the data of a key frame
+    enum RTPForwarderFrameType GetFrameType(); // type of the frame of the last forwarded packet
+    bool IsWaitingForKeyFrame();
+    static bool IsKeyFramePacket(char *pPacket, int pPacketSize, enum AVCodecID pCodecId); // the RTP packet starts the data of a key frame, can be called by any thread
+
+    /* statistic */
+    uint64_t GetForwardedPackets();
+    uint64_t GetSkippedPackets();
+    uint64_t GetSkippedFrames();
+
+private:
+    static bool SupportsFrameTypes(enum AVCodecID pCodecId);
+    static int GetPayloadOffset(unsigned char *pPacket, int pPacketSize); // behind the CSRC list and the header extension
+    static bool InspectPayload(enum AVCodecID pCodecId, unsigned char *pPayload, int pPayloadSize, enum RTPForwarderFrameType &pType, bool &pDroppable); // returns false if the type of the frame isn't given by this packet
+    bool ForwardSenderReport(char *pPacket, int pPacketSize, char **pResult, int &pResultSize);
+    void SkipPacket(bool pInSequence);
+
+    char                *mPacket;
+    int                 mPacketSize;
+    bool                mVideo;
+    /* configuration */
+    unsigned int        mSourceIdentifier;
+    enum RTPForwarderLayer mLayer;
+    /* rewriting */
+    bool                mInputSourceKnown;
+    unsigned int        mInputSourceIdentifier;
+    unsigned short      mSequenceNumberOffset;
+    unsigned short      mNextSequenceNumber;
+    uint32_t            mTimestampOffset;
+    uint32_t            mLastTimestamp; // last forwarded one
+    /* current frame */
+    bool                mFrameKnown;
+    uint32_t            mFrameTimestamp; // input timestamp
+    enum RTPForwarderFrameType mFrameType;
+    bool                mFrameThinned;
+    bool                mFrameDropped;
+    bool                mFrameForwarded; // at least one packet of the frame was forwarded
+    int64_t             mFrameLastForwardTime; // arrival time of the last completely forwarded frame
+    bool                mWaitingForKeyFrame;
+    /* last forwarded packet */
+    bool                mPacketFrameStart;
+    bool                mPacketKeyFrame;
+    bool                mPacketInSequence;
+    int                 mPacketPayloadSize;
+    /* statistic */
+    uint64_t            mForwardedPackets;
+    uint64_t            mForwardedOctets; // payload only, for sender reports
+    uint64_t            mSkippedPackets;
+    uint64_t            mSkippedFrames;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
@@ -0,0 +1,139 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: jitter buffer for reordering RTP packets by their sequence number
+ * Since:   2026-10-16
+ */
+
+#ifndef _MULTIMEDIA_RTP_JITTER_BUFFER_
+#define _MULTIMEDIA_RTP_JITTER_BUFFER_
+
+#include <stdint.h>
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of the reordering
+//#define RTP_JITTER_BUFFER_DEBUG
+
+// max. number of packets which can be stored while missing packets are awaited
+#define RTP_JITTER_BUFFER_CAPACITY                          64
+
+// borders of the adaptive reordering window
+#define RTP_JITTER_BUFFER_MIN_WINDOW                        5 // ms
+#define RTP_JITTER_BUFFER_MAX_WINDOW                        150 // ms
+
+// packets which are further behind are interpreted as restart of the remote stream, see RFC 3550, appendix A.1
+#define RTP_JITTER_BUFFER_MAX_MISORDER                      100
+
+///////////////////////////////////////////////////////////////////////////////
+
+enum JitterBufferVerdict
+{
+    JITTER_BUFFER_DELIVER = 0,      // packet is in order (or isn't an RTP packet) and has to be processed immediately
+    JITTER_BUFFER_STORED,           // packet was copied to the jitter buffer
+    JITTER_BUFFER_DROPPED           // packet arrived after it was declared as lost or it is a duplicate
+};
+
+struct JitterBufferSlot
+{
+    char        *Data;
+    int         Size;
+    int64_t     Number; // fragment number from the input FIFO
+    int64_t     SequenceNumber; // extended sequence number
+    int64_t     ArrivalTime; // in us
+    bool        Used;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Reorders received RTP packets before they are depacketized. Packets which
+ * arrive in order are never copied, they are processed directly from the
+ * input FIFO. If a gap is detected, the following packets are copied to the
+ * jitter buffer until the missing packets arrive or the reordering window
+ * expires. Only in the latter case the missing packets are skipped, which
+ * lets the RTP parser count them as lost.
+ * The window adapts to the observed reordering delay between its borders:
+ * packets which fill a gap stretch it, late packets double it and expired
+ * gaps shrink it slowly.
+ * All functions have to be called from the same thread, the statistic
+ * getters may be called from any thread.
+ */
+class RTPJitterBuffer
+{
+public:
+    RTPJitterBuffer(int pPacketSize, int pCapacity = RTP_JITTER_BUFFER_CAPACITY);
+    virtual ~RTPJitterBuffer();
+
+    void SetWindow(int pMinWindow, int pMaxWindow); // in ms
+    void Reset();
+
+    /* input */
+    enum JitterBufferVerdict Insert(char *pPacket, int pPacketSize, int64_t pNumber, int64_t pArrivalTime);
+
+    /* output */
+    bool GetNextPacket(char **pPacket, int &pPacketSize, int64_t &pNumber, int64_t pNow); // returns a stored packet if it is in order or its gap has expired, the packet has to be released via ReleasePacket()
+    void ReleasePacket();
+    void SkipGap(); // declares the packets in front of the stored ones as lost immediately
+    int64_t GetDeadline(); // time in us when the current gap expires
+    int GetMissingPackets(unsigned short *pSequenceNumbers, int pMaxCount); // returns the sorted sequence numbers of missing packets which weren't reported before, e.g., for NACKs
+
+    /* state */
+    bool IsFull();
+    int GetDepth();
+    int GetWindow(); // in ms
+    uint64_t GetLatePackets();
+    uint64_t GetReorderedPackets();
+
+private:
+    int64_t ExtendSequenceNumber(unsigned int pSequenceNumber);
+    int FindHead(); // slot with the lowest sequence number
+    int64_t GetOldestArrivalTime();
+    void LimitWindow();
+
+    JitterBufferSlot    *mSlots;
+    char                *mSlotMemory;
+    int                 mCapacity;
+    int                 mPacketSize;
+    int                 mDepth;
+    int                 mBorrowedSlot;
+    bool                mSynchronized;
+    int64_t             mExpectedSequenceNumber;
+    int64_t             mRequestedSequenceNumber; // last one which was checked by GetMissingPackets()
+    /* adaptive window, in us */
+    int64_t             mWindow;
+    int64_t             mMinWindow;
+    int64_t             mMaxWindow;
+    int64_t             mReorderDelay; // smoothed
+    /* statistic */
+    uint64_t            mLatePackets;
+    uint64_t            mReorderedPackets;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
@@ -0,0 +1,118 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+
+/*
+ * Purpose: token bucket based pacing of sent RTP packets
+ * Since:   2026-10-16
+ */
+
+#ifndef _MULTIMEDIA_RTP_PACER_
+#define _MULTIMEDIA_RTP_PACER_
+
+#include <stdint.h>
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of the pacer
+//#define RTP_PACER_DEBUG
+
+// default pacing rate as multiple of the target bit rate
+#define RTP_PACER_RATE_FACTOR                               250 // percent
+// lower border of the pacing rate, e.g., if no target bit rate is known
+#define RTP_PACER_MIN_BIT_RATE                              (256 * 1000) // bit/s
+// default amount of data which may be sent at once
+#define RTP_PACER_BURST_SIZE                                (4 * 1500) // bytes
+// default upper border of the delay which the pacer adds to a packet
+#define RTP_PACER_MAX_DELAY                                 5 // ms
+
+// how often are the input rate and the queue delay measured?
+#define RTP_PACER_PERIOD                                    500 // ms
+
+// shorter waits aren't worth a context switch, the packet is sent early instead
+#define RTP_PACER_MIN_WAIT                                  100 // us
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Spreads the packets of a frame over time instead of sending them as one
+ * burst which overflows the queues of the first bottleneck. A token bucket is
+ * filled with a multiple of the target bit rate of the congestion control or
+ * of the measured input rate if this is higher. A packet is sent immediately
+ * as long as the bucket isn't empty, the bucket may only hold the configured
+ * burst size.
+ * The pacer never delays a packet more than the configured max. delay after
+ * it was queued, hence a sender which can't keep up with the input rate
+ * doesn't accumulate latency.
+ * SetPacing() may be called by any thread, all other functions have to be
+ * called by the sending thread.
+ */
+class RTPPacer
+{
+public:
+    RTPPacer();
+    virtual ~RTPPacer();
+
+    void SetPacing(int pRateFactor, int pBurstSize = RTP_PACER_BURST_SIZE, int pMaxDelay = RTP_PACER_MAX_DELAY); // factor in percent (0 deactivates pacing), burst in bytes, delay in ms
+    void Reset();
+    bool IsActive();
+
+    /* sending thread */
+    void SetTargetBitRate(int pBitRate); // in bit/s, -1 if unknown
+    int64_t GetSendDelay(int64_t pQueueTime, int64_t pNow); // time in us until the packet may be sent, queue time is the time when the packet was queued
+    void AnnounceSentPacket(int pSize, int64_t pQueueTime, int64_t pNow);
+    static void Wait(int64_t pDelay); // high resolution wait, in us
+
+    /* state */
+    int GetPacingRate(); // in bit/s
+    int GetQueueDelay(); // avg. time in us from queuing until sending during the last period, -1 if unknown
+
+private:
+    void UpdatePacingRate();
+    void Refill(int64_t pNow);
+
+    /* configuration */
+    int                 mRateFactor; // in percent
+    int                 mBurstSize; // in bytes
+    int                 mMaxDelay; // in us
+    /* token bucket */
+    int                 mTargetBitRate;
+    int                 mInputBitRate;
+    int                 mPacingRate; // in bit/s
+    int64_t             mTokens; // in bytes * 10^6, may become negative by the debt of already sent packets
+    int64_t             mLastRefill;
+    /* measurement of the current period */
+    int64_t             mPeriodStart;
+    int64_t             mPeriodBytes;
+    int64_t             mPeriodQueueDelay;
+    int                 mPeriodPackets;
+    /* state */
+    int                 mQueueDelay; // in us
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
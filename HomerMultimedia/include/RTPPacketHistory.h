@@ -0,0 +1,128 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: history of sent RTP packets for retransmissions
+ * Since:   2026-10-16
+ */
+
+#ifndef _MULTIMEDIA_RTP_PACKET_HISTORY_
+#define _MULTIMEDIA_RTP_PACKET_HISTORY_
+
+#include <HBMutex.h>
+
+#include <stdint.h>
+
+using namespace Homer::Base;
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of retransmissions
+//#define RTP_PACKET_HISTORY_DEBUG
+
+// max. number of sent packets which are stored for retransmissions, has to be a divisor of 65536
+#define RTP_PACKET_HISTORY_CAPACITY                         256
+
+// packets which are older are not retransmitted because the receiver has already skipped them
+#define RTP_PACKET_HISTORY_MAX_AGE                          500 // ms
+
+// how often can the same packet be retransmitted?
+#define RTP_PACKET_HISTORY_MAX_RETRANSMISSIONS              2
+
+// max. share of retransmitted data compared to the sent data, avoids overload of an already congested link
+#define RTP_PACKET_HISTORY_MAX_RETRANSMISSION_SHARE         25 // percent
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct PacketHistorySlot
+{
+    char            *Data;
+    int             Size;
+    unsigned short  SequenceNumber;
+    int64_t         SendTime; // in us
+    int64_t         RetransmissionTime; // in us
+    int             Retransmissions;
+    bool            Pending; // queued for retransmission
+    bool            Used;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Stores the recently sent RTP packets of one sender and retransmits them if
+ * a receiver requests this via a generic NACK. The slot of a packet is given
+ * by its sequence number, hence a request is answered without searching.
+ * The round trip time is estimated by the age of a packet when it is
+ * requested for the first time. It limits the retransmissions: a packet isn't
+ * sent again as long as its last retransmission may still be on its way.
+ * Store() and GetNextRetransmission() have to be called by the sending
+ * thread, Request() and Discard() may be called by any thread.
+ */
+class RTPPacketHistory
+{
+public:
+    RTPPacketHistory(int pPacketSize, int pCapacity = RTP_PACKET_HISTORY_CAPACITY);
+    virtual ~RTPPacketHistory();
+
+    void SetMaxAge(int pMaxAge); // in ms
+    void Reset();
+
+    /* sending thread */
+    void Store(char *pPacket, int pPacketSize, int64_t pSendTime);
+    bool GetNextRetransmission(char **pPacket, int &pPacketSize, int64_t pNow); // the packet is valid until the next call to Store()
+
+    /* feedback */
+    int Request(unsigned short *pSequenceNumbers, int pCount, int64_t pNow); // returns the number of packets which were queued for retransmission
+    void Discard(char *pPacket, int pPacketSize); // the packet was dropped on purpose and mustn't be retransmitted
+
+    /* state */
+    int GetRtt(); // in ms
+    uint64_t GetRetransmittedPackets();
+    uint64_t GetRejectedRequests();
+
+private:
+    PacketHistorySlot   *mSlots;
+    char                *mSlotMemory;
+    int                 mCapacity;
+    int                 mPacketSize;
+    int64_t             mMaxAge; // in us
+    Mutex               mMutex;
+    /* retransmission queue */
+    unsigned short      *mPendingSequenceNumbers;
+    int                 mPendingHead;
+    int                 mPendingCount;
+    /* round trip time estimation, in us */
+    int64_t             mRtt;
+    /* statistic */
+    uint64_t            mSentBytes;
+    uint64_t            mRetransmittedBytes;
+    uint64_t            mRetransmittedPackets;
+    uint64_t            mRejectedRequests;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
@@ -0,0 +1,89 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: shared RTP packetizer for all media sinks of a media source
+ * Since:   2026-10-16
+ */
+
+#ifndef _MULTIMEDIA_RTP_PACKETIZER_
+#define _MULTIMEDIA_RTP_PACKETIZER_
+
+#include <Header_Ffmpeg.h>
+#include <RTP.h>
+
+#include <string>
+
+namespace Homer { namespace Multimedia {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of the shared packetizer
+//#define RTP_PACKETIZER_DEBUG
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Creates the RTP packets of an A/V packet once for all media sinks which
+ * receive it. The packets are created on the first request after
+ * AnnounceNextPacket(), further requests get the same packets. Each media
+ * sink adopts them via RTP::RtpAdopt() and rewrites only its own header
+ * fields, hence the packetization effort doesn't depend on the number of
+ * receivers.
+ * The packetizer is reopened if the A/V stream changes. All functions have to
+ * be called by the thread which relays the packets to the media sinks.
+ */
+class RTPPacketizer:
+    public RTP
+{
+public:
+    RTPPacketizer();
+    virtual ~RTPPacketizer();
+
+    void Reset(); // closes the packetizer, the next request reopens it
+    void AnnounceNextPacket(); // the next request refers to a new A/V packet
+
+    bool GetRtpPackets(AVPacket *pAVPacket, AVStream *pStream, const std::string &pStreamName, char *&pData, unsigned int &pDataSize, uint64_t &pTimestampOffset); // returns false if the packet can't be packetized
+
+    /* statistic */
+    uint64_t GetPacketizedPackets();
+    uint64_t GetAdoptions();
+
+private:
+    AVStream            *mStream;
+    AVCodecContext      *mStreamCodecContext;
+    enum AVCodecID      mStreamCodecId;
+    /* RTP packets of the current A/V packet */
+    bool                mPacketized;
+    bool                mPacketizingFailed;
+    char                *mData;
+    unsigned int        mDataSize;
+    /* statistic */
+    uint64_t            mPacketizedPackets;
+    uint64_t            mAdoptions;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
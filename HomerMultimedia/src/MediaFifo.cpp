@@ -40,6 +40,7 @@ using namespace std;
 MediaFifo::MediaFifo(std::string pName)
 {
     mName = pName;
+    mFifoMutex.AssignName("MediaFifoMutex");
     mFifoSize = 0;
     mFifoEntrySize = 0;
     mFifoWritePtr = 0;
@@ -54,6 +55,7 @@ MediaFifo::MediaFifo(int pFifoSize, int pFifoEntrySize, string pName)
     LOG(LOG_VERBOSE, "Creating FIFO for %s with %d entries of %d bytes", pName.c_str(), pFifoSize, pFifoEntrySize);
 
     mName = pName;
+    mFifoMutex.AssignName("MediaFifoMutex");
     mFifoSize = pFifoSize;
     mFifoEntrySize = pFifoEntrySize;
     mFifoWritePtr = 0;
@@ -278,6 +280,81 @@ void MediaFifo::ReadFifoExclusiveFinished(int pEntryPointer)
     mFifo[pEntryPointer].EntryMutex.unlock();
 }
 
+int MediaFifo::WriteFifoExclusive(char **pBuffer, int &pBufferSize)
+{
+    int tCurrentFifoWritePtr;
+
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: WriteFifoExclusive() START", mName.c_str());
+    #endif
+
+    mFifoMutex.lock();
+
+    if (mFifoAvailableEntries >= mFifoSize)
+    {
+        LOG(LOG_WARN, "%s-FIFO: buffer full (size is %d, read: %d, write %d) - dropping oldest (%d) data chunk", mName.c_str(), mFifoSize, mFifoReadPtr, mFifoWritePtr, mFifoReadPtr);
+
+        // update FIFO read pointer
+        mFifoReadPtr++;
+        if (mFifoReadPtr >= mFifoSize)
+            mFifoReadPtr = mFifoReadPtr - mFifoSize;
+    }else
+    {
+        // update FIFO counter
+        mFifoAvailableEntries++;
+    }
+
+    tCurrentFifoWritePtr = mFifoWritePtr;
+
+    // update FIFO write pointer
+    mFifoWritePtr++;
+    if (mFifoWritePtr >= mFifoSize)
+        mFifoWritePtr = mFifoWritePtr - mFifoSize;
+
+    // a reader which gets this entry will block on the fine grained mutex until the caller has finished writing
+    mFifo[tCurrentFifoWritePtr].EntryMutex.lock();
+    mFifoMutex.unlock();
+
+    // don't copy, give pointer to the slot memory instead
+    *pBuffer = mFifo[tCurrentFifoWritePtr].Data;
+    pBufferSize = mFifoEntrySize;
+
+    // NO unlock of fine grained mutex again -> has to be triggered by caller via separated function: WriteFifoExclusiveFinished()
+
+    return tCurrentFifoWritePtr;
+}
+
+void MediaFifo::WriteFifoExclusiveFinished(int pEntryPointer, int pBufferSize, int64_t pBufferTimestamp)
+{
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: finishing exclusive write access to %d with %d bytes", mName.c_str(), pEntryPointer, pBufferSize);
+    #endif
+
+    if (pBufferSize > mFifoEntrySize)
+    {
+        LOG(LOG_ERROR, "%s-FIFO: entries are limited to %d bytes, committed %d bytes, limiting size", mName.c_str(), mFifoEntrySize, pBufferSize);
+        pBufferSize = mFifoEntrySize;
+    }
+
+    mFifo[pEntryPointer].Size = pBufferSize;
+    mFifo[pEntryPointer].Number = pBufferTimestamp;
+    mFifo[pEntryPointer].EntryMutex.unlock();
+
+    mFifoMutex.lock();
+    mFifoDataInputCondition.Signal();
+    mFifoMutex.unlock();
+}
+
+void MediaFifo::WriteFifoExclusiveCanceled(int pEntryPointer)
+{
+    #ifdef MF_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: canceling exclusive write access to %d", mName.c_str(), pEntryPointer);
+    #endif
+
+    // a reader might already wait for this entry, hence we can't take it back and hand it over as empty chunk
+    WriteFifoExclusiveFinished(pEntryPointer, 0, 0);
+}
+
 void MediaFifo::WriteFifo(char* pBuffer, int pBufferSize, int64_t pBufferTimestamp)
 {
     int tCurrentFifoWritePtr;
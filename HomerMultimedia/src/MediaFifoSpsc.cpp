@@ -0,0 +1,437 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of a lock-free single-producer/single-consumer FIFO
+ * Since:   2026-10-16
+ */
+
+#include <MediaFifoSpsc.h>
+#include <Logger.h>
+
+#include <string.h> // memcpy
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+MediaFifoSpsc::MediaFifoSpsc(int pFifoSize, int pFifoEntrySize, string pName):
+    MediaFifo(pFifoSize, pFifoEntrySize, pName)
+{
+    mSpscWritePos = 0;
+    mSpscLeasePos = 0;
+    mSpscReadPos = 0;
+    mSpscBorrowPos = 0;
+    mReaderWaiting = 0;
+    mWriterWaiting = 0;
+    mWakeUpRequests = 0;
+    mClearRequested = 0;
+    mClearPos = 0;
+    mFullTimeout = MEDIA_FIFO_SPSC_FULL_TIMEOUT;
+    LOG(LOG_VERBOSE, "Created SPSC FIFO for %s with %d entries of %d bytes", pName.c_str(), mFifoSize, mFifoEntrySize);
+}
+
+MediaFifoSpsc::~MediaFifoSpsc()
+{
+    LOG(LOG_VERBOSE, "Destroying SPSC FIFO %s with size of %d", mName.c_str(), mFifoSize);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int MediaFifoSpsc::RingDistance(int pFrom, int pTo)
+{
+    int tResult = pTo - pFrom;
+    if (tResult < 0)
+        tResult += 2 * mFifoSize;
+
+    return tResult;
+}
+
+int MediaFifoSpsc::RingAdvance(int pPosition)
+{
+    int tResult = pPosition + 1;
+    if (tResult >= 2 * mFifoSize)
+        tResult = 0;
+
+    return tResult;
+}
+
+int MediaFifoSpsc::RingRetreat(int pPosition)
+{
+    int tResult = pPosition - 1;
+    if (tResult < 0)
+        tResult = 2 * mFifoSize - 1;
+
+    return tResult;
+}
+
+void MediaFifoSpsc::WakeUpReader()
+{
+    mFifoMutex.lock();
+    mFifoDataInputCondition.Signal();
+    mFifoMutex.unlock();
+}
+
+void MediaFifoSpsc::WakeUpWriter()
+{
+    mFifoMutex.lock();
+    mFifoSpaceCondition.Signal();
+    mFifoMutex.unlock();
+}
+
+// context: reader thread
+void MediaFifoSpsc::ExecuteClearRequest()
+{
+    // entries are still borrowed by the reader, postpone the request
+    if (mSpscBorrowPos != mSpscReadPos)
+        return;
+
+    if (__sync_lock_test_and_set(&mClearRequested, 0) == 0)
+        return;
+
+    __sync_synchronize();
+    int tClearPos = mClearPos;
+    int tReadPos = mSpscReadPos;
+
+    // ignore the request if we have already read beyond the requested position
+    if (RingDistance(tReadPos, tClearPos) <= RingDistance(tReadPos, mSpscWritePos))
+    {
+        #ifdef MFS_DEBUG
+            LOG(LOG_VERBOSE, "%s-FIFO: clearing %d entries", mName.c_str(), RingDistance(tReadPos, tClearPos));
+        #endif
+
+        __sync_synchronize();
+        mSpscBorrowPos = tClearPos;
+        mSpscReadPos = tClearPos;
+        __sync_synchronize();
+
+        if (mWriterWaiting)
+            WakeUpWriter();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MediaFifoSpsc::ReadFifo(char *pBuffer, int &pBufferSize, int64_t &pBufferTimestamp)
+{
+    char *tEntryBuffer;
+    int tEntrySize;
+    int64_t tEntryTimestamp;
+
+    int tEntry = ReadFifoExclusive(&tEntryBuffer, tEntrySize, tEntryTimestamp);
+
+    if (pBufferSize >= tEntrySize)
+    {// input buffer is okay
+        pBufferTimestamp = tEntryTimestamp;
+        pBufferSize = tEntrySize;
+        if (pBufferSize > 0)
+            memcpy((void*)pBuffer, tEntryBuffer, (size_t)pBufferSize);
+    }else
+    {// input buffer is too small
+        LOG(LOG_ERROR, "Given read buffer is too small (%d bytes) for the current chunk of %d bytes from FIFO %s, dropping data", pBufferSize, tEntrySize, mName.c_str());
+        pBufferSize = 0;
+    }
+
+    ReadFifoExclusiveFinished(tEntry);
+}
+
+void MediaFifoSpsc::ClearFifo()
+{
+    #ifdef MFS_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: going to clear entire buffer", mName.c_str());
+    #endif
+
+    // the reader drops everything which was written up to now
+    mClearPos = mSpscWritePos;
+    __sync_synchronize();
+    mClearRequested = 1;
+    __sync_synchronize();
+
+    // a waiting reader executes the request immediately
+    if (mReaderWaiting)
+        WakeUpReader();
+}
+
+int MediaFifoSpsc::GetUsage()
+{
+    // borrowed entries are already taken by the reader
+    return RingDistance(mSpscBorrowPos, mSpscWritePos);
+}
+
+void MediaFifoSpsc::SetFullTimeout(int pTimeout)
+{
+    mFullTimeout = pTimeout;
+}
+
+bool MediaFifoSpsc::WaitForInput(int pTimeout)
+{
+    if ((mSpscBorrowPos != mSpscWritePos) || (mWakeUpRequests > 0))
+        return true;
+
+    // slow path: FIFO is empty, sleep until the writer signals new data or the timeout expires
+    mFifoMutex.lock();
+    mReaderWaiting = 1;
+    __sync_synchronize();
+    if ((mSpscBorrowPos == mSpscWritePos) && (mWakeUpRequests < 1))
+        mFifoDataInputCondition.Wait(&mFifoMutex, (pTimeout > 0) ? pTimeout : 1);
+    mReaderWaiting = 0;
+    mFifoMutex.unlock();
+
+    return ((mSpscBorrowPos != mSpscWritePos) || (mWakeUpRequests > 0));
+}
+
+int MediaFifoSpsc::ReadFifoExclusive(char **pBuffer, int &pBufferSize, int64_t &pBufferTimestamp)
+{
+    int tReadPos;
+
+    #ifdef MFS_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: ReadFifoExclusive() START", mName.c_str());
+    #endif
+
+    while(true)
+    {
+        ExecuteClearRequest();
+
+        tReadPos = mSpscBorrowPos;
+        if (tReadPos != mSpscWritePos)
+            break;
+
+        // got a wake up signal?
+        if (mWakeUpRequests > 0)
+        {
+            __sync_fetch_and_sub(&mWakeUpRequests, 1);
+
+            #ifdef MFS_DEBUG
+                LOG(LOG_VERBOSE, "%s-FIFO: woke up by empty chunk", mName.c_str());
+            #endif
+
+            *pBuffer = NULL;
+            pBufferSize = 0;
+            pBufferTimestamp = 0;
+            return -1;
+        }
+
+        // slow path: FIFO is empty, sleep until the writer signals new data
+        mFifoMutex.lock();
+        mReaderWaiting = 1;
+        __sync_synchronize();
+        // a clear request is only executed if no entry is borrowed, otherwise waiting for it would end in a busy loop
+        while ((mSpscBorrowPos == mSpscWritePos) && (mWakeUpRequests < 1) && ((!mClearRequested) || (mSpscBorrowPos != mSpscReadPos)))
+        {
+            #ifdef MFS_DEBUG
+                LOG(LOG_VERBOSE, "%s-FIFO: waiting for new input", mName.c_str());
+            #endif
+
+            while(!mFifoDataInputCondition.Wait(&mFifoMutex))
+            {
+                LOG(LOG_ERROR, "%s-FIFO: error when waiting for new input", mName.c_str());
+            }
+        }
+        mReaderWaiting = 0;
+        mFifoMutex.unlock();
+    }
+
+    // make sure we see the entry data which was written before the write position was updated
+    __sync_synchronize();
+
+    int tEntry = (tReadPos >= mFifoSize) ? tReadPos - mFifoSize : tReadPos;
+
+    #ifdef MFS_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: reading exclusively entry %d with %d bytes", mName.c_str(), tEntry, mFifo[tEntry].Size);
+    #endif
+
+    pBufferTimestamp = mFifo[tEntry].Number;
+    pBufferSize = mFifo[tEntry].Size;
+    *pBuffer = mFifo[tEntry].Data;
+
+    mSpscBorrowPos = RingAdvance(tReadPos);
+
+    // NO release of the entry -> has to be triggered by caller via separated function: ReadFifoExclusiveFinished()
+
+    if (pBufferSize == 0)
+        LOG(LOG_VERBOSE, "%s-FIFO: data chunk with size 0 read", mName.c_str());
+
+    return tEntry;
+}
+
+void MediaFifoSpsc::ReadFifoExclusiveFinished(int pEntryPointer)
+{
+    // entry of an empty wake up chunk
+    if (pEntryPointer < 0)
+        return;
+
+    #ifdef MFS_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: finishing exclusive entry access to %d", mName.c_str(), pEntryPointer);
+    #endif
+
+    // we are done with reading the (oldest borrowed) entry before we hand it back to the writer
+    __sync_synchronize();
+    mSpscReadPos = RingAdvance(mSpscReadPos);
+    __sync_synchronize();
+
+    if (mWriterWaiting)
+        WakeUpWriter();
+}
+
+int MediaFifoSpsc::WriteFifoExclusive(char **pBuffer, int &pBufferSize)
+{
+    // slots which are already leased but not yet committed are occupied, too
+    int tWritePos = mSpscLeasePos;
+
+    #ifdef MFS_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: WriteFifoExclusive() START", mName.c_str());
+    #endif
+
+    if (RingDistance(mSpscReadPos, tWritePos) >= mFifoSize)
+    {
+        // the caller handles the overflow on its own
+        if (mFullTimeout <= 0)
+        {
+            *pBuffer = NULL;
+            pBufferSize = 0;
+            return -1;
+        }
+
+        // slow path: FIFO is full, sleep until the reader has released an entry
+        mFifoMutex.lock();
+        mWriterWaiting = 1;
+        __sync_synchronize();
+        if (RingDistance(mSpscReadPos, tWritePos) >= mFifoSize)
+        {
+            #ifdef MFS_DEBUG
+                LOG(LOG_VERBOSE, "%s-FIFO: waiting for free space", mName.c_str());
+            #endif
+            mFifoSpaceCondition.Wait(&mFifoMutex, mFullTimeout);
+        }
+        mWriterWaiting = 0;
+        mFifoMutex.unlock();
+
+        if (RingDistance(mSpscReadPos, tWritePos) >= mFifoSize)
+        {
+            LOG(LOG_WARN, "%s-FIFO: buffer full (size is %d) for more than %d ms, reader seems to be blocked", mName.c_str(), mFifoSize, mFullTimeout);
+            *pBuffer = NULL;
+            pBufferSize = 0;
+            return -1;
+        }
+    }
+
+    int tEntry = (tWritePos >= mFifoSize) ? tWritePos - mFifoSize : tWritePos;
+    mSpscLeasePos = RingAdvance(tWritePos);
+
+    // don't copy, give pointer to the slot memory instead
+    *pBuffer = mFifo[tEntry].Data;
+    pBufferSize = mFifoEntrySize;
+
+    return tEntry;
+}
+
+void MediaFifoSpsc::WriteFifoExclusiveFinished(int pEntryPointer, int pBufferSize, int64_t pBufferTimestamp)
+{
+    if (pEntryPointer < 0)
+        return;
+
+    #ifdef MFS_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: committing entry %d with %d bytes", mName.c_str(), pEntryPointer, pBufferSize);
+    #endif
+
+    if (pBufferSize > mFifoEntrySize)
+    {
+        LOG(LOG_ERROR, "%s-FIFO: entries are limited to %d bytes, committed %d bytes, limiting size", mName.c_str(), mFifoEntrySize, pBufferSize);
+        pBufferSize = mFifoEntrySize;
+    }
+
+    mFifo[pEntryPointer].Size = pBufferSize;
+    mFifo[pEntryPointer].Number = pBufferTimestamp;
+
+    // publish the entry data before the new write position
+    __sync_synchronize();
+    mSpscWritePos = RingAdvance(mSpscWritePos);
+    __sync_synchronize();
+
+    if (mReaderWaiting)
+        WakeUpReader();
+}
+
+void MediaFifoSpsc::WriteFifoExclusiveCanceled(int pEntryPointer)
+{
+    if (pEntryPointer < 0)
+        return;
+
+    #ifdef MFS_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: canceling lease of entry %d", mName.c_str(), pEntryPointer);
+    #endif
+
+    if (mSpscLeasePos == mSpscWritePos)
+    {
+        LOG(LOG_ERROR, "%s-FIFO: no leased entry available, ignoring cancellation of entry %d", mName.c_str(), pEntryPointer);
+        return;
+    }
+
+    int tLeasePos = RingRetreat(mSpscLeasePos);
+    if (((tLeasePos >= mFifoSize) ? tLeasePos - mFifoSize : tLeasePos) != pEntryPointer)
+        LOG(LOG_ERROR, "%s-FIFO: entry %d isn't the latest leased entry", mName.c_str(), pEntryPointer);
+
+    // the slot wasn't published, simply take it back
+    mSpscLeasePos = tLeasePos;
+}
+
+void MediaFifoSpsc::WriteFifo(char* pBuffer, int pBufferSize, int64_t pBufferTimestamp)
+{
+    #ifdef MFS_DEBUG
+        LOG(LOG_VERBOSE, "%s-FIFO: WriteFifo() START", mName.c_str());
+    #endif
+
+    if (pBufferSize > mFifoEntrySize)
+    {
+        LOG(LOG_ERROR, "%s-FIFO: entries are limited to %d bytes, current write request of %d bytes will be ignored, current FIFO size: %d", mName.c_str(), mFifoEntrySize, pBufferSize, mFifoSize);
+        return;
+    }
+
+    // empty chunks are wake up signals which may come from any thread
+    if (pBufferSize <= 0)
+    {
+        LOG(LOG_VERBOSE, "%s-FIFO: writing empty chunk", mName.c_str());
+        __sync_fetch_and_add(&mWakeUpRequests, 1);
+        WakeUpReader();
+        return;
+    }
+
+    char *tEntryBuffer;
+    int tEntrySize;
+    int tEntry = WriteFifoExclusive(&tEntryBuffer, tEntrySize);
+    if (tEntry < 0)
+    {
+        LOG(LOG_WARN, "%s-FIFO: dropping data chunk of %d bytes", mName.c_str(), pBufferSize);
+        return;
+    }
+
+    if (pBuffer != NULL)
+        memcpy((void*)tEntryBuffer, (const void*)pBuffer, (size_t)pBufferSize);
+
+    WriteFifoExclusiveFinished(tEntry, pBufferSize, pBufferTimestamp);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
@@ -47,6 +47,10 @@ MediaSink::MediaSink(enum MediaSinkType pType):
     mSinkIsActive = false;
     mMaxFpsTimestampLastFragment = 0;
     mMaxFpsFrameNumberLastFragment = 0;
+    mKeyFrameRequestTime = 0;
+    mKeyFrameRequestCount = 0;
+    mRtpPacketizer = NULL;
+    mQueuePolicy = MEDIA_SINK_QUEUE_DROP_NEWEST;
     switch(pType)
     {
         case MEDIA_SINK_VIDEO:
@@ -76,6 +80,98 @@ void MediaSink::SetActivation(bool pState)
     mSinkIsActive = pState;
 }
 
+int MediaSink::GetTargetBitRate()
+{
+    return -1;
+}
+
+void MediaSink::RequestKeyFrame()
+{
+    mKeyFrameRequestMutex.lock();
+    // the delay is measured from the first request, repetitions don't restart it
+    if (mKeyFrameRequestTime == 0)
+        mKeyFrameRequestTime = Time::GetMonotonicTimeStamp();
+    mKeyFrameRequestCount++;
+    uint64_t tRequestCount = mKeyFrameRequestCount;
+    mKeyFrameRequestMutex.unlock();
+
+    SetKeyFrameStatistic(tRequestCount, GetKeyFrameDelay());
+}
+
+int64_t MediaSink::GetKeyFrameRequestTime()
+{
+    int64_t tResult;
+
+    mKeyFrameRequestMutex.lock();
+    tResult = mKeyFrameRequestTime;
+    mKeyFrameRequestMutex.unlock();
+
+    return tResult;
+}
+
+void MediaSink::SetRtpPacketizer(RTPPacketizer *pPacketizer)
+{
+    mRtpPacketizer = pPacketizer;
+}
+
+void MediaSink::ForwardRtpPacket(char *pPacket, int pPacketSize, enum AVCodecID pCodecId)
+{
+}
+
+void MediaSink::SetQueuePolicy(enum MediaSinkQueuePolicy pPolicy)
+{
+    if (mQueuePolicy != pPolicy)
+    {
+        LOG(LOG_VERBOSE, "Setting queue policy of media sink %s to \"%s\"", GetId().c_str(), QueuePolicy2String(pPolicy).c_str());
+        mQueuePolicy = pPolicy;
+    }
+}
+
+enum MediaSinkQueuePolicy MediaSink::GetQueuePolicy()
+{
+    return mQueuePolicy;
+}
+
+string MediaSink::QueuePolicy2String(enum MediaSinkQueuePolicy pPolicy)
+{
+    switch(pPolicy)
+    {
+        case MEDIA_SINK_QUEUE_DROP_NEWEST:
+            return "drop newest";
+        case MEDIA_SINK_QUEUE_DROP_QUEUED:
+            return "drop queued";
+        case MEDIA_SINK_QUEUE_WAIT:
+            return "wait";
+        default:
+            return "unknown";
+    }
+}
+
+bool MediaSink::IsWaitingForKeyFrame()
+{
+    return false;
+}
+
+void MediaSink::AnnounceKeyFrame()
+{
+    int tDelay = -1;
+
+    mKeyFrameRequestMutex.lock();
+    if (mKeyFrameRequestTime != 0)
+    {
+        tDelay = (int)((Time::GetMonotonicTimeStamp() - mKeyFrameRequestTime) / 1000);
+        mKeyFrameRequestTime = 0;
+    }
+    uint64_t tRequestCount = mKeyFrameRequestCount;
+    mKeyFrameRequestMutex.unlock();
+
+    if (tDelay >= 0)
+    {
+        LOG(LOG_VERBOSE, "Sent key frame %d ms after it was requested", tDelay);
+        SetKeyFrameStatistic(tRequestCount, tDelay);
+    }
+}
+
 string MediaSink::GetId()
 {
     return mMediaId;
@@ -94,7 +190,7 @@ int MediaSink::GetMaxFps()
 
 bool MediaSink::BelowMaxFps(int pFrameNumber)
 {
-    int64_t tCurrentTime = Time::GetTimeStamp();
+    int64_t tCurrentTime = Time::GetMonotonicTimeStamp();
     int64_t tTimeDiff = tCurrentTime - mMaxFpsTimestampLastFragment;
 
     //LOG(LOG_VERBOSE, "Checking max. FPS for frame number %d", pFrameNumber);
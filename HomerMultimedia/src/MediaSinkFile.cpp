@@ -28,9 +28,13 @@
 #include <MediaSinkFile.h>
 #include <MediaSourceNet.h>
 #include <PacketStatistic.h>
+#include <ProcessStatisticService.h>
 #include <RTP.h>
+#include <HBTime.h>
 #include <Logger.h>
 
+#include <stdio.h>
+
 #include <string>
 
 namespace Homer { namespace Multimedia {
@@ -44,6 +48,7 @@ MediaSinkFile::MediaSinkFile(string pSinkFile, enum MediaSinkType pType, bool pR
     MediaSinkMem(pSinkFile, pType, pRtpActivated)
 {
     mSinkFile = pSinkFile;
+    mWriterNeeded = false;
     mMediaId = pSinkFile;
     AssignStreamName("FILE-OUT: " + mMediaId);
     switch(pType)
@@ -57,39 +62,120 @@ MediaSinkFile::MediaSinkFile(string pSinkFile, enum MediaSinkType pType, bool pR
         default:
             break;
     }
+    StartWriter();
 }
 
 MediaSinkFile::~MediaSinkFile()
 {
+    StopWriter();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MediaSinkFile::StopProcessing()
+{
+    mWriterNeeded = false;
+    MediaSinkMem::StopProcessing();
 }
 
-void MediaSinkFile::WriteFragment(char* pData, unsigned int pSize)
+void MediaSinkFile::StartWriter()
 {
-    #ifdef MSIF_DEBUG_PACKETS
-        LOG(LOG_VERBOSE, "Storing packet number %6ld at %p with size %4u(%3u header) in file %s", ++mPacketNumber, pData, pSize, RTP_HEADER_SIZE, mSinkFile.c_str());
+    LOG(LOG_VERBOSE, "Starting writer for file %s", mSinkFile.c_str());
+
+    if (!IsRunning())
+    {
+        // start writer main loop
+        StartThread();
 
-        // if RTP activated then reparse the current packet and print the content
-        if (mRtpActivated)
+        int tLoops = 0;
+
+        // wait until thread is running
+        while ((!IsRunning() /* wait until thread is started */) || (!mWriterNeeded /* wait until thread has finished the init. process */))
         {
-            char *tPacketData = pData;
-            unsigned int tPacketSize = pSize;
-            RtpParse(tPacketData, tPacketSize, mCurrentStream->codec->codec_id);
+            if (tLoops % 10 == 0)
+                LOG(LOG_VERBOSE, "Waiting for the start of the file writer thread, loop count: %d", ++tLoops);
+
+            Thread::Suspend(25 * 1000);
         }
-    #endif
-    AnnouncePacket(pSize);
+    }
+
+    LOG(LOG_VERBOSE, "Writer for file %s started", mSinkFile.c_str());
+}
+
+void MediaSinkFile::StopWriter()
+{
+    int tSignalingRound = 0;
+
+    LOG(LOG_VERBOSE, "Stopping writer");
+
+    // tell writer thread it isn't needed anymore
+    mWriterNeeded = false;
+
+    // wait for termination of writer thread
+    do
+    {
+        if(tSignalingRound > 0)
+            LOG(LOG_WARN, "Signaling round %d to stop writer, system has high load", tSignalingRound);
+        tSignalingRound++;
 
+        // write fake data to awake writer thread as long as it still runs
+        mSinkFifo->WriteFifo(NULL, 0, 0);
+
+        Suspend(25 * 1000);
+    }while(IsRunning());
+
+    LOG(LOG_VERBOSE, "Writer stopped");
+}
+
+void* MediaSinkFile::Run(void* pArgs)
+{
+    char *tBuffer;
+    int tBufferSize;
+    int64_t tFragmentNumber;
+    int64_t tLastFlush = Time::GetMonotonicTimeStamp();
+
+    LOG(LOG_VERBOSE, "%s file writer for %s started", GetDataTypeStr().c_str(), mSinkFile.c_str());
+    SVC_PROCESS_STATISTIC.AssignThreadName(GetDataTypeStr() + "-Writer(FILE)");
+
+    // the file stays open as long as the writer runs
     FILE *tFile = fopen(mSinkFile.c_str(), "a+");
     if (tFile == NULL)
+        LOG(LOG_ERROR, "Couldn't open file %s for writing", mSinkFile.c_str());
+
+    mWriterNeeded = true;
+
+    while(mWriterNeeded)
     {
-        LOG(LOG_ERROR, "Couldn't write to file %s", mSinkFile.c_str());
-        return;
+        int tEntry = mSinkFifo->ReadFifoExclusive(&tBuffer, tBufferSize, tFragmentNumber);
+
+        if ((mWriterNeeded) && (tFile != NULL) && (tBufferSize > 0))
+        {
+            #ifdef MSIF_DEBUG_PACKETS
+                LOG(LOG_VERBOSE, "Storing packet number %6"PRId64" with size %4d in file %s", tFragmentNumber, tBufferSize, mSinkFile.c_str());
+            #endif
+
+            size_t tWritten = fwrite((void*)tBuffer, 1, (size_t)tBufferSize, tFile);
+            if (tWritten < (size_t)tBufferSize)
+                LOG(LOG_ERROR, "Insufficient data was written to file %s (%u < %d)", mSinkFile.c_str(), (unsigned int)tWritten, tBufferSize);
+        }
+
+        // release FIFO entry lock
+        mSinkFifo->ReadFifoExclusiveFinished(tEntry);
+
+        int64_t tTime = Time::GetMonotonicTimeStamp();
+        if ((tFile != NULL) && (tTime - tLastFlush > MEDIA_SINK_FILE_FLUSH_PERIOD * 1000))
+        {
+            fflush(tFile);
+            tLastFlush = tTime;
+        }
     }
 
-    size_t tSent = fwrite((void*)pData, 1, (size_t) pSize, tFile);
-    fclose(tFile);
+    if (tFile != NULL)
+        fclose(tFile);
+
+    LOG(LOG_VERBOSE, "%s file writer for %s finished", GetDataTypeStr().c_str(), mSinkFile.c_str());
 
-    if (tSent < pSize)
-        LOG(LOG_ERROR, "Insufficient data was written to file %s (%u < %u)", mSinkFile.c_str(), tSent, pSize);
+    return NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -29,10 +29,12 @@
 #include <MediaSourceMem.h>
 #include <MediaSourceMuxer.h>
 #include <MediaFifo.h>
+#include <MediaFifoSpsc.h>
 #include <MediaSinkNet.h>
 #include <MediaSourceNet.h>
 #include <PacketStatistic.h>
 #include <RTP.h>
+#include <RTPPacketizer.h>
 #include <Logger.h>
 
 #include <string>
@@ -46,6 +48,15 @@ using namespace Homer::Monitor;
 
 #define MEDIA_SINK_MEM_PLAIN_FRAGMENT_BUFFER_SIZE    MEDIA_SOURCE_AV_CHUNK_BUFFER_SIZE
 
+// de/activate retransmissions of video packets which were requested by a receiver via NACK
+#define MEDIA_SINK_MEM_USE_RETRANSMISSIONS
+
+// default max. overhead of FEC packets in percent, 0 deactivates FEC
+#define MEDIA_SINK_MEM_FEC_PROTECTION                0
+
+// de/activate the estimation of the bit rate which the path to the receiver can carry, the video encoder follows this estimation
+#define MEDIA_SINK_MEM_USE_CONGESTION_CONTROL
+
 ///////////////////////////////////////////////////////////////////////////////
 
 MediaSinkMem::MediaSinkMem(string pMediaId, enum MediaSinkType pType, bool pRtpActivated):
@@ -60,10 +71,36 @@ MediaSinkMem::MediaSinkMem(string pMediaId, enum MediaSinkType pType, bool pRtpA
     mIncomingAVStreamCodecContext = NULL;
     mRtpActivated = pRtpActivated;
     mWaitUntillFirstKeyFrame = (pType == MEDIA_SINK_VIDEO) ? true : false;
+    mLastFirRequesterIdentifier = 0;
+    mLastFirSequenceNumber = -1;
+    mPacketHistory = NULL;
+    #ifdef MEDIA_SINK_MEM_USE_RETRANSMISSIONS
+        // lost audio packets are concealed by the decoder, a retransmission would arrive too late in most cases
+        if ((mRtpActivated) && (pType == MEDIA_SINK_VIDEO))
+            mPacketHistory = new RTPPacketHistory(MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
+    #endif
+    mFecEncoder = NULL;
+    if (mRtpActivated)
+    {
+        // a FEC packet is bigger than the protected packets, it has to fit into a FIFO entry
+        mFecEncoder = new RTPFecEncoder(MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE - RTP_FEC_HEADER_SIZE);
+        mFecEncoder->SetProtection(MEDIA_SINK_MEM_FEC_PROTECTION, true);
+    }
+    mCongestionControl = NULL;
+    #ifdef MEDIA_SINK_MEM_USE_CONGESTION_CONTROL
+        // audio streams are small and their encoders use a constant bit rate
+        if ((mRtpActivated) && (pType == MEDIA_SINK_VIDEO))
+            mCongestionControl = new RTPCongestionControl();
+    #endif
+    // the sink FIFO has exactly one writer (the relaying thread) and one reader (the sender thread)
     if (mRtpActivated)
-        mSinkFifo = new MediaFifo(MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE, GetDataTypeStr() + "-MediaSinkMem");
+        mSinkFifo = new MediaFifoSpsc(MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE, GetDataTypeStr() + "-MediaSinkMem");
     else
-        mSinkFifo = new MediaFifo(MEDIA_SOURCE_MUX_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SINK_MEM_PLAIN_FRAGMENT_BUFFER_SIZE, GetDataTypeStr() + "-MediaSinkMem");
+        mSinkFifo = new MediaFifoSpsc(MEDIA_SOURCE_MUX_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SINK_MEM_PLAIN_FRAGMENT_BUFFER_SIZE, GetDataTypeStr() + "-MediaSinkMem");
+    mSinkFifoOverflow = false;
+    mForwarder = NULL;
+    mForwardingLayer = RTP_FORWARDER_LAYER_ALL;
+    SetQueuePolicy(mQueuePolicy);
     AssignStreamName("MEM-OUT: " + mMediaId);
     switch(pType)
     {
@@ -81,12 +118,21 @@ MediaSinkMem::MediaSinkMem(string pMediaId, enum MediaSinkType pType, bool pRtpA
 MediaSinkMem::~MediaSinkMem()
 {
     CloseStreamer();
+    if (mForwarder != NULL)
+    {
+        RtcpUnregisterFeedbackReceiver();
+        LOG(LOG_VERBOSE, "Forwarded %"PRIu64" %s packets, skipped %"PRIu64" packets and %"PRIu64" frames", mForwarder->GetForwardedPackets(), GetDataTypeStr().c_str(), mForwarder->GetSkippedPackets(), mForwarder->GetSkippedFrames());
+        delete mForwarder;
+    }
     delete mSinkFifo;
+    delete mPacketHistory;
+    delete mFecEncoder;
+    delete mCongestionControl;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::string pStreamName)
+void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, const std::string &pStreamName)
 {
     bool tResetNeeded = false;
     bool tIsKeyFrame = pAVPacket->flags & AV_PKT_FLAG_KEY;
@@ -111,6 +157,9 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
             #ifdef MSIM_DEBUG_PACKETS
                 LOG(LOG_VERBOSE, "Still waiting for first key frame");
             #endif
+            // don't wait for the end of the current GOP
+            if (GetKeyFrameRequestTime() == 0)
+                RequestKeyFrame();
             return;
         }else
         {
@@ -118,6 +167,8 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
             mWaitUntillFirstKeyFrame = false;
         }
     }
+    if (tIsKeyFrame)
+        AnnounceKeyFrame();
 
     if (mRtpActivated)
     {
@@ -199,6 +250,11 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
             return;
         }
 
+        //####################################################################
+        // requested retransmissions are sent in front of new packets
+        //####################################################################
+        SendRetransmissions();
+
         //####################################################################
         // limit the outgoing stream to the defined maximum FPS value
         //####################################################################
@@ -237,12 +293,20 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
         #endif
 
 
-        int64_t tTime = Time::GetTimeStamp();
+        int64_t tTime = Time::GetMonotonicTimeStamp();
         char *tOutputStreamData = NULL;
         unsigned int tOutputStreamDataSize = 0;
-        bool tRtpCreationSucceed = RtpCreate(pAVPacket, tOutputStreamData, tOutputStreamDataSize);
+        bool tRtpCreationSucceed;
+        if (mRtpPacketizer != NULL)
+        {// the RTP packets are created once for all media sinks, we rewrite only our own header fields
+            char *tSharedData = NULL;
+            unsigned int tSharedDataSize = 0;
+            uint64_t tSharedTimestampOffset = 0;
+            tRtpCreationSucceed = ((mRtpPacketizer->GetRtpPackets(pAVPacket, pStream, pStreamName, tSharedData, tSharedDataSize, tSharedTimestampOffset)) && (RtpAdopt(tSharedData, tSharedDataSize, tSharedTimestampOffset, tOutputStreamData, tOutputStreamDataSize)));
+        }else
+            tRtpCreationSucceed = RtpCreate(pAVPacket, tOutputStreamData, tOutputStreamDataSize);
         #ifdef MSIM_DEBUG_TIMING
-            int64_t tTime2 = Time::GetTimeStamp();
+            int64_t tTime2 = Time::GetMonotonicTimeStamp();
             LOG(LOG_VERBOSE, "               generating RTP envelope took %"PRId64" us", tTime2 - tTime);
         #endif
         #ifdef MSIM_DEBUG_PACKETS
@@ -263,7 +327,7 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
         //####################################################################
         if ((tRtpCreationSucceed) && (tOutputStreamData != 0) && (tOutputStreamDataSize > 0))
         {
-            tTime = Time::GetTimeStamp();
+            tTime = Time::GetMonotonicTimeStamp();
             char *tRtpPacket = tOutputStreamData + 4;
             uint32_t tRtpPacketSize = 0;
             uint32_t tRemainingRtpDataSize = tOutputStreamDataSize;
@@ -280,6 +344,14 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
 
                 // send final packet
                 WriteFragment(tRtpPacket, tRtpPacketSize, ++mPacketNumber);
+                if (mPacketHistory != NULL)
+                    mPacketHistory->Store(tRtpPacket, tRtpPacketSize, tTime);
+
+                // send a FEC packet directly behind the last packet of its group
+                char *tFecPacket;
+                int tFecPacketSize;
+                if ((mFecEncoder != NULL) && (mFecEncoder->AddPacket(tRtpPacket, tRtpPacketSize, &tFecPacket, tFecPacketSize)))
+                    WriteFragment(tFecPacket, (unsigned int)tFecPacketSize, ++mPacketNumber);
 
                 // go to the next RTP packet
                 tRtpPacket = tRtpPacket + (tRtpPacketSize + 4);
@@ -291,10 +363,18 @@ void MediaSinkMem::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
                 #endif
             }while (tRemainingRtpDataSize > RTP_HEADER_SIZE);
             #ifdef MSIM_DEBUG_TIMING
-                tTime2 = Time::GetTimeStamp();
+                tTime2 = Time::GetMonotonicTimeStamp();
                 LOG(LOG_VERBOSE, "                             sending RTP packets to network took %"PRId64" us", tTime2 - tTime);
             #endif
         }
+
+        // update the estimation of the path's capacity
+        if (mCongestionControl != NULL)
+        {
+            mCongestionControl->AnnounceQueueUsage(mSinkFifo->GetUsage(), mSinkFifo->GetSize());
+            if (mCongestionControl->Update(Time::GetMonotonicTimeStamp()))
+                AnnounceBitRateEstimate(mCongestionControl->GetTargetBitRate());
+        }
     }else
     {
         // send final packet
@@ -344,6 +424,78 @@ void MediaSinkMem::ReadFragment(char *pData, int &pDataSize, int64_t &pFragmentN
     }
 }
 
+void MediaSinkMem::ForwardRtpPacket(char *pPacket, int pPacketSize, enum AVCodecID pCodecId)
+{
+    char *tPacket;
+    int tPacketSize;
+
+    // return immediately if the sink is stopped or if it sends an own stream
+    if ((!mSinkIsActive) || (!mRtpActivated) || (mMediaSinkOpened))
+        return;
+
+    //####################################################################
+    // the forwarded stream gets an own source identifier, the receiver addresses its feedback to it
+    //####################################################################
+    if (mForwarder == NULL)
+    {
+        LOG(LOG_VERBOSE, "Forwarding received %s stream via media sink %s", GetDataTypeStr().c_str(), GetId().c_str());
+        mForwarder = new RTPForwarder(MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE, (GetDataType() == DATA_TYPE_VIDEO));
+        mForwarder->SetSourceIdentifier(CreateLocalSourceIdentifier());
+        if (mPacketHistory != NULL)
+            mPacketHistory->Reset();
+        if (mFecEncoder != NULL)
+            mFecEncoder->Reset();
+        RtcpRegisterFeedbackReceiver();
+    }
+    mForwarder->SetLayer(mForwardingLayer);
+
+    // requested retransmissions are sent in front of new packets
+    SendRetransmissions();
+
+    int64_t tTime = Time::GetMonotonicTimeStamp();
+    if (!mForwarder->Forward(pPacket, pPacketSize, pCodecId, mMaxFps, tTime, &tPacket, tPacketSize))
+    {
+        // don't wait for the end of the current GOP
+        if ((mForwarder->IsWaitingForKeyFrame()) && (GetKeyFrameRequestTime() == 0))
+            RequestKeyFrame();
+        return;
+    }
+    if (mForwarder->IsKeyFrame())
+        AnnounceKeyFrame();
+
+    // a frame is forwarded completely or not at all
+    if ((mForwarder->IsFrameStart()) && (!AnnounceForwardedFrame(mForwarder->GetFrameType())))
+    {
+        mForwarder->DropFrame();
+        return;
+    }
+
+    WriteFragment(tPacket, (unsigned int)tPacketSize, ++mPacketNumber);
+    if (mPacketHistory != NULL)
+        mPacketHistory->Store(tPacket, tPacketSize, tTime);
+
+    // send a FEC packet directly behind the last packet of its group
+    char *tFecPacket;
+    int tFecPacketSize;
+    if ((mFecEncoder != NULL) && (mFecEncoder->AddPacket(tPacket, tPacketSize, &tFecPacket, tFecPacketSize)))
+        WriteFragment(tFecPacket, (unsigned int)tFecPacketSize, ++mPacketNumber);
+}
+
+void MediaSinkMem::SetForwardingLayer(enum RTPForwarderLayer pLayer)
+{
+    mForwardingLayer = pLayer;
+}
+
+enum RTPForwarderLayer MediaSinkMem::GetForwardingLayer()
+{
+    return mForwardingLayer;
+}
+
+bool MediaSinkMem::AnnounceForwardedFrame(enum RTPForwarderFrameType pType)
+{
+    return true;
+}
+
 void MediaSinkMem::StopProcessing()
 {
     LOG(LOG_VERBOSE, "Going to stop media sink \"%s\"", GetStreamName().c_str());
@@ -367,12 +519,52 @@ void MediaSinkMem::WriteFragment(char* pData, unsigned int pSize, int64_t pFragm
             RtpParse(tPacketData, tPacketSize, tLastFragment, tFragmentRtcpType, mIncomingAVStream->codec->codec_id, true);
         }
     #endif
-    AnnouncePacket(pSize);
-    if ((int)pSize <= mSinkFifo->GetEntrySize())
+    if ((int)pSize > mSinkFifo->GetEntrySize())
     {
-        mSinkFifo->WriteFifo(pData, (int)pSize, pFragmentNumber);
-    }else
         LOG(LOG_ERROR, "Packet for %s media sink of %u bytes is too big for FIFO with entries of %d bytes", GetDataTypeStr().c_str(), pSize, mSinkFifo->GetEntrySize());
+        return;
+    }
+
+    char *tEntryBuffer;
+    int tEntryBufferSize;
+    int tEntry = mSinkFifo->WriteFifoExclusive(&tEntryBuffer, tEntryBufferSize);
+    if (tEntry < 0)
+    {// the reader of this media sink is too slow, the other media sinks of the source mustn't wait for it
+        int tDroppedPackets = 1;
+        if (mQueuePolicy == MEDIA_SINK_QUEUE_DROP_QUEUED)
+        {
+            // the reader executes the request, the current packet is dropped, too
+            tDroppedPackets += mSinkFifo->GetUsage();
+            mSinkFifo->ClearFifo();
+        }
+        if (!mSinkFifoOverflow)
+        {
+            LOG(LOG_WARN, "Queue of %s media sink %s is full (%d entries), applying policy \"%s\"", GetDataTypeStr().c_str(), GetId().c_str(), mSinkFifo->GetSize(), QueuePolicy2String(mQueuePolicy).c_str());
+            mSinkFifoOverflow = true;
+        }
+        AnnounceDroppedPackets(tDroppedPackets);
+        return;
+    }
+    if (mSinkFifoOverflow)
+    {
+        LOG(LOG_VERBOSE, "Queue of %s media sink %s accepts packets again, %"PRIu64" packets were dropped until now", GetDataTypeStr().c_str(), GetId().c_str(), GetDroppedPacketCount());
+        mSinkFifoOverflow = false;
+    }
+
+    memcpy(tEntryBuffer, pData, pSize);
+    mSinkFifo->WriteFifoExclusiveFinished(tEntry, (int)pSize, pFragmentNumber);
+
+    AnnouncePacket(pSize);
+    if (mCongestionControl != NULL)
+        mCongestionControl->AnnounceSentPacket((int)pSize);
+}
+
+void MediaSinkMem::SetQueuePolicy(enum MediaSinkQueuePolicy pPolicy)
+{
+    MediaSink::SetQueuePolicy(pPolicy);
+
+    // only the waiting policy lets the FIFO block the relaying thread
+    mSinkFifo->SetFullTimeout((pPolicy == MEDIA_SINK_QUEUE_WAIT) ? MEDIA_FIFO_SPSC_FULL_TIMEOUT : 0);
 }
 
 bool MediaSinkMem::OpenStreamer(AVStream *pStream, string pStreamName)
@@ -396,6 +588,21 @@ bool MediaSinkMem::OpenStreamer(AVStream *pStream, string pStreamName)
 
     mMediaSinkOpened = true;
 
+    // the receivers address their NACKs to the new source identifier
+    if (mRtpActivated)
+    {
+        if (mPacketHistory != NULL)
+            mPacketHistory->Reset();
+        if (mFecEncoder != NULL)
+            mFecEncoder->Reset();
+        if (mCongestionControl != NULL)
+        {// start with the bit rate of the encoder
+            mCongestionControl->Reset(pStream->codec->bit_rate > 0 ? pStream->codec->bit_rate : RTP_CONGESTION_CONTROL_MAX_BIT_RATE);
+            AnnounceBitRateEstimate(mCongestionControl->GetTargetBitRate());
+        }
+        RtcpRegisterFeedbackReceiver();
+    }
+
     mIncomingFirstPacket = true;
     mIncomingAVStreamStartPts = 0;
     mIncomingAVStreamCodecID = pStream->codec->codec_id;
@@ -411,13 +618,122 @@ bool MediaSinkMem::CloseStreamer()
         return false;
 
     if (mRtpActivated)
+    {
+        // wait for a concurrent delivery of a NACK
+        RtcpUnregisterFeedbackReceiver();
+        if ((mPacketHistory != NULL) && (mPacketHistory->GetRetransmittedPackets() > 0))
+            LOG(LOG_VERBOSE, "Retransmitted %"PRIu64" %s packets, rejected %"PRIu64" requests, estimated RTT: %d ms", mPacketHistory->GetRetransmittedPackets(), GetDataTypeStr().c_str(), mPacketHistory->GetRejectedRequests(), mPacketHistory->GetRtt());
+        if ((mFecEncoder != NULL) && (mFecEncoder->GetFecPackets() > 0))
+            LOG(LOG_VERBOSE, "Sent %"PRIu64" %s FEC packets, last protection: %d percent, reported loss: %d percent", mFecEncoder->GetFecPackets(), GetDataTypeStr().c_str(), mFecEncoder->GetProtection(), mFecEncoder->GetLoss());
+        if (mCongestionControl != NULL)
+            LOG(LOG_VERBOSE, "Last estimated %s bit rate: %d bit/s, sent: %d bit/s, reported loss: %d percent", GetDataTypeStr().c_str(), mCongestionControl->GetTargetBitRate(), mCongestionControl->GetSentBitRate(), mCongestionControl->GetLoss());
         CloseRtpEncoder();
+    }
 
     mMediaSinkOpened = false;
 
     return true;
 }
 
+void MediaSinkMem::SetFecProtection(int pMaxOverhead, bool pAdaptive)
+{
+    if (mFecEncoder == NULL)
+    {
+        LOG(LOG_WARN, "FEC is only supported for RTP streams");
+        return;
+    }
+
+    mFecEncoder->SetProtection(pMaxOverhead, pAdaptive);
+}
+
+int MediaSinkMem::GetFecProtection()
+{
+    if (mFecEncoder == NULL)
+        return 0;
+
+    return mFecEncoder->GetProtection();
+}
+
+int MediaSinkMem::GetTargetBitRate()
+{
+    if ((mCongestionControl == NULL) || (!mMediaSinkOpened))
+        return -1;
+
+    return mCongestionControl->GetTargetBitRate();
+}
+
+bool MediaSinkMem::IsWaitingForKeyFrame()
+{
+    return ((mSinkIsActive) && (mWaitUntillFirstKeyFrame));
+}
+
+void MediaSinkMem::RtcpReceivedNack(unsigned short *pSequenceNumbers, int pCount)
+{
+    // every requested packet was lost once, this controls the adaptive FEC protection
+    if (mFecEncoder != NULL)
+        mFecEncoder->AnnounceLoss(pCount);
+    if (mCongestionControl != NULL)
+        mCongestionControl->AnnounceLostPackets(pCount);
+
+    if (mPacketHistory == NULL)
+        return;
+
+    // the sink FIFO has only one writer, hence the packets are only queued here and sent by the next call to ProcessPacket()
+    int64_t tNow = Time::GetMonotonicTimeStamp();
+    mPacketHistory->Request(pSequenceNumbers, pCount, tNow);
+}
+
+void MediaSinkMem::RtcpReceivedReport(RtcpReportBlock *pReport, int64_t pArrivalTime)
+{
+    int tRtt = RtcpCalculateRtt(pReport, pArrivalTime);
+    int tJitter = RtcpCalculateJitter(pReport);
+    float tLoss = (float)pReport->FractionLost * 100 / 256;
+
+    #ifdef MSIM_DEBUG_PACKETS
+        LOG(LOG_VERBOSE, "Got receiver report, RTT: %d ms, jitter: %d ms, loss: %.2f percent, cumulative lost: %d", tRtt, tJitter, tLoss, pReport->CumulativeLost);
+    #endif
+
+    SetReceptionQuality(tRtt, tJitter, tLoss);
+
+    if (mCongestionControl != NULL)
+    {
+        mCongestionControl->AnnounceReportedLoss((int)tLoss);
+        if (tRtt >= 0)
+            mCongestionControl->AnnounceDelay((int64_t)tRtt * 1000, pArrivalTime);
+    }
+}
+
+void MediaSinkMem::RtcpReceivedKeyFrameRequest(unsigned int pRequesterIdentifier, int pFirSequenceNumber)
+{
+    // a repeated FIR with the same sequence number refers to an already answered request, see RFC 5104, section 4.3.1.2
+    if (pFirSequenceNumber >= 0)
+    {
+        if ((pRequesterIdentifier == mLastFirRequesterIdentifier) && (pFirSequenceNumber == mLastFirSequenceNumber))
+            return;
+        mLastFirRequesterIdentifier = pRequesterIdentifier;
+        mLastFirSequenceNumber = pFirSequenceNumber;
+    }
+
+    #ifdef MSIM_DEBUG_PACKETS
+        LOG(LOG_VERBOSE, "Got %s from source %u", (pFirSequenceNumber >= 0) ? "FIR" : "PLI", pRequesterIdentifier);
+    #endif
+
+    // the media source polls the request before it encodes the next frame
+    RequestKeyFrame();
+}
+
+void MediaSinkMem::SendRetransmissions()
+{
+    char *tPacket;
+    int tPacketSize;
+
+    if (mPacketHistory == NULL)
+        return;
+
+    while (mPacketHistory->GetNextRetransmission(&tPacket, tPacketSize, Time::GetMonotonicTimeStamp()))
+        WriteFragment(tPacket, (unsigned int)tPacketSize, ++mPacketNumber);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 }} //namespace
@@ -38,6 +38,10 @@
 #include <Berkeley/SocketName.h>
 #include <RequirementTargetPort.h>
 
+#if defined(LINUX)
+#include <sys/prctl.h>
+#endif
+
 #include <string>
 
 #include <Requirements.h>
@@ -52,6 +56,30 @@ using namespace Homer::Base;
 
 #define MSIN_SIMULATED_PACKET_LOSS                              0 // in percent
 
+// maximum number of FIFO entries which are sent within one system call
+#define MSIN_SEND_BATCH_SIZE                                    16
+
+// default pacing of the sent packets
+#define MSIN_PACING_RATE_FACTOR                                 RTP_PACER_RATE_FACTOR // percent of the target bit rate, 0 deactivates pacing
+
+// timer slack of the sender thread, the pacer needs waits with a precision of some microseconds
+#define MSIN_TIMER_SLACK                                        10 // us
+
+// overload of the send queue: whole frames are dropped at the head of the queue if its usage or the age of the frame exceeds these borders
+#define MSIN_OVERLOAD_QUEUE_USAGE                               25 // percent, non-reference and audio frames are dropped
+#define MSIN_OVERLOAD_FRAME_AGE                                 150 // ms
+#define MSIN_HEAVY_OVERLOAD_QUEUE_USAGE                         50 // percent, reference frames are dropped, too
+#define MSIN_HEAVY_OVERLOAD_FRAME_AGE                           400 // ms
+
+// FIFO entry number of a frame descriptor, the packets carry their queue time instead
+#define MSIN_FRAME_DESCRIPTOR                                   -1
+
+// the local queues of the system deliver audio packets ahead of video packets
+#define MSIN_AUDIO_SEND_PRIORITY                                6
+
+// in-stream RTCP packets are never dropped
+#define IS_RTCP_TYPE(x)                                         (((x) >= 72) && ((x) <= 78))
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void MediaSinkNet::BasicInit(string pTargetHost, unsigned int pTargetPort)
@@ -59,8 +87,15 @@ void MediaSinkNet::BasicInit(string pTargetHost, unsigned int pTargetPort)
     mStreamFragmentCopyBuffer = NULL;
     mNAPIDataSocket = NULL;
     mDataSocket = NULL;
+    mDataSocketOwned = false;
     mBrokenPipe = false;
+    mPeerBound = false;
     mMaxNetworkPacketSize = -1;
+    mPacer = new RTPPacer();
+    mPacer->SetPacing(MSIN_PACING_RATE_FACTOR);
+    mQueueReferenceChainBroken = false;
+    mSendReferenceChainBroken = false;
+    mSendFrameDropped = false;
     mTargetHost = pTargetHost;
     mTargetPort = pTargetPort;
 }
@@ -131,7 +166,6 @@ MediaSinkNet::MediaSinkNet(string pTargetHost, unsigned int pTargetPort, Socket*
     mDataSocket = pLocalSocket;
     mNAPIUsed = false;
     enum TransportType tTransportType = SOCKET_RAW;
-    enum NetworkType tNetworkType = SOCKET_RAWNET;
 
     // get transport type
     mStreamedTransport = (tTransportType == SOCKET_TCP);
@@ -143,29 +177,9 @@ MediaSinkNet::MediaSinkNet(string pTargetHost, unsigned int pTargetPort, Socket*
     if (mDataSocket != NULL)
     {
         tTransportType = mDataSocket->GetTransportType();
-        tNetworkType = mDataSocket->GetNetworkType();
 
-        // define QoS settings
-        QoSSettings tQoSSettings;
-        switch(pType)
-        {
-            case MEDIA_SINK_VIDEO:
-                ClassifyStream(DATA_TYPE_VIDEO, tTransportType, tNetworkType);
-                tQoSSettings.DataRate = 20;
-                tQoSSettings.Delay = 250;
-                tQoSSettings.Features = QOS_FEATURE_NONE;
-                break;
-            case MEDIA_SINK_AUDIO:
-                ClassifyStream(DATA_TYPE_AUDIO, tTransportType, tNetworkType);
-                tQoSSettings.DataRate = 8;
-                tQoSSettings.Delay = 100;
-                tQoSSettings.Features = QOS_FEATURE_NONE;
-                break;
-            default:
-                LOG(LOG_ERROR, "Undefined media type");
-                break;
-        }
-        mDataSocket->SetQoS(tQoSSettings);
+        // the socket is shared with a receiver and therefore not connected
+        InitDataSocket(pType, false);
     }
 
     mMediaId = CreateId(pTargetHost, toString(pTargetPort), tTransportType, pRtpActivated);
@@ -174,6 +188,46 @@ MediaSinkNet::MediaSinkNet(string pTargetHost, unsigned int pTargetPort, Socket*
     StartSender();
 }
 
+MediaSinkNet::MediaSinkNet(string pTargetGroup, unsigned int pTargetPort, enum TransportType pTransportType, enum MediaSinkType pType, bool pRtpActivated, int pTtl, string pInterface):
+    MediaSinkMem("memory", pType, pRtpActivated)
+{
+    BasicInit(pTargetGroup, pTargetPort);
+    mNAPIUsed = false;
+    mStreamedTransport = false;
+
+    if (!Socket::IsMulticastAddress(pTargetGroup))
+        LOG(LOG_ERROR, "Target %s is no multicast group", pTargetGroup.c_str());
+
+    if ((pTransportType != SOCKET_UDP) && (pTransportType != SOCKET_UDP_LITE))
+    {
+        LOG(LOG_WARN, "Multicast isn't supported for %s transport, falling back to UDP", Socket::TransportType2String(pTransportType).c_str());
+        pTransportType = SOCKET_UDP;
+    }
+
+    LOG(LOG_VERBOSE, "Multicast media sink at: %s<%d>%s, TTL: %d, interface: %s", pTargetGroup.c_str(), pTargetPort, mRtpActivated ? "(RTP)" : "", pTtl, (pInterface != "") ? pInterface.c_str() : "default");
+
+    // the socket has to use the IP version of the group
+    mDataSocket = Socket::CreateClientSocket(IS_IPV6_ADDRESS(pTargetGroup) ? SOCKET_IPv6 : SOCKET_IPv4, pTransportType);
+    if (mDataSocket != NULL)
+    {
+        mDataSocketOwned = true;
+        mDataSocket->SetMulticastTtl(pTtl);
+        if (pInterface != "")
+            mDataSocket->SetMulticastInterface(pInterface);
+        // viewers at the local host receive the stream, too
+        mDataSocket->SetMulticastLoop(true);
+
+        // nobody else uses the socket, hence it can be connected to the group
+        InitDataSocket(pType, true);
+    }else
+        LOG(LOG_ERROR, "Couldn't create socket for multicast group %s", pTargetGroup.c_str());
+
+    mMediaId = CreateId(pTargetGroup, toString(pTargetPort), pTransportType, pRtpActivated);
+    AssignStreamName("NET-OUT: " + mMediaId);
+
+    StartSender();
+}
+
 MediaSinkNet::~MediaSinkNet()
 {
     StopSender();
@@ -184,15 +238,55 @@ MediaSinkNet::~MediaSinkNet()
             delete mNAPIDataSocket;
     }else
     {
-        //HINT: socket object has to be deleted outside
+        //HINT: socket object has to be deleted outside, except the own socket of a multicast stream
+        if (mDataSocketOwned)
+            delete mDataSocket;
     }
     free(mStreamFragmentCopyBuffer);
+    delete mPacer;
     LOG(LOG_VERBOSE, "Destroyed");
 }
 
+void MediaSinkNet::InitDataSocket(enum MediaSinkType pType, bool pConnect)
+{
+    enum TransportType tTransportType = mDataSocket->GetTransportType();
+    enum NetworkType tNetworkType = mDataSocket->GetNetworkType();
+
+    // define QoS settings
+    QoSSettings tQoSSettings;
+    switch(pType)
+    {
+        case MEDIA_SINK_VIDEO:
+            ClassifyStream(DATA_TYPE_VIDEO, tTransportType, tNetworkType);
+            tQoSSettings.DataRate = 20;
+            tQoSSettings.Delay = 250;
+            tQoSSettings.Features = QOS_FEATURE_NONE;
+            break;
+        case MEDIA_SINK_AUDIO:
+            ClassifyStream(DATA_TYPE_AUDIO, tTransportType, tNetworkType);
+            tQoSSettings.DataRate = 8;
+            tQoSSettings.Delay = 100;
+            tQoSSettings.Features = QOS_FEATURE_NONE;
+            mDataSocket->SetSendPriority(MSIN_AUDIO_SEND_PRIORITY);
+            break;
+        default:
+            LOG(LOG_ERROR, "Undefined media type");
+            break;
+    }
+    mDataSocket->SetQoS(tQoSSettings);
+
+    // the target never changes: resolve its address only once
+    if ((mTargetHost != "") && (mTargetPort != 0))
+        mPeerBound = mDataSocket->BindPeer(mTargetHost, mTargetPort, pConnect);
+
+    // hand over the fragments of a frame as one packet train, falls back to one datagram per fragment if the kernel doesn't support this
+    if (tTransportType == SOCKET_UDP)
+        mDataSocket->EnableSendOffload();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
-void MediaSinkNet::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::string pStreamName)
+void MediaSinkNet::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, const std::string &pStreamName)
 {
     int tNewMaxNetworkPacketSize = -1;
 
@@ -213,8 +307,211 @@ void MediaSinkNet::ProcessPacket(AVPacket *pAVPacket, AVStream *pStream, std::st
         }
     }
 
+    // the sender thread drops whole frames in case of an overload
+    enum MediaSinkNetFrameType tFrameType = ClassifyFrame(pAVPacket, pStream);
+    if (!QueueFrame(tFrameType))
+        return;
+
+    uint64_t tDroppedPackets = GetDroppedPacketCount();
+
     // call ProcessPacket from mem based media sink
     MediaSinkMem::ProcessPacket(pAVPacket, pStream, pStreamName);
+
+    // an incomplete reference frame breaks the reference chain
+    if ((GetDroppedPacketCount() != tDroppedPackets) && ((tFrameType == MSIN_FRAME_KEY) || (tFrameType == MSIN_FRAME_REFERENCE)) && (!mQueueReferenceChainBroken))
+    {
+        LOG(LOG_WARN, "Incomplete %s reference frame was queued for %s, waiting for the next key frame", GetDataTypeStr().c_str(), GetId().c_str());
+        mQueueReferenceChainBroken = true;
+        RequestKeyFrame();
+    }
+}
+
+enum MediaSinkNetFrameType MediaSinkNet::ClassifyFrame(AVPacket *pAVPacket, AVStream *pStream)
+{
+    if (GetDataType() == DATA_TYPE_AUDIO)
+        return MSIN_FRAME_AUDIO;
+
+    if (pAVPacket->flags & AV_PKT_FLAG_KEY)
+        return MSIN_FRAME_KEY;
+
+    if ((pStream != NULL) && (IsNonReferenceFrame(pStream->codec->codec_id, pAVPacket->data, pAVPacket->size)))
+        return MSIN_FRAME_NON_REFERENCE;
+
+    return MSIN_FRAME_REFERENCE;
+}
+
+bool MediaSinkNet::IsNonReferenceFrame(enum AVCodecID pCodecId, unsigned char *pData, int pDataSize)
+{
+    if (pData == NULL)
+        return false;
+
+    // search the start codes of the frame, unknown codecs and bitstream formats are treated as reference frames
+    for (int i = 0; i + 5 < pDataSize; i++)
+    {
+        if ((pData[i] != 0) || (pData[i + 1] != 0) || (pData[i + 2] != 1))
+            continue;
+
+        unsigned char *tHeader = &pData[i + 3];
+        switch(pCodecId)
+        {
+            case AV_CODEC_ID_H264:
+                {
+                    // all slices of a picture have the same nal_ref_idc, hence the first slice decides
+                    int tNalType = tHeader[0] & 0x1F;
+                    if ((tNalType >= 1) && (tNalType <= 5))
+                        return ((tHeader[0] & 0x60) == 0);
+                }
+                break;
+            case AV_CODEC_ID_MPEG4:
+                // VOP start code, B-VOPs aren't referenced
+                if (tHeader[0] == 0xB6)
+                    return ((tHeader[1] >> 6) == 2);
+                break;
+            case AV_CODEC_ID_MPEG1VIDEO:
+            case AV_CODEC_ID_MPEG2VIDEO:
+                // picture start code, B-pictures aren't referenced
+                if (tHeader[0] == 0x00)
+                    return (((tHeader[2] >> 3) & 0x07) == 3);
+                break;
+            default:
+                return false;
+        }
+    }
+
+    return false;
+}
+
+bool MediaSinkNet::AnnounceForwardedFrame(enum RTPForwarderFrameType pType)
+{
+    enum MediaSinkNetFrameType tFrameType = MSIN_FRAME_REFERENCE;
+
+    // the sender thread drops whole forwarded frames in case of an overload, too
+    switch(pType)
+    {
+        case RTP_FORWARDER_FRAME_KEY:
+            tFrameType = MSIN_FRAME_KEY;
+            break;
+        case RTP_FORWARDER_FRAME_REFERENCE:
+            tFrameType = MSIN_FRAME_REFERENCE;
+            break;
+        case RTP_FORWARDER_FRAME_NON_REFERENCE:
+            tFrameType = MSIN_FRAME_NON_REFERENCE;
+            break;
+        case RTP_FORWARDER_FRAME_AUDIO:
+            tFrameType = MSIN_FRAME_AUDIO;
+            break;
+    }
+
+    return QueueFrame(tFrameType);
+}
+
+bool MediaSinkNet::QueueFrame(enum MediaSinkNetFrameType pType)
+{
+    // frames which depend on a frame which couldn't be queued are useless
+    if (mQueueReferenceChainBroken)
+    {
+        if (pType == MSIN_FRAME_KEY)
+        {
+            LOG(LOG_VERBOSE, "Key frame repairs the reference chain of %s stream to %s", GetDataTypeStr().c_str(), GetId().c_str());
+            mQueueReferenceChainBroken = false;
+        }else if (pType != MSIN_FRAME_AUDIO)
+        {
+            AnnounceDroppedFrame(FRAME_DROP_BROKEN_REFERENCE);
+            return false;
+        }
+    }
+
+    MediaSinkNetFrame tFrame;
+    tFrame.QueueTime = Time::GetMonotonicTimeStamp();
+    tFrame.Type = pType;
+
+    char *tEntryBuffer;
+    int tEntryBufferSize;
+    int tEntry = mSinkFifo->WriteFifoExclusive(&tEntryBuffer, tEntryBufferSize);
+    if (tEntry < 0)
+    {// the queue is full, the frame would be incomplete
+        switch(pType)
+        {
+            case MSIN_FRAME_KEY:
+            case MSIN_FRAME_REFERENCE:
+                LOG(LOG_WARN, "Queue of %s media sink %s is full, dropping reference frames until the next key frame", GetDataTypeStr().c_str(), GetId().c_str());
+                AnnounceDroppedFrame(FRAME_DROP_REFERENCE);
+                mQueueReferenceChainBroken = true;
+                RequestKeyFrame();
+                break;
+            case MSIN_FRAME_NON_REFERENCE:
+                AnnounceDroppedFrame(FRAME_DROP_NON_REFERENCE);
+                break;
+            case MSIN_FRAME_AUDIO:
+                AnnounceDroppedFrame(FRAME_DROP_AUDIO);
+                break;
+        }
+        return false;
+    }
+
+    memcpy(tEntryBuffer, &tFrame, sizeof(tFrame));
+    mSinkFifo->WriteFifoExclusiveFinished(tEntry, (int)sizeof(tFrame), MSIN_FRAME_DESCRIPTOR);
+
+    return true;
+}
+
+bool MediaSinkNet::DropQueuedFrame(MediaSinkNetFrame *pFrame, int64_t pNow)
+{
+    int tQueueUsage = mSinkFifo->GetUsage() * 100 / mSinkFifo->GetSize();
+    int64_t tAge = pNow - pFrame->QueueTime;
+    bool tOverload = ((tQueueUsage >= MSIN_OVERLOAD_QUEUE_USAGE) || (tAge > (int64_t)MSIN_OVERLOAD_FRAME_AGE * 1000));
+    bool tHeavyOverload = ((tQueueUsage >= MSIN_HEAVY_OVERLOAD_QUEUE_USAGE) || (tAge > (int64_t)MSIN_HEAVY_OVERLOAD_FRAME_AGE * 1000));
+    enum FrameDropReason tReason;
+
+    switch(pFrame->Type)
+    {
+        case MSIN_FRAME_KEY:
+            // a key frame repairs the reference chain, hence it is never dropped
+            if (mSendReferenceChainBroken)
+            {
+                LOG(LOG_VERBOSE, "Key frame repairs the reference chain of %s stream to %s, queue usage: %d percent", GetDataTypeStr().c_str(), GetId().c_str(), tQueueUsage);
+                mSendReferenceChainBroken = false;
+            }
+            return false;
+        case MSIN_FRAME_REFERENCE:
+            if (mSendReferenceChainBroken)
+            {
+                tReason = FRAME_DROP_BROKEN_REFERENCE;
+                break;
+            }
+            if (!tHeavyOverload)
+                return false;
+            LOG(LOG_WARN, "Heavy overload of %s send queue to %s (usage: %d percent, frame age: %"PRId64" ms), dropping frames until the next key frame", GetDataTypeStr().c_str(), GetId().c_str(), tQueueUsage, tAge / 1000);
+            mSendReferenceChainBroken = true;
+            RequestKeyFrame();
+            tReason = FRAME_DROP_REFERENCE;
+            break;
+        case MSIN_FRAME_NON_REFERENCE:
+            // depends on the dropped reference frames, too
+            if (mSendReferenceChainBroken)
+            {
+                tReason = FRAME_DROP_BROKEN_REFERENCE;
+                break;
+            }
+            if (!tOverload)
+                return false;
+            tReason = FRAME_DROP_NON_REFERENCE;
+            break;
+        case MSIN_FRAME_AUDIO:
+            if (!tOverload)
+                return false;
+            tReason = FRAME_DROP_AUDIO;
+            break;
+        default:
+            return false;
+    }
+
+    #ifdef MSIN_DEBUG_PACKETS
+        LOG(LOG_VERBOSE, "Dropping %s of %s stream to %s, queue usage: %d percent, frame age: %"PRId64" ms", FrameDropReason2String(tReason).c_str(), GetDataTypeStr().c_str(), GetId().c_str(), tQueueUsage, tAge / 1000);
+    #endif
+    AnnounceDroppedFrame(tReason);
+
+    return true;
 }
 
 string MediaSinkNet::CreateId(string pHost, string pPort, enum TransportType pSocketTransportType, bool pRtpActivated)
@@ -231,11 +528,19 @@ void MediaSinkNet::StopProcessing()
     MediaSinkMem::StopProcessing();
 }
 
+void MediaSinkNet::SetPacing(int pRateFactor, int pBurstSize, int pMaxDelay)
+{
+    mPacer->SetPacing(pRateFactor, pBurstSize, pMaxDelay);
+}
+
 void MediaSinkNet::WriteFragment(char* pData, unsigned int pSize, int64_t pFragmentNumber)
 {
+    // the sender thread doesn't need the fragment number, instead the FIFO entry stores the queue time for the pacer
+    int64_t tQueueTime = Time::GetMonotonicTimeStamp();
+
     if (mRtpActivated)
     {// RTP active
-        MediaSinkMem::WriteFragment(pData, pSize, pFragmentNumber);
+        MediaSinkMem::WriteFragment(pData, pSize, tQueueTime);
     }else
     {// RTP inactive
         if (mMaxNetworkPacketSize > 0)
@@ -255,7 +560,7 @@ void MediaSinkNet::WriteFragment(char* pData, unsigned int pSize, int64_t pFragm
             char *tFragmentData = pData;
             while (tFragmentCount)
             {
-                int64_t tTime = Time::GetTimeStamp();
+                int64_t tTime = Time::GetMonotonicTimeStamp();
                 tFragmentSize = (unsigned int)(((int)pSize > mMaxNetworkPacketSize)? mMaxNetworkPacketSize : pSize);
 
                 // for TCP add an additional fragment header in front of the codec data to be able to differentiate the fragments in a received TCP packet at receiver side
@@ -274,17 +579,17 @@ void MediaSinkNet::WriteFragment(char* pData, unsigned int pSize, int64_t pFragm
                     }
                 }
 
-                int64_t tTime3 = Time::GetTimeStamp();
+                int64_t tTime3 = Time::GetMonotonicTimeStamp();
                 #ifdef MSIN_DEBUG_TIMING
-                    int64_t tTime4 = Time::GetTimeStamp();
+                    int64_t tTime4 = Time::GetMonotonicTimeStamp();
                     LOG(LOG_VERBOSE, "       SendFragment::AnnouncePacket for a fragment of %u bytes took %"PRId64" us", tFragmentSize, tTime4 - tTime3);
                 #endif
-                MediaSinkMem::WriteFragment(tFragmentData, tFragmentSize, pFragmentNumber /* do not increase the fragment number here because we don't disntinguish between sub-fragments here*/);
+                MediaSinkMem::WriteFragment(tFragmentData, tFragmentSize, tQueueTime);
 
                 tFragmentData = tFragmentData + tFragmentSize;
                 tFragmentCount--;
                 #ifdef MSIN_DEBUG_TIMING
-                    int64_t tTime2 = Time::GetTimeStamp();
+                    int64_t tTime2 = Time::GetMonotonicTimeStamp();
                     LOG(LOG_VERBOSE, "       SendFragment::Loop for a fragment of %u bytes took %"PRId64" us", tFragmentSize, tTime2 - tTime);
                 #endif
                 if ((tFragmentData > (pData + pSize)) && (tFragmentCount))
@@ -295,7 +600,7 @@ void MediaSinkNet::WriteFragment(char* pData, unsigned int pSize, int64_t pFragm
             }
         }else
         {// fragment has to be sent 1:1
-            MediaSinkMem::WriteFragment(pData, pSize, pFragmentNumber);
+            MediaSinkMem::WriteFragment(pData, pSize, tQueueTime);
         }
     }
 }
@@ -354,10 +659,14 @@ void MediaSinkNet::StopSender()
 
 void* MediaSinkNet::Run(void* pArgs)
 {
-    int tFifoEntry = 0;
+    int tFifoEntries[MSIN_SEND_BATCH_SIZE];
+    SocketDatagram tDatagrams[MSIN_SEND_BATCH_SIZE];
+    int64_t tQueueTimes[MSIN_SEND_BATCH_SIZE];
+    int64_t tQueueTime;
+    int tBatchSize;
+    int tDatagramCount;
     char *tBuffer;
     int tBufferSize;
-    int64_t tFragmentNumber;
 
     LOG(LOG_VERBOSE, "%s Stream relay for target %s:%u started", GetDataTypeStr().c_str(), mTargetHost.c_str(), mTargetPort);
     if (mNAPIUsed)
@@ -390,6 +699,13 @@ void* MediaSinkNet::Run(void* pArgs)
         }
     }
 
+    #if defined(LINUX)
+        // the default timer slack of 50 us would delay each paced packet
+        if (prctl(PR_SET_TIMERSLACK, MSIN_TIMER_SLACK * 1000, 0, 0, 0) != 0)
+            LOG(LOG_WARN, "Failed to reduce the timer slack of the sender thread");
+    #endif
+    mPacer->Reset();
+
     mSenderNeeded = true;
 
     while(mSenderNeeded)
@@ -398,36 +714,52 @@ void* MediaSinkNet::Run(void* pArgs)
         {
             int tBufferedPackets = mSinkFifo->GetUsage();
 
-            tFifoEntry = mSinkFifo->ReadFifoExclusive(&tBuffer, tBufferSize, tFragmentNumber);
+            // wait for the first entry and take all further entries which are already available
+            tBatchSize = 0;
+            tDatagramCount = 0;
+            do{
+                tFifoEntries[tBatchSize] = mSinkFifo->ReadFifoExclusive(&tBuffer, tBufferSize, tQueueTime);
+                tBatchSize++;
+
+                if (tBufferSize == 0)
+                {
+                    LOG(LOG_VERBOSE, "Zero byte %s packet in relay thread detected", GetDataTypeStr().c_str());
+                    break;
+                }
+
+                // the descriptor in front of the packets of a frame decides about the entire frame
+                if (tQueueTime == MSIN_FRAME_DESCRIPTOR)
+                {
+                    mSendFrameDropped = DropQueuedFrame((MediaSinkNetFrame*)tBuffer, Time::GetMonotonicTimeStamp());
+                    continue;
+                }
+                if ((mSendFrameDropped) && ((!mRtpActivated) || (tBufferSize < 2) || (!IS_RTCP_TYPE(tBuffer[1] & 0x7F))))
+                {
+                    // the receivers mustn't request the packets of a dropped frame
+                    if (mPacketHistory != NULL)
+                        mPacketHistory->Discard(tBuffer, tBufferSize);
+                    continue;
+                }
+
+                tDatagrams[tDatagramCount].Buffer = tBuffer;
+                tDatagrams[tDatagramCount].BufferSize = (ssize_t)tBufferSize;
+                tQueueTimes[tDatagramCount] = tQueueTime;
+                tDatagramCount++;
 
-            if ((tBufferSize > 0) && (mSenderNeeded))
-            {
                 #ifdef MSIN_DEBUG_PACKETS
                     if (tBufferedPackets > 2)
                         LOG(LOG_WARN, "%d/%d %s packets are already buffered for relaying to %s", tBufferedPackets, mSinkFifo->GetSize(), mCodec.c_str(), GetId().c_str());
                     else
-                        LOG(LOG_VERBOSE, "Sending packet %d with %d bytes, %d remaining packets in queue", (int)tFragmentNumber, tBufferSize, tBufferedPackets);
+                        LOG(LOG_VERBOSE, "Sending packet with %d bytes, queued for %"PRId64" us, %d remaining packets in queue", tBufferSize, Time::GetMonotonicTimeStamp() - tQueueTime, tBufferedPackets);
                 #endif
+            }while((tBatchSize < MSIN_SEND_BATCH_SIZE) && (mSinkFifo->GetUsage() > 0));
 
-                SendPacket(tBuffer, tBufferSize);
-            }
-
-            // release FIFO entry lock
-            mSinkFifo->ReadFifoExclusiveFinished(tFifoEntry);
+            if ((mSenderNeeded) && (tDatagramCount > 0))
+                SendPacketsPaced(tDatagrams, tQueueTimes, tDatagramCount);
 
-            if (tBufferSize == 0)
-            {
-                LOG(LOG_VERBOSE, "Zero byte %s packet in relay thread detected", GetDataTypeStr().c_str());
-            }
-
-            // is FIFO near overload situation?
-            if (mSinkFifo->GetUsage() >= mSinkFifo->GetSize() - 4)
-            {
-                LOG(LOG_WARN, "Relay FIFO is near overload situation, deleting all stored frames");
-
-                // delete all stored frames: it is a better for the encoding to have a gap instead of frames which have high picture differences
-                mSinkFifo->ClearFifo();
-            }
+            // release FIFO entry locks
+            for (int i = 0; i < tBatchSize; i++)
+                mSinkFifo->ReadFifoExclusiveFinished(tFifoEntries[i]);
         }else
         {
             LOG(LOG_VERBOSE, "Suspending the sender thread for 10 ms");
@@ -440,6 +772,97 @@ void* MediaSinkNet::Run(void* pArgs)
     return NULL;
 }
 
+void MediaSinkNet::SendPacketsPaced(SocketDatagram *pDatagrams, int64_t *pQueueTimes, int pDatagramCount)
+{
+    int tFirstDatagram = 0;
+
+    mPacer->SetTargetBitRate(GetTargetBitRate());
+    for (int i = 0; i < pDatagramCount; i++)
+    {
+        int64_t tNow = Time::GetMonotonicTimeStamp();
+        int64_t tDelay = mPacer->GetSendDelay(pQueueTimes[i], tNow);
+        if (tDelay > 0)
+        {
+            // the packets in front of the current one are sent as one batch
+            if (i > tFirstDatagram)
+                SendPackets(&pDatagrams[tFirstDatagram], i - tFirstDatagram);
+            tFirstDatagram = i;
+
+            #ifdef MSIN_DEBUG_TIMING
+                LOG(LOG_VERBOSE, "Pacing delays %s packet by %"PRId64" us, pacing rate: %d bit/s", GetDataTypeStr().c_str(), tDelay, mPacer->GetPacingRate());
+            #endif
+            RTPPacer::Wait(tDelay);
+            tNow = Time::GetMonotonicTimeStamp();
+        }
+        mPacer->AnnounceSentPacket((int)pDatagrams[i].BufferSize, pQueueTimes[i], tNow);
+    }
+    SendPackets(&pDatagrams[tFirstDatagram], pDatagramCount - tFirstDatagram);
+
+    SetPacingStatistic(mPacer->GetQueueDelay());
+}
+
+void MediaSinkNet::SendPackets(SocketDatagram *pDatagrams, int pDatagramCount)
+{
+    // simulated packet loss and packet debugging need the per-packet path
+    #if (MSIN_SIMULATED_PACKET_LOSS == 0) && (!defined(MSIN_DEBUG_PACKETS))
+        if ((((!mNAPIUsed) && (mDataSocket != NULL)) || ((mNAPIUsed) && (mNAPIDataSocket != NULL))) && (pDatagramCount > 1) && (pDatagramCount <= MSIN_SEND_BATCH_SIZE))
+        {
+            if ((mTargetHost == "") || (mTargetPort == 0))
+            {
+                LOG(LOG_ERROR, "Remote network address invalid: %s:%u", mTargetHost.c_str(), mTargetPort);
+                return;
+            }
+            if (mBrokenPipe)
+            {
+                LOG(LOG_VERBOSE, "Skipped transmission of %d fragments because of broken pipe", pDatagramCount);
+                return;
+            }
+
+            #ifdef MSIN_DEBUG_TIMING
+                int64_t tTime = Time::GetMonotonicTimeStamp();
+            #endif
+            if (mNAPIUsed)
+            {
+                // the NAPI implementation decides about the batching, e.g., io_uring submits the whole batch at once
+                char *tBuffers[MSIN_SEND_BATCH_SIZE];
+                int tBufferSizes[MSIN_SEND_BATCH_SIZE];
+                for (int i = 0; i < pDatagramCount; i++)
+                {
+                    tBuffers[i] = (char*)pDatagrams[i].Buffer;
+                    tBufferSizes[i] = (int)pDatagrams[i].BufferSize;
+                }
+                mNAPIDataSocket->writeBatch(tBuffers, tBufferSizes, pDatagramCount);
+                if (mNAPIDataSocket->isClosed())
+                {
+                    LOG(LOG_ERROR, "Error when sending data through NAPI connection to %s:%u, will skip further transmissions", mTargetHost.c_str(), mTargetPort);
+                    mBrokenPipe = true;
+                }
+            }else
+            {
+                bool tSent;
+                if (mPeerBound)
+                    tSent = mDataSocket->SendBatch(pDatagrams, pDatagramCount);
+                else
+                    tSent = mDataSocket->SendBatch(mTargetHost, mTargetPort, pDatagrams, pDatagramCount);
+                if (!tSent)
+                {
+                    LOG(LOG_ERROR, "Error when sending data through %s socket to %s:%u, will skip further transmissions", GetTransportTypeStr().c_str(), mTargetHost.c_str(), mTargetPort);
+                    mBrokenPipe = true;
+                }
+            }
+            #ifdef MSIN_DEBUG_TIMING
+                int64_t tTime2 = Time::GetMonotonicTimeStamp();
+                LOG(LOG_VERBOSE, "       sending %d packets took %"PRId64" us", pDatagramCount, tTime2 - tTime);
+            #endif
+
+            return;
+        }
+    #endif
+
+    for (int i = 0; i < pDatagramCount; i++)
+        SendPacket((char*)pDatagrams[i].Buffer, (unsigned int)pDatagrams[i].BufferSize);
+}
+
 void MediaSinkNet::SendPacket(char* pData, unsigned int pSize)
 {
     if ((mTargetHost == "") || (mTargetPort == 0))
@@ -486,7 +909,7 @@ void MediaSinkNet::SendPacket(char* pData, unsigned int pSize)
         }
     #endif
 
-    int64_t tTime = Time::GetTimeStamp();
+    int64_t tTime = Time::GetMonotonicTimeStamp();
     if(mNAPIUsed)
     {
         if (mNAPIDataSocket != NULL)
@@ -502,7 +925,12 @@ void MediaSinkNet::SendPacket(char* pData, unsigned int pSize)
     {
         if (mDataSocket != NULL)
         {
-            if (!mDataSocket->Send(mTargetHost, mTargetPort, pData, (ssize_t)pSize))
+            bool tSent;
+            if (mPeerBound)
+                tSent = mDataSocket->Send(pData, (ssize_t)pSize);
+            else
+                tSent = mDataSocket->Send(mTargetHost, mTargetPort, pData, (ssize_t)pSize);
+            if (!tSent)
             {
                 LOG(LOG_ERROR, "Error when sending data through %s socket to %s:%u, will skip further transmissions", GetTransportTypeStr().c_str(), mTargetHost.c_str(), mTargetPort);
                 mBrokenPipe = true;
@@ -510,7 +938,7 @@ void MediaSinkNet::SendPacket(char* pData, unsigned int pSize)
         }
     }
     #ifdef MSIN_DEBUG_TIMING
-        int64_t tTime2 = Time::GetTimeStamp();
+        int64_t tTime2 = Time::GetMonotonicTimeStamp();
         LOG(LOG_VERBOSE, "       sending a packet of %u bytes took %"PRId64" us", pSize, tTime2 - tTime);
     #endif
 }
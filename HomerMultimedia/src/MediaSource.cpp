@@ -122,6 +122,11 @@ MediaSource::MediaSource(string pName):
         mResampleFifo[i] = NULL;
     mGrabMutex.AssignName("GrabMutex");
 	mMediaSinksMutex.AssignName("MediaSinksMutex");
+	mMediaSinksSnapshotMutex.AssignName("MediaSinksSnapshotMutex");
+	mMediaSinksSnapshot = new MediaSinksSnapshot();
+	mMediaSinksSnapshot->References = 1;
+	mRelayStreamName = "";
+	mRelayStreamNameTimestamp = 0;
 	mMediaFiltersMutex.AssignName("MediaFiltersMutex");
 
     FfmpegInit();
@@ -181,6 +186,7 @@ MediaSource::~MediaSource()
 {
     DeleteAllRegisteredMediaSinks();
     DeleteAllRegisteredMediaFilters();
+    ReleaseMediaSinks(mMediaSinksSnapshot);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1079,7 +1085,7 @@ bool MediaSource::WaitForRTGrabbing()
         int64_t tDesiredPlayOutTime = mRTGrabbingFrameTimestamps.front() + tTimeDiffForHistory;
 
         // get the time since last successful grabbing
-        int64_t tWaitingTine = tDesiredPlayOutTime - Time::GetTimeStamp(); // in us
+        int64_t tWaitingTine = tDesiredPlayOutTime - Time::GetMonotonicTimeStamp(); // in us
 
         if (tWaitingTine > 0)
         {// skip capturing when we are too fast
@@ -1098,7 +1104,7 @@ bool MediaSource::WaitForRTGrabbing()
     }
 
     // store current timestamp
-    mRTGrabbingFrameTimestamps.push_back(Time::GetTimeStamp());
+    mRTGrabbingFrameTimestamps.push_back(Time::GetMonotonicTimeStamp());
 
     return true;
 }
@@ -1325,6 +1331,7 @@ MediaSinkNet* MediaSource::RegisterMediaSink(string pTarget, Requirements *pTran
         MediaSinkNet *tMediaSinkNet = new MediaSinkNet(pTarget, pTransportRequirements, (mMediaType == MEDIA_VIDEO) ? MEDIA_SINK_VIDEO : MEDIA_SINK_AUDIO, pRtpActivation);
         tMediaSinkNet->SetMaxFps(pMaxFps);
         mMediaSinks.push_back(tMediaSinkNet);
+        PublishMediaSinks();
         tResult = tMediaSinkNet;
     }
 
@@ -1338,6 +1345,7 @@ bool MediaSource::UnregisterMediaSink(string pTarget, Requirements *pTransportRe
 {
     bool tResult = false;
     MediaSinks::iterator tIt;
+    MediaSink *tMediaSink = NULL;
     string tId = pTarget + "[" + pTransportRequirements->getDescription() + "]";
 
     if (pTarget == "")
@@ -1355,12 +1363,7 @@ bool MediaSource::UnregisterMediaSink(string pTarget, Requirements *pTransportRe
             LOG(LOG_VERBOSE, "Found registered sink");
 
             tResult = true;
-            // free memory of media sink object
-            if (pAutoDelete)
-            {
-                delete (*tIt);
-                LOG(LOG_VERBOSE, "..deleted");
-            }
+            tMediaSink = *tIt;
             // remove registration of media sink object
             mMediaSinks.erase(tIt);
             LOG(LOG_VERBOSE, "..unregistered");
@@ -1368,6 +1371,19 @@ bool MediaSource::UnregisterMediaSink(string pTarget, Requirements *pTransportRe
         }
     }
 
+    if (tResult)
+    {
+        // the relaying threads may still use the media sink
+        PublishMediaSinks(true);
+
+        // free memory of media sink object
+        if (pAutoDelete)
+        {
+            delete tMediaSink;
+            LOG(LOG_VERBOSE, "..deleted");
+        }
+    }
+
     // unlock
     mMediaSinksMutex.unlock();
 
@@ -1492,6 +1508,10 @@ MediaSinkNet* MediaSource::RegisterMediaSink(string pTargetHost, unsigned int pT
         return NULL;
     }
 
+    // a multicast group isn't reachable via the shared socket of a conference, one stream serves all viewers in the local network
+    if (Socket::IsMulticastAddress(pTargetHost))
+        return RegisterMediaSink(pTargetHost, pTargetPort, pSocket->GetTransportType(), pRtpActivation, pMaxFps);
+
     LOG(LOG_VERBOSE, "Registering Berkeley sockets based media sink: %s<%d>", pTargetHost.c_str(), pTargetPort);
 
     // lock
@@ -1512,6 +1532,57 @@ MediaSinkNet* MediaSource::RegisterMediaSink(string pTargetHost, unsigned int pT
         MediaSinkNet *tMediaSinkNet = new MediaSinkNet(pTargetHost, pTargetPort, pSocket, (mMediaType == MEDIA_VIDEO) ? MEDIA_SINK_VIDEO : MEDIA_SINK_AUDIO, pRtpActivation);
         tMediaSinkNet->SetMaxFps(pMaxFps);
         mMediaSinks.push_back(tMediaSinkNet);
+        PublishMediaSinks();
+        tResult = tMediaSinkNet;
+    }
+
+    // unlock
+    mMediaSinksMutex.unlock();
+
+    return tResult;
+}
+
+MediaSinkNet* MediaSource::RegisterMediaSink(string pTargetGroup, unsigned int pTargetPort, enum TransportType pTransportType, bool pRtpActivation, int pMaxFps, int pTtl, string pInterface)
+{
+    MediaSinks::iterator tIt;
+    bool tFound = false;
+    MediaSinkNet *tResult = NULL;
+    string tId = MediaSinkNet::CreateId(pTargetGroup, toString(pTargetPort));
+
+    if ((pTargetGroup == "") || (pTargetPort == 0))
+    {
+        LOG(LOG_ERROR, "Sink is ignored because its target is undefined");
+        return NULL;
+    }
+
+    if (!Socket::IsMulticastAddress(pTargetGroup))
+    {
+        LOG(LOG_ERROR, "Sink is ignored because %s is no multicast group", pTargetGroup.c_str());
+        return NULL;
+    }
+
+    LOG(LOG_VERBOSE, "Registering multicast based media sink: %s<%d>", pTargetGroup.c_str(), pTargetPort);
+
+    // lock
+    mMediaSinksMutex.lock();
+
+    // the group is served only once, independent of the transport
+    for (tIt = mMediaSinks.begin(); tIt != mMediaSinks.end(); tIt++)
+    {
+        if ((*tIt)->GetId().find(tId) != string::npos)
+        {
+            LOG(LOG_WARN, "Sink already registered");
+            tFound = true;
+            break;
+        }
+    }
+
+    if (!tFound)
+    {
+        MediaSinkNet *tMediaSinkNet = new MediaSinkNet(pTargetGroup, pTargetPort, pTransportType, (mMediaType == MEDIA_VIDEO) ? MEDIA_SINK_VIDEO : MEDIA_SINK_AUDIO, pRtpActivation, pTtl, pInterface);
+        tMediaSinkNet->SetMaxFps(pMaxFps);
+        mMediaSinks.push_back(tMediaSinkNet);
+        PublishMediaSinks();
         tResult = tMediaSinkNet;
     }
 
@@ -1525,6 +1596,7 @@ bool MediaSource::UnregisterMediaSink(string pTargetHost, unsigned int pTargetPo
 {
     bool tResult = false;
     MediaSinks::iterator tIt;
+    MediaSink *tMediaSink = NULL;
     string tId = MediaSinkNet::CreateId(pTargetHost, toString(pTargetPort));
 
     if ((pTargetHost == "") || (pTargetPort == 0))
@@ -1542,12 +1614,7 @@ bool MediaSource::UnregisterMediaSink(string pTargetHost, unsigned int pTargetPo
             LOG(LOG_VERBOSE, "Found registered sink");
 
             tResult = true;
-            // free memory of media sink object
-            if (pAutoDelete)
-            {
-                delete (*tIt);
-                LOG(LOG_VERBOSE, "..deleted");
-            }
+            tMediaSink = *tIt;
             // remove registration of media sink object
             mMediaSinks.erase(tIt);
             LOG(LOG_VERBOSE, "..unregistered");
@@ -1555,6 +1622,19 @@ bool MediaSource::UnregisterMediaSink(string pTargetHost, unsigned int pTargetPo
         }
     }
 
+    if (tResult)
+    {
+        // the relaying threads may still use the media sink
+        PublishMediaSinks(true);
+
+        // free memory of media sink object
+        if (pAutoDelete)
+        {
+            delete tMediaSink;
+            LOG(LOG_VERBOSE, "..deleted");
+        }
+    }
+
     // unlock
     mMediaSinksMutex.unlock();
 
@@ -1593,6 +1673,7 @@ MediaSinkFile* MediaSource::RegisterMediaSink(string pTargetFile, bool pRtpActiv
     {
         MediaSinkFile *tMediaSinkFile = new MediaSinkFile(pTargetFile, (mMediaType == MEDIA_VIDEO)?MEDIA_SINK_VIDEO:MEDIA_SINK_AUDIO, pRtpActivation);
         mMediaSinks.push_back(tMediaSinkFile);
+        PublishMediaSinks();
         tResult = tMediaSinkFile;
     }
 
@@ -1606,6 +1687,7 @@ bool MediaSource::UnregisterMediaSink(string pTargetFile, bool pAutoDelete)
 {
     bool tResult = false;
     MediaSinks::iterator tIt;
+    MediaSink *tMediaSink = NULL;
     string tId = pTargetFile;
 
     if (pTargetFile == "")
@@ -1623,12 +1705,7 @@ bool MediaSource::UnregisterMediaSink(string pTargetFile, bool pAutoDelete)
             LOG(LOG_VERBOSE, "Found registered sink");
 
             tResult = true;
-            // free memory of media sink object
-            if (pAutoDelete)
-            {
-                delete (*tIt);
-                LOG(LOG_VERBOSE, "..deleted");
-            }
+            tMediaSink = *tIt;
             // remove registration of media sink object
             mMediaSinks.erase(tIt);
             LOG(LOG_VERBOSE, "..unregistered");
@@ -1636,6 +1713,19 @@ bool MediaSource::UnregisterMediaSink(string pTargetFile, bool pAutoDelete)
         }
     }
 
+    if (tResult)
+    {
+        // the relaying threads may still use the media sink
+        PublishMediaSinks(true);
+
+        // free memory of media sink object
+        if (pAutoDelete)
+        {
+            delete tMediaSink;
+            LOG(LOG_VERBOSE, "..deleted");
+        }
+    }
+
     // unlock
     mMediaSinksMutex.unlock();
 
@@ -1670,7 +1760,10 @@ MediaSink* MediaSource::RegisterMediaSink(MediaSink* pMediaSink)
     }
 
     if (!tFound)
+    {
         mMediaSinks.push_back(pMediaSink);
+        PublishMediaSinks();
+    }
 
     // unlock
     mMediaSinksMutex.unlock();
@@ -1682,6 +1775,7 @@ bool MediaSource::UnregisterMediaSink(MediaSink* pMediaSink, bool pAutoDelete)
 {
     bool tResult = false;
     MediaSinks::iterator tIt;
+    MediaSink *tMediaSink = NULL;
     string tId = pMediaSink->GetId();
 
     if (tId == "")
@@ -1699,12 +1793,7 @@ bool MediaSource::UnregisterMediaSink(MediaSink* pMediaSink, bool pAutoDelete)
             LOG(LOG_VERBOSE, "Found registered sink");
 
             tResult = true;
-            // free memory of media sink object
-            if (pAutoDelete)
-            {
-                delete (*tIt);
-                LOG(LOG_VERBOSE, "..deleted");
-            }
+            tMediaSink = *tIt;
             // remove registration of media sink object
             mMediaSinks.erase(tIt);
             LOG(LOG_VERBOSE, "..unregistered");
@@ -1712,6 +1801,19 @@ bool MediaSource::UnregisterMediaSink(MediaSink* pMediaSink, bool pAutoDelete)
         }
     }
 
+    if (tResult)
+    {
+        // the relaying threads may still use the media sink
+        PublishMediaSinks(true);
+
+        // free memory of media sink object
+        if (pAutoDelete)
+        {
+            delete tMediaSink;
+            LOG(LOG_VERBOSE, "..deleted");
+        }
+    }
+
     // unlock
     mMediaSinksMutex.unlock();
 
@@ -1722,6 +1824,7 @@ bool MediaSource::UnregisterGeneralMediaSink(string pId, bool pAutoDelete)
 {
     bool tResult = false;
     MediaSinks::iterator tIt;
+    MediaSink *tMediaSink = NULL;
 
     if (pId == "")
         return false;
@@ -1738,12 +1841,7 @@ bool MediaSource::UnregisterGeneralMediaSink(string pId, bool pAutoDelete)
             LOG(LOG_VERBOSE, "Found registered sink");
 
             tResult = true;
-            // free memory of media sink object
-            if (pAutoDelete)
-            {
-                delete (*tIt);
-                LOG(LOG_VERBOSE, "..deleted");
-            }
+            tMediaSink = *tIt;
             // remove registration of media sink object
             mMediaSinks.erase(tIt);
             LOG(LOG_VERBOSE, "..unregistered");
@@ -1751,6 +1849,19 @@ bool MediaSource::UnregisterGeneralMediaSink(string pId, bool pAutoDelete)
         }
     }
 
+    if (tResult)
+    {
+        // the relaying threads may still use the media sink
+        PublishMediaSinks(true);
+
+        // free memory of media sink object
+        if (pAutoDelete)
+        {
+            delete tMediaSink;
+            LOG(LOG_VERBOSE, "..deleted");
+        }
+    }
+
     // unlock
     mMediaSinksMutex.unlock();
 
@@ -1762,21 +1873,14 @@ vector<string> MediaSource::ListRegisteredMediaSinks()
     vector<string> tResult;
     MediaSinks::iterator tIt;
 
-    // lock
-    if (mMediaSinksMutex.lock(100))
+    MediaSinksSnapshot *tSnapshot = AcquireMediaSinks();
+
+    for (tIt = tSnapshot->Sinks.begin(); tIt != tSnapshot->Sinks.end(); tIt++)
     {
-        if(mMediaSinks.size() > 0)
-        {
-            for (tIt = mMediaSinks.begin(); tIt != mMediaSinks.end(); tIt++)
-            {
-                tResult.push_back((*tIt)->GetId());
-            }
-        }
+        tResult.push_back((*tIt)->GetId());
+    }
 
-        // unlock
-        mMediaSinksMutex.unlock();
-    }else
-        LOG(LOG_WARN, "Failed to lock mutex in specified time");
+    ReleaseMediaSinks(tSnapshot);
 
     return tResult;
 }
@@ -1784,25 +1888,24 @@ vector<string> MediaSource::ListRegisteredMediaSinks()
 void MediaSource::DeleteAllRegisteredMediaSinks()
 {
     MediaSinks::iterator tIt;
+    MediaSinks tMediaSinks;
 
     // lock
     mMediaSinksMutex.lock();
 
-    while(mMediaSinks.size())
-    {
-        for (tIt = mMediaSinks.begin(); tIt != mMediaSinks.end(); tIt++)
-        {
-            LOG(LOG_VERBOSE, "Deleting registered sink %s", (*tIt)->GetId().c_str());
+    // remove registration of all media sink objects
+    tMediaSinks.swap(mMediaSinks);
 
-            // free memory of media sink object
-            delete (*tIt);
-            LOG(LOG_VERBOSE, "..deleted");
+    // the relaying threads may still use the media sinks
+    PublishMediaSinks(true);
 
-            // remove registration of media sink object
-            mMediaSinks.erase(tIt);
-            LOG(LOG_VERBOSE, "..unregistered");
-            break;
-        }
+    for (tIt = tMediaSinks.begin(); tIt != tMediaSinks.end(); tIt++)
+    {
+        LOG(LOG_VERBOSE, "Deleting registered sink %s", (*tIt)->GetId().c_str());
+
+        // free memory of media sink object
+        delete (*tIt);
+        LOG(LOG_VERBOSE, "..deleted");
     }
 
     // unlock
@@ -1846,23 +1949,24 @@ void MediaSource::RelayAVPacketToMediaSinks(AVPacket *pAVPacket)
 {
     MediaSinks::iterator tIt;
 
-    // lock
-    mMediaSinksMutex.lock();
+    // the media sinks only queue the packet, hence a registration isn't blocked for long
+    MediaSinksSnapshot *tSnapshot = AcquireMediaSinks();
 
     #ifdef MS_DEBUG_PACKETS
-        LOG(LOG_VERBOSE, "Relaying packet for %s %s media source to %d media sinks", GetMediaTypeStr().c_str(), GetSourceTypeStr().c_str(), mMediaSinks.size());
+        LOG(LOG_VERBOSE, "Relaying packet for %s %s media source to %d media sinks", GetMediaTypeStr().c_str(), GetSourceTypeStr().c_str(), tSnapshot->Sinks.size());
     #endif
 
-    if (mMediaSinks.size() > 0)
+    if (tSnapshot->Sinks.size() > 0)
     {
-        for (tIt = mMediaSinks.begin(); tIt != mMediaSinks.end(); tIt++)
+        AVStream *tStream = (mFormatContext != NULL ? mFormatContext->streams[0] : NULL);
+        const string &tStreamName = GetRelayStreamName();
+        for (tIt = tSnapshot->Sinks.begin(); tIt != tSnapshot->Sinks.end(); tIt++)
         {
-            (*tIt)->ProcessPacket(pAVPacket, (mFormatContext != NULL ? mFormatContext->streams[0] : NULL), GetCurrentDeviceName());
+            (*tIt)->ProcessPacket(pAVPacket, tStream, tStreamName);
         }
     }
 
-    // unlock
-    mMediaSinksMutex.unlock();
+    ReleaseMediaSinks(tSnapshot);
 }
 
 void MediaSource::RelaySyncTimestampToMediaSinks(int64_t pReferenceNtpTimestamp, int64_t pReferenceFrameTimestamp)
@@ -1873,19 +1977,103 @@ void MediaSource::RelaySyncTimestampToMediaSinks(int64_t pReferenceNtpTimestamp,
         LOG(LOG_VERBOSE, "Update synch. for all media sinks");
     #endif
 
-    // lock
-    mMediaSinksMutex.lock();
+    MediaSinksSnapshot *tSnapshot = AcquireMediaSinks();
+
+    for (tIt = tSnapshot->Sinks.begin(); tIt != tSnapshot->Sinks.end(); tIt++)
+    {
+        (*tIt)->UpdateSynchronization(pReferenceNtpTimestamp, pReferenceFrameTimestamp);
+    }
+
+    ReleaseMediaSinks(tSnapshot);
+}
+
+MediaSinksSnapshot* MediaSource::AcquireMediaSinks()
+{
+    MediaSinksSnapshot *tResult;
+
+    mMediaSinksSnapshotMutex.lock();
+    tResult = mMediaSinksSnapshot;
+    tResult->References++;
+    mMediaSinksSnapshotMutex.unlock();
+
+    return tResult;
+}
+
+void MediaSource::ReleaseMediaSinks(MediaSinksSnapshot *pSnapshot)
+{
+    bool tUnused;
+
+    mMediaSinksSnapshotMutex.lock();
+    pSnapshot->References--;
+    tUnused = (pSnapshot->References == 0);
+    // an unregistering thread might wait for the last relaying thread
+    if (pSnapshot->References == 1)
+        mMediaSinksSnapshotReleased.Signal();
+    mMediaSinksSnapshotMutex.unlock();
 
-    if (mMediaSinks.size() > 0)
+    if (tUnused)
+        delete pSnapshot;
+}
+
+// HINT: has to be called with locked mMediaSinksMutex
+void MediaSource::PublishMediaSinks(bool pWaitForRelaying)
+{
+    MediaSinksSnapshot *tSnapshot = new MediaSinksSnapshot();
+    MediaSinksSnapshot *tOldSnapshot;
+    int tRounds = 0;
+
+    tSnapshot->Sinks = mMediaSinks;
+    tSnapshot->References = 1;
+
+    mMediaSinksSnapshotMutex.lock();
+    tOldSnapshot = mMediaSinksSnapshot;
+    mMediaSinksSnapshot = tSnapshot;
+    if (!pWaitForRelaying)
     {
-        for (tIt = mMediaSinks.begin(); tIt != mMediaSinks.end(); tIt++)
+        mMediaSinksSnapshotMutex.unlock();
+
+        // the last relaying thread deletes the old snapshot
+        ReleaseMediaSinks(tOldSnapshot);
+        return;
+    }
+
+    // the reference of the media source is used for waiting, the relaying threads hold the others
+    while (tOldSnapshot->References > 1)
+    {
+        if (!mMediaSinksSnapshotReleased.Wait(&mMediaSinksSnapshotMutex, MEDIA_SOURCE_RELAY_RELEASE_WARN_PERIOD))
         {
-            (*tIt)->UpdateSynchronization(pReferenceNtpTimestamp, pReferenceFrameTimestamp);
+            if (tOldSnapshot->References > 1)
+                LOG(LOG_WARN, "Waiting %d ms for %d relaying threads of %s %s media source, system has high load", ++tRounds * MEDIA_SOURCE_RELAY_RELEASE_WARN_PERIOD, tOldSnapshot->References - 1, GetMediaTypeStr().c_str(), GetSourceTypeStr().c_str());
         }
     }
+    mMediaSinksSnapshotMutex.unlock();
 
-    // unlock
-    mMediaSinksMutex.unlock();
+    delete tOldSnapshot;
+}
+
+string MediaSource::GetRelayStreamName()
+{
+    string tResult;
+    int64_t tTime = Time::GetMonotonicTimeStamp();
+    bool tRefresh;
+
+    // several relaying threads share the cache, the name is copied because another thread may refresh it
+    mMediaSinksSnapshotMutex.lock();
+    tRefresh = ((mRelayStreamNameTimestamp == 0) || (tTime - mRelayStreamNameTimestamp > MEDIA_SOURCE_RELAY_STREAM_NAME_REFRESH * 1000));
+    if (!tRefresh)
+        tResult = mRelayStreamName;
+    mMediaSinksSnapshotMutex.unlock();
+
+    if (tRefresh)
+    {
+        tResult = GetCurrentDeviceName();
+        mMediaSinksSnapshotMutex.lock();
+        mRelayStreamName = tResult;
+        mRelayStreamNameTimestamp = tTime;
+        mMediaSinksSnapshotMutex.unlock();
+    }
+
+    return tResult;
 }
 
 bool MediaSource::StartRecording(std::string pSaveFileName, int pSaveFileQuality)
@@ -2272,7 +2460,7 @@ bool MediaSource::StartRecording(std::string pSaveFileName, int pSaveFileQuality
     mRecorderFrameNumber = 0;
     mRecordingSaveFileName = pSaveFileName;
     mRecording = true;
-    mRecorderStart = av_gettime();
+    mRecorderStart = Time::GetMonotonicTimeStamp();
 
     return true;
 }
@@ -2374,7 +2562,7 @@ int64_t MediaSource::RecordingTime()
     int64_t tResult = 0;
 
     if (IsRecording())
-        tResult = (av_gettime() - mRecorderStart) / 1000 / 1000;
+        tResult = (Time::GetMonotonicTimeStamp() - mRecorderStart) / 1000 / 1000;
 
     return tResult;
 }
@@ -3074,12 +3262,12 @@ MetaData MediaSource::GetMetaData()
 
 void MediaSource::InitFpsEmulator()
 {
-    mSourceStartTimeForRTGrabbing = av_gettime();
+    mSourceStartTimeForRTGrabbing = Time::GetMonotonicTimeStamp();
 }
 
 int64_t MediaSource::GetPtsFromFpsEmulator()
 {
-    int64_t tRelativeRealTimeUSecs = av_gettime() - mSourceStartTimeForRTGrabbing; // relative playback time in usecs
+    int64_t tRelativeRealTimeUSecs = Time::GetMonotonicTimeStamp() - mSourceStartTimeForRTGrabbing; // relative playback time in usecs
     float tRelativeFrameNumber = GetInputFrameRate() * tRelativeRealTimeUSecs / AV_TIME_BASE;
     return (int64_t)tRelativeFrameNumber;
 }
@@ -3201,7 +3389,7 @@ void MediaSource::EventOpenGrabDeviceSuccessful(string pSource, int pLine)
     mDecodedBIFrames = 0;
 }
 
-void MediaSource::EventGrabChunkSuccessful(string pSource, int pLine, int pChunkNumber)
+void MediaSource::EventGrabChunkSuccessful(const string &pSource, int pLine, int pChunkNumber)
 {
     if (mLastGrabResultWasError)
     {
@@ -3222,7 +3410,7 @@ void MediaSource::EventGrabChunkSuccessful(string pSource, int pLine, int pChunk
     mLastGrabResultWasError = false;
 }
 
-void MediaSource::EventGrabChunkFailed(string pSource, int pLine, string pReason)
+void MediaSource::EventGrabChunkFailed(const string &pSource, int pLine, const string &pReason)
 {
     if ((!mLastGrabResultWasError) || (mLastGrabFailureReason != pReason))
     {
@@ -662,8 +662,8 @@ void MediaSourceFile::CalibrateRTGrabbing()
     // adopt the stored pts value which represent the start of the media presentation in real-time useconds
     float  tRelativeFrameIndex = mCurrentOutputFrameIndex - CalculateOutputFrameNumber(mInputStartPts);
     double tRelativeTime = (int64_t)((double)AV_TIME_BASE * tRelativeFrameIndex / GetOutputFrameRate());
-    LOG(LOG_WARN, "Calibrating %s RT playback, current frame: %.2lf, source start: %.2lf, RT ref. time: %.2f->%.2f(diff: %.2f)", GetMediaTypeStr().c_str(), mCurrentOutputFrameIndex, mInputStartPts, mSourceStartTimeForRTGrabbing, (float)av_gettime() - tRelativeTime, (float)av_gettime() - tRelativeTime -mSourceStartTimeForRTGrabbing);
-    mSourceStartTimeForRTGrabbing = av_gettime() - tRelativeTime; //HINT: no "+ mDecoderFramePreBufferTime * AV_TIME_BASE" here because we start playback immediately
+    LOG(LOG_WARN, "Calibrating %s RT playback, current frame: %.2lf, source start: %.2lf, RT ref. time: %.2f->%.2f(diff: %.2f)", GetMediaTypeStr().c_str(), mCurrentOutputFrameIndex, mInputStartPts, mSourceStartTimeForRTGrabbing, (float)Time::GetMonotonicTimeStamp() - tRelativeTime, (float)Time::GetMonotonicTimeStamp() - tRelativeTime -mSourceStartTimeForRTGrabbing);
+    mSourceStartTimeForRTGrabbing = Time::GetMonotonicTimeStamp() - tRelativeTime; //HINT: no "+ mDecoderFramePreBufferTime * AV_TIME_BASE" here because we start playback immediately
     #ifdef MSMEM_DEBUG_CALIBRATION
         LOG(LOG_WARN, "Calibrating %s RT playback: new PTS start: %.2f, rel. frame index: %.2f, rel. time: %.2f ms", GetMediaTypeStr().c_str(), mSourceStartTimeForRTGrabbing, tRelativeFrameIndex, (float)(tRelativeTime / 1000));
     #endif
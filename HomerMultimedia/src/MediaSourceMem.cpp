@@ -28,9 +28,13 @@
 //HINT: The remaining parts of the frame buffer are used to compensate situations with a high system load.
 
 #include <MediaSourceMem.h>
+#include <MediaFifoSpsc.h>
 #include <MediaSource.h>
 #include <ProcessStatisticService.h>
 #include <RTP.h>
+#include <RTPJitterBuffer.h>
+#include <RTPFecDecoder.h>
+#include <RTPForwarder.h>
 
 #include <Logger.h>
 #include <HBSystem.h>
@@ -68,6 +72,27 @@ using namespace Homer::Base;
 // how much delay for frame playback do we allow before we drop the frame?
 #define MEDIA_SOURCE_MEM_FRAME_DROP_THRESHOLD                               0.4 // seconds
 
+// de/activate reordering of received RTP packets by default
+#define MEDIA_SOURCE_MEM_USE_JITTER_BUFFER
+
+// de/activate NACKs for missing video packets by default
+#define MEDIA_SOURCE_MEM_USE_RETRANSMISSION_REQUESTS
+
+// how often do we send an RTCP receiver report to the remote sender?
+#define MEDIA_SOURCE_MEM_RECEIVER_REPORT_PERIOD                             1000 // ms
+
+// min. time between two key frame requests (PLI/FIR) towards the remote sender
+#define MEDIA_SOURCE_MEM_KEY_FRAME_REQUEST_PERIOD                           500 // ms
+
+// how long do we wait for a key frame from the cache of the remote sender before we send a FIR after joining a stream?
+#define MEDIA_SOURCE_MEM_JOIN_KEY_FRAME_TIMEOUT                             500 // ms
+
+// pseudo FIFO entry for fragments which are delivered from the jitter buffer
+#define MEDIA_SOURCE_MEM_JITTER_BUFFER_ENTRY                                -2
+
+// pseudo FIFO entry for packets which were recovered by FEC
+#define MEDIA_SOURCE_MEM_FEC_ENTRY                                          -3
+
 ///////////////////////////////////////////////////////////////////////////////
 
 MediaSourceMem::MediaSourceMem(string pName):
@@ -96,7 +121,6 @@ MediaSourceMem::MediaSourceMem(string pName):
     mGrabberProvidesRTGrabbing = true;
     mSourceType = SOURCE_MEMORY;
     mStreamPacketBuffer = (char*)malloc(MEDIA_SOURCE_MEM_STREAM_PACKET_BUFFER_SIZE);
-    mFragmentBuffer = (char*)malloc(MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
     mFragmentNumber = 0;
     mPacketStatAdditionalFragmentSize = 0;
     mOpenInputStream = false;
@@ -105,8 +129,32 @@ MediaSourceMem::MediaSourceMem(string pName):
     mRtpSourceCodecIdHint = AV_CODEC_ID_NONE;
     mSourceCodecId = AV_CODEC_ID_NONE;
 
-    mDecoderFragmentFifo = new MediaFifo(MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE, "MediaSourceMem-Fragments");
+    // the fragment FIFO has exactly one writer (e.g., the network listener) and one reader (the decoder input)
+    mDecoderFragmentFifo = new MediaFifoSpsc(MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT, MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE, "MediaSourceMem-Fragments");
     LOG(LOG_VERBOSE, "Listen for video/audio frames with queue of %d bytes", MEDIA_SOURCE_MEM_FRAGMENT_INPUT_QUEUE_SIZE_LIMIT * MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
+
+    // RTP packets are reordered between the fragment FIFO and the RTP parser
+    mJitterBuffer = new RTPJitterBuffer(MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
+    #ifdef MEDIA_SOURCE_MEM_USE_JITTER_BUFFER
+        mJitterBufferActive = true;
+    #else
+        mJitterBufferActive = false;
+    #endif
+    #ifdef MEDIA_SOURCE_MEM_USE_RETRANSMISSION_REQUESTS
+        mRetransmissionRequestsActive = true;
+    #else
+        mRetransmissionRequestsActive = false;
+    #endif
+
+    // lost RTP packets are recovered before they are reordered
+    mFecDecoder = new RTPFecDecoder(MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
+    mReceiverReportLastTime = 0;
+    mKeyFrameRequestLastTime = 0;
+    mKeyFrameRequestSent = false;
+    mKeyFrameRequestLostPackets = 0;
+    mKeyFrameJoinTime = 0;
+    mSelectiveForwarding = false;
+    mForwardedSourceIdentifier = 0;
 }
 
 MediaSourceMem::~MediaSourceMem()
@@ -127,9 +175,12 @@ MediaSourceMem::~MediaSourceMem()
         delete mDecoderFifo;
         mDecoderFifo = NULL;
     }
+    delete mJitterBuffer;
+    mJitterBuffer = NULL;
+    delete mFecDecoder;
+    mFecDecoder = NULL;
     mDecoderFragmentFifoDestructionMutex.unlock();
     free(mStreamPacketBuffer);
-    free(mFragmentBuffer);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -150,6 +201,7 @@ int MediaSourceMem::GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBuff
     {// rtp is active, fragmentation possible!
      // we have to parse every incoming network packet and create a frame packet from the network packets (fragments)
         char *tFragmentData;
+        int tFragmentEntry;
         int tFragmentBufferSize;
         int tFragmentDataSize;
         bool tLastFragmentOfAVPacket;
@@ -161,10 +213,8 @@ int MediaSourceMem::GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBuff
         do{
             tLastFragmentOfAVPacket = false;
             tFragmenHasAVData = false;
-            tFragmentData = &tMediaSourceMemInstance->mFragmentBuffer[0];
-            tFragmentBufferSize = MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE; // maximum size of one single fragment of a frame packet
-            // receive a fragment
-            tMediaSourceMemInstance->ReadFragment(tFragmentData, tFragmentBufferSize, tFragmentNumber);
+            // receive a fragment, it is parsed in place within the FIFO entry and only its payload is copied to the final buffer
+            tFragmentEntry = tMediaSourceMemInstance->ReadFragmentExclusive(&tFragmentData, tFragmentBufferSize, tFragmentNumber);
 
             // create new AV packet
             AVPacket tAVPacket;
@@ -174,8 +224,9 @@ int MediaSourceMem::GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBuff
             /* assume every frame as key frame, we simply relay hop-by-hop */
             tAVPacket.flags |= AV_PKT_FLAG_KEY;
 
-            // relay the received fragment to registered sinks
-            tMediaSourceMemInstance->RelayAVPacketToMediaSinks(&tAVPacket);
+            // relay the received fragment to registered sinks, the forwarding has delivered it already
+            if (!tMediaSourceMemInstance->mSelectiveForwarding)
+                tMediaSourceMemInstance->RelayAVPacketToMediaSinks(&tAVPacket);
 
             #ifdef MSMEM_DEBUG_PACKET_RECEIVER
                 LOGEX(MediaSourceMem, LOG_VERBOSE, "Got packet fragment of size %d at address %p", tFragmentBufferSize, tFragmentData);
@@ -185,11 +236,13 @@ int MediaSourceMem::GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBuff
 //                    LOG(LOG_VERBOSE, "stream data (%2u): RTP+12 %02hx(%3d)  RTP %02hx(%3d)", i, tFragmentData[i + 12] & 0xFF, tFragmentData[i + 12] & 0xFF, tFragmentData[i] & 0xFF, tFragmentData[i] & 0xFF);
             if (tMediaSourceMemInstance->mGrabbingStopped)
             {
+                tMediaSourceMemInstance->ReadFragmentExclusiveFinished(tFragmentEntry);
                 LOGEX(MediaSourceMem, LOG_WARN, "%s-Grabbing was stopped", tMediaSourceMemInstance->GetMediaTypeStr().c_str());
                 return AVERROR(ENODEV); //force negative resulting buffer size to signal error and force a return to the calling GUI!
             }
             if (tFragmentBufferSize < 0)
             {
+                tMediaSourceMemInstance->ReadFragmentExclusiveFinished(tFragmentEntry);
                 LOGEX(MediaSourceMem, LOG_ERROR, "Received invalid fragment");
                 return 0;
             }
@@ -211,6 +264,7 @@ int MediaSourceMem::GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBuff
                         {
                             // copy the fragment to the final buffer
                             memcpy(tBuffer, tFragmentData, tFragmentDataSize);
+                            tMediaSourceMemInstance->AnnounceCopiedBytes(tFragmentDataSize);
                             tBuffer += tFragmentDataSize;
                             tBufferSize += tFragmentDataSize;
                         }
@@ -233,6 +287,7 @@ int MediaSourceMem::GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBuff
                     {// we have received an unsupported RTCP packet/RTP payload or something went completely wrong
                         if (tMediaSourceMemInstance->HasInputStreamChanged())
                         {// we have to reset the source
+                            tMediaSourceMemInstance->ReadFragmentExclusiveFinished(tFragmentEntry);
                             LOGEX(MediaSourceMem, LOG_WARN, "Detected source change at remote side, signaling EOF and returning immediately");
                             return AVERROR(ENODEV);
                         }else
@@ -245,15 +300,20 @@ int MediaSourceMem::GetNextInputFrame(void *pOpaque, uint8_t *pBuffer, int pBuff
             {
                 if (tMediaSourceMemInstance->mGrabbingStopped)
                 {
+                    tMediaSourceMemInstance->ReadFragmentExclusiveFinished(tFragmentEntry);
                     LOGEX(MediaSourceMem, LOG_WARN, "Detected empty signaling fragment, grabber should be stopped, returning zero data");
                     return 0;
                 }else if (!tMediaSourceMemInstance->mDecoderThreadNeeded)
                 {
+                    tMediaSourceMemInstance->ReadFragmentExclusiveFinished(tFragmentEntry);
                     LOGEX(MediaSourceMem, LOG_WARN, "Detected empty signaling fragment, decoder should be stopped, returning zero data");
                     return 0;
                 }else
                     LOGEX(MediaSourceMem, LOG_WARN, "Detected empty signaling fragment, ignoring it");
             }
+
+            // give the FIFO entry back to the writer
+            tMediaSourceMemInstance->ReadFragmentExclusiveFinished(tFragmentEntry);
         }while(!tLastFragmentOfAVPacket);
     }else
     {// rtp is inactive
@@ -326,6 +386,15 @@ void MediaSourceMem::WriteFragment(char *pBuffer, int pBufferSize, int64_t pFrag
             if (pBufferSize > 7)
                 LOG(LOG_VERBOSE, "First eight bytes are: %hhx %hhx %hhx %hhx  %hhx %hhx %hhx %hhx", pBuffer[0], pBuffer[1], pBuffer[2], pBuffer[3], pBuffer[4], pBuffer[5], pBuffer[6], pBuffer[7]);
         #endif
+
+        if (mSelectiveForwarding)
+        {
+            ForwardFragment(pBuffer, pBufferSize);
+
+            // nobody grabs the stream locally, the signaling fragments are still delivered
+            if (!DecoderNeedsFragments())
+                return;
+        }
     }
 
     if (mDecoderFragmentFifo->GetUsage() >= mDecoderFragmentFifo->GetSize() - 4)
@@ -337,6 +406,66 @@ void MediaSourceMem::WriteFragment(char *pBuffer, int pBufferSize, int64_t pFrag
     }
 
     mDecoderFragmentFifo->WriteFifo(pBuffer, pBufferSize, pFragmentNumber);
+    AnnounceCopiedBytes(pBufferSize);
+}
+
+int MediaSourceMem::LeaseFragmentBuffer(char **pBuffer, int &pBufferSize)
+{
+    if (mDecoderFragmentFifo == NULL)
+    {
+        return -1;
+    }
+
+    return mDecoderFragmentFifo->WriteFifoExclusive(pBuffer, pBufferSize);
+}
+
+void MediaSourceMem::CommitFragmentBuffer(int pEntry, int pBufferSize, int64_t pFragmentNumber)
+{
+    if ((mDecoderFragmentFifo == NULL) || (pEntry < 0))
+    {
+        return;
+    }
+
+    if (pBufferSize > 0)
+    {
+        // log statistics
+        // mFragmentHeaderSize to add additional TCPFragmentHeader to the statistic if TCP is used, this is triggered by MediaSourceNet
+        AnnouncePacket((int)pBufferSize + mPacketStatAdditionalFragmentSize);
+
+        #ifdef MSMEM_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Commit fragment in entry %d with size %5d for %s decoder", pEntry, pBufferSize, GetMediaTypeStr().c_str());
+        #endif
+    }
+
+    if (mDecoderFragmentFifo->GetUsage() >= mDecoderFragmentFifo->GetSize() - 4)
+    {
+        LOG(LOG_WARN, "Decoder fragment FIFO is near overload situation in CommitFragmentBuffer(), deleting all stored fragments");
+
+        // delete all stored frames: it is a better for the decoding!
+        mDecoderFragmentFifo->ClearFifo();
+    }
+
+    mDecoderFragmentFifo->WriteFifoExclusiveFinished(pEntry, pBufferSize, pFragmentNumber);
+}
+
+void MediaSourceMem::CancelFragmentBuffer(int pEntry)
+{
+    if ((mDecoderFragmentFifo == NULL) || (pEntry < 0))
+    {
+        return;
+    }
+
+    mDecoderFragmentFifo->WriteFifoExclusiveCanceled(pEntry);
+}
+
+void MediaSourceMem::SetFragmentBufferBlocking(bool pBlocking)
+{
+    if (mDecoderFragmentFifo == NULL)
+    {
+        return;
+    }
+
+    ((MediaFifoSpsc*)mDecoderFragmentFifo)->SetFullTimeout(pBlocking ? MEDIA_FIFO_SPSC_FULL_TIMEOUT : 0);
 }
 
 void MediaSourceMem::ReadFragment(char *pBuffer, int &pBufferSize, int64_t &pFragmentNumber)
@@ -347,6 +476,7 @@ void MediaSourceMem::ReadFragment(char *pBuffer, int &pBufferSize, int64_t &pFra
     }
 
     mDecoderFragmentFifo->ReadFifo(&pBuffer[0], pBufferSize, pFragmentNumber);
+    AnnounceCopiedBytes(pBufferSize);
 
     if (pBufferSize > 0)
     {
@@ -365,6 +495,300 @@ void MediaSourceMem::ReadFragment(char *pBuffer, int &pBufferSize, int64_t &pFra
     }
 }
 
+int MediaSourceMem::ReadFragmentExclusive(char **pBuffer, int &pBufferSize, int64_t &pFragmentNumber)
+{
+    if (mDecoderFragmentFifo == NULL)
+    {
+        *pBuffer = NULL;
+        pBufferSize = -1;
+        return -1;
+    }
+
+    int tResult;
+    // stored packets are delivered even if the jitter buffer was deactivated in the meantime
+    if ((mRtpActivated) && ((mJitterBufferActive) || (mJitterBuffer->GetDepth() > 0)))
+        tResult = ReadFragmentFromJitterBuffer(pBuffer, pBufferSize, pFragmentNumber);
+    else
+    {
+        tResult = mDecoderFragmentFifo->ReadFifoExclusive(pBuffer, pBufferSize, pFragmentNumber);
+
+        // a recovery needs the reordering of the jitter buffer, otherwise FEC packets are skipped
+        while ((mRtpActivated) && (pBufferSize > 0) && (RTPFecDecoder::IsFecPacket(*pBuffer, pBufferSize)))
+        {
+            mDecoderFragmentFifo->ReadFifoExclusiveFinished(tResult);
+            tResult = mDecoderFragmentFifo->ReadFifoExclusive(pBuffer, pBufferSize, pFragmentNumber);
+        }
+        if ((mRtpActivated) && (pBufferSize > 0))
+            RtcpAnnounceArrival(*pBuffer, pBufferSize, Time::GetMonotonicTimeStamp());
+    }
+
+    if (mRtpActivated)
+    {
+        SendReceiverReport();
+        CheckKeyFrameNeed();
+    }
+
+    if (pBufferSize > 0)
+    {
+        #ifdef MSMEM_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Read fragment with number %5u at %p with size %5d towards %s decoder", (unsigned int)++mFragmentNumber, *pBuffer, pBufferSize, GetMediaTypeStr().c_str());
+        #endif
+    }
+
+    return tResult;
+}
+
+int MediaSourceMem::ReadFragmentFromJitterBuffer(char **pBuffer, int &pBufferSize, int64_t &pFragmentNumber)
+{
+    int tEntry;
+
+    while(true)
+    {
+        // stop waiting for missing packets if no further packet can be stored or the buffer has to be drained
+        if ((mJitterBuffer->IsFull()) || (!mJitterBufferActive))
+            mJitterBuffer->SkipGap();
+
+        // deliver stored packets which are in order now or whose gap has expired
+        if (mJitterBuffer->GetNextPacket(pBuffer, pBufferSize, pFragmentNumber, Time::GetMonotonicTimeStamp()))
+        {
+            UpdateJitterBufferStatistic();
+            return MEDIA_SOURCE_MEM_JITTER_BUFFER_ENTRY;
+        }
+
+        // wait for the missing packets, but not longer than the reordering window allows, new fragments and wake up signals end the waiting
+        if (mJitterBuffer->GetDepth() > 0)
+        {
+            int64_t tWaitTime = mJitterBuffer->GetDeadline() - Time::GetMonotonicTimeStamp();
+            bool tInput = (mDecoderFragmentFifo->GetUsage() > 0);
+            if ((!tInput) && (tWaitTime > 0) && (!mGrabbingStopped) && (mDecoderThreadNeeded))
+                tInput = ((MediaFifoSpsc*)mDecoderFragmentFifo)->WaitForInput((int)((tWaitTime + 999) / 1000));
+
+            if (!tInput)
+            {
+                // the caller should see the stop signal as soon as possible
+                if ((mGrabbingStopped) || (!mDecoderThreadNeeded))
+                    mJitterBuffer->SkipGap();
+                continue;
+            }
+        }
+
+        tEntry = mDecoderFragmentFifo->ReadFifoExclusive(pBuffer, pBufferSize, pFragmentNumber);
+
+        // wake up signals and empty fragments are handled by the caller
+        if (pBufferSize <= 0)
+            return tEntry;
+
+        // FEC packets are consumed here, a recovered packet is reordered like a received one
+        if (RTPFecDecoder::IsFecPacket(*pBuffer, pBufferSize))
+        {
+            char *tRecoveredPacket;
+            int tRecoveredPacketSize;
+            bool tRecovered = mFecDecoder->RecoverPacket(*pBuffer, pBufferSize, &tRecoveredPacket, tRecoveredPacketSize);
+            mDecoderFragmentFifo->ReadFifoExclusiveFinished(tEntry);
+            if (tRecovered)
+            {
+                switch(mJitterBuffer->Insert(tRecoveredPacket, tRecoveredPacketSize, pFragmentNumber, Time::GetMonotonicTimeStamp()))
+                {
+                    case JITTER_BUFFER_DELIVER:
+                        // the recovered packet is valid until the next FEC packet is processed
+                        *pBuffer = tRecoveredPacket;
+                        pBufferSize = tRecoveredPacketSize;
+                        UpdateFecStatistic();
+                        UpdateJitterBufferStatistic();
+                        return MEDIA_SOURCE_MEM_FEC_ENTRY;
+                    case JITTER_BUFFER_DROPPED:
+                        mFecDecoder->AnnounceLateRecovery();
+                        break;
+                    default:
+                        break;
+                }
+            }
+            UpdateFecStatistic();
+            UpdateJitterBufferStatistic();
+            continue;
+        }
+        mFecDecoder->StorePacket(*pBuffer, pBufferSize);
+
+        // the reception statistic is based on the arrival order, hence it is updated before the packets are reordered
+        int64_t tArrivalTime = Time::GetMonotonicTimeStamp();
+        RtcpAnnounceArrival(*pBuffer, pBufferSize, tArrivalTime);
+
+        switch(mJitterBuffer->Insert(*pBuffer, pBufferSize, pFragmentNumber, tArrivalTime))
+        {
+            case JITTER_BUFFER_DELIVER:
+                UpdateJitterBufferStatistic();
+                return tEntry;
+            case JITTER_BUFFER_STORED:
+                AnnounceCopiedBytes(pBufferSize);
+                RequestRetransmissions();
+                break;
+            default:
+                break;
+        }
+        UpdateJitterBufferStatistic();
+
+        // the packet was copied or dropped, give the FIFO entry back to the writer
+        mDecoderFragmentFifo->ReadFifoExclusiveFinished(tEntry);
+    }
+}
+
+void MediaSourceMem::RequestRetransmissions()
+{
+    // the decoder can conceal lost audio packets, a retransmission would arrive too late in most cases
+    if ((!mRetransmissionRequestsActive) || (mMediaType != MEDIA_VIDEO))
+        return;
+
+    // the remote sender is addressed by its source identifier
+    unsigned int tRemoteSourceIdentifier = GetSourceIdentifierFromRTP();
+    if (tRemoteSourceIdentifier == 0)
+        return;
+
+    unsigned short tSequenceNumbers[RTCP_NACK_ENTRIES_MAX];
+    int tCount = mJitterBuffer->GetMissingPackets(tSequenceNumbers, RTCP_NACK_ENTRIES_MAX);
+    if (tCount == 0)
+        return;
+
+    char tNack[RTCP_NACK_SIZE_MAX];
+    int tNackSize = RtcpCreateNack(tNack, tRemoteSourceIdentifier, tSequenceNumbers, tCount);
+    if (SendFeedback(tNack, tNackSize))
+    {
+        #ifdef MSMEM_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Requested retransmission of %d packets, first one is %hu", tCount, tSequenceNumbers[0]);
+        #endif
+    }
+}
+
+void MediaSourceMem::SendReceiverReport()
+{
+    int64_t tNow = Time::GetMonotonicTimeStamp();
+    if (tNow - mReceiverReportLastTime < MEDIA_SOURCE_MEM_RECEIVER_REPORT_PERIOD * 1000)
+        return;
+    mReceiverReportLastTime = tNow;
+
+    char tReport[RTCP_RECEIVER_REPORT_SIZE];
+    int tReportSize = RtcpCreateReceiverReport(tReport);
+    if (tReportSize == 0)
+        return;
+
+    // the round trip time is only known by the sender
+    SetReceptionQuality(-1, RtcpGetReceptionJitter(), RtcpGetReceptionLoss());
+
+    if (SendFeedback(tReport, tReportSize))
+    {
+        #ifdef MSMEM_DEBUG_PACKETS
+            LOG(LOG_VERBOSE, "Sent receiver report, jitter: %d ms, loss: %.2f percent", RtcpGetReceptionJitter(), RtcpGetReceptionLoss());
+        #endif
+    }
+}
+
+void MediaSourceMem::CheckKeyFrameNeed()
+{
+    if (mMediaType != MEDIA_VIDEO)
+        return;
+
+    // a joining receiver shouldn't wait for the next regular key frame of the sender, but the sender starts new receivers with its cached
+    // key frame and a FIR would force a new key frame for all receivers, hence it is only sent if the cached one doesn't arrive
+    if (!mKeyFrameRequestSent)
+    {
+        int64_t tNow = Time::GetMonotonicTimeStamp();
+        if (mKeyFrameJoinTime == 0)
+            mKeyFrameJoinTime = tNow;
+        if (tNow - mKeyFrameJoinTime >= MEDIA_SOURCE_MEM_JOIN_KEY_FRAME_TIMEOUT * 1000)
+            mKeyFrameRequestSent = RequestKeyFrame(true);
+        return;
+    }
+
+    // packets which were neither recovered by FEC nor retransmitted corrupt the picture until the next key frame
+    unsigned int tLostPackets = GetLostPacketsFromRTP();
+    if ((tLostPackets > mKeyFrameRequestLostPackets) && (RequestKeyFrame(false)))
+        mKeyFrameRequestLostPackets = tLostPackets;
+}
+
+bool MediaSourceMem::RequestKeyFrame(bool pFullIntraRequest)
+{
+    if (mMediaType != MEDIA_VIDEO)
+        return false;
+
+    // the remote sender is addressed by its source identifier, without local decoding it is only known from the forwarded packets
+    unsigned int tRemoteSourceIdentifier = GetSourceIdentifierFromRTP();
+    if (tRemoteSourceIdentifier == 0)
+        tRemoteSourceIdentifier = mForwardedSourceIdentifier;
+    if (tRemoteSourceIdentifier == 0)
+        return false;
+
+    // in forwarding mode the decoder thread and the writer of the fragment FIFO may request concurrently
+    mKeyFrameRequestMutex.lock();
+
+    // the sender needs some time to answer, further requests would only force additional key frames
+    int64_t tNow = Time::GetMonotonicTimeStamp();
+    if (tNow - mKeyFrameRequestLastTime < MEDIA_SOURCE_MEM_KEY_FRAME_REQUEST_PERIOD * 1000)
+    {
+        mKeyFrameRequestMutex.unlock();
+        return false;
+    }
+
+    char tRequest[RTCP_FIR_SIZE];
+    int tRequestSize;
+    if (pFullIntraRequest)
+        tRequestSize = RtcpCreateFir(tRequest, tRemoteSourceIdentifier);
+    else
+        tRequestSize = RtcpCreatePli(tRequest, tRemoteSourceIdentifier);
+    if (!SendFeedback(tRequest, tRequestSize))
+    {
+        mKeyFrameRequestMutex.unlock();
+        return false;
+    }
+
+    LOG(LOG_VERBOSE, "Requested %s key frame from remote sender 0x%x by %s", GetMediaTypeStr().c_str(), tRemoteSourceIdentifier, pFullIntraRequest ? "FIR" : "PLI");
+    mKeyFrameRequestLastTime = tNow;
+
+    mKeyFrameRequestMutex.unlock();
+
+    return true;
+}
+
+bool MediaSourceMem::SendFeedback(char *pData, int pDataSize)
+{
+    // a memory based source has no back channel to the sender
+    return false;
+}
+
+void MediaSourceMem::UpdateJitterBufferStatistic()
+{
+    SetJitterBufferStatistic(mJitterBuffer->GetDepth(), mJitterBuffer->GetLatePackets(), mJitterBuffer->GetReorderedPackets());
+}
+
+void MediaSourceMem::UpdateFecStatistic()
+{
+    SetFecStatistic(mFecDecoder->GetRecoveredPackets(), mFecDecoder->GetUnrecoverablePackets());
+}
+
+void MediaSourceMem::ReadFragmentExclusiveFinished(int pEntry)
+{
+    if (pEntry == MEDIA_SOURCE_MEM_JITTER_BUFFER_ENTRY)
+    {
+        mJitterBuffer->ReleasePacket();
+        UpdateJitterBufferStatistic();
+        return;
+    }
+
+    if ((mDecoderFragmentFifo == NULL) || (pEntry < 0))
+    {
+        return;
+    }
+
+    mDecoderFragmentFifo->ReadFifoExclusiveFinished(pEntry);
+
+    // is FIFO near overload situation?
+    if (mDecoderFragmentFifo->GetUsage() >= mDecoderFragmentFifo->GetSize() - 4)
+    {
+        LOG(LOG_WARN, "Decoder fragment FIFO is near overload situation in ReadFragmentExclusiveFinished(), deleting all stored fragments");
+
+        // delete all stored frames: it is a better for the decoding!
+        mDecoderFragmentFifo->ClearFifo();
+    }
+}
+
 std::string MediaSourceMem::GetBroadcasterName()
 {
     string tResult = "";
@@ -653,7 +1077,7 @@ void MediaSourceMem::StopGrabbing()
     WriteFragment(NULL, 0, 0);
 
     int tLoop = 0;
-    int64_t tTime = Time::GetTimeStamp();
+    int64_t tTime = Time::GetMonotonicTimeStamp();
     do{
         if (tLoop > 0)
             LOG(LOG_VERBOSE, "Attempt %d to stop %s %s grabbing", tLoop, GetMediaTypeStr().c_str(), GetSourceTypeStr().c_str());
@@ -665,7 +1089,7 @@ void MediaSourceMem::StopGrabbing()
     // now, the grabber returned and the lock was correctly acquired -> unlock again
     mGrabMutex.unlock();
 
-    LOG(LOG_VERBOSE, "Got %s %s decoder stopped after %lld ms", GetMediaTypeStr().c_str(), GetSourceTypeStr().c_str(), (Time::GetTimeStamp() - tTime) / 1000);
+    LOG(LOG_VERBOSE, "Got %s %s decoder stopped after %lld ms", GetMediaTypeStr().c_str(), GetSourceTypeStr().c_str(), (Time::GetMonotonicTimeStamp() - tTime) / 1000);
 
     LOG(LOG_VERBOSE, "Memory based %s source successfully stopped", GetMediaTypeStr().c_str());
 }
@@ -678,6 +1102,81 @@ int MediaSourceMem::GetChunkDropCounter()
         return mChunkDropCounter;
 }
 
+void MediaSourceMem::SetJitterBufferActivation(bool pActive)
+{
+    if (mJitterBufferActive != pActive)
+    {
+        LOG(LOG_VERBOSE, "Setting jitter buffer activation to %d", pActive);
+        mJitterBufferActive = pActive;
+    }
+}
+
+void MediaSourceMem::SetRetransmissionRequestActivation(bool pActive)
+{
+    if (mRetransmissionRequestsActive != pActive)
+    {
+        LOG(LOG_VERBOSE, "Setting activation of retransmission requests to %d", pActive);
+        mRetransmissionRequestsActive = pActive;
+    }
+}
+
+void MediaSourceMem::SetSelectiveForwarding(bool pActive)
+{
+    if (mSelectiveForwarding != pActive)
+    {
+        LOG(LOG_VERBOSE, "Setting activation of selective forwarding to %d", pActive);
+        mSelectiveForwarding = pActive;
+    }
+}
+
+bool MediaSourceMem::IsSelectiveForwarding()
+{
+    return mSelectiveForwarding;
+}
+
+bool MediaSourceMem::DecoderNeedsFragments()
+{
+    return ((mMediaSourceOpened) || (mOpenInputStream));
+}
+
+void MediaSourceMem::ForwardFragment(char *pBuffer, int pBufferSize)
+{
+    MediaSinks::iterator tIt;
+    unsigned char *tHeader = (unsigned char*)pBuffer;
+    bool tKeyFrameRequested = false;
+
+    if ((!mRtpActivated) || (pBufferSize < (int)RTP_HEADER_SIZE))
+        return;
+
+    // the key frame requests of the receivers address the remote sender even if nothing is decoded locally, RTCP packets within the stream use another layout
+    unsigned int tPayloadType = tHeader[1] & 0x7F;
+    if ((tPayloadType < 72) || (tPayloadType > 78))
+        mForwardedSourceIdentifier = ((unsigned int)tHeader[8] << 24) | ((unsigned int)tHeader[9] << 16) | ((unsigned int)tHeader[10] << 8) | (unsigned int)tHeader[11];
+
+    // a forwarded key frame makes the initial FIR of a joining receiver needless
+    if ((!mKeyFrameRequestSent) && (mMediaType == MEDIA_VIDEO) && (RTPForwarder::IsKeyFramePacket(pBuffer, pBufferSize, mSourceCodecId)))
+        mKeyFrameRequestSent = true;
+
+    // each media sink rewrites the packet for its own receiver
+    MediaSinksSnapshot *tSnapshot = AcquireMediaSinks();
+    for (tIt = tSnapshot->Sinks.begin(); tIt != tSnapshot->Sinks.end(); tIt++)
+    {
+        (*tIt)->ForwardRtpPacket(pBuffer, pBufferSize, mSourceCodecId);
+        if ((*tIt)->GetKeyFrameRequestTime() != 0)
+            tKeyFrameRequested = true;
+    }
+    ReleaseMediaSinks(tSnapshot);
+
+    // a receiver which has joined or lost its synchronization needs a key frame from the remote sender, the requests are rate limited
+    if (tKeyFrameRequested)
+        RequestKeyFrame(false);
+}
+
+void MediaSourceMem::SetJitterBufferWindow(int pMinWindow, int pMaxWindow)
+{
+    mJitterBuffer->SetWindow(pMinWindow, pMaxWindow);
+}
+
 int MediaSourceMem::GetFragmentBufferCounter()
 {
     int tResult = 0;
@@ -1015,6 +1514,13 @@ bool MediaSourceMem::CloseGrabDevice()
     // reset the FIFO to have a clean FIFO next time we open the media source again
     if (mDecoderFragmentFifo != NULL)
         mDecoderFragmentFifo->ClearFifo();
+    mJitterBuffer->Reset();
+    mFecDecoder->Reset();
+    mReceiverReportLastTime = 0;
+    mKeyFrameRequestLastTime = 0;
+    mKeyFrameRequestSent = false;
+    mKeyFrameRequestLostPackets = 0;
+    mKeyFrameJoinTime = 0;
 
     ResetPacketStatistic();
 
@@ -1059,7 +1565,7 @@ int MediaSourceMem::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool pDropChu
 
     bool tShouldGrabNext = false;
     int tGrabLoops = 0;
-    int64_t tGrabStartTime = Time::GetTimeStamp();
+    int64_t tGrabStartTime = Time::GetMonotonicTimeStamp();
 
     do{
         tShouldGrabNext = false;
@@ -1258,7 +1764,7 @@ int MediaSourceMem::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool pDropChu
                 }
             }
         }
-        if ((tShouldGrabNext) && (Time::GetTimeStamp() >= tGrabStartTime + MEDIA_SOURCE_MEM_GRABBING_TIMEOUT * AV_TIME_BASE))
+        if ((tShouldGrabNext) && (Time::GetMonotonicTimeStamp() >= tGrabStartTime + MEDIA_SOURCE_MEM_GRABBING_TIMEOUT * AV_TIME_BASE))
         {
             LOG(LOG_VERBOSE, "Timeout of %.2f seconds occurred for %s grabbing, haven't found a suitable frame, using the current one anyhow", (float)MEDIA_SOURCE_MEM_GRABBING_TIMEOUT, GetMediaTypeStr().c_str());
             tShouldGrabNext = false;
@@ -2014,9 +2520,11 @@ void* MediaSourceMem::Run(void* pArgs)
                                         {
                                             mDecoderWaitForNextKeyFrame = false;
                                             mDecoderWaitForNextKeyFrameTimeout = 0;
+                                            // a joining receiver doesn't need the initial FIR anymore
+                                            mKeyFrameRequestSent = true;
                                         }else
                                         {
-                                            if (av_gettime() > mDecoderWaitForNextKeyFrameTimeout)
+                                            if (Time::GetMonotonicTimeStamp() > mDecoderWaitForNextKeyFrameTimeout)
                                             {
                                                 LOG(LOG_WARN, "We haven't found a key frame in the input stream within a specified time, giving up, continuing anyways");
                                                 mDecoderWaitForNextKeyFrame = false;
@@ -2029,6 +2537,9 @@ void* MediaSourceMem::Run(void* pArgs)
                                             LOG(LOG_VERBOSE, "Read first %s key frame at frame number %.2lf with flags %d from input stream after seeking", GetMediaTypeStr().c_str(), tCurrentOutputFrameNumber, tPacket->flags);
                                         }else
                                         {
+                                            // a remote sender is asked for a key frame instead of waiting for its next regular one, a joining receiver waits for the cached key frame first
+                                            if ((mRtpActivated) && (mKeyFrameRequestSent))
+                                                RequestKeyFrame(false);
                                             #ifdef MSMEM_DEBUG_SEEKING
                                                 LOG(LOG_VERBOSE, "Dropping %s frame %.2lf because we are waiting for next key frame after seeking", GetMediaTypeStr().c_str(), tCurrentOutputFrameNumber);
                                             #endif
@@ -2449,7 +2960,7 @@ void MediaSourceMem::ResetDecoderBuffers()
     LOG(LOG_VERBOSE, "Waiting for first %s key frame after reset of decoder buffers", GetMediaTypeStr().c_str());
     mDecoderWaitForNextKeyFramePackets = true;
     mDecoderWaitForNextKeyFrame = true;
-    mDecoderWaitForNextKeyFrameTimeout = av_gettime() + MSM_WAITING_FOR_FIRST_KEY_FRAME_TIMEOUT * 1000 * 1000;
+    mDecoderWaitForNextKeyFrameTimeout = Time::GetMonotonicTimeStamp() + MSM_WAITING_FOR_FIRST_KEY_FRAME_TIMEOUT * 1000 * 1000;
 
     mDecoderResetBuffersMutex.unlock();
 }
@@ -2459,7 +2970,7 @@ void MediaSourceMem::WriteOutputChunk(char* pChunkBuffer, int pChunkBufferSize,
     #ifdef MSMEM_DEBUG_WAITING_TIMING
         // calculate passed time since last call
         int64_t tTimeToLastcall = 0;
-        int64_t tTime = Time::GetTimeStamp();
+        int64_t tTime = Time::GetMonotonicTimeStamp();
         if (mTimeLastWrittenOutputChunk == 0)
         {// first call
             mTimeLastWrittenOutputChunk = tTime;
@@ -2613,7 +3124,7 @@ void MediaSourceMem::CalibrateRTGrabbing()
         LOG(LOG_ERROR, "Found invalid relative PTS value of: %.2lf for frame index: %.2f", tRelativeTime, tRelativeFrameIndex);
         tRelativeTime = 0;
     }
-    mSourceStartTimeForRTGrabbing = av_gettime() - tRelativeTime  + mSourceTimeShiftForRTGrabbing + mDecoderFramePreBufferTime * AV_TIME_BASE;
+    mSourceStartTimeForRTGrabbing = Time::GetMonotonicTimeStamp() - tRelativeTime  + mSourceTimeShiftForRTGrabbing + mDecoderFramePreBufferTime * AV_TIME_BASE;
     #ifdef MSMEM_DEBUG_CALIBRATION
         LOG(LOG_WARN, "Calibrating %s RT playback: new PTS start: %.2f, rel. frame index: %.2f, rel. time: %.2f ms", GetMediaTypeStr().c_str(), mSourceStartTimeForRTGrabbing, tRelativeFrameIndex, (float)(tRelativeTime / 1000));
     #endif
@@ -2659,7 +3170,7 @@ bool MediaSourceMem::WaitForRTGrabbing()
     #ifdef MSMEM_DEBUG_WAITING_TIMING
         // calculate passed time since last call
         int64_t tTimeToLastcall = 0;
-        int64_t tTime = Time::GetTimeStamp();
+        int64_t tTime = Time::GetMonotonicTimeStamp();
         if (mLastTimeWaitForRTGrabbing == 0)
         {// first call
             mLastTimeWaitForRTGrabbing = tTime;
@@ -2678,7 +3189,7 @@ bool MediaSourceMem::WaitForRTGrabbing()
     int64_t tDesiredPlayOutTime = 1000 * ((int64_t)tCurrentPtsFromGrabber); // in us
 
     // calculate the current (normalized) play-out time of the current A/V stream
-    int64_t tCurrentPlayOutTime = av_gettime() - (int64_t)mSourceStartTimeForRTGrabbing; // in us
+    int64_t tCurrentPlayOutTime = Time::GetMonotonicTimeStamp() - (int64_t)mSourceStartTimeForRTGrabbing; // in us
 
     // check if we have already reached the pre-buffer threshold time
     if (tCurrentPlayOutTime < 0)
@@ -2701,7 +3212,7 @@ bool MediaSourceMem::WaitForRTGrabbing()
         }
 
         // update play-out time
-        tCurrentPlayOutTime = av_gettime() - (int64_t)mSourceStartTimeForRTGrabbing; // in us
+        tCurrentPlayOutTime = Time::GetMonotonicTimeStamp() - (int64_t)mSourceStartTimeForRTGrabbing; // in us
     }
 
     // calculate the time offset between the desired and current play-out time, which can be used for a wait cycle (Thread::Suspend)
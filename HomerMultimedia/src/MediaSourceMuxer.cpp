@@ -57,6 +57,31 @@ namespace Homer { namespace Multimedia {
 // audio bit rate which is used during streaming as default setting
 #define MEDIA_SOURCE_MUX_DEFAULT_AUDIO_BIT_RATE                 (256 * 1024)
 
+// de/activate the adaption of the video bit rate (only libx264) and frame rate to the congestion state which is estimated by the media sinks
+#define MEDIA_SOURCE_MUX_USE_CONGESTION_CONTROL
+
+// how often is the video encoder adapted to the congestion state?
+#define MEDIA_SOURCE_MUX_CONGESTION_CONTROL_PERIOD              500 // ms
+
+// the bit rate is only changed if the estimation differs by more than this from the current encoder setting
+#define MEDIA_SOURCE_MUX_CONGESTION_CONTROL_HYSTERESIS          5 // percent
+
+// below this part of the configured bit rate the frame rate is reduced, too, otherwise the picture quality would drop too much
+#define MEDIA_SOURCE_MUX_CONGESTION_CONTROL_FPS_THRESHOLD       50 // percent
+#define MEDIA_SOURCE_MUX_CONGESTION_CONTROL_MIN_FPS             5
+
+// min. time between two key frames which are forced by requests of the media sinks, one key frame answers the requests of all sinks
+#define MEDIA_SOURCE_MUX_KEY_FRAME_REQUEST_INTERVAL             500 // ms
+
+// de/activate the GOP cache: a newly activated media sink gets the packets since the last key frame and can start decoding immediately
+#define MEDIA_SOURCE_MUX_USE_GOP_CACHE
+
+// max. size of the cached packets, a longer GOP isn't cached until the next key frame
+#define MEDIA_SOURCE_MUX_GOP_CACHE_SIZE                         (4 * 1024 * 1024) // bytes
+
+// how many cached packets are relayed to a primed media sink per encoded packet? the sink catches up with this factor
+#define MEDIA_SOURCE_MUX_GOP_CACHE_PRIMING_BURST                4
+
 ///////////////////////////////////////////////////////////////////////////////
 
 //H.264 default settings
@@ -79,6 +104,23 @@ MediaSourceMuxer::MediaSourceMuxer(MediaSource *pMediaSource):
     mStreamQuality = 20;
     mStreamBitRate = -1;
     mStreamMaxFps = 0;
+    mStreamAdaptiveFps = 0;
+    #ifdef MEDIA_SOURCE_MUX_USE_CONGESTION_CONTROL
+        mCongestionControlActivated = true;
+    #else
+        mCongestionControlActivated = false;
+    #endif
+    mCongestionControlLastUpdate = 0;
+    mKeyFrameForcedLastTime = 0;
+    #ifdef MEDIA_SOURCE_MUX_USE_GOP_CACHE
+        mGopCacheActivated = true;
+    #else
+        mGopCacheActivated = false;
+    #endif
+    mGopCacheValid = false;
+    mGopCacheBuffer = NULL;
+    mGopCacheBufferUsage = 0;
+    mRtpPacketizer = new RTPPacketizer();
     mVideoHFlip = false;
     mVideoVFlip = false;
     mMediaSource = pMediaSource;
@@ -109,6 +151,8 @@ MediaSourceMuxer::~MediaSourceMuxer()
 
     LOG(LOG_VERBOSE, "..freeing stream packet buffer");
     av_free(mStreamPacketBuffer);
+    free(mGopCacheBuffer);
+    delete mRtpPacketizer;
     LOG(LOG_VERBOSE, "Destroyed");
 }
 
@@ -627,6 +671,9 @@ bool MediaSourceMuxer::OpenVideoMuxer(int pResX, int pResY, float pFps)
                         LOG(LOG_WARN, "Setting H.264 preset to: %s", H264_DEFAULT_PRESET);
                         if ((tResult = av_opt_set(mCodecContext->priv_data, "preset", H264_DEFAULT_PRESET, 0)) < 0)
                             LOG(LOG_ERROR, "Failed to set A/V option \"preset\" because %s(0x%x)", strerror(AVUNERROR(tResult)), tResult);
+                        // forced key frames have to be IDR frames, otherwise a joining receiver can't start decoding with them
+                        if ((tResult = av_opt_set(mCodecContext->priv_data, "forced-idr", "1", 0)) < 0)
+                            LOG(LOG_WARN, "Failed to set A/V option \"forced-idr\" because %s(0x%x)", strerror(AVUNERROR(tResult)), tResult);
                         break;
         case AV_CODEC_ID_HEVC:
                         LOG(LOG_WARN, "Setting HEVC preset to: %s", HEVC_DEFAULT_PRESET);
@@ -668,7 +715,11 @@ bool MediaSourceMuxer::OpenVideoMuxer(int pResX, int pResY, float pFps)
     //######################################################
     //### give some verbose output
     //######################################################
-    mStreamMaxFps_LastFrame_Timestamp = Time::GetTimeStamp();
+    mStreamMaxFps_LastFrame_Timestamp = Time::GetMonotonicTimeStamp();
+    mStreamAdaptiveFps = 0;
+    mCongestionControlLastUpdate = 0;
+    mKeyFrameForcedLastTime = 0;
+    ResetGopCache();
     MarkOpenGrabDeviceSuccessful();
     LOG(LOG_INFO, "    ..max packet size: %d bytes", mStreamMaxPacketSize);
     LOG(LOG_INFO, "  stream...");
@@ -947,6 +998,9 @@ bool MediaSourceMuxer::CloseMuxer()
         // make sure we can free the memory structures
         StopEncoder();
 
+        // the packetizer refers to the stream which is freed below
+        mRtpPacketizer->Reset();
+
         LOG(LOG_VERBOSE, "..closing %s codec", GetMediaTypeStr().c_str());
 
         // Close the codec
@@ -1201,13 +1255,9 @@ int MediaSourceMuxer::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool pDropC
         return tResult;
     }
 
-    // lock
-    mMediaSinksMutex.lock();
-
-    int tMediaSinks = mMediaSinks.size();
-
-    // unlock
-    mMediaSinksMutex.unlock();
+    MediaSinksSnapshot *tSnapshot = AcquireMediaSinks();
+    int tMediaSinks = tSnapshot->Sinks.size();
+    ReleaseMediaSinks(tSnapshot);
 
     //####################################################################
     // live marker - OSD
@@ -1226,7 +1276,7 @@ int MediaSourceMuxer::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool pDropC
     if ((BelowMaxFps(tResult) /* we have to call this function continuously */) && (mStreamActivated) && (!pDropChunk) && (tResult >= 0) && (pChunkSize > 0) && (tMediaSinks) && (mEncoderFifo != NULL))
     {
         // we relay this chunk to all registered media sinks based on the dedicated relay thread
-        int64_t tTime = Time::GetTimeStamp();
+        int64_t tTime = Time::GetMonotonicTimeStamp();
 
         int64_t tNtpTime = (int64_t)RTP::GetNtpTime();
 
@@ -1236,7 +1286,7 @@ int MediaSourceMuxer::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool pDropC
 
         mEncoderFifo->WriteFifo((char*)pChunkBuffer, pChunkSize, tNtpTime);
         #ifdef MSM_DEBUG_TIMING
-            int64_t tTime2 = Time::GetTimeStamp();
+            int64_t tTime2 = Time::GetMonotonicTimeStamp();
             //LOG(LOG_VERBOSE, "Writing %d bytes to Encoder-FIFO took %"PRId64" us", pChunkSize, tTime2 - tTime);
         #endif
     }
@@ -1255,15 +1305,21 @@ int MediaSourceMuxer::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool pDropC
 //HINT: call this function continuously !
 bool MediaSourceMuxer::BelowMaxFps(int pFrameNumber)
 {
-    int64_t tCurrentTime = Time::GetTimeStamp();
+    int64_t tCurrentTime = Time::GetMonotonicTimeStamp();
 
-    if (mStreamMaxFps != 0)
+    // the frame rate might be reduced during congestion
+    int tMaxFps = mStreamMaxFps;
+    int tAdaptiveFps = mStreamAdaptiveFps;
+    if ((tAdaptiveFps != 0) && ((tMaxFps == 0) || (tAdaptiveFps < tMaxFps)))
+        tMaxFps = tAdaptiveFps;
+
+    if (tMaxFps != 0)
     {
         int64_t tTimeDiffToLastFrame = tCurrentTime - mStreamMaxFps_LastFrame_Timestamp;
-        int64_t tTimeDiffTreshold = 1000*1000 / mStreamMaxFps;
+        int64_t tTimeDiffTreshold = 1000*1000 / tMaxFps;
         int64_t tTimeDiffForNextFrame = tTimeDiffToLastFrame - tTimeDiffTreshold;
         #ifdef MSM_DEBUG_PACKETS
-            LOG(LOG_VERBOSE, "Checking max. FPS(%d) for frame number %d: %"PRId64" < %"PRId64" => %s", mStreamMaxFps, pFrameNumber, tTimeDiffToLastFrame, tTimeDiffTreshold, (tTimeDiffToLastFrame < tTimeDiffTreshold) ? "yes" : "no");
+            LOG(LOG_VERBOSE, "Checking max. FPS(%d) for frame number %d: %"PRId64" < %"PRId64" => %s", tMaxFps, pFrameNumber, tTimeDiffToLastFrame, tTimeDiffTreshold, (tTimeDiffToLastFrame < tTimeDiffTreshold) ? "yes" : "no");
         #endif
 
         // time for a new frame?
@@ -1286,6 +1342,255 @@ bool MediaSourceMuxer::BelowMaxFps(int pFrameNumber)
     return false;
 }
 
+void MediaSourceMuxer::SetCongestionControlActivation(bool pState)
+{
+    if (mCongestionControlActivated != pState)
+    {
+        LOG(LOG_VERBOSE, "Setting %s congestion control activation to %d", GetMediaTypeStr().c_str(), pState);
+        mCongestionControlActivated = pState;
+    }
+}
+
+// HINT: called by the encoder thread before a video frame is encoded
+void MediaSourceMuxer::AdaptToCongestion()
+{
+    int64_t tCurrentTime = Time::GetMonotonicTimeStamp();
+    int tTargetBitRate = -1;
+
+    if ((!mCongestionControlActivated) || (mStreamBitRate <= 0) || (tCurrentTime - mCongestionControlLastUpdate < MEDIA_SOURCE_MUX_CONGESTION_CONTROL_PERIOD * 1000))
+        return;
+    mCongestionControlLastUpdate = tCurrentTime;
+
+    // all media sinks share one encoder, hence the receiver with the worst path determines the bit rate
+    MediaSinksSnapshot *tSnapshot = AcquireMediaSinks();
+    for (MediaSinks::iterator tIt = tSnapshot->Sinks.begin(); tIt != tSnapshot->Sinks.end(); tIt++)
+    {
+        int tSinkBitRate = (*tIt)->GetTargetBitRate();
+        if ((tSinkBitRate > 0) && ((tTargetBitRate == -1) || (tSinkBitRate < tTargetBitRate)))
+            tTargetBitRate = tSinkBitRate;
+    }
+    ReleaseMediaSinks(tSnapshot);
+
+    // the configured bit rate is the upper border
+    if ((tTargetBitRate == -1) || (tTargetBitRate > mStreamBitRate))
+        tTargetBitRate = mStreamBitRate;
+
+    // apply the new bit rate to the encoder: only libx264 reconfigures its rate control if the bit rate of the opened codec context changes,
+    // the other encoders keep the bit rate from opening the codec and congestion is only handled by the frame rate reduction below
+    if ((mCodecContext->codec != NULL) && (string(mCodecContext->codec->name) == "libx264"))
+    {
+        int tDiff = tTargetBitRate - mCodecContext->bit_rate;
+        if (tDiff < 0)
+            tDiff = -tDiff;
+        if ((int64_t)tDiff * 100 > (int64_t)mCodecContext->bit_rate * MEDIA_SOURCE_MUX_CONGESTION_CONTROL_HYSTERESIS)
+        {
+            #ifdef MSM_DEBUG_PACKETS
+                LOG(LOG_VERBOSE, "Adapting %s encoder bit rate from %d to %d bit/s", GetMediaTypeStr().c_str(), mCodecContext->bit_rate, tTargetBitRate);
+            #endif
+            mCodecContext->bit_rate = tTargetBitRate;
+        }
+    }
+    AnnounceBitRateEstimate(tTargetBitRate);
+
+    // reduce the frame rate if the bit rate isn't enough for a reasonable picture quality
+    int tAdaptiveFps = 0;
+    if ((int64_t)tTargetBitRate * 100 < (int64_t)mStreamBitRate * MEDIA_SOURCE_MUX_CONGESTION_CONTROL_FPS_THRESHOLD)
+    {
+        int tFps = (int)GetOutputFrameRate();
+        if ((mStreamMaxFps != 0) && (mStreamMaxFps < tFps))
+            tFps = mStreamMaxFps;
+        tAdaptiveFps = (int)((int64_t)tFps * tTargetBitRate * 100 / ((int64_t)mStreamBitRate * MEDIA_SOURCE_MUX_CONGESTION_CONTROL_FPS_THRESHOLD));
+        if (tAdaptiveFps < MEDIA_SOURCE_MUX_CONGESTION_CONTROL_MIN_FPS)
+            tAdaptiveFps = MEDIA_SOURCE_MUX_CONGESTION_CONTROL_MIN_FPS;
+    }
+    if (tAdaptiveFps != mStreamAdaptiveFps)
+    {
+        if (tAdaptiveFps != 0)
+            LOG(LOG_VERBOSE, "Reducing %s frame rate to %d fps because of an estimated bit rate of %d bit/s", GetMediaTypeStr().c_str(), tAdaptiveFps, tTargetBitRate);
+        else
+            LOG(LOG_VERBOSE, "Restoring %s frame rate, estimated bit rate is %d bit/s", GetMediaTypeStr().c_str(), tTargetBitRate);
+        mStreamAdaptiveFps = tAdaptiveFps;
+    }
+}
+
+// HINT: called by the encoder thread before a video frame is encoded
+bool MediaSourceMuxer::KeyFrameRequested()
+{
+    int64_t tCurrentTime = Time::GetMonotonicTimeStamp();
+    int64_t tRequestTime = 0;
+
+    // a forced key frame is expensive, hence the requests of all media sinks are rate limited together
+    if (tCurrentTime - mKeyFrameForcedLastTime < MEDIA_SOURCE_MUX_KEY_FRAME_REQUEST_INTERVAL * 1000)
+        return false;
+
+    MediaSinksSnapshot *tSnapshot = AcquireMediaSinks();
+    for (MediaSinks::iterator tIt = tSnapshot->Sinks.begin(); tIt != tSnapshot->Sinks.end(); tIt++)
+    {
+        int64_t tSinkRequestTime = (*tIt)->GetKeyFrameRequestTime();
+        if ((tSinkRequestTime != 0) && ((tRequestTime == 0) || (tSinkRequestTime < tRequestTime)))
+            tRequestTime = tSinkRequestTime;
+    }
+    ReleaseMediaSinks(tSnapshot);
+
+    if (tRequestTime == 0)
+        return false;
+
+    LOG(LOG_VERBOSE, "Forcing %s key frame, oldest request is %"PRId64" ms old", GetMediaTypeStr().c_str(), (tCurrentTime - tRequestTime) / 1000);
+    mKeyFrameForcedLastTime = tCurrentTime;
+
+    return true;
+}
+
+void MediaSourceMuxer::SetGopCacheActivation(bool pState)
+{
+    if (mGopCacheActivated != pState)
+    {
+        LOG(LOG_VERBOSE, "Setting %s GOP cache activation to %d", GetMediaTypeStr().c_str(), pState);
+        mGopCacheActivated = pState;
+    }
+}
+
+// HINT: called by the encoder thread
+void MediaSourceMuxer::ResetGopCache()
+{
+    mGopCacheValid = false;
+    mGopCacheBufferUsage = 0;
+    mGopCacheEntries.clear();
+}
+
+// HINT: called by the encoder thread
+void MediaSourceMuxer::StoreInGopCache(AVPacket *pAVPacket)
+{
+    // each key frame starts a new GOP
+    if (pAVPacket->flags & AV_PKT_FLAG_KEY)
+    {
+        ResetGopCache();
+        mGopCacheValid = true;
+    }
+    if (!mGopCacheValid)
+        return;
+
+    if (mGopCacheBufferUsage + pAVPacket->size > MEDIA_SOURCE_MUX_GOP_CACHE_SIZE)
+    {
+        LOG(LOG_WARN, "GOP cache is full, %d packets with %d bytes are cached, caching stopped until next key frame", (int)mGopCacheEntries.size(), mGopCacheBufferUsage);
+        ResetGopCache();
+        return;
+    }
+
+    if (mGopCacheBuffer == NULL)
+        mGopCacheBuffer = (char*)malloc(MEDIA_SOURCE_MUX_GOP_CACHE_SIZE);
+
+    GopCacheEntry tEntry;
+    tEntry.Offset = mGopCacheBufferUsage;
+    tEntry.Size = pAVPacket->size;
+    tEntry.Pts = pAVPacket->pts;
+    tEntry.Dts = pAVPacket->dts;
+    tEntry.Duration = pAVPacket->duration;
+    tEntry.Flags = pAVPacket->flags;
+    memcpy(mGopCacheBuffer + tEntry.Offset, pAVPacket->data, pAVPacket->size);
+    mGopCacheBufferUsage += pAVPacket->size;
+    mGopCacheEntries.push_back(tEntry);
+}
+
+// HINT: called by the encoder thread for each encoded packet
+void MediaSourceMuxer::RelayAVPacketToMediaSinks(AVPacket *pAVPacket)
+{
+    bool tGopCacheActive = ((mGopCacheActivated) && (mMediaType == MEDIA_VIDEO));
+    AVStream *tStream = (mFormatContext != NULL ? mFormatContext->streams[0] : NULL);
+    const string &tStreamName = GetRelayStreamName();
+    bool tIsKeyFrame = pAVPacket->flags & AV_PKT_FLAG_KEY;
+    GopCachePositions tPositions;
+    MediaSinks tPrimedMediaSinks;
+
+    if (tGopCacheActive)
+        StoreInGopCache(pAVPacket);
+
+    // the RTP packets of the current packet are created only once for all media sinks
+    mRtpPacketizer->AnnounceNextPacket();
+
+    // the media sinks only queue the packet, hence a registration isn't blocked for long
+    MediaSinksSnapshot *tSnapshot = AcquireMediaSinks();
+
+    for (MediaSinks::iterator tIt = tSnapshot->Sinks.begin(); tIt != tSnapshot->Sinks.end(); tIt++)
+    {
+        MediaSink *tMediaSink = *tIt;
+        int tPosition = -1;
+
+        if (tGopCacheActive)
+        {
+            GopCachePositions::iterator tPositionIt = mGopCachePositions.find(tMediaSink);
+            if (tPositionIt != mGopCachePositions.end())
+            {// the sink is already primed
+                if (mGopCacheValid)
+                {
+                    // a new key frame makes the remaining cached packets superfluous
+                    if (!tIsKeyFrame)
+                        tPosition = tPositionIt->second;
+                }else
+                {
+                    LOG(LOG_WARN, "GOP cache was reset while priming media sink %s, requesting key frame", tMediaSink->GetId().c_str());
+                    tMediaSink->RequestKeyFrame();
+                }
+            }else if ((mGopCacheValid) && (!tIsKeyFrame) && (tMediaSink->IsWaitingForKeyFrame()))
+            {// the sink would drop everything until the next key frame
+                LOG(LOG_VERBOSE, "Priming media sink %s with %d cached packets", tMediaSink->GetId().c_str(), (int)mGopCacheEntries.size());
+                tPosition = 0;
+            }
+        }
+
+        if (tPosition == -1)
+        {
+            tMediaSink->SetRtpPacketizer(mRtpPacketizer);
+            tMediaSink->ProcessPacket(pAVPacket, tStream, tStreamName);
+            tMediaSink->SetRtpPacketizer(NULL);
+        }else
+        {
+            tPositions[tMediaSink] = tPosition;
+            tPrimedMediaSinks.push_back(tMediaSink);
+        }
+    }
+
+    // primed sinks get individual packets, hence they are served after all sinks which share the current packet
+    for (MediaSinks::iterator tIt = tPrimedMediaSinks.begin(); tIt != tPrimedMediaSinks.end(); tIt++)
+    {
+        MediaSink *tMediaSink = *tIt;
+        int tPosition = tPositions[tMediaSink];
+
+        // the current packet is the last cache entry, hence the sink gets it via the cache, too
+        for (int i = 0; (i < MEDIA_SOURCE_MUX_GOP_CACHE_PRIMING_BURST) && (tPosition < (int)mGopCacheEntries.size()); i++)
+        {
+            GopCacheEntry *tEntry = &mGopCacheEntries[tPosition];
+            AVPacket tPacket;
+            av_init_packet(&tPacket);
+            tPacket.data = (uint8_t*)mGopCacheBuffer + tEntry->Offset;
+            tPacket.size = tEntry->Size;
+            tPacket.pts = tEntry->Pts;
+            tPacket.dts = tEntry->Dts;
+            tPacket.duration = tEntry->Duration;
+            tPacket.flags = tEntry->Flags;
+            tPacket.stream_index = pAVPacket->stream_index;
+            mRtpPacketizer->AnnounceNextPacket();
+            tMediaSink->SetRtpPacketizer(mRtpPacketizer);
+            tMediaSink->ProcessPacket(&tPacket, tStream, tStreamName);
+            tMediaSink->SetRtpPacketizer(NULL);
+            tPosition++;
+        }
+
+        if (tPosition < (int)mGopCacheEntries.size())
+            tPositions[tMediaSink] = tPosition;
+        else
+        {
+            LOG(LOG_VERBOSE, "Media sink %s has caught up with the live stream", tMediaSink->GetId().c_str());
+            tPositions.erase(tMediaSink);
+        }
+    }
+
+    // sinks which were unregistered in the meantime vanish here
+    mGopCachePositions.swap(tPositions);
+
+    ReleaseMediaSinks(tSnapshot);
+}
+
 int64_t MediaSourceMuxer::CalculateEncoderPts(int pFrameNumber)
 {
     int64_t tResult = 0;
@@ -1499,13 +1804,9 @@ void* MediaSourceMuxer::Run(void* pArgs)
 
             if ((tBufferSize > 0) && (mEncoderThreadNeeded))
             {
-                // lock
-                mMediaSinksMutex.lock();
-
-                int tRegisteredMediaSinks = mMediaSinks.size();
-
-                // unlock
-                mMediaSinksMutex.unlock();
+                MediaSinksSnapshot *tSnapshot = AcquireMediaSinks();
+                int tRegisteredMediaSinks = tSnapshot->Sinks.size();
+                ReleaseMediaSinks(tSnapshot);
 
                 //####################################################################
                 //### reencode frame and send it to the registered media sinks
@@ -1516,7 +1817,7 @@ void* MediaSourceMuxer::Run(void* pArgs)
                     {
                         case MEDIA_VIDEO:
                             {
-                                int64_t tTime3 = Time::GetTimeStamp();
+                                int64_t tTime3 = Time::GetMonotonicTimeStamp();
                                 // ####################################################################
                                 // ### CREATE YUV FRAME based on SCALER output
                                 // ###################################################################
@@ -1524,13 +1825,13 @@ void* MediaSourceMuxer::Run(void* pArgs)
                                 avpicture_fill((AVPicture *)tYUVFrame, (uint8_t *)tBuffer, mCodecContext->pix_fmt, mCurrentStreamingResX, mCurrentStreamingResY);
 
                                 #ifdef MSM_DEBUG_TIMING
-                                    int64_t tTime5 = Time::GetTimeStamp();
+                                    int64_t tTime5 = Time::GetMonotonicTimeStamp();
                                     LOG(LOG_VERBOSE, "     preparing data structures took %"PRId64" us", tTime5 - tTime3);
                                 #endif
 
                                 tEncoderOutputFrameTimestamp = (int64_t)rint(CalculateEncoderPts(mFrameNumber));
-                                if (mMediaSource->HasVariableOutputFrameRate())
-                                {// base source delivers a variable output frame rate (we cannot rely on equidistant times between two grabbed frames
+                                if ((mMediaSource->HasVariableOutputFrameRate()) || (mStreamAdaptiveFps != 0))
+                                {// base source delivers a variable output frame rate or frames are dropped because of congestion (we cannot rely on equidistant times between two grabbed frames
                                     if (mEncoderStartTime == 0)
                                     {
                                         LOG(LOG_WARN, "Encoder start time is still invalid, setting a default value");
@@ -1591,6 +1892,20 @@ void* MediaSourceMuxer::Run(void* pArgs)
                                 #endif
                                 RelaySyncTimestampToMediaSinks(tOutputFrameTimestamp, tYUVFrame->pts);
 
+                                // ####################################################################
+                                // ### follow the congestion state of the media sinks
+                                // ####################################################################
+                                AdaptToCongestion();
+
+                                // ####################################################################
+                                // ### answer key frame requests of the media sinks
+                                // ####################################################################
+                                if (KeyFrameRequested())
+                                {
+                                    tYUVFrame->pict_type = AV_PICTURE_TYPE_I;
+                                    tYUVFrame->key_frame = 1;
+                                }
+
                                 // ####################################################################
                                 // ### generate new output frame
                                 // ####################################################################
@@ -31,6 +31,7 @@
 #include <ProcessStatisticService.h>
 #include <RequirementTransmitBitErrors.h>
 #include <RTP.h>
+#include <HBSocketReactor.h>
 #include <Logger.h>
 
 #include <string>
@@ -46,17 +47,33 @@ using namespace Homer::Base;
 // maximum number of acceptable continuous receive errors
 #define MEDIA_SOURCE_NET_MAX_RECEIVE_ERRORS                           3
 
+// maximum number of datagrams which are received within one system call
+#define MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE                           16
+
+// size of the receive buffers, with active receive offload it is split into fewer but larger buffers for coalesced datagrams
+#define MEDIA_SOURCE_NET_RECEIVE_BUFFER_SIZE                          (MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE * MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE)
+
+// de/activate UDP receive offload (GRO) for datagram sockets, only used while the datagrams aren't received directly into the fragment FIFO
+#define MEDIA_SOURCE_NET_USE_RECEIVE_OFFLOAD
+
+// de/activate the reception of datagrams directly into the fragment FIFO of the decoder, not used for TCP and coalesced datagrams
+#define MEDIA_SOURCE_NET_USE_ZERO_COPY_RECEPTION
+
+// de/activate the shared socket reactor for datagram sockets instead of one listener thread per stream
+#define MEDIA_SOURCE_NET_USE_SOCKET_REACTOR
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
 class NetworkListener :
-    public Thread
+    public Thread, public SocketReactorHandler
 {
 public:
     NetworkListener(MediaSourceNet *pMediaSourceNet, Socket *pDataSocket, bool pRtpActivated = true);
     NetworkListener(MediaSourceNet *pMediaSourceNet, unsigned int pPortNumber, enum TransportType pTransportType, bool pRtpActivated = true);
     NetworkListener(MediaSourceNet *pMediaSourceNet, std::string pLocalName, Requirements *pTransportRequirements, bool pRtpActivated = true);
+    NetworkListener(MediaSourceNet *pMediaSourceNet, std::string pMulticastGroup, unsigned int pPortNumber, enum TransportType pTransportType, std::string pInterface, bool pRtpActivated = true);
 
     virtual ~NetworkListener();
 
@@ -68,15 +85,28 @@ public:
     enum NetworkType GetNetworkType();
     std::string GetListenerName();
     std::string GetCurrentDevicePeerName();
+    bool SendFeedback(char *pData, int pDataSize);
 
 private:
     friend class MediaSourceNet;
 
     void Init(Socket *pDataSocket, unsigned int pLocalPort, bool pRtpActivated = true);
     bool ReceivePacket(std::string &pSourceHost, unsigned int &pSourcePort, char* pData, int &pSize);
+    int ReceivePackets(std::string &pSourceHost, unsigned int &pSourcePort, SocketDatagram *pDatagrams, int pDatagramCount, bool pNonBlocking = false);
+    bool ReceiveAndProcessPackets(bool pNonBlocking = false);
+    void InitReceiveBuffers();
+    void UpdateReceiveOffload();
+    bool IsZeroCopyUsable();
+    int LeaseReceiveBuffers();
+    void CancelReceiveBuffers(int pFirstBuffer, int pBufferCount);
+    void UpdateDeviceDescription();
+    bool IsReactorUsable();
+    std::string GetLocalHost(); // the group of a multicast stream, otherwise the local address of the socket
 
     /* network listener */
     virtual void* Run(void* pArgs = NULL);
+    /* socket reactor based listener */
+    virtual bool SocketReadable(Socket *pSocket);
 
     MediaSourceNet      *mMediaSourceNet;
     bool                mRtpActivated;
@@ -87,12 +117,23 @@ private:
     bool                mListenerNeeded;
     bool                mListenerStopped;
     bool                mListenerSocketCreatedOutside;
+    bool                mListenerRegistered;
+    bool                mFragmentFifoOverflow;
     bool                mStreamedTransport;
+    char                *mPacketBuffers;
+    SocketDatagram      mDatagrams[MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE];
+    int                 mReceiveBufferCount;
+    ssize_t             mReceiveBufferSize;
+    int                 mLeasedEntries[MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE];
+    int64_t             mReceivedPackets;
     /* Berkeley sockets based transport */
     std::string         mPeerHost;
     unsigned int        mPeerPort;
+    Mutex               mPeerMutex; // the peer address is also used by the decoder thread for sending feedback
     Socket              *mDataSocket;
     unsigned int        mListenerPort;
+    std::string         mMulticastGroup;
+    std::string         mMulticastInterface;
     /* NAPI based transport */
     IConnection         *mNAPIDataSocket;
     ICEPBinding         *mNAPIBinding;
@@ -108,12 +149,19 @@ void NetworkListener::Init(Socket *pDataSocket, unsigned int pLocalPort, bool pR
     mPeerHost = "";
     mPeerPort = 0;
     mReceiveErrors = 0;
+    mReceivedPackets = 0;
     mListenerNeeded = false;
+    mListenerRegistered = false;
+    mFragmentFifoOverflow = false;
     mListenerPort = pLocalPort;
     mRtpActivated = pRtpActivated;
 
+    mPacketBuffers = (char*)malloc(MEDIA_SOURCE_NET_RECEIVE_BUFFER_SIZE);
+
     mDataSocket = pDataSocket;
 
+    InitReceiveBuffers();
+
     if(mDataSocket != NULL)
     {
         // check the UDP-Lite and the RTP header
@@ -126,7 +174,7 @@ void NetworkListener::Init(Socket *pDataSocket, unsigned int pLocalPort, bool pR
             mMediaSourceNet->mPacketStatAdditionalFragmentSize = TCP_FRAGMENT_HEADER_SIZE;
         }
         LOG(LOG_VERBOSE, "Listen for media packets at port %u, transport %s, IP version %d", mDataSocket->GetLocalPort(), Socket::TransportType2String(mDataSocket->GetTransportType()).c_str(), mDataSocket->GetNetworkType());
-        mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + MediaSinkNet::CreateId(mDataSocket->GetLocalHost(), toString(mDataSocket->GetLocalPort()), mDataSocket->GetTransportType(), mRtpActivated);
+        mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + MediaSinkNet::CreateId(GetLocalHost(), toString(mDataSocket->GetLocalPort()), mDataSocket->GetTransportType(), mRtpActivated);
 
         mListenerPort = mDataSocket->GetLocalPort();
     }else if (mNAPIDataSocket != NULL)
@@ -178,6 +226,36 @@ NetworkListener::NetworkListener(MediaSourceNet *pMediaSourceNet, unsigned int p
     Init(Socket::CreateServerSocket(SOCKET_IPv6, pTransportType, pPortNumber), 0, pRtpActivated);
 }
 
+NetworkListener::NetworkListener(MediaSourceNet *pMediaSourceNet, string pMulticastGroup, unsigned int pPortNumber, enum TransportType pTransportType, string pInterface, bool pRtpActivated)
+{
+    mMediaSourceNet = pMediaSourceNet;
+    LOG(LOG_VERBOSE, "Created, have to create socket for multicast group %s", pMulticastGroup.c_str());
+    if ((pPortNumber == 0) || (pPortNumber > 65535))
+        LOG(LOG_ERROR, "Given port number is invalid");
+
+    mListenerSocketCreatedOutside = false;
+    mStreamedTransport = false;
+    mMulticastGroup = pMulticastGroup;
+    mMulticastInterface = pInterface;
+
+    mNAPIUsed = false;
+
+    if ((pTransportType != SOCKET_UDP) && (pTransportType != SOCKET_UDP_LITE))
+    {
+        LOG(LOG_WARN, "Multicast isn't supported for %s transport, falling back to UDP", Socket::TransportType2String(pTransportType).c_str());
+        pTransportType = SOCKET_UDP;
+    }
+
+    LOG(LOG_VERBOSE, "Local multicast media listener at: %s<%d>%s, interface: %s", pMulticastGroup.c_str(), pPortNumber, pRtpActivated ? "(RTP)" : "", (pInterface != "") ? pInterface.c_str() : "default");
+
+    // several viewers at the same host listen at the same port, the socket has to use the IP version of the group
+    Socket *tSocket = Socket::CreateServerSocket(IS_IPV6_ADDRESS(pMulticastGroup) ? SOCKET_IPv6 : SOCKET_IPv4, pTransportType, pPortNumber, true);
+    if ((tSocket != NULL) && (!tSocket->JoinMulticastGroup(mMulticastGroup, mMulticastInterface)))
+        LOG(LOG_ERROR, "Couldn't join multicast group %s, only unicast packets will be received", pMulticastGroup.c_str());
+
+    Init(tSocket, 0, pRtpActivated);
+}
+
 NetworkListener::NetworkListener(MediaSourceNet *pMediaSourceNet, string pLocalName, Requirements *pTransportRequirements, bool pRtpActivated)
 {
     mMediaSourceNet = pMediaSourceNet;
@@ -219,6 +297,9 @@ NetworkListener::NetworkListener(MediaSourceNet *pMediaSourceNet, string pLocalN
 
 NetworkListener::~NetworkListener()
 {
+    if (mListenerRegistered)
+        SVC_SOCKET_REACTOR.UnregisterSocket(mDataSocket);
+
     if(mNAPIUsed)
     {
         if (mNAPIBinding != NULL)
@@ -230,10 +311,107 @@ NetworkListener::~NetworkListener()
     {
         if (!mListenerSocketCreatedOutside)
         {
+            if ((mDataSocket != NULL) && (mMulticastGroup != ""))
+            {
+                LOG(LOG_VERBOSE, "..leaving multicast group %s", mMulticastGroup.c_str());
+                mDataSocket->LeaveMulticastGroup(mMulticastGroup, mMulticastInterface);
+            }
             LOG(LOG_VERBOSE, "..destroying socket object");
             delete mDataSocket;
         }
     }
+
+    free(mPacketBuffers);
+}
+
+void NetworkListener::InitReceiveBuffers()
+{
+    mReceiveBufferCount = MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE;
+    mReceiveBufferSize = MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE;
+
+    for (int i = 0; i < mReceiveBufferCount; i++)
+        mDatagrams[i].Buffer = mPacketBuffers + i * mReceiveBufferSize;
+}
+
+// context: receiving thread
+void NetworkListener::UpdateReceiveOffload()
+{
+    #ifdef MEDIA_SOURCE_NET_USE_RECEIVE_OFFLOAD
+        if ((mNAPIUsed) || (mDataSocket == NULL) || (mDataSocket->GetTransportType() != SOCKET_UDP))
+            return;
+
+        // the kernel may coalesce several datagrams of the same flow, these are split into fragments again before they are written to the FIFO,
+        // hence the offload is only used if the datagrams can't be received directly into the fragment FIFO, e.g., for streams which are only forwarded
+        bool tOffload = true;
+        #ifdef MEDIA_SOURCE_NET_USE_ZERO_COPY_RECEPTION
+            tOffload = ((mMediaSourceNet->mSelectiveForwarding) && (!mMediaSourceNet->DecoderNeedsFragments()));
+        #endif
+        if (tOffload == mDataSocket->IsReceiveOffloadActive())
+            return;
+
+        if ((mDataSocket->EnableReceiveOffload(tOffload)) && (tOffload))
+        {
+            mReceiveBufferCount = MEDIA_SOURCE_NET_RECEIVE_BUFFER_SIZE / SOCKET_COALESCED_BUFFER_SIZE;
+            mReceiveBufferSize = SOCKET_COALESCED_BUFFER_SIZE;
+            LOG(LOG_VERBOSE, "Receive offload activated, using %d receive buffers of %d bytes", mReceiveBufferCount, (int)mReceiveBufferSize);
+        }else if (!mDataSocket->IsReceiveOffloadActive())
+        {
+            mReceiveBufferCount = MEDIA_SOURCE_NET_RECEIVE_BATCH_SIZE;
+            mReceiveBufferSize = MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE;
+            if (!tOffload)
+                LOG(LOG_VERBOSE, "Receive offload deactivated, using %d receive buffers of %d bytes", mReceiveBufferCount, (int)mReceiveBufferSize);
+        }
+    #endif
+}
+
+bool NetworkListener::IsZeroCopyUsable()
+{
+    // the forwarded packets don't need the fragment FIFO if nobody grabs the stream locally
+    if ((mMediaSourceNet->mSelectiveForwarding) && (!mMediaSourceNet->DecoderNeedsFragments()))
+        return false;
+
+    #ifdef MEDIA_SOURCE_NET_USE_ZERO_COPY_RECEPTION
+        // TCP fragments have to be extracted from the stream, coalesced datagrams have to be split
+        return ((!mStreamedTransport) && ((mNAPIUsed) || (mDataSocket == NULL) || (!mDataSocket->IsReceiveOffloadActive())));
+    #else
+        return false;
+    #endif
+}
+
+int NetworkListener::LeaseReceiveBuffers()
+{
+    int tResult = 0;
+    int tBufferCount = mNAPIUsed ? 1 : mReceiveBufferCount;
+    int tFifoUsage = mMediaSourceNet->GetFragmentBufferCounter();
+    int tFifoSize = mMediaSourceNet->GetFragmentBufferSize();
+
+    for (int i = 0; i < tBufferCount; i++)
+    {
+        char *tBuffer;
+        int tBufferSize;
+
+        // only the first lease may wait for free space, further buffers are leased only if the FIFO isn't near its overload situation
+        if ((i > 0) && (tFifoUsage + i >= tFifoSize - 4))
+            break;
+
+        mLeasedEntries[i] = mMediaSourceNet->LeaseFragmentBuffer(&tBuffer, tBufferSize);
+        if (mLeasedEntries[i] < 0)
+            break;
+
+        mDatagrams[i].Buffer = tBuffer;
+        mDatagrams[i].BufferSize = tBufferSize;
+        mDatagrams[i].SegmentSize = 0;
+        tResult++;
+    }
+
+    return tResult;
+}
+
+void NetworkListener::CancelReceiveBuffers(int pFirstBuffer, int pBufferCount)
+{
+    // the latest lease has to be canceled first
+    for (int i = pBufferCount - 1; i >= pFirstBuffer; i--)
+        mMediaSourceNet->CancelFragmentBuffer(mLeasedEntries[i]);
 }
 
 unsigned int NetworkListener::GetListenerPort()
@@ -252,6 +430,33 @@ void NetworkListener::StartListener()
         mMediaSourceNet->mDecoderFragmentFifo->ClearFifo();
     }
 
+    if (IsReactorUsable())
+    {
+        // a former registration was deactivated when grabbing stopped
+        if (mListenerRegistered)
+            SVC_SOCKET_REACTOR.UnregisterSocket(mDataSocket);
+
+        UpdateDeviceDescription();
+        mMediaSourceNet->AssignStreamName(mMediaSourceNet->mCurrentDeviceName);
+
+        // set marker to "active"
+        mListenerStopped = false;
+        mListenerNeeded = true;
+
+        // the reactor thread is shared with other streams, it mustn't wait for a slow decoder
+        mMediaSourceNet->SetFragmentBufferBlocking(false);
+        mListenerRegistered = SVC_SOCKET_REACTOR.RegisterSocket(mDataSocket, this);
+        if (mListenerRegistered)
+        {
+            LOG(LOG_VERBOSE, "%s network listener for port %u registered at socket reactor", mMediaSourceNet->GetMediaTypeStr().c_str(), GetListenerPort());
+            return;
+        }
+
+        LOG(LOG_WARN, "Registration at socket reactor failed, falling back to a listener thread");
+        mListenerNeeded = false;
+    }
+    mMediaSourceNet->SetFragmentBufferBlocking(true);
+
     if (!IsRunning())
     {
         // start decoder main loop
@@ -278,6 +483,21 @@ void NetworkListener::StopListener()
     // tell network listener thread: it isn't needed anymore
     mListenerNeeded = false;
 
+    if (mListenerRegistered)
+    {
+        // waits for a running receive call
+        LOG(LOG_VERBOSE, "  ..unregistering from socket reactor");
+        SVC_SOCKET_REACTOR.UnregisterSocket(mDataSocket);
+        mListenerRegistered = false;
+        mListenerStopped = true;
+
+        if (mDataSocket != NULL)
+        {
+            LOG(LOG_VERBOSE, "  ..stopping (receiver) Berkeley socket");
+            mDataSocket->StopReceiving();
+        }
+    }
+
     if(IsRunning())
     {
         if (mNAPIUsed)
@@ -375,6 +595,34 @@ bool NetworkListener::ReceivePacket(std::string &pSourceHost, unsigned int &pSou
     return tResult;
 }
 
+int NetworkListener::ReceivePackets(std::string &pSourceHost, unsigned int &pSourcePort, SocketDatagram *pDatagrams, int pDatagramCount, bool pNonBlocking)
+{
+    int tResult = -1;
+
+    if ((!mNAPIUsed) && (mDataSocket != NULL))
+    {
+        tResult = mDataSocket->ReceiveBatch(pSourceHost, pSourcePort, pDatagrams, pDatagramCount, pNonBlocking);
+    }else
+    {// NAPI doesn't support batched reception
+        int tSize = (int)pDatagrams[0].BufferSize;
+        if (ReceivePacket(pSourceHost, pSourcePort, (char*)pDatagrams[0].Buffer, tSize))
+            tResult = 1;
+        pDatagrams[0].DataSize = (ssize_t)tSize;
+    }
+
+    return tResult;
+}
+
+bool NetworkListener::IsReactorUsable()
+{
+    #ifdef MEDIA_SOURCE_NET_USE_SOCKET_REACTOR
+        // NAPI doesn't support readiness notifications, streamed transport needs a blocking accept()
+        return ((!mNAPIUsed) && (mDataSocket != NULL) && (!mStreamedTransport) && (SVC_SOCKET_REACTOR.IsAvailable()));
+    #else
+        return false;
+    #endif
+}
+
 string NetworkListener::GetListenerName()
 {
     string tResult = "";
@@ -386,7 +634,7 @@ string NetworkListener::GetListenerName()
 
     }else
     {
-        tResult = "NET-IN: " + MediaSinkNet::CreateId(mDataSocket->GetLocalHost(), toString(mDataSocket->GetLocalPort()), mDataSocket->GetTransportType(), mRtpActivated);
+        tResult = "NET-IN: " + MediaSinkNet::CreateId(GetLocalHost(), toString(mDataSocket->GetLocalPort()), mDataSocket->GetTransportType(), mRtpActivated);
     }
 
     return tResult;
@@ -410,49 +658,34 @@ string NetworkListener::GetCurrentDevicePeerName()
     }
 }
 
-void* NetworkListener::Run(void* pArgs)
+string NetworkListener::GetLocalHost()
 {
-    char                *tPacketBuffer = NULL;
-    string              tSourceHost = "";
-    unsigned int        tSourcePort = 0;
-    int                 tDataSize;
-    int64_t             tReceivedPackets = 0;
+    if (mMulticastGroup != "")
+        return mMulticastGroup;
+    else
+        return mDataSocket->GetLocalHost();
+}
 
-    LOG(LOG_WARN, "%s Socket-Listener for port %u started", mMediaSourceNet->GetMediaTypeStr().c_str(), GetListenerPort());
-    mListenerStopped = false;
+bool NetworkListener::SendFeedback(char *pData, int pDataSize)
+{
+    // the remote side of a conference uses the same port for sending and receiving, hence the feedback is sent back to the source address of the received packets
+    // the sender of a multicast stream doesn't listen for feedback, and it would be flooded by the feedback of all viewers
+    if ((mNAPIUsed) || (mDataSocket == NULL) || (mStreamedTransport) || (mMulticastGroup != ""))
+        return false;
 
-    tPacketBuffer = (char*)malloc(MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE);
+    mPeerMutex.lock();
+    string tPeerHost = mPeerHost;
+    unsigned int tPeerPort = mPeerPort;
+    mPeerMutex.unlock();
 
-    if (mNAPIUsed)
-    {
-        switch(mMediaSourceNet->mMediaType)
-        {
-            case MEDIA_VIDEO:
-                SVC_PROCESS_STATISTIC.AssignThreadName("Video-InputListener(NAPI," + mMediaSourceNet->GetGuiNameFromCodecID(mMediaSourceNet->GetSourceCodec()) + ")");
-                break;
-            case MEDIA_AUDIO:
-                SVC_PROCESS_STATISTIC.AssignThreadName("Audio-InputListener(NAPI," + mMediaSourceNet->GetGuiNameFromCodecID(mMediaSourceNet->GetSourceCodec()) + ")");
-                break;
-            default:
-                LOG(LOG_ERROR, "Unknown media type");
-                break;
-        }
-    }else
-    {
-        switch(mMediaSourceNet->mMediaType)
-        {
-            case MEDIA_VIDEO:
-                SVC_PROCESS_STATISTIC.AssignThreadName("Video-InputListener(NET," + mMediaSourceNet->GetGuiNameFromCodecID(mMediaSourceNet->GetSourceCodec()) + ")");
-                break;
-            case MEDIA_AUDIO:
-                SVC_PROCESS_STATISTIC.AssignThreadName("Audio-InputListener(NET," + mMediaSourceNet->GetGuiNameFromCodecID(mMediaSourceNet->GetSourceCodec()) + ")");
-                break;
-            default:
-                LOG(LOG_ERROR, "Unknown media type");
-                break;
-        }
-    }
+    if ((tPeerHost == "") || (tPeerPort == 0))
+        return false;
 
+    return mDataSocket->Send(tPeerHost, tPeerPort, pData, (ssize_t)pDataSize);
+}
+
+void NetworkListener::UpdateDeviceDescription()
+{
     if (mNAPIUsed)
     {
         // assume Berkeley-Socket implementation behind NAPI interface => therefore we can easily conclude on "UDP/TCP/UDP-Lite"
@@ -464,71 +697,126 @@ void* NetworkListener::Run(void* pArgs)
         mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), tTransportType, tNetworkType);
     }else
     {
-        mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + MediaSinkNet::CreateId(mDataSocket->GetLocalHost(), toString(mDataSocket->GetLocalPort()), mDataSocket->GetTransportType(), mRtpActivated);
+        mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + MediaSinkNet::CreateId(GetLocalHost(), toString(mDataSocket->GetLocalPort()), mDataSocket->GetTransportType(), mRtpActivated);
         // update category for packet statistics
         mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), mDataSocket->GetTransportType(), mDataSocket->GetNetworkType());
     }
-    mMediaSourceNet->AssignStreamName(mMediaSourceNet->mCurrentDeviceName);
+}
 
-    // set marker to "active"
-    mListenerNeeded = true;
+bool NetworkListener::ReceiveAndProcessPackets(bool pNonBlocking)
+{
+    char                *tPacketBuffer = NULL;
+    int                 tReceivedDatagrams;
+    int                 tLeasedBuffers = 0;
+    string              tSourceHost = "";
+    unsigned int        tSourcePort = 0;
+    int                 tDataSize;
 
-    while ((mListenerNeeded) && (!mMediaSourceNet->mGrabbingStopped))
+    //####################################################################
+    // receive packets from network socket
+    // ###################################################################
+    // receive directly into fragment buffers of the decoder if possible, otherwise use the own buffers and copy the fragments afterwards
+    UpdateReceiveOffload();
+    bool tZeroCopy = IsZeroCopyUsable();
+    if (tZeroCopy)
+        tLeasedBuffers = LeaseReceiveBuffers();
+    if (tLeasedBuffers == 0)
     {
-        //####################################################################
-        // receive packet from network socket
-        // ###################################################################
-        tDataSize = MEDIA_SOURCE_MEM_FRAGMENT_BUFFER_SIZE;
-        tSourceHost = "";
-        if (!ReceivePacket(tSourceHost, tSourcePort, tPacketBuffer, tDataSize))
-        {// error occurred
-            if (mReceiveErrors == MEDIA_SOURCE_NET_MAX_RECEIVE_ERRORS)
-            {
-                LOG(LOG_ERROR, "Maximum number of continuous receive errors(%d) is exceeded, will stop network listener", MEDIA_SOURCE_NET_MAX_RECEIVE_ERRORS);
-                mListenerNeeded = false;
-                break;
-            }else
-                mReceiveErrors++;
+        for (int i = 0; i < mReceiveBufferCount; i++)
+        {
+            mDatagrams[i].Buffer = mPacketBuffers + i * mReceiveBufferSize;
+            mDatagrams[i].BufferSize = mReceiveBufferSize;
+            mDatagrams[i].SegmentSize = 0;
+        }
+    }
+    tReceivedDatagrams = ReceivePackets(tSourceHost, tSourcePort, mDatagrams, mStreamedTransport ? 1 : ((tLeasedBuffers > 0) ? tLeasedBuffers : mReceiveBufferCount), pNonBlocking);
+    // give back the unused buffers, in case of an error all of them, afterwards only the buffers of the received datagrams are leased
+    if (tLeasedBuffers > 0)
+    {
+        if (tReceivedDatagrams > 0)
+        {
+            CancelReceiveBuffers(tReceivedDatagrams, tLeasedBuffers);
+            tLeasedBuffers = tReceivedDatagrams;
         }else
-        {// everything is okay
-            mReceiveErrors = 0;
-            tReceivedPackets++;
+        {
+            CancelReceiveBuffers(0, tLeasedBuffers);
+            tLeasedBuffers = 0;
         }
-
-        // stop loop if listener isn't needed anymore
-        if (!mListenerNeeded)
+    }
+    if ((tReceivedDatagrams == 0) && (pNonBlocking))
+    {// nothing available
+        return true;
+    }
+    // the reactor doesn't wait for free fragment buffers, the received packets are dropped
+    if ((tZeroCopy) && (tLeasedBuffers == 0) && (pNonBlocking) && (tReceivedDatagrams > 0))
+    {
+        if (!mFragmentFifoOverflow)
         {
-            LOG(LOG_WARN, "Leaving %s network listener immediately", mMediaSourceNet->GetMediaTypeStr().c_str());
-            break;
+            LOG(LOG_WARN, "Decoder fragment FIFO of %s network listener is full, dropping received packets", mMediaSourceNet->GetMediaTypeStr().c_str());
+            mFragmentFifoOverflow = true;
         }
-//      LOG(LOG_ERROR, "Data Size: %d", (int)tDataSize);
-//      LOG(LOG_ERROR, "Port: %u", tSourcePort);
-//      LOG(LOG_ERROR, "Host: %s", tSourceHost.c_str());
+        for (int tDatagram = 0; tDatagram < tReceivedDatagrams; tDatagram++)
+        {
+            if (mDatagrams[tDatagram].DataSize > 0)
+            {
+                mReceivedPackets++;
+                if (mMediaSourceNet->mSelectiveForwarding)
+                    mMediaSourceNet->ForwardFragment((char*)mDatagrams[tDatagram].Buffer, (int)mDatagrams[tDatagram].DataSize);
+            }
+        }
+        mMediaSourceNet->AnnounceDroppedPackets(tReceivedDatagrams);
+        mReceiveErrors = 0;
+        return true;
+    }
+    if ((tLeasedBuffers > 0) && (mFragmentFifoOverflow))
+    {
+        LOG(LOG_VERBOSE, "Decoder fragment FIFO of %s network listener accepts packets again, %"PRIu64" packets were dropped until now", mMediaSourceNet->GetMediaTypeStr().c_str(), mMediaSourceNet->GetDroppedPacketCount());
+        mFragmentFifoOverflow = false;
+    }
+    if (tReceivedDatagrams < 1)
+    {// error occurred
+        if (mReceiveErrors == MEDIA_SOURCE_NET_MAX_RECEIVE_ERRORS)
+        {
+            LOG(LOG_ERROR, "Maximum number of continuous receive errors(%d) is exceeded, will stop network listener", MEDIA_SOURCE_NET_MAX_RECEIVE_ERRORS);
+            mListenerNeeded = false;
+            return false;
+        }else
+            mReceiveErrors++;
+        tReceivedDatagrams = 1;
+        // the buffer may be a canceled lease, it is reported as faulty packet
+        mDatagrams[0].DataSize = -1;
+    }else
+    {// everything is okay
+        mReceiveErrors = 0;
+    }
+
+    // stop if listener isn't needed anymore
+    if (!mListenerNeeded)
+    {
+        LOG(LOG_WARN, "Leaving %s network listener immediately", mMediaSourceNet->GetMediaTypeStr().c_str());
+        if (tLeasedBuffers > 0)
+            CancelReceiveBuffers(0, tLeasedBuffers);
+        return false;
+    }
+
+    for (int tDatagram = 0; tDatagram < tReceivedDatagrams; tDatagram++)
+    {
+        tPacketBuffer = (char*)mDatagrams[tDatagram].Buffer;
+        tDataSize = (int)mDatagrams[tDatagram].DataSize;
+        if (tDataSize >= 0)
+            mReceivedPackets++;
 
         if ((tDataSize > 0) && (tSourceHost != "") && (tSourcePort != 0))
         {
             // some news about the peer?
             if ((mPeerHost != tSourceHost) || (mPeerPort != tSourcePort))
             {
-                if (mNAPIUsed)
-                {
-                    // assume Berkeley-Socket implementation behind NAPI interface => therefore we can easily conclude on "UDP/TCP/UDP-Lite"
-                    mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + mNAPIDataSocket->getName()->toString() + "(" + (mStreamedTransport ? "TCP" : (mNAPIDataSocket->getRequirements()->contains(RequirementTransmitBitErrors::type()) ? "UDP-Lite" : "UDP")) + (mRtpActivated ? "/RTP" : "") + ")";
-
-                    enum TransportType tTransportType = (mStreamedTransport ? SOCKET_TCP : (mNAPIDataSocket->getRequirements()->contains(RequirementTransmitBitErrors::type()) ? SOCKET_UDP_LITE : SOCKET_UDP));
-                    // update category for packet statistics
-                    enum NetworkType tNetworkType = (IS_IPV6_ADDRESS(mNAPIDataSocket->getName()->toString())) ? SOCKET_IPv6 : SOCKET_IPv4;
-                    mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), tTransportType, tNetworkType);
-                }else
-                {
-                    mMediaSourceNet->mCurrentDeviceName = "NET-IN: " + MediaSinkNet::CreateId(mDataSocket->GetLocalHost(), toString(mDataSocket->GetLocalPort()), mDataSocket->GetTransportType(), mRtpActivated);
-
-                    // update category for packet statistics
-                    mMediaSourceNet->ClassifyStream(mMediaSourceNet->GetDataType(), mDataSocket->GetTransportType(), mDataSocket->GetNetworkType());
-                }
+                UpdateDeviceDescription();
                 LOG(LOG_VERBOSE, "Setting device name to %s", mMediaSourceNet->mCurrentDeviceName.c_str());
+                mPeerMutex.lock();
                 mPeerHost = tSourceHost;
                 mPeerPort = tSourcePort;
+                mPeerMutex.unlock();
             }
 
             #ifdef MSN_DEBUG_PACKETS
@@ -564,13 +852,31 @@ void* NetworkListener::Run(void* pArgs)
                     //       -> picture errors occur if the video quality is high enough and causes a high data rate
                     tData += TCP_FRAGMENT_HEADER_SIZE;
                     tDataSize -= TCP_FRAGMENT_HEADER_SIZE;
-                    mMediaSourceNet->WriteFragment(tData, (int)tHeader->FragmentSize, tReceivedPackets);
+                    mMediaSourceNet->WriteFragment(tData, (int)tHeader->FragmentSize, mReceivedPackets);
                     tData += tHeader->FragmentSize;
                     tDataSize -= tHeader->FragmentSize;
                 }
+            }else if (tLeasedBuffers > 0)
+            {// UDP transport, the data is already stored in the fragment FIFO
+                if (mMediaSourceNet->mSelectiveForwarding)
+                    mMediaSourceNet->ForwardFragment(tPacketBuffer, (int)tDataSize);
+                mMediaSourceNet->CommitFragmentBuffer(mLeasedEntries[tDatagram], (int)tDataSize, mReceivedPackets);
             }else
             {// UDP transport
-                mMediaSourceNet->WriteFragment(tPacketBuffer, (int)tDataSize, tReceivedPackets);
+                int tSegmentSize = (int)mDatagrams[tDatagram].SegmentSize;
+                if (tSegmentSize > 0)
+                {// coalesced datagrams: split them into the original fragments, only the last one may be shorter
+                    while (tDataSize > 0)
+                    {
+                        int tFragmentSize = (tDataSize > tSegmentSize) ? tSegmentSize : tDataSize;
+                        mMediaSourceNet->WriteFragment(tPacketBuffer, tFragmentSize, mReceivedPackets);
+                        tPacketBuffer += tFragmentSize;
+                        tDataSize -= tFragmentSize;
+                        if (tDataSize > 0)
+                            mReceivedPackets++;
+                    }
+                }else
+                    mMediaSourceNet->WriteFragment(tPacketBuffer, (int)tDataSize, mReceivedPackets);
             }
         }else
         {
@@ -579,18 +885,91 @@ void* NetworkListener::Run(void* pArgs)
                 LOG(LOG_VERBOSE, "Zero byte %s packet received", mMediaSourceNet->GetMediaTypeStr().c_str());
 
                 // add also a zero byte packet to enable early thread termination
-                mMediaSourceNet->WriteFragment(tPacketBuffer, 0, 0);
+                if (tLeasedBuffers > 0)
+                    mMediaSourceNet->CommitFragmentBuffer(mLeasedEntries[tDatagram], 0, 0);
+                else
+                    mMediaSourceNet->WriteFragment(tPacketBuffer, 0, 0);
             }else
             {
                 LOG(LOG_VERBOSE, "Got faulty %s packet with size: %d from %s:%u", mMediaSourceNet->GetMediaTypeStr().c_str(), tDataSize, tSourceHost.c_str(), tSourcePort);
                 tDataSize = -1;
+                // the leased buffer can't be taken back anymore, it is handed over as empty fragment
+                if (tLeasedBuffers > 0)
+                    mMediaSourceNet->CommitFragmentBuffer(mLeasedEntries[tDatagram], 0, 0);
             }
         }
     }
 
+    return true;
+}
+
+bool NetworkListener::SocketReadable(Socket *pSocket)
+{
+    if ((!mListenerNeeded) || ((mMediaSourceNet->mGrabbingStopped) && (!mMediaSourceNet->mSelectiveForwarding)))
+    {
+        mListenerStopped = true;
+        return false;
+    }
+
+    if (!ReceiveAndProcessPackets(true))
+    {
+        mListenerStopped = true;
+        return false;
+    }
+
+    return true;
+}
+
+void* NetworkListener::Run(void* pArgs)
+{
+    LOG(LOG_WARN, "%s Socket-Listener for port %u started", mMediaSourceNet->GetMediaTypeStr().c_str(), GetListenerPort());
+    mListenerStopped = false;
+
+    if (mNAPIUsed)
+    {
+        switch(mMediaSourceNet->mMediaType)
+        {
+            case MEDIA_VIDEO:
+                SVC_PROCESS_STATISTIC.AssignThreadName("Video-InputListener(NAPI," + mMediaSourceNet->GetGuiNameFromCodecID(mMediaSourceNet->GetSourceCodec()) + ")");
+                break;
+            case MEDIA_AUDIO:
+                SVC_PROCESS_STATISTIC.AssignThreadName("Audio-InputListener(NAPI," + mMediaSourceNet->GetGuiNameFromCodecID(mMediaSourceNet->GetSourceCodec()) + ")");
+                break;
+            default:
+                LOG(LOG_ERROR, "Unknown media type");
+                break;
+        }
+    }else
+    {
+        switch(mMediaSourceNet->mMediaType)
+        {
+            case MEDIA_VIDEO:
+                SVC_PROCESS_STATISTIC.AssignThreadName("Video-InputListener(NET," + mMediaSourceNet->GetGuiNameFromCodecID(mMediaSourceNet->GetSourceCodec()) + ")");
+                break;
+            case MEDIA_AUDIO:
+                SVC_PROCESS_STATISTIC.AssignThreadName("Audio-InputListener(NET," + mMediaSourceNet->GetGuiNameFromCodecID(mMediaSourceNet->GetSourceCodec()) + ")");
+                break;
+            default:
+                LOG(LOG_ERROR, "Unknown media type");
+                break;
+        }
+    }
+
+    UpdateDeviceDescription();
+    mMediaSourceNet->AssignStreamName(mMediaSourceNet->mCurrentDeviceName);
+
+    // set marker to "active"
+    mListenerNeeded = true;
+
+    // the forwarding continues if the local grabbing stops
+    while ((mListenerNeeded) && ((!mMediaSourceNet->mGrabbingStopped) || (mMediaSourceNet->mSelectiveForwarding)))
+    {
+        if (!ReceiveAndProcessPackets())
+            break;
+    }
+
     LOG(LOG_VERBOSE, "%s Socket-Listener for port %u finished", mMediaSourceNet->GetMediaTypeStr().c_str(), GetListenerPort());
 
-    free(tPacketBuffer);
     mListenerStopped = true;
 
     return NULL;
@@ -632,6 +1011,16 @@ MediaSourceNet::MediaSourceNet(unsigned int pPortNumber, enum TransportType pTra
     Init();
 }
 
+MediaSourceNet::MediaSourceNet(string pMulticastGroup, unsigned int pPortNumber, enum TransportType pTransportType, string pInterface):
+    MediaSourceMem("NET-IN:")
+{
+    LOG(LOG_VERBOSE, "Created, have to create socket for multicast group %s", pMulticastGroup.c_str());
+
+    mNetworkListener = new NetworkListener(this, pMulticastGroup, pPortNumber, pTransportType, pInterface);
+
+    Init();
+}
+
 MediaSourceNet::MediaSourceNet(string pLocalName, Requirements *pTransportRequirements):
     MediaSourceMem("NET-IN:")
 {
@@ -669,6 +1058,14 @@ string MediaSourceNet::GetCurrentDevicePeerName()
         return "";
 }
 
+bool MediaSourceNet::SendFeedback(char *pData, int pDataSize)
+{
+    if (mNetworkListener != NULL)
+        return mNetworkListener->SendFeedback(pData, pDataSize);
+    else
+        return false;
+}
+
 unsigned int MediaSourceNet::GetListenerPort()
 {
     if (mNetworkListener != NULL)
@@ -677,6 +1074,15 @@ unsigned int MediaSourceNet::GetListenerPort()
         return 0;
 }
 
+void MediaSourceNet::SetSelectiveForwarding(bool pActive)
+{
+    MediaSourceMem::SetSelectiveForwarding(pActive);
+
+    // the forwarding doesn't wait until somebody opens the stream locally
+    if ((pActive) && (mNetworkListener != NULL))
+        mNetworkListener->StartListener();
+}
+
 bool MediaSourceNet::OpenVideoGrabDevice(int pResX, int pResY, float pFps)
 {
     LOG(LOG_VERBOSE, "Trying to open the video source");
@@ -454,7 +454,7 @@ int MediaSourcePortAudio::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool pD
     #endif
 
     #ifdef MSPA_DEBUG_TIMING
-        int64_t tTime = Time::GetTimeStamp();
+        int64_t tTime = Time::GetMonotonicTimeStamp();
     #endif
     int64_t tReadChunkNumber;
     mCaptureFifo->ReadFifo((char*)pChunkBuffer, pChunkSize, tReadChunkNumber);
@@ -497,7 +497,7 @@ int MediaSourcePortAudio::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool pD
     WaitForRTGrabbing();
 
     #ifdef MSPA_DEBUG_TIMING
-        LOG(LOG_VERBOSE, "PortAudio-READ took %lld ms", (Time::GetTimeStamp() - tTime) / 1000);
+        LOG(LOG_VERBOSE, "PortAudio-READ took %lld ms", (Time::GetMonotonicTimeStamp() - tTime) / 1000);
     #endif
 
     // acknowledge success
@@ -507,7 +507,7 @@ int MediaSourcePulseAudio::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool p
         pChunkSize = MEDIA_SOURCE_SAMPLES_BUFFER_SIZE;
 
     #ifdef MSPUA_DEBUG_TIMING
-        int64_t tTime = Time::GetTimeStamp();
+        int64_t tTime = Time::GetMonotonicTimeStamp();
     #endif
     if (pa_simple_read(mInputStream, (void *)pChunkBuffer, (size_t)pChunkSize, &tRes) < 0)
     {
@@ -538,7 +538,7 @@ int MediaSourcePulseAudio::GrabChunk(void* pChunkBuffer, int& pChunkSize, bool p
     WaitForRTGrabbing();
 
     #ifdef MSPUA_DEBUG_TIMING
-        LOG(LOG_VERBOSE, "PulseAudio-READ took %lld ms", (Time::GetTimeStamp() - tTime) / 1000);
+        LOG(LOG_VERBOSE, "PulseAudio-READ took %lld ms", (Time::GetMonotonicTimeStamp() - tTime) / 1000);
     #endif
 
     // acknowledge success
@@ -58,6 +58,7 @@
 #include <Header_Ffmpeg.h>
 #include <PacketStatistic.h>
 #include <HBSocket.h>
+#include <HBTime.h>
 #include <MediaSourceNet.h>
 #include <Logger.h>
 
@@ -78,7 +79,7 @@ using namespace Homer::Monitor;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#define IS_RTCP_TYPE(x)                 ((x >= 72) && (x <= 76))
+#define IS_RTCP_TYPE(x)                 ((x >= 72) && (x <= 78))
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -100,6 +101,9 @@ using namespace Homer::Monitor;
  */
 unsigned int RTP::mH261PayloadSizeMax = 1280;
 
+RtcpFeedbackReceivers RTP::sRtcpFeedbackReceivers;
+Mutex RTP::sRtcpFeedbackReceiversMutex;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // ########################## AMR-NB (RFC 3267) ###########################################
@@ -477,13 +481,22 @@ RTP::RTP()
     mTargetPort = 0;
     mStreamCodecID = AV_CODEC_ID_NONE;
     mLocalSourceIdentifier = 0;
+    mRtcpFeedbackReceiverIdentifier = 0;
     mPayloadId = RTP_PAYLOAD_TYPE_NONE;
     mPayloadIdNegotiatedByExternal = RTP_PAYLOAD_TYPE_NONE;
+    for (int i = 0; i < RTCP_SENDER_REPORT_HISTORY; i++)
+    {
+        mRtcpSentSenderReports[i].Ntp = 0;
+        mRtcpSentSenderReports[i].Time = 0;
+    }
+    mRtcpSentSenderReportIndex = 0;
+    mRtcpFirSequenceNumber = 0;
     Init();
 }
 
 RTP::~RTP()
 {
+    RtcpUnregisterFeedbackReceiver();
     LOG(LOG_VERBOSE, "Destroyed");
 }
 
@@ -528,6 +541,12 @@ void RTP::Init()
     mRemoteTimestamp = 0;
     mRtcpRelativeLoss = 0;
     mRtcpEndToEndDelay = 0;
+    mRtcpReceptionStarted = false;
+    mRtcpReceptionSourceIdentifier = 0;
+    mRtcpReceptionFractionLost = 0;
+    mRtcpReceptionJitter = 0;
+    mRtcpLastSenderReportNtp = 0;
+    mRtcpLastSenderReportArrival = 0;
     mLastTimestampFromRTPHeader = 0;
     mLastSequenceNumberFromRTPHeader = 0;
     mLostPackets = 0;
@@ -545,6 +564,11 @@ void RTP::Init()
     mH261H263EndByteBits = 0;
     mH261H263EndByte = 0;
     mHEVCIsUsingDonFields = false;
+    mRtpAdoptionStarted = false;
+    mRtpAdoptionSequenceNumber = 0;
+    mRtpAdoptionLastTimestamp = 0;
+    mRtpAdoptionPackets = 0;
+    mRtpAdoptionOctets = 0;
 }
 
 bool RTP::ResetRrtpParser()
@@ -1332,6 +1356,115 @@ bool RTP::RtpCreate(AVPacket *pAVPacket, char *&pResultingOutputData, unsigned i
     return true;
 }
 
+// HINT: the shared packetizer creates the RTP packets once for all senders of a stream, each sender rewrites only
+//       the header fields which belong to its own RTP session: SSRC, sequence number, timestamp offset and payload type
+bool RTP::RtpAdopt(char *pSharedData, unsigned int pSharedDataSize, uint64_t pSharedTimestampOffset, char *&pResultingOutputData, unsigned int &pResultingOutputDataSize)
+{
+    if ((!mRtpEncoderOpened) || (mRtpPacketStream == NULL))
+        return false;
+
+    if ((pSharedData == NULL) || (pSharedDataSize == 0))
+        return false;
+
+    if (pSharedDataSize > MEDIA_SOURCE_AV_CHUNK_BUFFER_SIZE)
+    {
+        LOG(LOG_ERROR, "Shared RTP stream of %u bytes is too big for the local RTP packet stream", pSharedDataSize);
+        return false;
+    }
+
+    // the first adopted packet defines the sequence number and timestamp space of this sender
+    if (!mRtpAdoptionStarted)
+    {
+        mRtpAdoptionStarted = true;
+        mRtpAdoptionSequenceNumber = (unsigned short int)av_get_random_seed();
+        mLocalTimestampOffset = av_get_random_seed();
+        mRtpAdoptionLastTimestamp = (uint32_t)mLocalTimestampOffset;
+    }
+
+    // the shared packets are reused by the following senders, hence they are rewritten within the local packet stream
+    memcpy(mRtpPacketStream, pSharedData, pSharedDataSize);
+
+    char *tRtpPacket = mRtpPacketStream + 4;
+    uint32_t tRtpPacketSize = 0;
+    uint32_t tRemainingRtpDataSize = pSharedDataSize;
+    RtcpHeader *tSenderReport = NULL;
+
+    // go through all shared RTP packets
+    do{
+        tRtpPacketSize = ntohl(*(uint32_t*)(tRtpPacket - 4));
+
+        // if there is no packet data we should leave the loop
+        if (tRtpPacketSize == 0)
+            break;
+
+        if (tRtpPacketSize + 4 > tRemainingRtpDataSize)
+        {
+            LOG(LOG_ERROR, "Shared RTP packet of %u bytes exceeds the remaining %u bytes of the RTP stream", tRtpPacketSize, tRemainingRtpDataSize);
+            return false;
+        }
+
+        RtpHeader* tRtpHeader = (RtpHeader*)tRtpPacket;
+
+        // convert from network to host byte order
+        for (int i = 0; i < 3; i++)
+            tRtpHeader->Data[i] = ntohl(tRtpHeader->Data[i]);
+
+        bool tRtcpPacket = IS_RTCP_TYPE(tRtpHeader->PayloadType);
+        if (!tRtcpPacket)
+        {// usual RTP packet
+            mRtpAdoptionLastTimestamp = (uint32_t)(tRtpHeader->Timestamp - (uint32_t)pSharedTimestampOffset + (uint32_t)mLocalTimestampOffset);
+            tRtpHeader->SequenceNumber = mRtpAdoptionSequenceNumber++;
+            tRtpHeader->PayloadType = mPayloadId;
+            tRtpHeader->Timestamp = mRtpAdoptionLastTimestamp;
+            tRtpHeader->Ssrc = mLocalSourceIdentifier;
+        }else
+        {// RTCP packet
+            RtcpHeader* tRtcpHeader = (RtcpHeader*)tRtpPacket;
+
+            if (tRtcpHeader->General.Type == RTCP_SENDER_REPORT)
+            {
+                tRtcpHeader->Feedback.Ssrc = mLocalSourceIdentifier;
+                tSenderReport = tRtcpHeader;
+            }
+        }
+
+        // convert from host to network byte order
+        for (int i = 0; i < 3; i++)
+            tRtpHeader->Data[i] = htonl(tRtpHeader->Data[i]);
+
+        if (!tRtcpPacket)
+        {
+            // a sender report is patched with the timestamp of the following RTP packet, see RtpCreate()
+            if (tSenderReport != NULL)
+            {
+                RtcpPatchLiveSenderReport((char*)tSenderReport, mRtpAdoptionLastTimestamp);
+                tSenderReport->Feedback.Packets = htonl(mRtpAdoptionPackets);
+                tSenderReport->Feedback.Octets = htonl(mRtpAdoptionOctets);
+                tSenderReport = NULL;
+            }
+            mRtpAdoptionPackets++;
+            mRtpAdoptionOctets += tRtpPacketSize - RTP_HEADER_SIZE;
+        }
+
+        // go to the next RTP packet
+        tRtpPacket = tRtpPacket + (tRtpPacketSize + 4);
+        tRemainingRtpDataSize -= (tRtpPacketSize + 4);
+    }while (tRemainingRtpDataSize >= RTP_HEADER_SIZE);
+
+    // a sender report at the end of the stream refers to the last sent RTP packet
+    if (tSenderReport != NULL)
+    {
+        RtcpPatchLiveSenderReport((char*)tSenderReport, mRtpAdoptionLastTimestamp);
+        tSenderReport->Feedback.Packets = htonl(mRtpAdoptionPackets);
+        tSenderReport->Feedback.Octets = htonl(mRtpAdoptionOctets);
+    }
+
+    pResultingOutputData = mRtpPacketStream;
+    pResultingOutputDataSize = pSharedDataSize;
+
+    return true;
+}
+
 // HINT: ffmpeg lacks support for rtp encapsulation for h261  codec
 bool RTP::RtpCreateH261(char *&pData, unsigned int &pDataSize, int64_t pPacketPts)
 {
@@ -1537,6 +1670,11 @@ unsigned int RTP::GetSourceIdentifierFromRTP()
     return mRemoteSourceIdentifier;
 }
 
+uint64_t RTP::GetLocalTimestampOffset()
+{
+    return mLocalTimestampOffset;
+}
+
 bool RTP::HasSourceChangedFromRTP()
 {
     return mRtpRemoteSourceChanged;
@@ -1714,7 +1852,7 @@ bool RTP::RtpParse(char *&pData, int &pDataSize, bool &pIsLastFragment, enum Rtc
     // RTCP feedback packet within data stream: RFC4585
     // transmitted every 5 seconds
     // #############################################################
-    if ((tRtpHeader->PayloadType >= 72) && (tRtpHeader->PayloadType <= 76))
+    if (IS_RTCP_TYPE(tRtpHeader->PayloadType))
     {// RTCP intermediate packet for streaming feedback received
         if (!pLoggingOnly)
             mRTCPPacketCounter++;
@@ -1754,8 +1892,8 @@ bool RTP::RtpParse(char *&pData, int &pDataSize, bool &pIsLastFragment, enum Rtc
                         break;
                 case RTCP_RECEIVER_REPORT:
                         {
-                            LOG(LOG_WARN, "Got a RECEIVER REPORT packet, this packet type isn't supported yet");
-                            pDataSize = 0;
+                            if (!RtcpParseReceiverReport(pData, pDataSize))
+                                LOG(LOG_ERROR, "Unable to parse receiver report in received RTCP packet");
                         }
                         break;
                 case RTCP_SOURCE_DESCRIPTION:
@@ -1780,6 +1918,18 @@ bool RTP::RtpParse(char *&pData, int &pDataSize, bool &pIsLastFragment, enum Rtc
                             pDataSize = 0;
                         }
                         break;
+                case RTCP_TRANSPORT_FEEDBACK:
+                        {
+                            if (!RtcpParseTransportFeedback(pData, pDataSize))
+                                LOG(LOG_ERROR, "Unable to parse transport feedback in received RTCP packet");
+                        }
+                        break;
+                case RTCP_PAYLOAD_FEEDBACK:
+                        {
+                            if (!RtcpParsePayloadFeedback(pData, pDataSize))
+                                LOG(LOG_ERROR, "Unable to parse payload specific feedback in received RTCP packet");
+                        }
+                        break;
                 default:
                         LOG(LOG_ERROR, "Unsupported RTCP packet type: %d (nested packet nr. %d)", (int)tCurrentRtcpType, tFoundNestedPackets);
                         pDataSize = 0;
@@ -3021,6 +3171,11 @@ string RTP::GetCodecFromPreferedPayloadID(int pId)
                 tResult = "hevc/h265";
                 break;
 
+        //forward error correction
+        case RTP_PAYLOAD_TYPE_FEC:
+                tResult = "ulpfec";
+                break;
+
         //audio
         case 0:
                 tResult = "G711 u-law)";
@@ -3078,7 +3233,7 @@ string GetRtcpPayloadTypeStr(int pType)
         case RTCP_SENDER_REPORT:
                 tResult = "sender report";
                 break;
-        case 201:
+        case RTCP_RECEIVER_REPORT:
                 tResult = "receiver report";
                 break;
         case 202:
@@ -3090,6 +3245,12 @@ string GetRtcpPayloadTypeStr(int pType)
         case 204:
                 tResult = "application defined";
                 break;
+        case RTCP_TRANSPORT_FEEDBACK:
+                tResult = "transport feedback";
+                break;
+        case RTCP_PAYLOAD_FEEDBACK:
+                tResult = "payload feedback";
+                break;
         default:
                 tResult = "type " + toString(pType);
                 break;
@@ -3259,6 +3420,10 @@ bool RTP::RtcpParseSenderReport(char *&pData, int &pDataSize, unsigned int &pPac
         mRtcpLastReceivedPackets = mReceivedPackets;
         mSynchDataMutex.unlock();
 
+        // the next receiver report refers to this sender report
+        mRtcpLastSenderReportNtp = ((tRtcpHeader->Feedback.TimestampHigh & 0xFFFF) << 16) | (tRtcpHeader->Feedback.TimestampLow >> 16);
+        mRtcpLastSenderReportArrival = Time::GetMonotonicTimeStamp();
+
         tResult = true;
     }else
     {// set fall back values
@@ -3274,6 +3439,547 @@ bool RTP::RtcpParseSenderReport(char *&pData, int &pDataSize, unsigned int &pPac
     return tResult;
 }
 
+// generic NACK, RFC 4585, chapter 6.2.1
+bool RTP::RtcpParseTransportFeedback(char *&pData, int &pDataSize)
+{
+    bool tResult = false;
+
+    if (pDataSize < 12 /* header, SSRC of packet sender and SSRC of media source */)
+    {
+        LOGEX(RTP, LOG_ERROR, "Expected at least 12 bytes and got %d bytes as RTCP transport feedback", pDataSize);
+        pDataSize = 0;
+        return false;
+    }
+
+    RtcpHeader* tRtcpHeader = (RtcpHeader*)pData;
+
+    // convert from network to host byte order
+    for (int i = 0; i < 3; i++)
+        tRtcpHeader->Data[i] = ntohl(tRtcpHeader->Data[i]);
+    int tRtcpHeaderLength = (tRtcpHeader->TransportFeedback.Length + 1) * 4 /* 32 bit words */;
+    unsigned int tFmt = tRtcpHeader->TransportFeedback.Fmt;
+    unsigned int tMediaSsrc = tRtcpHeader->TransportFeedback.MediaSsrc;
+    // convert from host to network byte order again
+    for (int i = 0; i < 3; i++)
+        tRtcpHeader->Data[i] = htonl(tRtcpHeader->Data[i]);
+
+    if (tRtcpHeaderLength > pDataSize)
+    {
+        LOGEX(RTP, LOG_ERROR, "RTCP transport feedback of %d bytes exceeds the remaining %d bytes of the packet", tRtcpHeaderLength, pDataSize);
+        pDataSize = 0;
+        return false;
+    }
+
+    // go to the next RTCP packet
+    pDataSize -= tRtcpHeaderLength;
+    pData += tRtcpHeaderLength;
+
+    if (tFmt != RTCP_FEEDBACK_FMT_NACK)
+    {
+        LOGEX(RTP, LOG_WARN, "Got transport feedback of type %u, this feedback type isn't supported yet", tFmt);
+        return true;
+    }
+
+    // each FCI entry consists of a 16 bit packet ID (PID) and a 16 bit bitmask of following lost packets (BLP)
+    int tEntries = (tRtcpHeaderLength - 12) / 4;
+    if (tEntries > RTCP_NACK_ENTRIES_MAX)
+    {
+        LOGEX(RTP, LOG_WARN, "Got NACK with %d entries, considering only the first %d ones", tEntries, RTCP_NACK_ENTRIES_MAX);
+        tEntries = RTCP_NACK_ENTRIES_MAX;
+    }
+    unsigned short tSequenceNumbers[17 * RTCP_NACK_ENTRIES_MAX];
+    int tCount = 0;
+    uint32_t *tFci = (uint32_t*)(((char*)tRtcpHeader) + 12);
+    for (int i = 0; i < tEntries; i++)
+    {
+        uint32_t tEntry = ntohl(tFci[i]);
+        unsigned short tPid = (unsigned short)(tEntry >> 16);
+        unsigned short tBlp = (unsigned short)(tEntry & 0xFFFF);
+        tSequenceNumbers[tCount++] = tPid;
+        for (int j = 0; j < 16; j++)
+        {
+            if (tBlp & (1 << j))
+                tSequenceNumbers[tCount++] = (unsigned short)(tPid + j + 1);
+        }
+    }
+
+    #ifdef RTCP_DEBUG_PACKETS_DECODER
+        LOGEX(RTP, LOG_VERBOSE, "NACK: %d packets of source %u are requested", tCount, tMediaSsrc);
+    #endif
+
+    // deliver the feedback to the local sender, the lock avoids a concurrent destruction of the sender
+    sRtcpFeedbackReceiversMutex.lock();
+    RtcpFeedbackReceivers::iterator tIt = sRtcpFeedbackReceivers.find(tMediaSsrc);
+    if (tIt != sRtcpFeedbackReceivers.end())
+    {
+        tIt->second->RtcpReceivedNack(tSequenceNumbers, tCount);
+        tResult = true;
+    }else
+    {
+        LOGEX(RTP, LOG_VERBOSE, "Got NACK for unknown local source %u, ignoring it", tMediaSsrc);
+        tResult = true;
+    }
+    sRtcpFeedbackReceiversMutex.unlock();
+
+    return tResult;
+}
+
+int RTP::RtcpCreateNack(char *pData, unsigned int pMediaSourceIdentifier, unsigned short *pSequenceNumbers, int pCount)
+{
+    if (pCount < 1)
+        return 0;
+
+    RtcpHeader* tRtcpHeader = (RtcpHeader*)pData;
+    uint32_t *tFci = (uint32_t*)(pData + 12);
+    int tEntries = 0;
+
+    // combine up to 17 consecutive sequence numbers within one FCI entry, further sequence numbers are skipped if the entry limit is reached
+    int tPos = 0;
+    while ((tPos < pCount) && (tEntries < RTCP_NACK_ENTRIES_MAX))
+    {
+        unsigned short tPid = pSequenceNumbers[tPos++];
+        unsigned short tBlp = 0;
+        while (tPos < pCount)
+        {
+            unsigned short tDistance = (unsigned short)(pSequenceNumbers[tPos] - tPid);
+            if ((tDistance < 1) || (tDistance > 16))
+                break;
+            tBlp |= (unsigned short)(1 << (tDistance - 1));
+            tPos++;
+        }
+        tFci[tEntries++] = htonl(((uint32_t)tPid << 16) | (uint32_t)tBlp);
+    }
+
+    tRtcpHeader->Data[0] = 0;
+    tRtcpHeader->TransportFeedback.Version = 2;
+    tRtcpHeader->TransportFeedback.Padding = 0;
+    tRtcpHeader->TransportFeedback.Fmt = RTCP_FEEDBACK_FMT_NACK;
+    tRtcpHeader->TransportFeedback.Type = RTCP_TRANSPORT_FEEDBACK;
+    tRtcpHeader->TransportFeedback.Length = 2 + tEntries; // length is reported minus one
+    tRtcpHeader->TransportFeedback.Ssrc = mLocalSourceIdentifier;
+    tRtcpHeader->TransportFeedback.MediaSsrc = pMediaSourceIdentifier;
+
+    // convert from host to network byte order
+    for (int i = 0; i < 3; i++)
+        tRtcpHeader->Data[i] = htonl(tRtcpHeader->Data[i]);
+
+    #ifdef RTCP_DEBUG_PACKETS_ENCODER
+        LOG(LOG_VERBOSE, "Created NACK for %d packets of source %u with %d entries", pCount, pMediaSourceIdentifier, tEntries);
+    #endif
+
+    return 12 + 4 * tEntries;
+}
+
+// payload specific feedback, RFC 4585, chapter 6.3 and RFC 5104, chapter 4.3.1
+bool RTP::RtcpParsePayloadFeedback(char *&pData, int &pDataSize)
+{
+    if (pDataSize < 12 /* header, SSRC of packet sender and SSRC of media source */)
+    {
+        LOGEX(RTP, LOG_ERROR, "Expected at least 12 bytes and got %d bytes as RTCP payload feedback", pDataSize);
+        pDataSize = 0;
+        return false;
+    }
+
+    RtcpHeader* tRtcpHeader = (RtcpHeader*)pData;
+
+    // convert from network to host byte order, the layout is the same as for transport feedback
+    for (int i = 0; i < 3; i++)
+        tRtcpHeader->Data[i] = ntohl(tRtcpHeader->Data[i]);
+    int tRtcpHeaderLength = (tRtcpHeader->TransportFeedback.Length + 1) * 4 /* 32 bit words */;
+    unsigned int tFmt = tRtcpHeader->TransportFeedback.Fmt;
+    unsigned int tSenderSsrc = tRtcpHeader->TransportFeedback.Ssrc;
+    unsigned int tMediaSsrc = tRtcpHeader->TransportFeedback.MediaSsrc;
+    // convert from host to network byte order again
+    for (int i = 0; i < 3; i++)
+        tRtcpHeader->Data[i] = htonl(tRtcpHeader->Data[i]);
+
+    if (tRtcpHeaderLength > pDataSize)
+    {
+        LOGEX(RTP, LOG_ERROR, "RTCP payload feedback of %d bytes exceeds the remaining %d bytes of the packet", tRtcpHeaderLength, pDataSize);
+        pDataSize = 0;
+        return false;
+    }
+
+    // go to the next RTCP packet
+    pDataSize -= tRtcpHeaderLength;
+    pData += tRtcpHeaderLength;
+
+    switch(tFmt)
+    {
+        case RTCP_FEEDBACK_FMT_PLI:
+            {
+                #ifdef RTCP_DEBUG_PACKETS_DECODER
+                    LOGEX(RTP, LOG_VERBOSE, "PLI: source %u requests a key frame from source %u", tSenderSsrc, tMediaSsrc);
+                #endif
+
+                // deliver the feedback to the local sender, the lock avoids a concurrent destruction of the sender
+                sRtcpFeedbackReceiversMutex.lock();
+                RtcpFeedbackReceivers::iterator tIt = sRtcpFeedbackReceivers.find(tMediaSsrc);
+                if (tIt != sRtcpFeedbackReceivers.end())
+                    tIt->second->RtcpReceivedKeyFrameRequest(tSenderSsrc, -1);
+                else
+                    LOGEX(RTP, LOG_VERBOSE, "Got PLI for unknown local source %u, ignoring it", tMediaSsrc);
+                sRtcpFeedbackReceiversMutex.unlock();
+            }
+            break;
+        case RTCP_FEEDBACK_FMT_FIR:
+            {
+                // each FCI entry consists of the SSRC of the addressed media sender and an 8 bit sequence number
+                int tEntries = (tRtcpHeaderLength - 12) / 8;
+                uint32_t *tFci = (uint32_t*)(((char*)tRtcpHeader) + 12);
+                for (int i = 0; i < tEntries; i++)
+                {
+                    unsigned int tSsrc = ntohl(tFci[2 * i]);
+                    int tSequenceNumber = (int)(ntohl(tFci[2 * i + 1]) >> 24);
+
+                    #ifdef RTCP_DEBUG_PACKETS_DECODER
+                        LOGEX(RTP, LOG_VERBOSE, "FIR: source %u requests a key frame from source %u with sequence number %d", tSenderSsrc, tSsrc, tSequenceNumber);
+                    #endif
+
+                    sRtcpFeedbackReceiversMutex.lock();
+                    RtcpFeedbackReceivers::iterator tIt = sRtcpFeedbackReceivers.find(tSsrc);
+                    if (tIt != sRtcpFeedbackReceivers.end())
+                        tIt->second->RtcpReceivedKeyFrameRequest(tSenderSsrc, tSequenceNumber);
+                    sRtcpFeedbackReceiversMutex.unlock();
+                }
+            }
+            break;
+        default:
+            LOGEX(RTP, LOG_WARN, "Got payload feedback of type %u, this feedback type isn't supported yet", tFmt);
+            break;
+    }
+
+    return true;
+}
+
+int RTP::RtcpCreatePli(char *pData, unsigned int pMediaSourceIdentifier)
+{
+    RtcpHeader* tRtcpHeader = (RtcpHeader*)pData;
+
+    tRtcpHeader->Data[0] = 0;
+    tRtcpHeader->TransportFeedback.Version = 2;
+    tRtcpHeader->TransportFeedback.Padding = 0;
+    tRtcpHeader->TransportFeedback.Fmt = RTCP_FEEDBACK_FMT_PLI;
+    tRtcpHeader->TransportFeedback.Type = RTCP_PAYLOAD_FEEDBACK;
+    tRtcpHeader->TransportFeedback.Length = RTCP_PLI_SIZE / 4 - 1; // length is reported minus one
+    tRtcpHeader->TransportFeedback.Ssrc = mLocalSourceIdentifier;
+    tRtcpHeader->TransportFeedback.MediaSsrc = pMediaSourceIdentifier;
+
+    // convert from host to network byte order
+    for (int i = 0; i < 3; i++)
+        tRtcpHeader->Data[i] = htonl(tRtcpHeader->Data[i]);
+
+    #ifdef RTCP_DEBUG_PACKETS_ENCODER
+        LOG(LOG_VERBOSE, "Created PLI for source %u", pMediaSourceIdentifier);
+    #endif
+
+    return RTCP_PLI_SIZE;
+}
+
+int RTP::RtcpCreateFir(char *pData, unsigned int pMediaSourceIdentifier)
+{
+    RtcpHeader* tRtcpHeader = (RtcpHeader*)pData;
+    uint32_t *tFci = (uint32_t*)(pData + 12);
+
+    tRtcpHeader->Data[0] = 0;
+    tRtcpHeader->TransportFeedback.Version = 2;
+    tRtcpHeader->TransportFeedback.Padding = 0;
+    tRtcpHeader->TransportFeedback.Fmt = RTCP_FEEDBACK_FMT_FIR;
+    tRtcpHeader->TransportFeedback.Type = RTCP_PAYLOAD_FEEDBACK;
+    tRtcpHeader->TransportFeedback.Length = RTCP_FIR_SIZE / 4 - 1; // length is reported minus one
+    tRtcpHeader->TransportFeedback.Ssrc = mLocalSourceIdentifier;
+    tRtcpHeader->TransportFeedback.MediaSsrc = 0; // the media sender is addressed within the FCI entry
+
+    // convert from host to network byte order
+    for (int i = 0; i < 3; i++)
+        tRtcpHeader->Data[i] = htonl(tRtcpHeader->Data[i]);
+
+    // each call is a new request, the media sender ignores only repetitions with the same sequence number
+    mRtcpFirSequenceNumber = (mRtcpFirSequenceNumber + 1) & 0xFF;
+    tFci[0] = htonl(pMediaSourceIdentifier);
+    tFci[1] = htonl(mRtcpFirSequenceNumber << 24);
+
+    #ifdef RTCP_DEBUG_PACKETS_ENCODER
+        LOG(LOG_VERBOSE, "Created FIR for source %u with sequence number %u", pMediaSourceIdentifier, mRtcpFirSequenceNumber);
+    #endif
+
+    return RTCP_FIR_SIZE;
+}
+
+// receiver report, RFC 3550, chapter 6.4.2
+bool RTP::RtcpParseReceiverReport(char *&pData, int &pDataSize)
+{
+    if (pDataSize < 8 /* header and SSRC of packet sender */)
+    {
+        LOGEX(RTP, LOG_ERROR, "Expected at least 8 bytes and got %d bytes as RTCP receiver report", pDataSize);
+        pDataSize = 0;
+        return false;
+    }
+
+    RtcpHeader* tRtcpHeader = (RtcpHeader*)pData;
+
+    // convert from network to host byte order
+    for (int i = 0; i < 2; i++)
+        tRtcpHeader->Data[i] = ntohl(tRtcpHeader->Data[i]);
+    int tRtcpHeaderLength = (tRtcpHeader->General.Length + 1) * 4 /* 32 bit words */;
+    int tReportBlocks = tRtcpHeader->General.RC;
+    // convert from host to network byte order again
+    for (int i = 0; i < 2; i++)
+        tRtcpHeader->Data[i] = htonl(tRtcpHeader->Data[i]);
+
+    if (tRtcpHeaderLength > pDataSize)
+    {
+        LOGEX(RTP, LOG_ERROR, "RTCP receiver report of %d bytes exceeds the remaining %d bytes of the packet", tRtcpHeaderLength, pDataSize);
+        pDataSize = 0;
+        return false;
+    }
+
+    // go to the next RTCP packet
+    pDataSize -= tRtcpHeaderLength;
+    pData += tRtcpHeaderLength;
+
+    if (8 + 24 * tReportBlocks > tRtcpHeaderLength)
+    {
+        LOGEX(RTP, LOG_ERROR, "RTCP receiver report of %d bytes is too short for %d report blocks", tRtcpHeaderLength, tReportBlocks);
+        return false;
+    }
+
+    int64_t tArrivalTime = Time::GetMonotonicTimeStamp();
+    uint32_t *tReportBlock = (uint32_t*)(((char*)tRtcpHeader) + 8);
+    for (int i = 0; i < tReportBlocks; i++)
+    {
+        RtcpReportBlock tReport;
+        uint32_t tLoss = ntohl(tReportBlock[1]);
+        tReport.Ssrc = ntohl(tReportBlock[0]);
+        tReport.FractionLost = tLoss >> 24;
+        tReport.CumulativeLost = (tLoss & 0x800000) ? (int)(tLoss | 0xFF000000) /* negative 24 bit value */ : (int)(tLoss & 0xFFFFFF);
+        tReport.HighestSequenceNumber = ntohl(tReportBlock[2]);
+        tReport.Jitter = ntohl(tReportBlock[3]);
+        tReport.Lsr = ntohl(tReportBlock[4]);
+        tReport.Dlsr = ntohl(tReportBlock[5]);
+        tReportBlock += 6;
+
+        #ifdef RTCP_DEBUG_PACKETS_DECODER
+            LOGEX(RTP, LOG_VERBOSE, "RECEIVER REPORT: source %u, fraction lost: %u/256, cumulative lost: %d, highest sequence number: %u, jitter: %u", tReport.Ssrc, tReport.FractionLost, tReport.CumulativeLost, tReport.HighestSequenceNumber, tReport.Jitter);
+        #endif
+
+        // deliver the report to the local sender, the lock avoids a concurrent destruction of the sender
+        sRtcpFeedbackReceiversMutex.lock();
+        RtcpFeedbackReceivers::iterator tIt = sRtcpFeedbackReceivers.find(tReport.Ssrc);
+        if (tIt != sRtcpFeedbackReceivers.end())
+            tIt->second->RtcpReceivedReport(&tReport, tArrivalTime);
+        sRtcpFeedbackReceiversMutex.unlock();
+    }
+
+    return true;
+}
+
+int RTP::RtcpCreateReceiverReport(char *pData)
+{
+    if (!mRtcpReceptionStarted)
+        return 0;
+
+    // expected and lost packets, RFC 3550, appendix A.3
+    uint32_t tExtendedMaxSequenceNumber = mRtcpReceptionSequenceNumberCycles + mRtcpReceptionMaxSequenceNumber;
+    uint32_t tExpected = tExtendedMaxSequenceNumber - mRtcpReceptionBaseSequenceNumber + 1;
+    int64_t tLost = (int64_t)tExpected - (int64_t)mRtcpReceptionPackets;
+    if (tLost > 0x7FFFFF)
+        tLost = 0x7FFFFF;
+    if (tLost < -0x800000)
+        tLost = -0x800000;
+
+    uint32_t tExpectedInterval = tExpected - mRtcpReceptionExpectedPrior;
+    uint32_t tReceivedInterval = mRtcpReceptionPackets - mRtcpReceptionPacketsPrior;
+    int64_t tLostInterval = (int64_t)tExpectedInterval - (int64_t)tReceivedInterval;
+    mRtcpReceptionExpectedPrior = tExpected;
+    mRtcpReceptionPacketsPrior = mRtcpReceptionPackets;
+    if ((tExpectedInterval == 0) || (tLostInterval <= 0))
+        mRtcpReceptionFractionLost = 0;
+    else
+        mRtcpReceptionFractionLost = (unsigned int)((tLostInterval << 8) / tExpectedInterval);
+    if (mRtcpReceptionFractionLost > 255)
+        mRtcpReceptionFractionLost = 255;
+
+    // delay since the last sender report in units of 1/65536 seconds
+    uint32_t tDlsr = 0;
+    if (mRtcpLastSenderReportArrival != 0)
+        tDlsr = (uint32_t)((Time::GetMonotonicTimeStamp() - mRtcpLastSenderReportArrival) * 65536 / 1000000);
+
+    RtcpHeader* tRtcpHeader = (RtcpHeader*)pData;
+    tRtcpHeader->Data[0] = 0;
+    tRtcpHeader->General.Version = 2;
+    tRtcpHeader->General.Padding = 0;
+    tRtcpHeader->General.RC = 1;
+    tRtcpHeader->General.Type = RTCP_RECEIVER_REPORT;
+    tRtcpHeader->General.Length = RTCP_RECEIVER_REPORT_SIZE / 4 - 1; // length is reported minus one
+    tRtcpHeader->General.Ssrc = mLocalSourceIdentifier;
+
+    // convert from host to network byte order
+    for (int i = 0; i < 2; i++)
+        tRtcpHeader->Data[i] = htonl(tRtcpHeader->Data[i]);
+
+    uint32_t *tReportBlock = (uint32_t*)(pData + 8);
+    tReportBlock[0] = htonl(mRtcpReceptionSourceIdentifier);
+    tReportBlock[1] = htonl((mRtcpReceptionFractionLost << 24) | ((uint32_t)tLost & 0xFFFFFF));
+    tReportBlock[2] = htonl(tExtendedMaxSequenceNumber);
+    tReportBlock[3] = htonl(mRtcpReceptionJitter >> 4);
+    tReportBlock[4] = htonl(mRtcpLastSenderReportNtp);
+    tReportBlock[5] = htonl(tDlsr);
+
+    #ifdef RTCP_DEBUG_PACKETS_ENCODER
+        LOG(LOG_VERBOSE, "Created receiver report for source %u, fraction lost: %u/256, cumulative lost: %d, jitter: %u", mRtcpReceptionSourceIdentifier, mRtcpReceptionFractionLost, (int)tLost, mRtcpReceptionJitter >> 4);
+    #endif
+
+    return RTCP_RECEIVER_REPORT_SIZE;
+}
+
+void RTP::RtcpAnnounceArrival(char *pPacket, int pPacketSize, int64_t pArrivalTime)
+{
+    unsigned char *tHeader = (unsigned char*)pPacket;
+
+    // the clock rate depends on the codec, FEC packets use their own sequence numbers
+    if ((mStreamCodecID == AV_CODEC_ID_NONE) || (pPacketSize < (int)RTP_HEADER_SIZE) || ((tHeader[0] >> 6) != 2) || (IS_RTCP_TYPE(tHeader[1] & 0x7F)) || ((tHeader[1] & 0x7F) == RTP_PAYLOAD_TYPE_FEC))
+        return;
+
+    unsigned short int tSequenceNumber = (unsigned short int)(((unsigned int)tHeader[2] << 8) | (unsigned int)tHeader[3]);
+    uint32_t tTimestamp = ((uint32_t)tHeader[4] << 24) | ((uint32_t)tHeader[5] << 16) | ((uint32_t)tHeader[6] << 8) | (uint32_t)tHeader[7];
+    unsigned int tSourceIdentifier = ((unsigned int)tHeader[8] << 24) | ((unsigned int)tHeader[9] << 16) | ((unsigned int)tHeader[10] << 8) | (unsigned int)tHeader[11];
+    uint32_t tTransit = (uint32_t)(pArrivalTime * (int64_t)CalculateClockRateFactor() / 1000) - tTimestamp;
+
+    // a new remote source restarts the statistic
+    if ((!mRtcpReceptionStarted) || (mRtcpReceptionSourceIdentifier != tSourceIdentifier))
+    {
+        mRtcpReceptionStarted = true;
+        mRtcpReceptionSourceIdentifier = tSourceIdentifier;
+        mRtcpReceptionMaxSequenceNumber = tSequenceNumber;
+        mRtcpReceptionSequenceNumberCycles = 0;
+        mRtcpReceptionBaseSequenceNumber = tSequenceNumber;
+        mRtcpReceptionPackets = 1;
+        mRtcpReceptionExpectedPrior = 0;
+        mRtcpReceptionPacketsPrior = 0;
+        mRtcpReceptionLastTransit = tTransit;
+        mRtcpReceptionJitter = 0;
+        mRtcpReceptionFractionLost = 0;
+        return;
+    }
+
+    // duplicates and reordered packets don't update the highest sequence number
+    unsigned short int tDelta = (unsigned short int)(tSequenceNumber - mRtcpReceptionMaxSequenceNumber);
+    if ((tDelta > 0) && (tDelta < 0x8000))
+    {
+        if (tSequenceNumber < mRtcpReceptionMaxSequenceNumber)
+            mRtcpReceptionSequenceNumberCycles += 65536;
+        mRtcpReceptionMaxSequenceNumber = tSequenceNumber;
+    }
+    mRtcpReceptionPackets++;
+
+    // interarrival jitter, RFC 3550, appendix A.8
+    int32_t tDiff = (int32_t)(tTransit - mRtcpReceptionLastTransit);
+    if (tDiff < 0)
+        tDiff = -tDiff;
+    mRtcpReceptionLastTransit = tTransit;
+    mRtcpReceptionJitter += tDiff - ((mRtcpReceptionJitter + 8) >> 4);
+}
+
+int RTP::RtcpGetReceptionJitter()
+{
+    return (int)((mRtcpReceptionJitter >> 4) / CalculateClockRateFactor());
+}
+
+float RTP::RtcpGetReceptionLoss()
+{
+    return (float)mRtcpReceptionFractionLost * 100 / 256;
+}
+
+void RTP::RtcpStoreSentSenderReport(uint32_t pNtpHigh, uint32_t pNtpLow)
+{
+    mRtcpSentSenderReportsMutex.lock();
+    mRtcpSentSenderReportIndex = (mRtcpSentSenderReportIndex + 1) % RTCP_SENDER_REPORT_HISTORY;
+    mRtcpSentSenderReports[mRtcpSentSenderReportIndex].Ntp = ((pNtpHigh & 0xFFFF) << 16) | (pNtpLow >> 16);
+    mRtcpSentSenderReports[mRtcpSentSenderReportIndex].Time = Time::GetMonotonicTimeStamp();
+    mRtcpSentSenderReportsMutex.unlock();
+}
+
+int RTP::RtcpCalculateRtt(RtcpReportBlock *pReport, int64_t pArrivalTime)
+{
+    int tResult = -1;
+
+    // no sender report was received by the remote side yet
+    if (pReport->Lsr == 0)
+        return -1;
+
+    // the NTP timestamps of the sender reports might refer to the grabbing time, hence the local send time is used, search from the newest report
+    mRtcpSentSenderReportsMutex.lock();
+    for (int i = 0; i < RTCP_SENDER_REPORT_HISTORY; i++)
+    {
+        RtcpSentSenderReport *tSenderReport = &mRtcpSentSenderReports[(mRtcpSentSenderReportIndex + RTCP_SENDER_REPORT_HISTORY - i) % RTCP_SENDER_REPORT_HISTORY];
+        if ((tSenderReport->Time != 0) && (tSenderReport->Ntp == pReport->Lsr))
+        {
+            int64_t tRtt = pArrivalTime - tSenderReport->Time - (int64_t)pReport->Dlsr * 1000000 / 65536;
+            tResult = (tRtt > 0) ? (int)(tRtt / 1000) : 0;
+            break;
+        }
+    }
+    mRtcpSentSenderReportsMutex.unlock();
+
+    return tResult;
+}
+
+int RTP::RtcpCalculateJitter(RtcpReportBlock *pReport)
+{
+    return (int)(pReport->Jitter / CalculateClockRateFactor());
+}
+
+unsigned int RTP::CreateLocalSourceIdentifier()
+{
+    mLocalSourceIdentifier = av_get_random_seed();
+
+    return mLocalSourceIdentifier;
+}
+
+void RTP::RtcpRegisterFeedbackReceiver()
+{
+    RtcpUnregisterFeedbackReceiver();
+
+    if (mLocalSourceIdentifier == 0)
+        return;
+
+    sRtcpFeedbackReceiversMutex.lock();
+    sRtcpFeedbackReceivers[mLocalSourceIdentifier] = this;
+    mRtcpFeedbackReceiverIdentifier = mLocalSourceIdentifier;
+    sRtcpFeedbackReceiversMutex.unlock();
+
+    LOG(LOG_VERBOSE, "Registered local source %u for RTCP feedback", mRtcpFeedbackReceiverIdentifier);
+}
+
+void RTP::RtcpUnregisterFeedbackReceiver()
+{
+    if (mRtcpFeedbackReceiverIdentifier == 0)
+        return;
+
+    sRtcpFeedbackReceiversMutex.lock();
+    RtcpFeedbackReceivers::iterator tIt = sRtcpFeedbackReceivers.find(mRtcpFeedbackReceiverIdentifier);
+    if ((tIt != sRtcpFeedbackReceivers.end()) && (tIt->second == this))
+        sRtcpFeedbackReceivers.erase(tIt);
+    mRtcpFeedbackReceiverIdentifier = 0;
+    sRtcpFeedbackReceiversMutex.unlock();
+}
+
+void RTP::RtcpReceivedNack(unsigned short *pSequenceNumbers, int pCount)
+{
+    LOG(LOG_VERBOSE, "Ignoring NACK for %d packets", pCount);
+}
+
+void RTP::RtcpReceivedReport(RtcpReportBlock *pReport, int64_t pArrivalTime)
+{
+    LOG(LOG_VERBOSE, "Ignoring receiver report for source %u", pReport->Ssrc);
+}
+
+void RTP::RtcpReceivedKeyFrameRequest(unsigned int pRequesterIdentifier, int pFirSequenceNumber)
+{
+    LOG(LOG_VERBOSE, "Ignoring key frame request from source %u", pRequesterIdentifier);
+}
+
 void RTP::SetSynchronizationReferenceForRTP(uint64_t pReferenceNtpTime, uint64_t pReferencePts)
 {
     if (!mRtpEncoderOpened)
@@ -3327,6 +4033,7 @@ void RTP::RtcpPatchLiveSenderReport(char *pHeader, uint32_t pTimestamp)
     tRtcpHeader->Feedback.TimestampHigh = tNtpTime / 1000000;
     tRtcpHeader->Feedback.TimestampLow = ((tNtpTime % 1000000) << 32) / 1000000;
     tRtcpHeader->Feedback.RtpTimestamp = tPts;
+    RtcpStoreSentSenderReport(tRtcpHeader->Feedback.TimestampHigh, tRtcpHeader->Feedback.TimestampLow);
 
     #ifdef RTCP_DEBUG_PACKET_ENCODER_FFMPEG
         LOG(LOG_VERBOSE, "Setting RTCP synch.: (RTP %u, NTP: US %lu, high %u/%lu, low %u/%lu,  DE %lu / %lu)", pTimestamp, tNtpTime, tRtcpHeader->Feedback.TimestampHigh, tNtpTime / 1000000, tRtcpHeader->Feedback.TimestampLow, ((tNtpTime % 1000000) << 32) / 1000000, tNtpTime - NTP_OFFSET_US, av_gettime());
@@ -3380,6 +4087,7 @@ void RTP::RtcpCreateH261SenderReport(char *&pData /* current stream pointer */,
         tRtcpHeader->Feedback.RtpTimestamp = pCurPts * CalculateClockRateFactor() /* 90 kHz clock rate */;
         tRtcpHeader->Feedback.Packets = mH261SentPackets;
         tRtcpHeader->Feedback.Octets = mH261SentOctets;
+        RtcpStoreSentSenderReport(tRtcpHeader->Feedback.TimestampHigh, tRtcpHeader->Feedback.TimestampLow);
 
         // convert from host to network byte order
         for (int i = 0; i < 7; i++)
@@ -0,0 +1,298 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: Implementation of a sender side congestion control for RTP streams
+ * Since:   2026-10-16
+ */
+
+#include <RTPCongestionControl.h>
+#include <Logger.h>
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPCongestionControl::RTPCongestionControl()
+{
+    mMinBitRate = RTP_CONGESTION_CONTROL_MIN_BIT_RATE;
+    mMaxBitRate = RTP_CONGESTION_CONTROL_MAX_BIT_RATE;
+    Reset(mMinBitRate);
+}
+
+RTPCongestionControl::~RTPCongestionControl()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPCongestionControl::SetBitRateLimits(int pMinBitRate, int pMaxBitRate)
+{
+    if (pMinBitRate < 1)
+        pMinBitRate = 1;
+    if (pMaxBitRate < pMinBitRate)
+        pMaxBitRate = pMinBitRate;
+
+    mMutex.lock();
+    mMinBitRate = pMinBitRate;
+    mMaxBitRate = pMaxBitRate;
+    if (mTargetBitRate < mMinBitRate)
+        mTargetBitRate = mMinBitRate;
+    if (mTargetBitRate > mMaxBitRate)
+        mTargetBitRate = mMaxBitRate;
+    mMutex.unlock();
+}
+
+void RTPCongestionControl::Reset(int pStartBitRate)
+{
+    mMutex.lock();
+    mTargetBitRate = pStartBitRate;
+    if (mTargetBitRate < mMinBitRate)
+        mTargetBitRate = mMinBitRate;
+    if (mTargetBitRate > mMaxBitRate)
+        mTargetBitRate = mMaxBitRate;
+    mLastUpdate = 0;
+    mSentBytes = 0;
+    mSentPackets = 0;
+    mLostPackets = 0;
+    mReportedLoss = -1;
+    mMaxQueueUsage = 0;
+    mDelaySampleCount = 0;
+    mDelaySampleHead = 0;
+    mSentBitRate = 0;
+    mLoss = 0;
+    mDelayGradient = 0;
+    mSignal = CONGESTION_NORMAL;
+    mMutex.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPCongestionControl::AnnounceSentPacket(int pSize)
+{
+    mMutex.lock();
+    mSentBytes += pSize;
+    mSentPackets++;
+    mMutex.unlock();
+}
+
+void RTPCongestionControl::AnnounceQueueUsage(int pUsage, int pSize)
+{
+    if (pSize <= 0)
+        return;
+
+    int tUsage = pUsage * 100 / pSize;
+
+    mMutex.lock();
+    if (tUsage > mMaxQueueUsage)
+        mMaxQueueUsage = tUsage;
+    mMutex.unlock();
+}
+
+void RTPCongestionControl::AnnounceLostPackets(int pCount)
+{
+    mMutex.lock();
+    mLostPackets += pCount;
+    mMutex.unlock();
+}
+
+void RTPCongestionControl::AnnounceReportedLoss(int pLoss)
+{
+    mMutex.lock();
+    if (pLoss > mReportedLoss)
+        mReportedLoss = pLoss;
+    mMutex.unlock();
+}
+
+void RTPCongestionControl::AnnounceDelay(int64_t pDelay, int64_t pNow)
+{
+    mMutex.lock();
+    int tIndex = (mDelaySampleHead + mDelaySampleCount) % RTP_CONGESTION_CONTROL_DELAY_SAMPLES;
+    if (mDelaySampleCount == RTP_CONGESTION_CONTROL_DELAY_SAMPLES)
+        mDelaySampleHead = (mDelaySampleHead + 1) % RTP_CONGESTION_CONTROL_DELAY_SAMPLES;
+    else
+        mDelaySampleCount++;
+    mDelaySamples[tIndex].Time = pNow;
+    mDelaySamples[tIndex].Delay = pDelay;
+    mMutex.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// HINT: has to be called with locked mutex
+enum CongestionSignal RTPCongestionControl::DetectOveruse(int64_t pNow)
+{
+    mDelayGradient = 0;
+
+    // a growing send queue shows an overuse of the local uplink
+    if (mMaxQueueUsage > RTP_CONGESTION_CONTROL_QUEUE_THRESHOLD)
+        return CONGESTION_OVERUSE;
+
+    // forget outdated delay samples
+    while ((mDelaySampleCount > 0) && (pNow - mDelaySamples[mDelaySampleHead].Time > RTP_CONGESTION_CONTROL_DELAY_MAX_AGE * 1000))
+    {
+        mDelaySampleHead = (mDelaySampleHead + 1) % RTP_CONGESTION_CONTROL_DELAY_SAMPLES;
+        mDelaySampleCount--;
+    }
+    if (mDelaySampleCount < 4)
+        return CONGESTION_NORMAL;
+
+    // the slope of a linear regression through the delay samples gives the delay gradient
+    double tMeanTime = 0, tMeanDelay = 0;
+    for (int i = 0; i < mDelaySampleCount; i++)
+    {
+        CongestionDelaySample *tSample = &mDelaySamples[(mDelaySampleHead + i) % RTP_CONGESTION_CONTROL_DELAY_SAMPLES];
+        tMeanTime += (double)(tSample->Time - mDelaySamples[mDelaySampleHead].Time);
+        tMeanDelay += (double)tSample->Delay;
+    }
+    tMeanTime /= mDelaySampleCount;
+    tMeanDelay /= mDelaySampleCount;
+
+    double tCovariance = 0, tVariance = 0;
+    for (int i = 0; i < mDelaySampleCount; i++)
+    {
+        CongestionDelaySample *tSample = &mDelaySamples[(mDelaySampleHead + i) % RTP_CONGESTION_CONTROL_DELAY_SAMPLES];
+        double tTime = (double)(tSample->Time - mDelaySamples[mDelaySampleHead].Time) - tMeanTime;
+        tCovariance += tTime * ((double)tSample->Delay - tMeanDelay);
+        tVariance += tTime * tTime;
+    }
+    if (tVariance <= 0)
+        return CONGESTION_NORMAL;
+
+    // delay growth within the sample window
+    int64_t tWindow = mDelaySamples[(mDelaySampleHead + mDelaySampleCount - 1) % RTP_CONGESTION_CONTROL_DELAY_SAMPLES].Time - mDelaySamples[mDelaySampleHead].Time;
+    mDelayGradient = (int)(tCovariance / tVariance * tWindow / 1000);
+
+    if (mDelayGradient > RTP_CONGESTION_CONTROL_DELAY_THRESHOLD)
+        return CONGESTION_OVERUSE;
+    if (mDelayGradient < -RTP_CONGESTION_CONTROL_DELAY_THRESHOLD)
+        return CONGESTION_UNDERUSE;
+
+    return CONGESTION_NORMAL;
+}
+
+bool RTPCongestionControl::Update(int64_t pNow)
+{
+    if (mLastUpdate == 0)
+    {
+        mLastUpdate = pNow;
+        return false;
+    }
+
+    int64_t tPeriod = pNow - mLastUpdate;
+    if (tPeriod < RTP_CONGESTION_CONTROL_PERIOD * 1000)
+        return false;
+    mLastUpdate = pNow;
+
+    mMutex.lock();
+
+    // measure the loss and the actually sent rate of the last period
+    int tLoss = -1;
+    if (mSentPackets > 0)
+    {
+        tLoss = mLostPackets * 100 / mSentPackets;
+        if (tLoss > 100)
+            tLoss = 100;
+    }
+    // NACKs and receiver reports describe the same lost packets, hence the higher loss is used
+    if (mReportedLoss > tLoss)
+        tLoss = mReportedLoss;
+    if (tLoss >= 0)
+    {
+        mLoss = (mLoss + tLoss) / 2;
+        if ((mLoss == 0) && (tLoss > 0))
+            mLoss = 1;
+    }
+    mSentBitRate = (int)(mSentBytes * 8 * 1000000 / tPeriod);
+    mSignal = DetectOveruse(pNow);
+    mSentBytes = 0;
+    mSentPackets = 0;
+    mLostPackets = 0;
+    mReportedLoss = -1;
+    mMaxQueueUsage = 0;
+
+    int tTargetBitRate = mTargetBitRate;
+    if (mSignal == CONGESTION_OVERUSE)
+    {// let the queues drain
+        int tBaseBitRate = ((mSentBitRate > 0) && (mSentBitRate < tTargetBitRate)) ? mSentBitRate : tTargetBitRate;
+        tTargetBitRate = (int)((int64_t)tBaseBitRate * RTP_CONGESTION_CONTROL_DECREASE / 100);
+    }else if (mLoss > RTP_CONGESTION_CONTROL_LOSS_HIGH)
+    {// the path is lossy: rate * (1 - loss / 2)
+        tTargetBitRate = (int)((int64_t)tTargetBitRate * (200 - mLoss) / 200);
+    }else if ((mLoss < RTP_CONGESTION_CONTROL_LOSS_LOW) && (mSignal == CONGESTION_NORMAL))
+    {// probe for more bandwidth, but only if the sender uses the current rate
+        int tIncreasedBitRate = tTargetBitRate + (int)((int64_t)tTargetBitRate * RTP_CONGESTION_CONTROL_INCREASE * tPeriod / (100 * 1000000));
+        if ((int64_t)tIncreasedBitRate * 100 <= (int64_t)mSentBitRate * RTP_CONGESTION_CONTROL_MAX_PROBING)
+            tTargetBitRate = tIncreasedBitRate;
+    }
+    // otherwise the rate is held: queues are draining or the loss is moderate
+
+    if (tTargetBitRate < mMinBitRate)
+        tTargetBitRate = mMinBitRate;
+    if (tTargetBitRate > mMaxBitRate)
+        tTargetBitRate = mMaxBitRate;
+
+    bool tResult = (tTargetBitRate != mTargetBitRate);
+
+    #ifdef RTP_CONGESTION_CONTROL_DEBUG
+        LOG(LOG_VERBOSE, "Target bit rate: %d => %d, sent: %d bit/s, loss: %d percent, delay gradient: %d ms, signal: %d", mTargetBitRate, tTargetBitRate, mSentBitRate, mLoss, mDelayGradient, (int)mSignal);
+    #endif
+
+    mTargetBitRate = tTargetBitRate;
+
+    mMutex.unlock();
+
+    return tResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int RTPCongestionControl::GetTargetBitRate()
+{
+    return mTargetBitRate;
+}
+
+int RTPCongestionControl::GetSentBitRate()
+{
+    return mSentBitRate;
+}
+
+int RTPCongestionControl::GetLoss()
+{
+    return mLoss;
+}
+
+int RTPCongestionControl::GetDelayGradient()
+{
+    return mDelayGradient;
+}
+
+enum CongestionSignal RTPCongestionControl::GetSignal()
+{
+    return mSignal;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
@@ -0,0 +1,259 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: Implementation of the recovery of lost RTP packets by XOR based forward error correction
+ * Since:   2026-10-16
+ */
+
+#include <RTPFecDecoder.h>
+#include <RTP.h>
+#include <Logger.h>
+
+#include <stdlib.h>
+#include <string.h> // memcpy
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+// RTCP packets which are transported within the RTP stream aren't protected
+#define IS_RTCP_TYPE(x)                 (((x) >= 72) && ((x) <= 78))
+
+// offsets within a FEC packet, the FEC header follows the RTP header
+#define FEC_RECOVERY_FLAGS              (RTP_HEADER_SIZE + 0)   // E, L, P, X, CC
+#define FEC_RECOVERY_PAYLOAD_TYPE       (RTP_HEADER_SIZE + 1)   // M, PT
+#define FEC_SEQUENCE_NUMBER_BASE        (RTP_HEADER_SIZE + 2)
+#define FEC_RECOVERY_TIMESTAMP          (RTP_HEADER_SIZE + 4)
+#define FEC_RECOVERY_LENGTH             (RTP_HEADER_SIZE + 8)
+#define FEC_PROTECTION_LENGTH           (RTP_HEADER_SIZE + 10)
+#define FEC_MASK                        (RTP_HEADER_SIZE + 12)
+#define FEC_PAYLOAD                     (RTP_HEADER_SIZE + RTP_FEC_HEADER_SIZE)
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPFecDecoder::RTPFecDecoder(int pPacketSize, int pCapacity)
+{
+    mPacketSize = pPacketSize;
+    mCapacity = pCapacity;
+    mSlots = (FecDecoderSlot*)malloc(mCapacity * sizeof(FecDecoderSlot));
+    mSlotMemory = (char*)malloc(mCapacity * mPacketSize);
+    mRecoveredPacket = (char*)malloc(mPacketSize);
+    for (int i = 0; i < mCapacity; i++)
+        mSlots[i].Data = mSlotMemory + i * mPacketSize;
+    Reset();
+}
+
+RTPFecDecoder::~RTPFecDecoder()
+{
+    free(mRecoveredPacket);
+    free(mSlotMemory);
+    free(mSlots);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPFecDecoder::Reset()
+{
+    for (int i = 0; i < mCapacity; i++)
+    {
+        mSlots[i].Size = 0;
+        mSlots[i].SequenceNumber = 0;
+        mSlots[i].Used = false;
+    }
+    mActive = false;
+    mRecoveredPackets = 0;
+    mUnrecoverablePackets = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPFecDecoder::IsFecPacket(char *pPacket, int pPacketSize)
+{
+    unsigned char *tHeader = (unsigned char*)pPacket;
+
+    return ((pPacketSize >= (int)FEC_PAYLOAD) && ((tHeader[0] >> 6) == 2) && ((tHeader[1] & 0x7F) == RTP_PAYLOAD_TYPE_FEC));
+}
+
+void RTPFecDecoder::StorePacket(char *pPacket, int pPacketSize)
+{
+    unsigned char *tHeader = (unsigned char*)pPacket;
+
+    if ((!mActive) || (pPacketSize < (int)RTP_HEADER_SIZE) || (pPacketSize > mPacketSize) || ((tHeader[0] >> 6) != 2) || (IS_RTCP_TYPE(tHeader[1] & 0x7F)))
+        return;
+
+    // the header is still in network byte order
+    unsigned short tSequenceNumber = (unsigned short)(((unsigned int)tHeader[2] << 8) | (unsigned int)tHeader[3]);
+    FecDecoderSlot *tSlot = &mSlots[tSequenceNumber % mCapacity];
+
+    memcpy(tSlot->Data, pPacket, pPacketSize);
+    tSlot->Size = pPacketSize;
+    tSlot->SequenceNumber = tSequenceNumber;
+    tSlot->Used = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPFecDecoder::RecoverPacket(char *pFecPacket, int pFecPacketSize, char **pPacket, int &pPacketSize)
+{
+    unsigned char *tFecPacket = (unsigned char*)pFecPacket;
+    unsigned char *tRecoveredPacket = (unsigned char*)mRecoveredPacket;
+
+    // the packets of the first group weren't stored
+    if (!mActive)
+    {
+        LOG(LOG_VERBOSE, "Received first FEC packet, activating recovery of lost packets");
+        mActive = true;
+        return false;
+    }
+
+    // we support only the short mask of the ULP level 0 header
+    if ((tFecPacket[FEC_RECOVERY_FLAGS] & 0xC0) != 0)
+    {
+        #ifdef RTP_FEC_DECODER_DEBUG
+            LOG(LOG_VERBOSE, "Unsupported FEC packet with flags 0x%02x", tFecPacket[FEC_RECOVERY_FLAGS]);
+        #endif
+        return false;
+    }
+
+    unsigned short tBase = (unsigned short)(((unsigned int)tFecPacket[FEC_SEQUENCE_NUMBER_BASE] << 8) | (unsigned int)tFecPacket[FEC_SEQUENCE_NUMBER_BASE + 1]);
+    int tProtectionLength = ((int)tFecPacket[FEC_PROTECTION_LENGTH] << 8) | (int)tFecPacket[FEC_PROTECTION_LENGTH + 1];
+    unsigned int tMask = ((unsigned int)tFecPacket[FEC_MASK] << 8) | (unsigned int)tFecPacket[FEC_MASK + 1];
+
+    if ((pFecPacketSize < (int)FEC_PAYLOAD + tProtectionLength) || ((int)RTP_HEADER_SIZE + tProtectionLength > mPacketSize))
+    {
+        LOG(LOG_WARN, "Received invalid FEC packet with %d bytes for a protection length of %d bytes", pFecPacketSize, tProtectionLength);
+        return false;
+    }
+
+    // find the lost packets of the group
+    int tMissingPackets = 0;
+    unsigned short tMissingSequenceNumber = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        if ((tMask & (0x8000 >> i)) == 0)
+            continue;
+
+        unsigned short tSequenceNumber = (unsigned short)(tBase + i);
+        FecDecoderSlot *tSlot = &mSlots[tSequenceNumber % mCapacity];
+        if ((!tSlot->Used) || (tSlot->SequenceNumber != tSequenceNumber))
+        {
+            tMissingSequenceNumber = tSequenceNumber;
+            tMissingPackets++;
+        }
+    }
+
+    if (tMissingPackets == 0)
+        return false;
+
+    if (tMissingPackets > 1)
+    {
+        #ifdef RTP_FEC_DECODER_DEBUG
+            LOG(LOG_VERBOSE, "Can't recover %d lost packets of FEC group starting at %hu", tMissingPackets, tBase);
+        #endif
+        mUnrecoverablePackets += tMissingPackets;
+        return false;
+    }
+
+    // start with the recovery fields of the FEC packet, see RFC 5109, section 8.2
+    unsigned char tFlags = tFecPacket[FEC_RECOVERY_FLAGS];
+    unsigned char tPayloadType = tFecPacket[FEC_RECOVERY_PAYLOAD_TYPE];
+    unsigned char tTimestamp[4];
+    memcpy(tTimestamp, tFecPacket + FEC_RECOVERY_TIMESTAMP, 4);
+    int tLength = ((int)tFecPacket[FEC_RECOVERY_LENGTH] << 8) | (int)tFecPacket[FEC_RECOVERY_LENGTH + 1];
+    memcpy(tRecoveredPacket + RTP_HEADER_SIZE, tFecPacket + FEC_PAYLOAD, tProtectionLength);
+
+    // XOR the received packets of the group
+    for (int i = 0; i < 16; i++)
+    {
+        unsigned short tSequenceNumber = (unsigned short)(tBase + i);
+        if (((tMask & (0x8000 >> i)) == 0) || (tSequenceNumber == tMissingSequenceNumber))
+            continue;
+
+        FecDecoderSlot *tSlot = &mSlots[tSequenceNumber % mCapacity];
+        unsigned char *tPacket = (unsigned char*)tSlot->Data;
+        int tPayloadSize = tSlot->Size - (int)RTP_HEADER_SIZE;
+        if (tPayloadSize > tProtectionLength)
+            tPayloadSize = tProtectionLength;
+
+        tFlags ^= tPacket[0] & 0x3F;
+        tPayloadType ^= tPacket[1];
+        for (int j = 0; j < 4; j++)
+            tTimestamp[j] ^= tPacket[4 + j];
+        tLength ^= tSlot->Size - (int)RTP_HEADER_SIZE;
+        for (int j = 0; j < tPayloadSize; j++)
+            tRecoveredPacket[RTP_HEADER_SIZE + j] ^= tPacket[RTP_HEADER_SIZE + j];
+    }
+
+    if (tLength > tProtectionLength)
+    {
+        LOG(LOG_WARN, "Recovered packet %hu has invalid length of %d bytes, protection length is %d bytes", tMissingSequenceNumber, tLength, tProtectionLength);
+        mUnrecoverablePackets++;
+        return false;
+    }
+
+    // the source identifier is the one of the FEC packet
+    tRecoveredPacket[0] = 0x80 | (tFlags & 0x3F);
+    tRecoveredPacket[1] = tPayloadType;
+    tRecoveredPacket[2] = (unsigned char)(tMissingSequenceNumber >> 8);
+    tRecoveredPacket[3] = (unsigned char)(tMissingSequenceNumber & 0xFF);
+    memcpy(tRecoveredPacket + 4, tTimestamp, 4);
+    memcpy(tRecoveredPacket + 8, tFecPacket + 8, 4);
+
+    *pPacket = mRecoveredPacket;
+    pPacketSize = (int)RTP_HEADER_SIZE + tLength;
+    mRecoveredPackets++;
+
+    #ifdef RTP_FEC_DECODER_DEBUG
+        LOG(LOG_VERBOSE, "Recovered packet %hu with %d bytes from FEC group starting at %hu", tMissingSequenceNumber, pPacketSize, tBase);
+    #endif
+
+    return true;
+}
+
+void RTPFecDecoder::AnnounceLateRecovery()
+{
+    if (mRecoveredPackets > 0)
+        mRecoveredPackets--;
+    mUnrecoverablePackets++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPFecDecoder::IsActive()
+{
+    return mActive;
+}
+
+uint64_t RTPFecDecoder::GetRecoveredPackets()
+{
+    return mRecoveredPackets;
+}
+
+uint64_t RTPFecDecoder::GetUnrecoverablePackets()
+{
+    return mUnrecoverablePackets;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
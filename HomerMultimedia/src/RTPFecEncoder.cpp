@@ -0,0 +1,291 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: Implementation of XOR based forward error correction for sent RTP packets
+ * Since:   2026-10-16
+ */
+
+#include <RTPFecEncoder.h>
+#include <RTP.h>
+#include <Logger.h>
+
+#include <stdlib.h>
+#include <string.h> // memcpy, memset
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+// RTCP packets which are transported within the RTP stream aren't protected
+#define IS_RTCP_TYPE(x)                 (((x) >= 72) && ((x) <= 78))
+
+// offsets within a FEC packet, the FEC header follows the RTP header
+#define FEC_RECOVERY_FLAGS              (RTP_HEADER_SIZE + 0)   // E, L, P, X, CC
+#define FEC_RECOVERY_PAYLOAD_TYPE       (RTP_HEADER_SIZE + 1)   // M, PT
+#define FEC_SEQUENCE_NUMBER_BASE        (RTP_HEADER_SIZE + 2)
+#define FEC_RECOVERY_TIMESTAMP          (RTP_HEADER_SIZE + 4)
+#define FEC_RECOVERY_LENGTH             (RTP_HEADER_SIZE + 8)
+#define FEC_PROTECTION_LENGTH           (RTP_HEADER_SIZE + 10)
+#define FEC_MASK                        (RTP_HEADER_SIZE + 12)
+#define FEC_PAYLOAD                     (RTP_HEADER_SIZE + RTP_FEC_HEADER_SIZE)
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPFecEncoder::RTPFecEncoder(int pPacketSize)
+{
+    mPacketSize = pPacketSize;
+    mFecPacket = (char*)malloc(FEC_PAYLOAD + mPacketSize);
+    mMaxOverhead = 0;
+    mAdaptive = false;
+    mGroupSize = RTP_FEC_GROUP_SIZE_MAX;
+    mFecSequenceNumber = (unsigned short)rand();
+    Reset();
+}
+
+RTPFecEncoder::~RTPFecEncoder()
+{
+    free(mFecPacket);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPFecEncoder::SetProtection(int pMaxOverhead, bool pAdaptive)
+{
+    if (pMaxOverhead < 0)
+        pMaxOverhead = 0;
+    if (pMaxOverhead > 100)
+        pMaxOverhead = 100;
+
+    LOG(LOG_VERBOSE, "Setting FEC protection to %s%d percent", pAdaptive ? "max. " : "", pMaxOverhead);
+
+    mMutex.lock();
+    mMaxOverhead = pMaxOverhead;
+    mAdaptive = pAdaptive;
+    mMutex.unlock();
+
+    AdaptGroupSize();
+}
+
+void RTPFecEncoder::Reset()
+{
+    mMutex.lock();
+    mGroupPackets = 0;
+    mGroupBase = 0;
+    mGroupProtectionLength = 0;
+    mLostPackets = 0;
+    mSentPackets = 0;
+    mLoss = 0;
+    mLossReported = false;
+    mFecPackets = 0;
+    mMutex.unlock();
+
+    AdaptGroupSize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPFecEncoder::StartGroup(unsigned short pSequenceNumber)
+{
+    // the payload area is cleared lazily whenever a longer packet is added
+    memset(mFecPacket, 0, FEC_PAYLOAD);
+    mFecPacket[0] = (char)0x80; // version 2
+    mFecPacket[1] = RTP_PAYLOAD_TYPE_FEC;
+    mFecPacket[FEC_SEQUENCE_NUMBER_BASE] = (char)(pSequenceNumber >> 8);
+    mFecPacket[FEC_SEQUENCE_NUMBER_BASE + 1] = (char)(pSequenceNumber & 0xFF);
+    mGroupBase = pSequenceNumber;
+    mGroupPackets = 0;
+    mGroupProtectionLength = 0;
+}
+
+bool RTPFecEncoder::AddPacket(char *pPacket, int pPacketSize, char **pFecPacket, int &pFecPacketSize)
+{
+    unsigned char *tHeader = (unsigned char*)pPacket;
+    unsigned char *tFecPacket = (unsigned char*)mFecPacket;
+
+    if ((mMaxOverhead == 0) || (pPacketSize < (int)RTP_HEADER_SIZE) || (IS_RTCP_TYPE(tHeader[1] & 0x7F)))
+        return false;
+
+    int tPayloadSize = pPacketSize - (int)RTP_HEADER_SIZE;
+    if (pPacketSize > mPacketSize)
+    {
+        LOG(LOG_ERROR, "FEC packets are limited to %d protected bytes, packet with %d bytes stays unprotected", mPacketSize, pPacketSize);
+        return false;
+    }
+
+    // the header is still in network byte order
+    unsigned short tSequenceNumber = (unsigned short)(((unsigned int)tHeader[2] << 8) | (unsigned int)tHeader[3]);
+
+    // a group consists of consecutive packets, otherwise the mask can't describe it
+    if ((mGroupPackets > 0) && ((unsigned short)(tSequenceNumber - mGroupBase) != mGroupPackets))
+    {
+        #ifdef RTP_FEC_ENCODER_DEBUG
+            LOG(LOG_VERBOSE, "Packet %hu doesn't continue FEC group starting at %hu, dropping %d protected packets", tSequenceNumber, mGroupBase, mGroupPackets);
+        #endif
+        mGroupPackets = 0;
+    }
+    if (mGroupPackets == 0)
+        StartGroup(tSequenceNumber);
+
+    // XOR the recovery fields, see RFC 5109, section 7.3
+    tFecPacket[FEC_RECOVERY_FLAGS] ^= tHeader[0] & 0x3F;
+    tFecPacket[FEC_RECOVERY_PAYLOAD_TYPE] ^= tHeader[1];
+    for (int i = 0; i < 4; i++)
+        tFecPacket[FEC_RECOVERY_TIMESTAMP + i] ^= tHeader[4 + i];
+    tFecPacket[FEC_RECOVERY_LENGTH] ^= (unsigned char)(tPayloadSize >> 8);
+    tFecPacket[FEC_RECOVERY_LENGTH + 1] ^= (unsigned char)(tPayloadSize & 0xFF);
+
+    // XOR everything behind the fixed RTP header
+    if (tPayloadSize > mGroupProtectionLength)
+    {
+        memset(tFecPacket + FEC_PAYLOAD + mGroupProtectionLength, 0, tPayloadSize - mGroupProtectionLength);
+        mGroupProtectionLength = tPayloadSize;
+    }
+    for (int i = 0; i < tPayloadSize; i++)
+        tFecPacket[FEC_PAYLOAD + i] ^= tHeader[RTP_HEADER_SIZE + i];
+
+    // mark the packet in the mask, the MSB corresponds to the base sequence number
+    unsigned int tMask = 0x8000 >> mGroupPackets;
+    tFecPacket[FEC_MASK] |= (unsigned char)(tMask >> 8);
+    tFecPacket[FEC_MASK + 1] |= (unsigned char)(tMask & 0xFF);
+    mGroupPackets++;
+
+    // timestamp and source identifier of the last protected packet
+    memcpy(tFecPacket + 4, tHeader + 4, 8);
+
+    // the loss estimation is based on the media packets only
+    if (++mSentPackets >= RTP_FEC_ADAPTION_PERIOD)
+        AdaptGroupSize();
+
+    // close the group if it is complete or if a half filled group ends with a frame
+    bool tEndOfFrame = ((tHeader[1] & 0x80) != 0);
+    int tMinGroupPackets = mGroupSize / 2;
+    if (tMinGroupPackets < 2)
+        tMinGroupPackets = 2;
+    if ((mGroupPackets < mGroupSize) && ((!tEndOfFrame) || (mGroupPackets < tMinGroupPackets)))
+        return false;
+
+    tFecPacket[FEC_PROTECTION_LENGTH] = (unsigned char)(mGroupProtectionLength >> 8);
+    tFecPacket[FEC_PROTECTION_LENGTH + 1] = (unsigned char)(mGroupProtectionLength & 0xFF);
+    tFecPacket[2] = (unsigned char)(mFecSequenceNumber >> 8);
+    tFecPacket[3] = (unsigned char)(mFecSequenceNumber & 0xFF);
+    mFecSequenceNumber++;
+
+    *pFecPacket = mFecPacket;
+    pFecPacketSize = FEC_PAYLOAD + mGroupProtectionLength;
+    mFecPackets++;
+
+    #ifdef RTP_FEC_ENCODER_DEBUG
+        LOG(LOG_VERBOSE, "Created FEC packet for %d packets starting at %hu with %d bytes", mGroupPackets, mGroupBase, pFecPacketSize);
+    #endif
+
+    mGroupPackets = 0;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPFecEncoder::AnnounceLoss(int pLostPackets)
+{
+    mMutex.lock();
+    mLostPackets += pLostPackets;
+    mLossReported = true;
+    mMutex.unlock();
+}
+
+void RTPFecEncoder::AdaptGroupSize()
+{
+    mMutex.lock();
+
+    // update the smoothed loss if a complete period was sent
+    if (mSentPackets >= RTP_FEC_ADAPTION_PERIOD)
+    {
+        int tLoss = mLostPackets * 100 / mSentPackets;
+        if (tLoss > 100)
+            tLoss = 100;
+        mLoss = (mLoss + tLoss) / 2;
+        if ((mLoss == 0) && (tLoss > 0))
+            mLoss = 1;
+        mLostPackets = 0;
+        mSentPackets = 0;
+    }
+
+    // the configured overhead is the lower border of the group size
+    int tMinGroupSize = RTP_FEC_GROUP_SIZE_MAX;
+    if (mMaxOverhead > 0)
+        tMinGroupSize = 100 / mMaxOverhead;
+    if (tMinGroupSize < 1)
+        tMinGroupSize = 1;
+    if (tMinGroupSize > RTP_FEC_GROUP_SIZE_MAX)
+        tMinGroupSize = RTP_FEC_GROUP_SIZE_MAX;
+
+    int tGroupSize = tMinGroupSize;
+    if ((mAdaptive) && (mLossReported))
+    {
+        if (mLoss > 0)
+            tGroupSize = 100 / (RTP_FEC_LOSS_FACTOR * mLoss);
+        else
+            tGroupSize = RTP_FEC_GROUP_SIZE_MAX;
+        if (tGroupSize < tMinGroupSize)
+            tGroupSize = tMinGroupSize;
+        if (tGroupSize > RTP_FEC_GROUP_SIZE_MAX)
+            tGroupSize = RTP_FEC_GROUP_SIZE_MAX;
+    }
+
+    #ifdef RTP_FEC_ENCODER_DEBUG
+        if (tGroupSize != mGroupSize)
+            LOG(LOG_VERBOSE, "Changing FEC group size from %d to %d, smoothed loss is %d percent", mGroupSize, tGroupSize, mLoss);
+    #endif
+    mGroupSize = tGroupSize;
+
+    mMutex.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPFecEncoder::IsActive()
+{
+    return (mMaxOverhead > 0);
+}
+
+int RTPFecEncoder::GetProtection()
+{
+    if (mMaxOverhead == 0)
+        return 0;
+
+    return 100 / mGroupSize;
+}
+
+int RTPFecEncoder::GetLoss()
+{
+    return mLoss;
+}
+
+uint64_t RTPFecEncoder::GetFecPackets()
+{
+    return mFecPackets;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
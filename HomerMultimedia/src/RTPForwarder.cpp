@@ -0,0 +1,529 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: Implementation of the selective forwarding of received RTP packets to one receiver
+ * Since:   2026-10-16
+ */
+
+#include <RTPForwarder.h>
+#include <RTP.h>
+#include <Logger.h>
+
+#include <stdlib.h>
+#include <string.h> // memcpy
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+// RTCP packets which are transported within the RTP stream
+#define IS_RTCP_TYPE(x)                 (((x) >= 72) && ((x) <= 78))
+
+// sender report without report blocks
+#define RTCP_SR_TYPE                    200
+#define RTCP_SR_SIZE                    28
+
+// the VOP header of MPEG-4 is preceded at most by the VOS, VO and VOL headers
+#define MPEG4_VOP_SEARCH_LIMIT          128
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the header fields are in network byte order
+static uint32_t ReadUint32(unsigned char *pData)
+{
+    return ((uint32_t)pData[0] << 24) | ((uint32_t)pData[1] << 16) | ((uint32_t)pData[2] << 8) | (uint32_t)pData[3];
+}
+
+static void WriteUint32(unsigned char *pData, uint32_t pValue)
+{
+    pData[0] = (unsigned char)(pValue >> 24);
+    pData[1] = (unsigned char)((pValue >> 16) & 0xFF);
+    pData[2] = (unsigned char)((pValue >> 8) & 0xFF);
+    pData[3] = (unsigned char)(pValue & 0xFF);
+}
+
+// IDR slices and parameter sets belong to a key frame, other slices are reference or non-reference data, see RFC 6184, section 5.3
+static bool ClassifyH264NalUnit(unsigned char pNalHeader, enum RTPForwarderFrameType &pType)
+{
+    switch(pNalHeader & 0x1F)
+    {
+        case 5: // IDR slice
+        case 7: // sequence parameter set
+        case 8: // picture parameter set
+            pType = RTP_FORWARDER_FRAME_KEY;
+            return true;
+        case 1: // non-IDR slice
+        case 2: // slice data partition A
+            if (pType != RTP_FORWARDER_FRAME_KEY)
+                pType = ((pNalHeader & 0x60) != 0) ? RTP_FORWARDER_FRAME_REFERENCE : RTP_FORWARDER_FRAME_NON_REFERENCE;
+            return true;
+        default:
+            return false;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPForwarder::RTPForwarder(int pPacketSize, bool pVideo)
+{
+    mPacketSize = pPacketSize;
+    mPacket = (char*)malloc(mPacketSize);
+    mVideo = pVideo;
+    mSourceIdentifier = 0;
+    mLayer = RTP_FORWARDER_LAYER_ALL;
+    mSequenceNumberOffset = 0;
+    mNextSequenceNumber = (unsigned short)rand();
+    mTimestampOffset = 0;
+    mLastTimestamp = (uint32_t)rand();
+    mForwardedPackets = 0;
+    mForwardedOctets = 0;
+    mSkippedPackets = 0;
+    mSkippedFrames = 0;
+    Reset();
+}
+
+RTPForwarder::~RTPForwarder()
+{
+    free(mPacket);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPForwarder::SetSourceIdentifier(unsigned int pSourceIdentifier)
+{
+    mSourceIdentifier = pSourceIdentifier;
+}
+
+void RTPForwarder::SetLayer(enum RTPForwarderLayer pLayer)
+{
+    if (mLayer != pLayer)
+        LOG(LOG_VERBOSE, "Forwarding %s", (pLayer == RTP_FORWARDER_LAYER_BASE) ? "key and reference frames only" : "all frames");
+    mLayer = pLayer;
+}
+
+enum RTPForwarderLayer RTPForwarder::GetLayer()
+{
+    return mLayer;
+}
+
+void RTPForwarder::Reset()
+{
+    mInputSourceKnown = false;
+    mInputSourceIdentifier = 0;
+    mFrameKnown = false;
+    mFrameTimestamp = 0;
+    mFrameType = mVideo ? RTP_FORWARDER_FRAME_REFERENCE : RTP_FORWARDER_FRAME_AUDIO;
+    mFrameThinned = false;
+    mFrameDropped = false;
+    mFrameForwarded = false;
+    mFrameLastForwardTime = 0;
+    mWaitingForKeyFrame = mVideo;
+    mPacketFrameStart = false;
+    mPacketKeyFrame = false;
+    mPacketInSequence = false;
+    mPacketPayloadSize = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPForwarder::Forward(char *pPacket, int pPacketSize, enum AVCodecID pCodecId, int pMaxFps, int64_t pArrivalTime, char **pResult, int &pResultSize)
+{
+    unsigned char *tHeader = (unsigned char*)pPacket;
+    unsigned char *tResult = (unsigned char*)mPacket;
+
+    mPacketFrameStart = false;
+    mPacketKeyFrame = false;
+
+    if ((pPacketSize < (int)RTP_HEADER_SIZE) || ((tHeader[0] >> 6) != 2))
+        return false;
+    if (pPacketSize > mPacketSize)
+    {
+        LOG(LOG_ERROR, "Forwarded packets are limited to %d bytes, dropping packet with %d bytes", mPacketSize, pPacketSize);
+        mSkippedPackets++;
+        return false;
+    }
+
+    unsigned int tPayloadType = tHeader[1] & 0x7F;
+    if (IS_RTCP_TYPE(tPayloadType))
+        return ForwardSenderReport(pPacket, pPacketSize, pResult, pResultSize);
+
+    // FEC packets protect the original sequence numbers, the media sink of the receiver creates its own ones
+    if (tPayloadType == RTP_PAYLOAD_TYPE_FEC)
+    {
+        mSkippedPackets++;
+        return false;
+    }
+
+    unsigned short tSequenceNumber = (unsigned short)(((unsigned int)tHeader[2] << 8) | (unsigned int)tHeader[3]);
+    uint32_t tTimestamp = ReadUint32(tHeader + 4);
+    unsigned int tSourceIdentifier = ReadUint32(tHeader + 8);
+
+    //####################################################################
+    // a new remote source continues the sequence number and timestamp space of its predecessor
+    //####################################################################
+    if ((!mInputSourceKnown) || (tSourceIdentifier != mInputSourceIdentifier))
+    {
+        if (mInputSourceKnown)
+            LOG(LOG_VERBOSE, "Forwarded source changed from 0x%x to 0x%x", mInputSourceIdentifier, tSourceIdentifier);
+        mInputSourceKnown = true;
+        mInputSourceIdentifier = tSourceIdentifier;
+        mSequenceNumberOffset = (unsigned short)(mNextSequenceNumber - tSequenceNumber);
+        mTimestampOffset = mLastTimestamp + RTP_FORWARDER_SOURCE_SWITCH_GAP - tTimestamp;
+        mFrameKnown = false;
+        mWaitingForKeyFrame = mVideo;
+    }
+    if ((mWaitingForKeyFrame) && (!SupportsFrameTypes(pCodecId)))
+        mWaitingForKeyFrame = false;
+
+    //####################################################################
+    // inspect the payload behind the CSRC list and the header extension
+    //####################################################################
+    int tPayloadOffset = GetPayloadOffset(tHeader, pPacketSize);
+    int tPayloadSize = pPacketSize - tPayloadOffset;
+    enum RTPForwarderFrameType tPacketType = RTP_FORWARDER_FRAME_REFERENCE;
+    bool tDroppable = false;
+    bool tTypeKnown = false;
+    if ((mVideo) && (tPayloadSize > 0))
+        tTypeKnown = InspectPayload(pCodecId, tHeader + tPayloadOffset, tPayloadSize, tPacketType, tDroppable);
+    else if (tPayloadSize < 0)
+        tPayloadSize = 0;
+    bool tKeyFrame = ((tTypeKnown) && (tPacketType == RTP_FORWARDER_FRAME_KEY));
+
+    //####################################################################
+    // a new timestamp starts a new frame, reordered packets of older frames don't
+    //####################################################################
+    if ((!mFrameKnown) || ((int32_t)(tTimestamp - mFrameTimestamp) > 0))
+    {
+        if ((mFrameKnown) && (!mFrameForwarded))
+            mSkippedFrames++;
+        mFrameKnown = true;
+        mFrameTimestamp = tTimestamp;
+        mFrameDropped = false;
+        mFrameForwarded = false;
+        mFrameThinned = false;
+        if (mVideo)
+        {
+            // without a hint in the first packet the frame is treated as reference frame
+            mFrameType = tTypeKnown ? tPacketType : RTP_FORWARDER_FRAME_REFERENCE;
+
+            // non-reference data is dropped if the receiver doesn't take all frames
+            if (mLayer == RTP_FORWARDER_LAYER_BASE)
+                mFrameThinned = true;
+            if ((pMaxFps > 0) && (mFrameLastForwardTime > 0) && ((pArrivalTime - mFrameLastForwardTime) * 100 < (int64_t)RTP_FORWARDER_FPS_TOLERANCE * 1000000 / pMaxFps))
+                mFrameThinned = true;
+            if ((!mFrameThinned) || (mFrameType != RTP_FORWARDER_FRAME_NON_REFERENCE))
+                mFrameLastForwardTime = pArrivalTime;
+        }else
+            mFrameType = RTP_FORWARDER_FRAME_AUDIO;
+    }else if ((tKeyFrame) && (tTimestamp == mFrameTimestamp))
+    {// e.g., an IDR slice behind an access unit delimiter
+        mFrameType = RTP_FORWARDER_FRAME_KEY;
+    }
+
+    //####################################################################
+    // drop the packet or rewrite its header
+    //####################################################################
+    unsigned short tOutputSequenceNumber = (unsigned short)(tSequenceNumber + mSequenceNumberOffset);
+    bool tInSequence = ((short)(tOutputSequenceNumber - mNextSequenceNumber) >= 0);
+
+    bool tSkip = false;
+    if (mWaitingForKeyFrame)
+    {
+        if (tKeyFrame)
+        {
+            LOG(LOG_VERBOSE, "Forwarding of source 0x%x starts with key frame", mInputSourceIdentifier);
+            mWaitingForKeyFrame = false;
+        }else
+            tSkip = true;
+    }
+    if ((mFrameDropped) || ((mFrameThinned) && ((tDroppable) || (mFrameType == RTP_FORWARDER_FRAME_NON_REFERENCE))))
+        tSkip = true;
+    if (tSkip)
+    {
+        #ifdef RTP_FORWARDER_DEBUG
+            LOG(LOG_VERBOSE, "Skipping packet %hu of source 0x%x", tSequenceNumber, mInputSourceIdentifier);
+        #endif
+        SkipPacket(tInSequence);
+        return false;
+    }
+
+    memcpy(mPacket, pPacket, pPacketSize);
+    if (tInSequence)
+        mNextSequenceNumber = (unsigned short)(tOutputSequenceNumber + 1);
+    uint32_t tOutputTimestamp = tTimestamp + mTimestampOffset;
+    if ((int32_t)(tOutputTimestamp - mLastTimestamp) > 0)
+        mLastTimestamp = tOutputTimestamp;
+    tResult[2] = (unsigned char)(tOutputSequenceNumber >> 8);
+    tResult[3] = (unsigned char)(tOutputSequenceNumber & 0xFF);
+    WriteUint32(tResult + 4, tOutputTimestamp);
+    WriteUint32(tResult + 8, mSourceIdentifier);
+
+    mPacketFrameStart = !mFrameForwarded;
+    mPacketKeyFrame = tKeyFrame;
+    mPacketInSequence = tInSequence;
+    mPacketPayloadSize = tPayloadSize;
+    mFrameForwarded = true;
+    mForwardedPackets++;
+    mForwardedOctets += tPayloadSize;
+
+    #ifdef RTP_FORWARDER_DEBUG
+        LOG(LOG_VERBOSE, "Forwarding packet %hu of source 0x%x as packet %hu of source 0x%x", tSequenceNumber, mInputSourceIdentifier, tOutputSequenceNumber, mSourceIdentifier);
+    #endif
+
+    *pResult = mPacket;
+    pResultSize = pPacketSize;
+
+    return true;
+}
+
+void RTPForwarder::SkipPacket(bool pInSequence)
+{
+    // the following packets close the gap, a reordered packet can't be removed from the sequence number space anymore
+    if (pInSequence)
+        mSequenceNumberOffset--;
+    mSkippedPackets++;
+}
+
+void RTPForwarder::DropFrame()
+{
+    if ((!mFrameForwarded) || (mForwardedPackets == 0))
+        return;
+
+    // the sequence number of the last forwarded packet is used again
+    if (mPacketInSequence)
+        mNextSequenceNumber--;
+    SkipPacket(mPacketInSequence);
+    mForwardedPackets--;
+    mForwardedOctets -= mPacketPayloadSize;
+    mFrameDropped = true;
+    mFrameForwarded = false;
+    mPacketFrameStart = false;
+    mPacketKeyFrame = false;
+}
+
+bool RTPForwarder::ForwardSenderReport(char *pPacket, int pPacketSize, char **pResult, int &pResultSize)
+{
+    unsigned char *tHeader = (unsigned char*)pPacket;
+    unsigned char *tResult = (unsigned char*)mPacket;
+
+    // only sender reports of the current source can be mapped to the forwarded stream, see RFC 3550, section 6.4.1
+    if ((tHeader[1] != RTCP_SR_TYPE) || (pPacketSize < RTCP_SR_SIZE) || (!mInputSourceKnown) || (ReadUint32(tHeader + 4) != mInputSourceIdentifier) || (mForwardedPackets == 0))
+    {
+        mSkippedPackets++;
+        return false;
+    }
+
+    // the report blocks describe the reception of the remote sender and the compound packet refers to its source, both are removed
+    memcpy(mPacket, pPacket, RTCP_SR_SIZE);
+    tResult[0] = 0x80;
+    tResult[2] = 0;
+    tResult[3] = RTCP_SR_SIZE / 4 - 1;
+    WriteUint32(tResult + 4, mSourceIdentifier);
+    // the NTP time of the remote sender is kept, it synchronizes the forwarded audio and video streams
+    WriteUint32(tResult + 16, ReadUint32(tHeader + 16) + mTimestampOffset);
+    WriteUint32(tResult + 20, (uint32_t)mForwardedPackets);
+    WriteUint32(tResult + 24, (uint32_t)mForwardedOctets);
+
+    *pResult = mPacket;
+    pResultSize = RTCP_SR_SIZE;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPForwarder::SupportsFrameTypes(enum AVCodecID pCodecId)
+{
+    switch(pCodecId)
+    {
+        case AV_CODEC_ID_H264:
+        case AV_CODEC_ID_MPEG4:
+        case AV_CODEC_ID_MPEG1VIDEO:
+        case AV_CODEC_ID_MPEG2VIDEO:
+            return true;
+        default:
+            return false;
+    }
+}
+
+int RTPForwarder::GetPayloadOffset(unsigned char *pPacket, int pPacketSize)
+{
+    int tResult = (int)RTP_HEADER_SIZE + 4 * (pPacket[0] & 0x0F);
+    if (((pPacket[0] & 0x10) != 0) && (tResult + 4 <= pPacketSize))
+        tResult += 4 + 4 * (((int)pPacket[tResult + 2] << 8) | (int)pPacket[tResult + 3]);
+
+    return tResult;
+}
+
+bool RTPForwarder::InspectPayload(enum AVCodecID pCodecId, unsigned char *pPayload, int pPayloadSize, enum RTPForwarderFrameType &pType, bool &pDroppable)
+{
+    bool tResult = false;
+
+    pType = RTP_FORWARDER_FRAME_REFERENCE;
+    pDroppable = false;
+
+    switch(pCodecId)
+    {
+        case AV_CODEC_ID_H264:
+            // NAL units with nal_ref_idc 0 aren't used for the prediction of other pictures, the NRI of an aggregation is the max. of its units
+            pDroppable = ((pPayload[0] & 0x60) == 0);
+            switch(pPayload[0] & 0x1F)
+            {
+                case 24: // STAP-A
+                    {
+                        int tOffset = 1;
+                        while (tOffset + 3 <= pPayloadSize)
+                        {
+                            int tUnitSize = ((int)pPayload[tOffset] << 8) | (int)pPayload[tOffset + 1];
+                            tOffset += 2;
+                            if ((tUnitSize == 0) || (tOffset + tUnitSize > pPayloadSize))
+                                break;
+                            if (ClassifyH264NalUnit(pPayload[tOffset], pType))
+                                tResult = true;
+                            tOffset += tUnitSize;
+                        }
+                    }
+                    break;
+                case 28: // FU-A, only the first fragment gives the type of the fragmented unit
+                    if ((pPayloadSize > 1) && ((pPayload[1] & 0x80) != 0))
+                        tResult = ClassifyH264NalUnit((pPayload[0] & 0xE0) | (pPayload[1] & 0x1F), pType);
+                    break;
+                default:
+                    tResult = ClassifyH264NalUnit(pPayload[0], pType);
+                    break;
+            }
+            break;
+        case AV_CODEC_ID_MPEG4:
+            // the VOP header gives the coding type, see ISO/IEC 14496-2, section 6.2.5
+            for (int i = 0; (i + 4 < pPayloadSize) && (i < MPEG4_VOP_SEARCH_LIMIT); i++)
+            {
+                if ((pPayload[i] == 0) && (pPayload[i + 1] == 0) && (pPayload[i + 2] == 1) && (pPayload[i + 3] == 0xB6))
+                {
+                    switch(pPayload[i + 4] >> 6)
+                    {
+                        case 0: // I-VOP
+                            pType = RTP_FORWARDER_FRAME_KEY;
+                            break;
+                        case 2: // B-VOP
+                            pType = RTP_FORWARDER_FRAME_NON_REFERENCE;
+                            break;
+                        default:
+                            pType = RTP_FORWARDER_FRAME_REFERENCE;
+                            break;
+                    }
+                    tResult = true;
+                    break;
+                }
+            }
+            break;
+        case AV_CODEC_ID_MPEG1VIDEO:
+        case AV_CODEC_ID_MPEG2VIDEO:
+            // the video specific header of each packet gives the picture type, see RFC 2250, section 3.4
+            if (pPayloadSize >= 4)
+            {
+                switch(pPayload[2] & 0x07)
+                {
+                    case 1: // I picture
+                        pType = RTP_FORWARDER_FRAME_KEY;
+                        tResult = true;
+                        break;
+                    case 2: // P picture
+                        pType = RTP_FORWARDER_FRAME_REFERENCE;
+                        tResult = true;
+                        break;
+                    case 3: // B picture
+                        pType = RTP_FORWARDER_FRAME_NON_REFERENCE;
+                        tResult = true;
+                        break;
+                    default:
+                        break;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+
+    return tResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPForwarder::IsFrameStart()
+{
+    return mPacketFrameStart;
+}
+
+bool RTPForwarder::IsKeyFrame()
+{
+    return mPacketKeyFrame;
+}
+
+enum RTPForwarderFrameType RTPForwarder::GetFrameType()
+{
+    return mFrameType;
+}
+
+bool RTPForwarder::IsKeyFramePacket(char *pPacket, int pPacketSize, enum AVCodecID pCodecId)
+{
+    unsigned char *tHeader = (unsigned char*)pPacket;
+
+    if ((pPacketSize < (int)RTP_HEADER_SIZE) || ((tHeader[0] >> 6) != 2) || (!SupportsFrameTypes(pCodecId)))
+        return false;
+
+    unsigned int tPayloadType = tHeader[1] & 0x7F;
+    if ((IS_RTCP_TYPE(tPayloadType)) || (tPayloadType == RTP_PAYLOAD_TYPE_FEC))
+        return false;
+
+    int tPayloadOffset = GetPayloadOffset(tHeader, pPacketSize);
+    if (tPayloadOffset >= pPacketSize)
+        return false;
+
+    enum RTPForwarderFrameType tType;
+    bool tDroppable;
+    return ((InspectPayload(pCodecId, tHeader + tPayloadOffset, pPacketSize - tPayloadOffset, tType, tDroppable)) && (tType == RTP_FORWARDER_FRAME_KEY));
+}
+
+bool RTPForwarder::IsWaitingForKeyFrame()
+{
+    return mWaitingForKeyFrame;
+}
+
+uint64_t RTPForwarder::GetForwardedPackets()
+{
+    return mForwardedPackets;
+}
+
+uint64_t RTPForwarder::GetSkippedPackets()
+{
+    return mSkippedPackets;
+}
+
+uint64_t RTPForwarder::GetSkippedFrames()
+{
+    return mSkippedFrames;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
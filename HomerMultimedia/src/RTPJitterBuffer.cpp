@@ -0,0 +1,406 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: Implementation of a jitter buffer for reordering RTP packets
+ * Since:   2026-10-16
+ */
+
+#include <RTPJitterBuffer.h>
+#include <RTP.h>
+#include <Logger.h>
+
+#include <stdlib.h>
+#include <string.h> // memcpy
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+// RTCP packets which are transported within the RTP stream don't have a valid sequence number
+#define IS_RTCP_TYPE(x)                 (((x) >= 72) && ((x) <= 78))
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPJitterBuffer::RTPJitterBuffer(int pPacketSize, int pCapacity)
+{
+    mPacketSize = pPacketSize;
+    mCapacity = pCapacity;
+    mSlots = (JitterBufferSlot*)malloc(mCapacity * sizeof(JitterBufferSlot));
+    mSlotMemory = (char*)malloc(mCapacity * mPacketSize);
+    for (int i = 0; i < mCapacity; i++)
+    {
+        mSlots[i].Data = mSlotMemory + i * mPacketSize;
+        mSlots[i].Size = 0;
+        mSlots[i].Number = 0;
+        mSlots[i].SequenceNumber = 0;
+        mSlots[i].ArrivalTime = 0;
+        mSlots[i].Used = false;
+    }
+    mMinWindow = RTP_JITTER_BUFFER_MIN_WINDOW * 1000;
+    mMaxWindow = RTP_JITTER_BUFFER_MAX_WINDOW * 1000;
+    Reset();
+}
+
+RTPJitterBuffer::~RTPJitterBuffer()
+{
+    free(mSlotMemory);
+    free(mSlots);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPJitterBuffer::SetWindow(int pMinWindow, int pMaxWindow)
+{
+    if (pMinWindow < 0)
+        pMinWindow = 0;
+    if (pMaxWindow < pMinWindow)
+        pMaxWindow = pMinWindow;
+
+    LOG(LOG_VERBOSE, "Setting reordering window to %d - %d ms", pMinWindow, pMaxWindow);
+
+    mMinWindow = (int64_t)pMinWindow * 1000;
+    mMaxWindow = (int64_t)pMaxWindow * 1000;
+    LimitWindow();
+}
+
+void RTPJitterBuffer::Reset()
+{
+    for (int i = 0; i < mCapacity; i++)
+        mSlots[i].Used = false;
+    mDepth = 0;
+    mBorrowedSlot = -1;
+    mSynchronized = false;
+    mExpectedSequenceNumber = 0;
+    mRequestedSequenceNumber = -1;
+    mWindow = mMinWindow;
+    mReorderDelay = 0;
+    mLatePackets = 0;
+    mReorderedPackets = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int64_t RTPJitterBuffer::ExtendSequenceNumber(unsigned int pSequenceNumber)
+{
+    // signed 16 bit distance to the expected sequence number, this handles the wrap around
+    int16_t tDistance = (int16_t)(uint16_t)(pSequenceNumber - (unsigned int)(mExpectedSequenceNumber & 0xFFFF));
+
+    return mExpectedSequenceNumber + tDistance;
+}
+
+int RTPJitterBuffer::FindHead()
+{
+    int tResult = -1;
+
+    for (int i = 0; i < mCapacity; i++)
+    {
+        if ((mSlots[i].Used) && ((tResult < 0) || (mSlots[i].SequenceNumber < mSlots[tResult].SequenceNumber)))
+            tResult = i;
+    }
+
+    return tResult;
+}
+
+int64_t RTPJitterBuffer::GetOldestArrivalTime()
+{
+    int64_t tResult = 0;
+
+    for (int i = 0; i < mCapacity; i++)
+    {
+        if ((mSlots[i].Used) && ((tResult == 0) || (mSlots[i].ArrivalTime < tResult)))
+            tResult = mSlots[i].ArrivalTime;
+    }
+
+    return tResult;
+}
+
+void RTPJitterBuffer::LimitWindow()
+{
+    if (mWindow < mMinWindow)
+        mWindow = mMinWindow;
+    if (mWindow > mMaxWindow)
+        mWindow = mMaxWindow;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+enum JitterBufferVerdict RTPJitterBuffer::Insert(char *pPacket, int pPacketSize, int64_t pNumber, int64_t pArrivalTime)
+{
+    unsigned char *tHeader = (unsigned char*)pPacket;
+
+    // non-RTP data and in-stream RTCP packets are left to the RTP parser
+    if ((pPacketSize < (int)RTP_HEADER_SIZE) || ((tHeader[0] >> 6) != 2) || (IS_RTCP_TYPE(tHeader[1] & 0x7F)))
+        return JITTER_BUFFER_DELIVER;
+
+    // the header is still in network byte order
+    unsigned int tSequenceNumber = ((unsigned int)tHeader[2] << 8) | (unsigned int)tHeader[3];
+
+    if (!mSynchronized)
+    {
+        mSynchronized = true;
+        mExpectedSequenceNumber = tSequenceNumber;
+    }
+
+    int64_t tExtendedSequenceNumber = ExtendSequenceNumber(tSequenceNumber);
+    int64_t tDistance = tExtendedSequenceNumber - mExpectedSequenceNumber;
+
+    // packet is in order
+    if (tDistance == 0)
+    {
+        if (mDepth > 0)
+        {// the packet closes a gap, stretch the window if the gap was open for a long time
+            int64_t tDelay = pArrivalTime - GetOldestArrivalTime();
+            mReorderDelay += (tDelay - mReorderDelay) / 8;
+            if (2 * tDelay > mWindow)
+                mWindow = 2 * tDelay;
+            else
+                mWindow -= (mWindow - 2 * mReorderDelay) / 16;
+            LimitWindow();
+            mReorderedPackets++;
+
+            #ifdef RTP_JITTER_BUFFER_DEBUG
+                LOG(LOG_VERBOSE, "Reordered packet %u after %"PRId64" us, window is now %"PRId64" us", tSequenceNumber, tDelay, mWindow);
+            #endif
+        }
+        mExpectedSequenceNumber++;
+        return JITTER_BUFFER_DELIVER;
+    }
+
+    // packet is behind the expected one
+    if (tDistance < 0)
+    {
+        if (tDistance >= -RTP_JITTER_BUFFER_MAX_MISORDER)
+        {// the packet was already declared as lost or is a duplicate
+            mWindow *= 2;
+            LimitWindow();
+            mLatePackets++;
+
+            #ifdef RTP_JITTER_BUFFER_DEBUG
+                LOG(LOG_VERBOSE, "Late packet %u, expected %u, window is now %"PRId64" us", tSequenceNumber, (unsigned int)(mExpectedSequenceNumber & 0xFFFF), mWindow);
+            #endif
+            return JITTER_BUFFER_DROPPED;
+        }
+
+        // the remote side has restarted its stream, the stored packets are outdated
+        LOG(LOG_WARN, "Detected restart of RTP sequence numbering (%u after %u), dropping %d stored packets", tSequenceNumber, (unsigned int)((mExpectedSequenceNumber - 1) & 0xFFFF), mDepth);
+        for (int i = 0; i < mCapacity; i++)
+        {
+            if (i != mBorrowedSlot)
+            {
+                if (mSlots[i].Used)
+                    mDepth--;
+                mSlots[i].Used = false;
+            }
+        }
+        mExpectedSequenceNumber = tSequenceNumber + 1;
+        mRequestedSequenceNumber = tSequenceNumber;
+        return JITTER_BUFFER_DELIVER;
+    }
+
+    // a jump which the buffer can't bridge, resynchronize if nothing is stored
+    if ((tDistance >= mCapacity) && (mDepth == 0))
+    {
+        mExpectedSequenceNumber = tExtendedSequenceNumber + 1;
+        return JITTER_BUFFER_DELIVER;
+    }
+
+    // packet is ahead of the expected one: store it until the gap is closed or expires
+    int tFreeSlot = -1;
+    for (int i = 0; i < mCapacity; i++)
+    {
+        if (mSlots[i].Used)
+        {
+            if (mSlots[i].SequenceNumber == tExtendedSequenceNumber)
+            {
+                #ifdef RTP_JITTER_BUFFER_DEBUG
+                    LOG(LOG_VERBOSE, "Duplicate of stored packet %u", tSequenceNumber);
+                #endif
+                return JITTER_BUFFER_DROPPED;
+            }
+        }else if (tFreeSlot < 0)
+            tFreeSlot = i;
+    }
+    if (tFreeSlot < 0)
+    {
+        LOG(LOG_ERROR, "Jitter buffer is full (%d packets), dropping packet %u", mCapacity, tSequenceNumber);
+        return JITTER_BUFFER_DROPPED;
+    }
+    if (pPacketSize > mPacketSize)
+    {
+        LOG(LOG_ERROR, "Jitter buffer slots are limited to %d bytes, dropping packet %u with %d bytes", mPacketSize, tSequenceNumber, pPacketSize);
+        return JITTER_BUFFER_DROPPED;
+    }
+
+    memcpy(mSlots[tFreeSlot].Data, pPacket, pPacketSize);
+    mSlots[tFreeSlot].Size = pPacketSize;
+    mSlots[tFreeSlot].Number = pNumber;
+    mSlots[tFreeSlot].SequenceNumber = tExtendedSequenceNumber;
+    mSlots[tFreeSlot].ArrivalTime = pArrivalTime;
+    mSlots[tFreeSlot].Used = true;
+    mDepth++;
+
+    #ifdef RTP_JITTER_BUFFER_DEBUG
+        LOG(LOG_VERBOSE, "Stored packet %u, expected %u, %d packets stored", tSequenceNumber, (unsigned int)(mExpectedSequenceNumber & 0xFFFF), mDepth);
+    #endif
+
+    return JITTER_BUFFER_STORED;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPJitterBuffer::GetNextPacket(char **pPacket, int &pPacketSize, int64_t &pNumber, int64_t pNow)
+{
+    if ((mDepth == 0) || (mBorrowedSlot >= 0))
+        return false;
+
+    int tHead = FindHead();
+
+    if (mSlots[tHead].SequenceNumber != mExpectedSequenceNumber)
+    {
+        // the missing packets are still awaited
+        if (pNow < GetDeadline())
+            return false;
+
+        #ifdef RTP_JITTER_BUFFER_DEBUG
+            LOG(LOG_VERBOSE, "Gap of %"PRId64" packets expired after %"PRId64" us", mSlots[tHead].SequenceNumber - mExpectedSequenceNumber, mWindow);
+        #endif
+
+        // the window was too long for this gap, shrink it slowly
+        mWindow -= mWindow / 8;
+        LimitWindow();
+
+        // skip the missing packets, the RTP parser will count them as lost
+        mExpectedSequenceNumber = mSlots[tHead].SequenceNumber;
+    }
+
+    *pPacket = mSlots[tHead].Data;
+    pPacketSize = mSlots[tHead].Size;
+    pNumber = mSlots[tHead].Number;
+    mBorrowedSlot = tHead;
+    mExpectedSequenceNumber++;
+
+    return true;
+}
+
+void RTPJitterBuffer::ReleasePacket()
+{
+    if (mBorrowedSlot < 0)
+        return;
+
+    if (mSlots[mBorrowedSlot].Used)
+    {
+        mSlots[mBorrowedSlot].Used = false;
+        mDepth--;
+    }
+    mBorrowedSlot = -1;
+}
+
+void RTPJitterBuffer::SkipGap()
+{
+    if ((mDepth == 0) || (mBorrowedSlot >= 0))
+        return;
+
+    mExpectedSequenceNumber = mSlots[FindHead()].SequenceNumber;
+}
+
+int RTPJitterBuffer::GetMissingPackets(unsigned short *pSequenceNumbers, int pMaxCount)
+{
+    int tResult = 0;
+
+    if (mDepth == 0)
+        return 0;
+
+    // find the range of the gaps: from the expected packet to the newest stored one
+    int64_t tNewest = mExpectedSequenceNumber;
+    for (int i = 0; i < mCapacity; i++)
+    {
+        if ((mSlots[i].Used) && (mSlots[i].SequenceNumber > tNewest))
+            tNewest = mSlots[i].SequenceNumber;
+    }
+
+    // each missing packet is reported only once
+    int64_t tSequenceNumber = mExpectedSequenceNumber;
+    if (tSequenceNumber <= mRequestedSequenceNumber)
+        tSequenceNumber = mRequestedSequenceNumber + 1;
+    for (; (tSequenceNumber < tNewest) && (tResult < pMaxCount); tSequenceNumber++)
+    {
+        bool tStored = false;
+        for (int i = 0; i < mCapacity; i++)
+        {
+            if ((mSlots[i].Used) && (mSlots[i].SequenceNumber == tSequenceNumber))
+            {
+                tStored = true;
+                break;
+            }
+        }
+        if (!tStored)
+            pSequenceNumbers[tResult++] = (unsigned short)(tSequenceNumber & 0xFFFF);
+        mRequestedSequenceNumber = tSequenceNumber;
+    }
+
+    #ifdef RTP_JITTER_BUFFER_DEBUG
+        if (tResult > 0)
+            LOG(LOG_VERBOSE, "Reporting %d missing packets, first one is %hu", tResult, pSequenceNumbers[0]);
+    #endif
+
+    return tResult;
+}
+
+int64_t RTPJitterBuffer::GetDeadline()
+{
+    if (mDepth == 0)
+        return 0;
+
+    return GetOldestArrivalTime() + mWindow;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPJitterBuffer::IsFull()
+{
+    return (mDepth >= mCapacity);
+}
+
+int RTPJitterBuffer::GetDepth()
+{
+    return mDepth;
+}
+
+int RTPJitterBuffer::GetWindow()
+{
+    return (int)(mWindow / 1000);
+}
+
+uint64_t RTPJitterBuffer::GetLatePackets()
+{
+    return mLatePackets;
+}
+
+uint64_t RTPJitterBuffer::GetReorderedPackets()
+{
+    return mReorderedPackets;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
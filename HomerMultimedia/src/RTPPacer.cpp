@@ -0,0 +1,249 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+
+
+/*
+ * Purpose: Implementation of token bucket based pacing of sent RTP packets
+ * Since:   2026-10-16
+ */
+
+#include <RTPPacer.h>
+#include <HBThread.h>
+#include <Logger.h>
+
+#if defined(LINUX) || defined(APPLE) || defined(BSD)
+#include <time.h> // nanosleep
+#include <errno.h>
+#endif
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPPacer::RTPPacer()
+{
+    mRateFactor = RTP_PACER_RATE_FACTOR;
+    mBurstSize = RTP_PACER_BURST_SIZE;
+    mMaxDelay = RTP_PACER_MAX_DELAY * 1000;
+    mTargetBitRate = -1;
+    mPacingRate = RTP_PACER_MIN_BIT_RATE;
+    Reset();
+}
+
+RTPPacer::~RTPPacer()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPPacer::SetPacing(int pRateFactor, int pBurstSize, int pMaxDelay)
+{
+    // a pacing rate below the input rate would only delay each packet by the max. delay
+    if ((pRateFactor > 0) && (pRateFactor < 100))
+        pRateFactor = 100;
+    if (pRateFactor < 0)
+        pRateFactor = 0;
+    if (pBurstSize < 1)
+        pBurstSize = 1;
+    if (pMaxDelay < 0)
+        pMaxDelay = 0;
+
+    if (pRateFactor > 0)
+        LOG(LOG_VERBOSE, "Setting pacing to %d percent of the target bit rate, burst size: %d bytes, max. delay: %d ms", pRateFactor, pBurstSize, pMaxDelay);
+    else
+        LOG(LOG_VERBOSE, "Deactivating pacing");
+
+    // the sending thread reads the values without locking, each of them is valid on its own
+    mBurstSize = pBurstSize;
+    mMaxDelay = pMaxDelay * 1000;
+    mRateFactor = pRateFactor;
+}
+
+void RTPPacer::Reset()
+{
+    mInputBitRate = 0;
+    mTokens = (int64_t)mBurstSize * 1000000;
+    mLastRefill = 0;
+    mPeriodStart = 0;
+    mPeriodBytes = 0;
+    mPeriodQueueDelay = 0;
+    mPeriodPackets = 0;
+    mQueueDelay = -1;
+    UpdatePacingRate();
+}
+
+bool RTPPacer::IsActive()
+{
+    return (mRateFactor > 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPPacer::SetTargetBitRate(int pBitRate)
+{
+    if (mTargetBitRate == pBitRate)
+        return;
+
+    mTargetBitRate = pBitRate;
+    UpdatePacingRate();
+}
+
+void RTPPacer::UpdatePacingRate()
+{
+    int64_t tBitRate = (mTargetBitRate > mInputBitRate) ? mTargetBitRate : mInputBitRate;
+    tBitRate = tBitRate * mRateFactor / 100;
+    if (tBitRate < RTP_PACER_MIN_BIT_RATE)
+        tBitRate = RTP_PACER_MIN_BIT_RATE;
+    if (tBitRate > 0x7FFFFFFF)
+        tBitRate = 0x7FFFFFFF;
+
+    #ifdef RTP_PACER_DEBUG
+        if (mPacingRate != (int)tBitRate)
+            LOG(LOG_VERBOSE, "Changing pacing rate to %d bit/s, target rate: %d bit/s, input rate: %d bit/s", (int)tBitRate, mTargetBitRate, mInputBitRate);
+    #endif
+    mPacingRate = (int)tBitRate;
+}
+
+void RTPPacer::Refill(int64_t pNow)
+{
+    if (mLastRefill == 0)
+        mLastRefill = pNow;
+
+    int64_t tTimeDiff = pNow - mLastRefill;
+    if (tTimeDiff <= 0)
+        return;
+    mLastRefill = pNow;
+
+    // a full bucket would overflow anyway, this avoids an overflow of the calculation after long idle periods
+    int64_t tMaxTokens = (int64_t)mBurstSize * 1000000;
+    if (tTimeDiff > (int64_t)RTP_PACER_PERIOD * 1000)
+    {
+        mTokens = tMaxTokens;
+        return;
+    }
+
+    // bytes/s * us = bytes * 10^6
+    mTokens += (int64_t)(mPacingRate / 8) * tTimeDiff;
+    if (mTokens > tMaxTokens)
+        mTokens = tMaxTokens;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int64_t RTPPacer::GetSendDelay(int64_t pQueueTime, int64_t pNow)
+{
+    if (mRateFactor == 0)
+        return 0;
+
+    Refill(pNow);
+    if (mTokens >= 0)
+        return 0;
+
+    // the debt of the already sent packets has to be paid off before the next packet
+    int64_t tDelay = -mTokens / (mPacingRate / 8);
+
+    // the latency border has priority over the pacing rate
+    if ((pQueueTime > 0) && (pNow + tDelay > pQueueTime + mMaxDelay))
+        tDelay = pQueueTime + mMaxDelay - pNow;
+
+    if (tDelay < RTP_PACER_MIN_WAIT)
+        return 0;
+
+    return tDelay;
+}
+
+void RTPPacer::AnnounceSentPacket(int pSize, int64_t pQueueTime, int64_t pNow)
+{
+    if (mPeriodStart == 0)
+        mPeriodStart = pNow;
+
+    mPeriodBytes += pSize;
+    if ((pQueueTime > 0) && (pNow > pQueueTime))
+        mPeriodQueueDelay += pNow - pQueueTime;
+    mPeriodPackets++;
+
+    if (mRateFactor > 0)
+    {
+        mTokens -= (int64_t)pSize * 1000000;
+
+        // packets which were sent early because of the latency border mustn't stall the following ones beyond it
+        int64_t tMinTokens = -(int64_t)(mPacingRate / 8) * mMaxDelay;
+        if (mTokens < tMinTokens)
+            mTokens = tMinTokens;
+    }
+
+    // end of the measurement period
+    int64_t tPeriod = pNow - mPeriodStart;
+    if (tPeriod >= (int64_t)RTP_PACER_PERIOD * 1000)
+    {
+        int tInputBitRate = (int)(mPeriodBytes * 8 * 1000000 / tPeriod);
+        mInputBitRate = (mInputBitRate > 0) ? (mInputBitRate + tInputBitRate) / 2 : tInputBitRate;
+        mQueueDelay = (int)(mPeriodQueueDelay / mPeriodPackets);
+
+        #ifdef RTP_PACER_DEBUG
+            LOG(LOG_VERBOSE, "Paced %d packets at %d bit/s, input rate: %d bit/s, avg. queue delay: %d us", mPeriodPackets, mPacingRate, mInputBitRate, mQueueDelay);
+        #endif
+
+        mPeriodStart = pNow;
+        mPeriodBytes = 0;
+        mPeriodQueueDelay = 0;
+        mPeriodPackets = 0;
+        UpdatePacingRate();
+    }
+}
+
+void RTPPacer::Wait(int64_t pDelay)
+{
+    if (pDelay <= 0)
+        return;
+
+    #if defined(LINUX) || defined(APPLE) || defined(BSD)
+        // usleep() is obsolete and rounds up more than necessary, nanosleep() continues after an interrupt with the remaining time
+        struct timespec tDelay;
+        tDelay.tv_sec = (time_t)(pDelay / 1000000);
+        tDelay.tv_nsec = (long)(pDelay % 1000000) * 1000;
+        while ((nanosleep(&tDelay, &tDelay) != 0) && (errno == EINTR))
+        {
+        }
+    #else
+        Thread::Suspend((unsigned int)pDelay);
+    #endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int RTPPacer::GetPacingRate()
+{
+    return mPacingRate;
+}
+
+int RTPPacer::GetQueueDelay()
+{
+    return mQueueDelay;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
@@ -0,0 +1,283 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: Implementation of a history of sent RTP packets for retransmissions
+ * Since:   2026-10-16
+ */
+
+#include <RTPPacketHistory.h>
+#include <RTP.h>
+#include <Logger.h>
+
+#include <stdlib.h>
+#include <string.h> // memcpy
+
+namespace Homer { namespace Multimedia {
+
+using namespace Homer::Base;
+
+// RTCP packets which are transported within the RTP stream don't have a valid sequence number
+#define IS_RTCP_TYPE(x)                 (((x) >= 72) && ((x) <= 78))
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPPacketHistory::RTPPacketHistory(int pPacketSize, int pCapacity)
+{
+    mPacketSize = pPacketSize;
+    mCapacity = pCapacity;
+    mSlots = (PacketHistorySlot*)malloc(mCapacity * sizeof(PacketHistorySlot));
+    mSlotMemory = (char*)malloc(mCapacity * mPacketSize);
+    mPendingSequenceNumbers = (unsigned short*)malloc(mCapacity * sizeof(unsigned short));
+    for (int i = 0; i < mCapacity; i++)
+        mSlots[i].Data = mSlotMemory + i * mPacketSize;
+    mMaxAge = RTP_PACKET_HISTORY_MAX_AGE * 1000;
+    Reset();
+}
+
+RTPPacketHistory::~RTPPacketHistory()
+{
+    free(mPendingSequenceNumbers);
+    free(mSlotMemory);
+    free(mSlots);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPPacketHistory::SetMaxAge(int pMaxAge)
+{
+    if (pMaxAge < 0)
+        pMaxAge = 0;
+
+    LOG(LOG_VERBOSE, "Setting max. age of retransmitted packets to %d ms", pMaxAge);
+
+    mMutex.lock();
+    mMaxAge = (int64_t)pMaxAge * 1000;
+    mMutex.unlock();
+}
+
+void RTPPacketHistory::Reset()
+{
+    mMutex.lock();
+    for (int i = 0; i < mCapacity; i++)
+    {
+        mSlots[i].Size = 0;
+        mSlots[i].SequenceNumber = 0;
+        mSlots[i].SendTime = 0;
+        mSlots[i].RetransmissionTime = 0;
+        mSlots[i].Retransmissions = 0;
+        mSlots[i].Pending = false;
+        mSlots[i].Used = false;
+    }
+    mPendingHead = 0;
+    mPendingCount = 0;
+    mRtt = 0;
+    mSentBytes = 0;
+    mRetransmittedBytes = 0;
+    mRetransmittedPackets = 0;
+    mRejectedRequests = 0;
+    mMutex.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPPacketHistory::Store(char *pPacket, int pPacketSize, int64_t pSendTime)
+{
+    unsigned char *tHeader = (unsigned char*)pPacket;
+
+    // in-stream RTCP packets aren't retransmitted
+    if ((pPacketSize < (int)RTP_HEADER_SIZE) || (IS_RTCP_TYPE(tHeader[1] & 0x7F)))
+        return;
+
+    if (pPacketSize > mPacketSize)
+    {
+        LOG(LOG_ERROR, "Packet history slots are limited to %d bytes, packet with %d bytes can't be retransmitted", mPacketSize, pPacketSize);
+        return;
+    }
+
+    // the header is still in network byte order
+    unsigned short tSequenceNumber = (unsigned short)(((unsigned int)tHeader[2] << 8) | (unsigned int)tHeader[3]);
+    PacketHistorySlot *tSlot = &mSlots[tSequenceNumber % mCapacity];
+
+    mMutex.lock();
+    memcpy(tSlot->Data, pPacket, pPacketSize);
+    tSlot->Size = pPacketSize;
+    tSlot->SequenceNumber = tSequenceNumber;
+    tSlot->SendTime = pSendTime;
+    tSlot->RetransmissionTime = 0;
+    tSlot->Retransmissions = 0;
+    tSlot->Pending = false;
+    tSlot->Used = true;
+    mSentBytes += pPacketSize;
+    mMutex.unlock();
+}
+
+bool RTPPacketHistory::GetNextRetransmission(char **pPacket, int &pPacketSize, int64_t pNow)
+{
+    bool tResult = false;
+
+    // avoid locking if nothing is queued, a concurrent request is handled with the next call
+    if (mPendingCount == 0)
+        return false;
+
+    mMutex.lock();
+    while ((mPendingCount > 0) && (!tResult))
+    {
+        unsigned short tSequenceNumber = mPendingSequenceNumbers[mPendingHead];
+        mPendingHead = (mPendingHead + 1) % mCapacity;
+        mPendingCount--;
+
+        // the slot may have been overwritten by a newer packet in the meantime
+        PacketHistorySlot *tSlot = &mSlots[tSequenceNumber % mCapacity];
+        if ((!tSlot->Used) || (!tSlot->Pending) || (tSlot->SequenceNumber != tSequenceNumber))
+            continue;
+
+        tSlot->Pending = false;
+        tSlot->Retransmissions++;
+        tSlot->RetransmissionTime = pNow;
+        mRetransmittedBytes += tSlot->Size;
+        mRetransmittedPackets++;
+
+        // only the sending thread overwrites the packet data, hence it stays valid until the next call to Store()
+        *pPacket = tSlot->Data;
+        pPacketSize = tSlot->Size;
+        tResult = true;
+
+        #ifdef RTP_PACKET_HISTORY_DEBUG
+            LOG(LOG_VERBOSE, "Retransmitting packet %hu (retransmission %d) after %"PRId64" us", tSequenceNumber, tSlot->Retransmissions, pNow - tSlot->SendTime);
+        #endif
+    }
+    mMutex.unlock();
+
+    return tResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int RTPPacketHistory::Request(unsigned short *pSequenceNumbers, int pCount, int64_t pNow)
+{
+    int tResult = 0;
+
+    mMutex.lock();
+    for (int i = 0; i < pCount; i++)
+    {
+        PacketHistorySlot *tSlot = &mSlots[pSequenceNumbers[i] % mCapacity];
+
+        // packet is already overwritten by a newer one
+        if ((!tSlot->Used) || (tSlot->SequenceNumber != pSequenceNumbers[i]))
+        {
+            #ifdef RTP_PACKET_HISTORY_DEBUG
+                LOG(LOG_VERBOSE, "Requested packet %hu isn't stored anymore", pSequenceNumbers[i]);
+            #endif
+            mRejectedRequests++;
+            continue;
+        }
+
+        // already queued
+        if (tSlot->Pending)
+            continue;
+
+        int64_t tAge = pNow - tSlot->SendTime;
+
+        // the first request of a packet limits the round trip time, it includes the time the receiver needed to detect the loss
+        if (tSlot->Retransmissions == 0)
+        {
+            if (mRtt == 0)
+                mRtt = tAge;
+            else
+                mRtt += (tAge - mRtt) / 8;
+        }
+
+        // the receiver has already skipped this packet
+        if (tAge > mMaxAge)
+        {
+            #ifdef RTP_PACKET_HISTORY_DEBUG
+                LOG(LOG_VERBOSE, "Requested packet %hu is too old (%"PRId64" us)", pSequenceNumbers[i], tAge);
+            #endif
+            mRejectedRequests++;
+            continue;
+        }
+
+        // the last retransmission may still be on its way
+        if ((tSlot->Retransmissions > 0) && (pNow - tSlot->RetransmissionTime < mRtt))
+            continue;
+
+        // limit the additional data rate
+        if ((tSlot->Retransmissions >= RTP_PACKET_HISTORY_MAX_RETRANSMISSIONS) || (mPendingCount >= mCapacity) ||
+            (mRetransmittedBytes * 100 > mSentBytes * RTP_PACKET_HISTORY_MAX_RETRANSMISSION_SHARE))
+        {
+            mRejectedRequests++;
+            continue;
+        }
+
+        tSlot->Pending = true;
+        mPendingSequenceNumbers[(mPendingHead + mPendingCount) % mCapacity] = pSequenceNumbers[i];
+        mPendingCount++;
+        tResult++;
+    }
+    mMutex.unlock();
+
+    #ifdef RTP_PACKET_HISTORY_DEBUG
+        LOG(LOG_VERBOSE, "Queued %d of %d requested packets for retransmission, RTT is about %"PRId64" us", tResult, pCount, mRtt);
+    #endif
+
+    return tResult;
+}
+
+void RTPPacketHistory::Discard(char *pPacket, int pPacketSize)
+{
+    unsigned char *tHeader = (unsigned char*)pPacket;
+
+    if ((pPacketSize < (int)RTP_HEADER_SIZE) || (IS_RTCP_TYPE(tHeader[1] & 0x7F)))
+        return;
+
+    // the header is still in network byte order
+    unsigned short tSequenceNumber = (unsigned short)(((unsigned int)tHeader[2] << 8) | (unsigned int)tHeader[3]);
+    PacketHistorySlot *tSlot = &mSlots[tSequenceNumber % mCapacity];
+
+    // a pending retransmission is skipped by GetNextRetransmission(), the packet data stays valid
+    mMutex.lock();
+    if ((tSlot->Used) && (tSlot->SequenceNumber == tSequenceNumber))
+        tSlot->Used = false;
+    mMutex.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int RTPPacketHistory::GetRtt()
+{
+    return (int)(mRtt / 1000);
+}
+
+uint64_t RTPPacketHistory::GetRetransmittedPackets()
+{
+    return mRetransmittedPackets;
+}
+
+uint64_t RTPPacketHistory::GetRejectedRequests()
+{
+    return mRejectedRequests;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
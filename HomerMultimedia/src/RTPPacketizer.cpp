@@ -0,0 +1,151 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+
+/*
+ * Purpose: Implementation of a shared RTP packetizer for all media sinks of a media source
+ * Since:   2026-10-16
+ */
+
+#include <RTPPacketizer.h>
+#include <Logger.h>
+
+namespace Homer { namespace Multimedia {
+
+using namespace std;
+using namespace Homer::Base;
+
+///////////////////////////////////////////////////////////////////////////////
+
+RTPPacketizer::RTPPacketizer()
+{
+    mStream = NULL;
+    mStreamCodecContext = NULL;
+    mStreamCodecId = AV_CODEC_ID_NONE;
+    mPacketizedPackets = 0;
+    mAdoptions = 0;
+    AnnounceNextPacket();
+}
+
+RTPPacketizer::~RTPPacketizer()
+{
+    Reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RTPPacketizer::Reset()
+{
+    if (mStream != NULL)
+    {
+        LOG(LOG_VERBOSE, "Closing shared RTP packetizer, %"PRIu64" packetized A/V packets were adopted %"PRIu64" times by media sinks", mPacketizedPackets, mAdoptions);
+        CloseRtpEncoder();
+    }
+    mStream = NULL;
+    mStreamCodecContext = NULL;
+    mStreamCodecId = AV_CODEC_ID_NONE;
+    AnnounceNextPacket();
+}
+
+void RTPPacketizer::AnnounceNextPacket()
+{
+    mPacketized = false;
+    mPacketizingFailed = false;
+    mData = NULL;
+    mDataSize = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool RTPPacketizer::GetRtpPackets(AVPacket *pAVPacket, AVStream *pStream, const string &pStreamName, char *&pData, unsigned int &pDataSize, uint64_t &pTimestampOffset)
+{
+    if (pStream == NULL)
+        return false;
+
+    // a failed packetization isn't repeated for each media sink
+    if (mPacketizingFailed)
+        return false;
+
+    if (!mPacketized)
+    {
+        //####################################################################
+        // check if RTP encoder is valid for the current stream
+        //####################################################################
+        if ((mStream != NULL) && ((mStream != pStream) || (mStreamCodecContext != pStream->codec) || (mStreamCodecId != pStream->codec->codec_id)))
+        {
+            LOG(LOG_VERBOSE, "Incoming AV stream changed, resetting shared RTP packetizer");
+            Reset();
+        }
+        if (mStream == NULL)
+        {
+            // the packets aren't sent by the packetizer, hence the target is only a placeholder
+            if (!OpenRtpEncoder("0.0.0.0", 0, pStream, pStreamName))
+            {
+                LOG(LOG_ERROR, "Couldn't open the shared RTP packetizer");
+                mPacketizingFailed = true;
+                return false;
+            }
+            mStream = pStream;
+            mStreamCodecContext = pStream->codec;
+            mStreamCodecId = pStream->codec->codec_id;
+        }
+
+        // the packetizer adapts the timestamps of the packet, the media sinks need the original ones
+        AVPacket tPacket = *pAVPacket;
+        if (!RtpCreate(&tPacket, mData, mDataSize))
+        {
+            #ifdef RTP_PACKETIZER_DEBUG
+                LOG(LOG_VERBOSE, "Shared RTP packetizer didn't create packets for A/V packet of %d bytes", pAVPacket->size);
+            #endif
+            mPacketizingFailed = true;
+            return false;
+        }
+        mPacketized = true;
+        mPacketizedPackets++;
+
+        #ifdef RTP_PACKETIZER_DEBUG
+            LOG(LOG_VERBOSE, "Created shared RTP stream of %u bytes for A/V packet of %d bytes", mDataSize, pAVPacket->size);
+        #endif
+    }
+
+    pData = mData;
+    pDataSize = mDataSize;
+    pTimestampOffset = GetLocalTimestampOffset();
+    mAdoptions++;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t RTPPacketizer::GetPacketizedPackets()
+{
+    return mPacketizedPackets;
+}
+
+uint64_t RTPPacketizer::GetAdoptions()
+{
+    return mAdoptions;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
@@ -26,6 +26,7 @@
 
 #include <VideoScaler.h>
 #include <MediaSourceMuxer.h>
+#include <MediaFifoSpsc.h>
 #include <ProcessStatisticService.h>
 #include <HBSocket.h>
 #include <RTP.h>
@@ -73,7 +74,10 @@ void VideoScaler::StartScaler(int pInputQueueSize, int pSourceResX, int pSourceR
 
     int tInputBufferSize = avpicture_get_size(mSourcePixelFormat, mSourceResX, mSourceResY) + FF_INPUT_BUFFER_PADDING_SIZE;
     //HINT: we have to allocate input FIFO here to make sure we can force a return from a read request inside StopScaler(), StartScaler() and StopScaler() should be called from the same thread/context!
-    mInputFifo = new MediaFifo(mQueueSize, tInputBufferSize, "VIDEO-ScalerInput/" + mName);
+    MediaFifoSpsc *tInputFifo = new MediaFifoSpsc(mQueueSize, tInputBufferSize, "VIDEO-ScalerInput/" + mName);
+    // the capture thread mustn't wait for a slow scaler, the scaler drops the oldest frames instead
+    tInputFifo->SetFullTimeout(0);
+    mInputFifo = tInputFifo;
 
     // start scaler main loop
     StartThread();
@@ -289,6 +293,13 @@ void* VideoScaler::Run(void* pArgs)
             #endif
             int64_t tInputFrameTimestamp;
             tFifoEntry = mInputFifo->ReadFifoExclusive(&tBuffer, tBufferSize, tInputFrameTimestamp);
+            // the queue is full and the writer drops new frames, hence the oldest frames are skipped until a slot is free again
+            while ((tBufferSize > 0) && (mScalerNeeded) && (mInputFifo->GetUsage() >= mInputFifo->GetSize() - 1))
+            {
+                LOG(LOG_WARN, "Input queue of %s video scaler is full, dropping oldest frame", mName.c_str());
+                mInputFifo->ReadFifoExclusiveFinished(tFifoEntry);
+                tFifoEntry = mInputFifo->ReadFifoExclusive(&tBuffer, tBufferSize, tInputFrameTimestamp);
+            }
             #ifdef VS_DEBUG_PACKETS
                 LOG(LOG_VERBOSE, "Got new input of %d bytes for scaling", tBufferSize);
             #endif
@@ -339,7 +350,7 @@ void* VideoScaler::Run(void* pArgs)
                     // ####################################################################
                     // ### SCALE FRAME (CONVERT)
                     // ###################################################################
-                    int64_t tTime = Time::GetTimeStamp();
+                    int64_t tTime = Time::GetMonotonicTimeStamp();
                     // convert
 
                     #ifdef VS_DEBUG_PACKETS
@@ -352,7 +363,7 @@ void* VideoScaler::Run(void* pArgs)
                     HM_sws_scale(mVideoScalerContext, tInputFrame->data, tInputFrame->linesize, 0, mSourceResY, tOutputFrame->data, tOutputFrame->linesize);
                     #ifdef VS_DEBUG_PACKETS
                         LOG(LOG_VERBOSE, "..video scaling for %s finished", mName.c_str());
-                        int64_t tTime2 = Time::GetTimeStamp();
+                        int64_t tTime2 = Time::GetMonotonicTimeStamp();
                         LOG(LOG_VERBOSE, "SCALER-scaling video frame took %"PRId64" us", tTime2 - tTime);
                     #endif
 
@@ -313,14 +313,14 @@ void WaveOutPulseAudio::DoWriteChunk(char *pChunkBuffer, int pChunkSize)
     if (!mPlaybackStopped)
     {
         #ifdef WOPUA_DEBUG_TIMING
-            int64_t tTime = Time::GetTimeStamp();
+            int64_t tTime = Time::GetMonotonicTimeStamp();
         #endif
         if (pa_simple_write(mOutputStream, pChunkBuffer, pChunkSize, &tRes) < 0)
         {
             LOG(LOG_ERROR, "Couldn't write audio chunk of %d bytes to output stream because %s(%d)", pChunkSize, pa_strerror(tRes), tRes);
         }
         #ifdef WOPUA_DEBUG_TIMING
-            LOG(LOG_VERBOSE, "PulseAudio-WRITE took %lld ms", (Time::GetTimeStamp() - tTime) / 1000);
+            LOG(LOG_VERBOSE, "PulseAudio-WRITE took %lld ms", (Time::GetMonotonicTimeStamp() - tTime) / 1000);
         #endif
     }
 }
@@ -53,7 +53,7 @@ public:
     virtual Requirements* getRequirements();
     virtual Events getEvents();
 
-private:
+protected:
     IConnection*    mConnection; // we support only one association
     Requirements	*mRequirements;
     Socket		    *mSocket;
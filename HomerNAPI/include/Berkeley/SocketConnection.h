@@ -56,13 +56,14 @@ public:
     virtual Requirements* getRequirements();
     virtual Events getEvents();
 
-private:
+protected:
     bool		    mBlockingMode;
     Requirements    *mRequirements;
     Socket		    *mSocket;
     bool            mIsClosed;
     std::string     mPeerHost;
     unsigned int    mPeerPort;
+    bool            mPeerBound;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -56,6 +56,18 @@ public:
     virtual bool changeRequirements(Requirements *pRequirements) = 0;
     virtual Requirements* getRequirements() = 0;
     virtual Events getEvents() = 0;
+
+    /* optional batching and zero-copy extensions, implementations without support fall back to read() and write() */
+    virtual void writeBatch(char** pBuffers, int *pBufferSizes, int pBufferCount) // the buffers are only needed until the call returns
+    {
+        for (int i = 0; (i < pBufferCount) && (!isClosed()); i++)
+            write(pBuffers[i], pBufferSizes[i]);
+    }
+    virtual bool readBuffer(char* &pBuffer, int &pBufferSize) // hands out a buffer of the connection which is valid until releaseBuffer(), returns false if not supported
+    {
+        return false;
+    }
+    virtual void releaseBuffer(char* pBuffer){ }
 };
 
 typedef std::vector<IConnection*> IConnections;
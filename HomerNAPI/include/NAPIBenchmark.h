@@ -0,0 +1,104 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: loopback benchmark for NAPI implementations
+ * Since:   2026-10-16
+ */
+
+#ifndef _NAPI_BENCHMARK_
+#define _NAPI_BENCHMARK_
+
+#include <HBThread.h>
+
+#include <IConnection.h>
+
+#include <list>
+#include <string>
+#include <stdint.h>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define NAPI_BENCHMARK_PACKETS                  100000
+#define NAPI_BENCHMARK_PACKET_SIZE              1280 // typical size of RTP packets
+#define NAPI_BENCHMARK_PORT                     5090
+
+// number of datagrams which are handed to writeBatch() at once, like the packets of one video frame
+#define NAPI_BENCHMARK_BATCH_SIZE               16
+
+// max. time the receiver gets for outstanding packets after the sender has finished
+#define NAPI_BENCHMARK_DRAIN_TIME               1000 // ms
+
+struct NAPIBenchmarkResult
+{
+    std::string             Implementation;
+    int                     SentPackets;
+    int                     ReceivedPackets;
+    int64_t                 SendDuration; // in us
+    int64_t                 ReceiveDuration; // in us, from first to last received packet
+};
+
+typedef std::list<NAPIBenchmarkResult> NAPIBenchmarkResults;
+
+///////////////////////////////////////////////////////////////////////////////
+
+class NAPIBenchmarkReceiver:
+    public Thread
+{
+public:
+    NAPIBenchmarkReceiver(IConnection *pConnection, int pPacketSize);
+    virtual ~NAPIBenchmarkReceiver();
+
+    virtual void* Run(void* pArgs = NULL);
+
+    int GetReceivedPackets();
+    int64_t GetReceiveDuration();
+
+private:
+    IConnection         *mConnection;
+    char                *mPacketBuffer;
+    int                 mPacketBufferSize;
+    volatile int        mReceivedPackets;
+    int64_t             mFirstPacketTime;
+    int64_t             mLastPacketTime;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Sends datagrams via the IPv6 loopback interface from one NAPI association
+ * to a NAPI binding of the same implementation. The previously selected
+ * implementation is restored afterwards.
+ */
+class NAPIBenchmark
+{
+public:
+    static bool Run(std::string pImplName, NAPIBenchmarkResult &pResult, int pPacketCount = NAPI_BENCHMARK_PACKETS, int pPacketSize = NAPI_BENCHMARK_PACKET_SIZE);
+    static NAPIBenchmarkResults RunAll(int pPacketCount = NAPI_BENCHMARK_PACKETS, int pPacketSize = NAPI_BENCHMARK_PACKET_SIZE); // runs the benchmark for all registered implementations
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
@@ -0,0 +1,51 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: UringBinding
+ * Since:   2026-10-16
+ */
+
+#ifndef _NAPI_URING_BINDING_
+#define _NAPI_URING_BINDING_
+
+#include <Berkeley/SocketBinding.h>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the socket is created like for Berkeley sockets, only the data transfer of datagram associations is done via io_uring
+class UringBinding:
+	public SocketBinding
+{
+public:
+	UringBinding(std::string pLocalName, Requirements *pRequirements);
+    virtual ~UringBinding( );
+
+    virtual IConnection* readConnection();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
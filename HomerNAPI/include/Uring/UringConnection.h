@@ -0,0 +1,150 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: UringConnection
+ * Since:   2026-10-16
+ */
+
+#ifndef _NAPI_URING_CONNECTION_
+#define _NAPI_URING_CONNECTION_
+
+#include <Uring/UringQueue.h>
+#include <Berkeley/SocketConnection.h>
+#include <HBSocket.h>
+#include <HBMutex.h>
+
+#include <list>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// number of datagrams which can be in flight at the same time for sending (registered buffer slots)
+#define URING_WRITE_SLOTS                       32
+#define URING_WRITE_SLOT_SIZE                   (8 * 1024)
+
+// max. number of datagrams which are handed to the kernel by one system call in writeBatch(), larger batches are split
+#define URING_WRITE_BATCH_SIZE                  32
+
+// number of provided buffers for multishot reception, has to be a power of 2
+#define URING_READ_SLOTS                        64
+#define URING_READ_SLOT_SIZE                    (16 * 1024 + 256) // max. datagram size (jumbo packets) + space for source address and reception header
+#define URING_READ_BUFFER_GROUP                 0
+
+#define URING_QUEUE_ENTRIES                     64
+
+// max. time for waiting on outstanding operations when a connection is destroyed
+#define URING_SHUTDOWN_TIMEOUT                  500 // ms
+
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef NAPI_URING_SUPPORTED
+
+struct UringReceivedDatagram
+{
+    unsigned short          BufferId;
+    int                     Size; // size of the entire reception buffer content
+};
+
+/*
+ * Datagram association which uses the Berkeley socket of the base class only
+ * for setup and option handling. Sending uses registered buffers and the
+ * socket as fixed file. Reception is done via a multishot receive on a ring
+ * of provided buffers, a single system call may deliver many datagrams.
+ * Read and write direction use separate rings in order to avoid that the
+ * reader and the writer thread reap each others completions.
+ * Stream associations and kernels with missing io_uring features fall back
+ * to the Berkeley implementation.
+ */
+class UringConnection:
+	public SocketConnection
+{
+public:
+	UringConnection(std::string pTarget, Requirements *pRequirements);
+	UringConnection(Socket *pSocket);
+    virtual ~UringConnection( );
+
+    virtual void read(char* pBuffer, int &pBufferSize);
+    virtual void write(char* pBuffer, int pBufferSize);
+    virtual void writeBatch(char** pBuffers, int *pBufferSizes, int pBufferCount);
+    virtual bool readBuffer(char* &pBuffer, int &pBufferSize);
+    virtual void releaseBuffer(char* pBuffer);
+    virtual void cancel();
+
+private:
+    void InitDefaults();
+    bool IsDatagramSocket();
+
+    /* sending */
+    bool InitWriteUring();
+    bool PrepareWriteTarget();
+    void ReapWriteCompletions();
+    void DestroyWriteUring();
+
+    /* reception */
+    bool InitReadUring();
+    bool ArmReceive();
+    void ReapReadCompletions();
+    void RecycleReadBuffer(unsigned short pBufferId);
+    int WaitForDatagram(); // returns 1 if a datagram is available, 0 for the Berkeley fallback and -1 if the connection is closed
+    char* TakeDatagram(int &pPayloadSize); // returns the payload within the provided buffer, the buffer has to be recycled afterwards
+    void DestroyReadUring();
+
+    /* sending */
+    Mutex               mWriteMutex;
+    int                 mWriteUringState; // -1 = not initialized, 0 = Berkeley fallback, 1 = active
+    UringQueue          mWriteQueue;
+    char                *mWriteBuffers;
+    int                 mWriteFreeSlots[URING_WRITE_SLOTS];
+    int                 mWriteFreeSlotCount;
+    struct msghdr       mWriteMessages[URING_WRITE_SLOTS];
+    struct iovec        mWriteVectors[URING_WRITE_SLOTS];
+    SocketAddressDescriptor mWriteAddresses[URING_WRITE_SLOTS];
+    struct msghdr       mWriteBatchMessages[URING_WRITE_BATCH_SIZE];
+    struct iovec        mWriteBatchVectors[URING_WRITE_BATCH_SIZE];
+    int                 mWriteBatchPending; // sends of the current batch which aren't finished yet
+    std::string         mWriteTargetHost;
+    unsigned int        mWriteTargetPort;
+    SocketAddressDescriptor mWriteTargetAddress;
+    unsigned int        mWriteTargetAddressSize;
+    /* reception */
+    Mutex               mReadMutex;
+    int                 mReadUringState; // -1 = not initialized, 0 = Berkeley fallback, 1 = active
+    UringQueue          mReadQueue;
+    char                *mReadBuffers;
+    struct io_uring_buf_ring *mReadBufferRing;
+    unsigned short      mReadBufferRingTail;
+    bool                mReadBufferRingRegistered;
+    struct msghdr       mReadMessage;
+    bool                mReceiveArmed;
+    std::list<UringReceivedDatagram> mReceivedDatagrams;
+    SocketAddressDescriptor mLastSourceAddress;
+    unsigned int        mLastSourceAddressSize;
+};
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
@@ -0,0 +1,124 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: minimal wrapper for a Linux io_uring submission/completion queue pair
+ * Since:   2026-10-16
+ */
+
+#ifndef _NAPI_URING_QUEUE_
+#define _NAPI_URING_QUEUE_
+
+// io_uring with multishot reception and provided buffer rings is available since Linux 6.0
+#if defined(LINUX)
+#include <linux/version.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6,0,0)
+#define NAPI_URING_SUPPORTED
+#endif
+#endif
+
+#ifdef NAPI_URING_SUPPORTED
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#include <stdint.h>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the following de/activates debugging of io_uring operations
+//#define NAPI_URING_DEBUG
+
+// copy of one completion queue entry
+struct UringCompletion
+{
+    uint64_t                UserData;
+    int                     Result; // result of the operation or negative error code
+    unsigned int            Flags;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The queue uses the raw system calls because liburing isn't available on
+ * all supported distributions. Submissions have to be serialized by the
+ * caller, a blocking Wait() may run concurrently to submissions from other
+ * threads. Completions have to be reaped by a single thread.
+ */
+class UringQueue
+{
+public:
+    UringQueue();
+    virtual ~UringQueue();
+
+    static bool IsSupported(); // probes the running kernel for the needed operations
+
+    bool Init(unsigned int pEntries);
+    void Close();
+    bool IsReady();
+
+    /* submission */
+    struct io_uring_sqe* GetSqe(); // returns a cleared SQE or NULL if the submission queue is full
+    int Submit(unsigned int pMinComplete = 0); // hands all prepared SQEs to the kernel and waits for the given number of completions, returns the number of consumed SQEs or -1
+    bool Wait(); // blocks until at least one completion is available, returns false in case of an error
+
+    /* completion */
+    bool PeekCompletion(UringCompletion &pCompletion); // consumes the oldest completion without any system call
+
+    /* registration */
+    bool RegisterFiles(int *pHandles, unsigned int pCount);
+    bool RegisterBuffers(struct iovec *pBuffers, unsigned int pCount);
+    bool RegisterBufferRing(struct io_uring_buf_ring *pRing, unsigned int pEntries, unsigned short pGroup);
+    bool UnregisterBufferRing(unsigned short pGroup);
+
+private:
+    int Enter(unsigned int pToSubmit, unsigned int pMinComplete, unsigned int pFlags);
+    int Register(unsigned int pOpcode, void *pArgs, unsigned int pArgsCount);
+
+    int                 mRingHandle;
+    /* submission queue */
+    void                *mSqRing;
+    size_t              mSqRingSize;
+    struct io_uring_sqe *mSqes;
+    size_t              mSqesSize;
+    volatile unsigned int *mSqHead;
+    volatile unsigned int *mSqTail;
+    unsigned int        *mSqArray;
+    unsigned int        mSqMask;
+    unsigned int        mSqEntries;
+    unsigned int        mSqLocalTail; // includes prepared SQEs which aren't published yet
+    /* completion queue */
+    void                *mCqRing;
+    size_t              mCqRingSize;
+    struct io_uring_cqe *mCqes;
+    volatile unsigned int *mCqHead;
+    volatile unsigned int *mCqTail;
+    unsigned int        mCqMask;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
+
+#endif
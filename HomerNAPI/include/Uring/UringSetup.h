@@ -0,0 +1,57 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: UringSetup
+ * Since:   2026-10-16
+ */
+
+#ifndef _NAPI_URING_SETUP_
+#define _NAPI_URING_SETUP_
+
+#include <Name.h>
+#include <ISetup.h>
+
+namespace Homer { namespace Base {
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define URING_SOCKETS               "Linux io_uring"
+
+///////////////////////////////////////////////////////////////////////////////
+
+class UringSetup:
+	public ISetup
+{
+public:
+	UringSetup();
+    virtual ~UringSetup();
+
+    virtual IConnection* connect(Name *pName, Requirements *pRequirements = 0);
+    virtual ICEPBinding* bind(Name *pName, Requirements *pRequirements = 0);
+    virtual Requirements getCapabilities(Name *pName, Requirements *pImportantRequirements = 0);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} // namespaces
+
+#endif
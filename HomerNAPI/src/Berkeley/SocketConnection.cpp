@@ -52,6 +52,7 @@ SocketConnection::SocketConnection(std::string pTarget, Requirements *pRequireme
 {
     bool tFoundTransport = false;
     mSocket = NULL;
+    mPeerBound = false;
 
     mBlockingMode = true;
     mPeerHost = pTarget;
@@ -111,6 +112,9 @@ SocketConnection::SocketConnection(std::string pTarget, Requirements *pRequireme
         {
             mSocket->SetPeerHost(mPeerHost);
             mSocket->SetPeerPort(mPeerPort);
+            // the target of an association never changes: connect datagram sockets once and avoid address handling per write()
+            if ((tUdp) || (tUdpLite))
+                mPeerBound = mSocket->BindPeer(mPeerHost, mPeerPort);
             mIsClosed = false;
 
             /* QoS requirements and additional transport requirements */
@@ -130,6 +134,7 @@ SocketConnection::SocketConnection(Socket *pSocket)
 {
     mIsClosed = false;
     mSocket = pSocket;
+    mPeerBound = false;
     mBlockingMode = true;
     mPeerHost = "";
     mPeerPort = 0;
@@ -193,8 +198,10 @@ void SocketConnection::write(char* pBuffer, int pBufferSize)
 {
     if (mSocket != NULL)
     {
-        if ((mPeerHost != "") && (mPeerPort != 0))
-        mIsClosed = !mSocket->Send(mPeerHost, mPeerPort, (void*)pBuffer, (ssize_t) pBufferSize);
+        if (mPeerBound)
+            mIsClosed = !mSocket->Send((void*)pBuffer, (ssize_t) pBufferSize);
+        else if ((mPeerHost != "") && (mPeerPort != 0))
+            mIsClosed = !mSocket->Send(mPeerHost, mPeerPort, (void*)pBuffer, (ssize_t) pBufferSize);
         if (mIsClosed)
         	LOG(LOG_ERROR, "NAPI connection marked as closed");
         //TODO: extended error signaling
@@ -26,6 +26,8 @@
 
 #include <NAPI.h>
 #include <Berkeley/SocketSetup.h>
+#include <Uring/UringQueue.h>
+#include <Uring/UringSetup.h>
 
 #include <Logger.h>
 
@@ -44,6 +46,10 @@ NAPIService::NAPIService()
 	mSetupInterface = NULL;
 	mSetupInterfaceName = "";
 	registerImpl(new SocketSetup(), BERKEYLEY_SOCKETS);
+	#ifdef NAPI_URING_SUPPORTED
+	    if (UringQueue::IsSupported())
+	        registerImpl(new UringSetup(), URING_SOCKETS);
+	#endif
 }
 
 NAPIService::~NAPIService()
@@ -0,0 +1,231 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of a loopback benchmark for NAPI implementations
+ * Since:   2026-10-16
+ */
+
+#include <NAPI.h>
+#include <NAPIBenchmark.h>
+#include <Requirements.h>
+#include <RequirementTransmitChunks.h>
+#include <RequirementTargetPort.h>
+
+#include <HBTime.h>
+#include <HBThread.h>
+
+#include <Logger.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace Homer { namespace Base {
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+NAPIBenchmarkReceiver::NAPIBenchmarkReceiver(IConnection *pConnection, int pPacketSize)
+{
+    mConnection = pConnection;
+    // one additional byte allows us to detect oversized datagrams
+    mPacketBufferSize = pPacketSize + 1;
+    mPacketBuffer = (char*)malloc(mPacketBufferSize);
+    mReceivedPackets = 0;
+    mFirstPacketTime = 0;
+    mLastPacketTime = 0;
+}
+
+NAPIBenchmarkReceiver::~NAPIBenchmarkReceiver()
+{
+    free(mPacketBuffer);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void* NAPIBenchmarkReceiver::Run(void* pArgs)
+{
+    LOG(LOG_VERBOSE, "NAPI benchmark receiver started");
+
+    while (!mConnection->isClosed())
+    {
+        // zero-copy reception if the implementation supports it
+        char *tPacket = NULL;
+        int tPacketSize = mPacketBufferSize;
+        if (mConnection->readBuffer(tPacket, tPacketSize))
+            mConnection->releaseBuffer(tPacket);
+        else
+            mConnection->read(mPacketBuffer, tPacketSize);
+        if ((tPacketSize > 0) && (!mConnection->isClosed()))
+        {
+            mLastPacketTime = Time::GetMonotonicTimeStamp();
+            if (mFirstPacketTime == 0)
+                mFirstPacketTime = mLastPacketTime;
+            mReceivedPackets++;
+        }
+    }
+
+    LOG(LOG_VERBOSE, "NAPI benchmark receiver finished after %d packets", mReceivedPackets);
+
+    return NULL;
+}
+
+int NAPIBenchmarkReceiver::GetReceivedPackets()
+{
+    return mReceivedPackets;
+}
+
+int64_t NAPIBenchmarkReceiver::GetReceiveDuration()
+{
+    return mLastPacketTime - mFirstPacketTime;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool NAPIBenchmark::Run(string pImplName, NAPIBenchmarkResult &pResult, int pPacketCount, int pPacketSize)
+{
+    string tPreviousImplName = NAPI.getCurrentImplName();
+
+    pResult.Implementation = pImplName;
+    pResult.SentPackets = 0;
+    pResult.ReceivedPackets = 0;
+    pResult.SendDuration = 0;
+    pResult.ReceiveDuration = 0;
+
+    if (!NAPI.selectImpl(pImplName))
+    {
+        LOGEX(NAPIBenchmark, LOG_ERROR, "NAPI implementation \"%s\" isn't available", pImplName.c_str());
+        return false;
+    }
+
+    LOGEX(NAPIBenchmark, LOG_INFO, "Benchmarking NAPI implementation \"%s\" with %d packets of %d bytes", pImplName.c_str(), pPacketCount, pPacketSize);
+
+    /* receiver side */
+    Requirements *tBindRequs = new Requirements();
+    RequirementTargetPort *tBindPort = new RequirementTargetPort(NAPI_BENCHMARK_PORT);
+    tBindRequs->add(new RequirementTransmitChunks());
+    tBindRequs->add(tBindPort);
+    Name tLocalName("::");
+    ICEPBinding *tBinding = NAPI.bind(&tLocalName, tBindRequs);
+    IConnection *tReceiverConnection = (tBinding != NULL) ? tBinding->readConnection() : NULL;
+    if (tReceiverConnection == NULL)
+    {
+        LOGEX(NAPIBenchmark, LOG_ERROR, "Unable to create NAPI binding for the benchmark");
+        delete tBinding;
+        NAPI.selectImpl(tPreviousImplName);
+        return false;
+    }
+
+    /* sender side, the binding might have used another port than requested */
+    Requirements *tConnectRequs = new Requirements();
+    tConnectRequs->add(new RequirementTransmitChunks());
+    tConnectRequs->add(new RequirementTargetPort(tBindPort->getPort()));
+    Name tTargetName("::1");
+    IConnection *tSenderConnection = NAPI.connect(&tTargetName, tConnectRequs);
+    if ((tSenderConnection == NULL) || (tSenderConnection->isClosed()))
+    {
+        LOGEX(NAPIBenchmark, LOG_ERROR, "Unable to create NAPI association for the benchmark");
+        delete tSenderConnection;
+        delete tBinding;
+        NAPI.selectImpl(tPreviousImplName);
+        return false;
+    }
+
+    NAPIBenchmarkReceiver *tReceiver = new NAPIBenchmarkReceiver(tReceiverConnection, pPacketSize);
+    tReceiver->StartThread();
+
+    char *tPackets = (char*)malloc(NAPI_BENCHMARK_BATCH_SIZE * pPacketSize);
+    char *tBatchBuffers[NAPI_BENCHMARK_BATCH_SIZE];
+    int tBatchBufferSizes[NAPI_BENCHMARK_BATCH_SIZE];
+    memset(tPackets, 0xAA, NAPI_BENCHMARK_BATCH_SIZE * pPacketSize);
+
+    int64_t tStartTime = Time::GetMonotonicTimeStamp();
+    while (pResult.SentPackets < pPacketCount)
+    {
+        int tBatchSize = (pPacketCount - pResult.SentPackets > NAPI_BENCHMARK_BATCH_SIZE) ? NAPI_BENCHMARK_BATCH_SIZE : pPacketCount - pResult.SentPackets;
+        for (int i = 0; i < tBatchSize; i++)
+        {
+            int tPacketNumber = pResult.SentPackets + i;
+            tBatchBuffers[i] = tPackets + i * pPacketSize;
+            tBatchBufferSizes[i] = pPacketSize;
+            memcpy(tBatchBuffers[i], &tPacketNumber, sizeof(tPacketNumber) < (size_t)pPacketSize ? sizeof(tPacketNumber) : (size_t)pPacketSize);
+        }
+        tSenderConnection->writeBatch(tBatchBuffers, tBatchBufferSizes, tBatchSize);
+        if (tSenderConnection->isClosed())
+        {
+            LOGEX(NAPIBenchmark, LOG_ERROR, "NAPI association was closed after %d packets", pResult.SentPackets);
+            break;
+        }
+        pResult.SentPackets += tBatchSize;
+    }
+    pResult.SendDuration = Time::GetMonotonicTimeStamp() - tStartTime;
+
+    // give the receiver some time for the outstanding packets
+    int tRounds = 0;
+    while ((tReceiver->GetReceivedPackets() < pResult.SentPackets) && (tRounds < NAPI_BENCHMARK_DRAIN_TIME / 10))
+    {
+        Thread::Suspend(10 * 1000);
+        tRounds++;
+    }
+
+    // the connection is canceled before the receiver thread is stopped, this wakes up a blocked read()
+    tReceiverConnection->cancel();
+    tReceiver->StopThread(NAPI_BENCHMARK_DRAIN_TIME);
+    pResult.ReceivedPackets = tReceiver->GetReceivedPackets();
+    pResult.ReceiveDuration = tReceiver->GetReceiveDuration();
+
+    delete tReceiver;
+    delete tSenderConnection;
+    tBinding->cancel();
+    delete tBinding;
+    free(tPackets);
+
+    NAPI.selectImpl(tPreviousImplName);
+
+    LOGEX(NAPIBenchmark, LOG_INFO, "NAPI implementation \"%s\": sent %d packets in %"PRId64" us (%.0f packets/s), received %d packets (%.2f %% loss) in %"PRId64" us (%.0f packets/s)",
+            pImplName.c_str(),
+            pResult.SentPackets, pResult.SendDuration, (pResult.SendDuration > 0) ? 1000000.0 * pResult.SentPackets / pResult.SendDuration : 0.0,
+            pResult.ReceivedPackets, (pResult.SentPackets > 0) ? 100.0 * (pResult.SentPackets - pResult.ReceivedPackets) / pResult.SentPackets : 0.0,
+            pResult.ReceiveDuration, (pResult.ReceiveDuration > 0) ? 1000000.0 * pResult.ReceivedPackets / pResult.ReceiveDuration : 0.0);
+
+    return true;
+}
+
+NAPIBenchmarkResults NAPIBenchmark::RunAll(int pPacketCount, int pPacketSize)
+{
+    NAPIBenchmarkResults tResult;
+    SetupInterfacesNames tImplNames = NAPI.getAllImplNames();
+    SetupInterfacesNames::iterator tIt;
+
+    for (tIt = tImplNames.begin(); tIt != tImplNames.end(); tIt++)
+    {
+        NAPIBenchmarkResult tImplResult;
+        if (Run(*tIt, tImplResult, pPacketCount, pPacketSize))
+            tResult.push_back(tImplResult);
+    }
+
+    return tResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
@@ -0,0 +1,84 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: UringBinding
+ * Since:   2026-10-16
+ */
+
+#include <Uring/UringQueue.h>
+
+#ifdef NAPI_URING_SUPPORTED
+
+#include <NAPI.h>
+#include <Uring/UringBinding.h>
+#include <Uring/UringConnection.h>
+
+#include <Logger.h>
+
+#include <string>
+
+namespace Homer { namespace Base {
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+UringBinding::UringBinding(std::string pLocalName, Requirements *pRequirements):
+    SocketBinding(pLocalName, pRequirements)
+{
+}
+
+UringBinding::~UringBinding()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+IConnection* UringBinding::readConnection()
+{
+    if (mIsClosed)
+        return NULL;
+
+    if (mConnection == NULL)
+    {
+        switch(mSocket->GetTransportType())
+        {
+            case SOCKET_UDP:
+            case SOCKET_UDP_LITE:
+                LOG(LOG_VERBOSE, "Creating new io_uring association");
+                mConnection = new UringConnection(mSocket);
+                mConnection->changeRequirements(mRequirements);
+                break;
+            default:
+                // streams are handled by the Berkeley implementation
+                return SocketBinding::readConnection();
+        }
+    }
+
+    return mConnection;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
+
+#endif
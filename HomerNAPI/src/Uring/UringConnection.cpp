@@ -0,0 +1,790 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: UringConnection
+ * Since:   2026-10-16
+ */
+
+#include <Uring/UringQueue.h>
+
+#ifdef NAPI_URING_SUPPORTED
+
+#include <NAPI.h>
+#include <Uring/UringConnection.h>
+
+#include <HBSocket.h>
+#include <HBThread.h>
+
+#include <Logger.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+namespace Homer { namespace Base {
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the upper 32 bits of the user data describe the operation, the lower ones the write slot
+#define URING_USER_DATA_WRITE                   (1ULL << 32)
+#define URING_USER_DATA_RECEIVE                 (2ULL << 32)
+#define URING_USER_DATA_WAKEUP                  (3ULL << 32)
+#define URING_USER_DATA_CANCEL                  (4ULL << 32)
+#define URING_USER_DATA_WRITE_BATCH             (5ULL << 32)
+#define URING_USER_DATA_KIND(x)                 ((x) & 0xFFFFFFFF00000000ULL)
+#define URING_USER_DATA_SLOT(x)                 ((int)((x) & 0xFFFFFFFFULL))
+
+///////////////////////////////////////////////////////////////////////////////
+
+UringConnection::UringConnection(std::string pTarget, Requirements *pRequirements):
+    SocketConnection(pTarget, pRequirements)
+{
+    InitDefaults();
+}
+
+UringConnection::UringConnection(Socket *pSocket):
+    SocketConnection(pSocket)
+{
+    InitDefaults();
+}
+
+UringConnection::~UringConnection()
+{
+    // the rings have to be gone before the base class destroys the socket
+    if (!isClosed())
+        cancel();
+
+    mReadMutex.lock();
+    DestroyReadUring();
+    mReadMutex.unlock();
+
+    mWriteMutex.lock();
+    DestroyWriteUring();
+    mWriteMutex.unlock();
+}
+
+void UringConnection::InitDefaults()
+{
+    mWriteUringState = -1;
+    mWriteBuffers = NULL;
+    mWriteFreeSlotCount = 0;
+    mWriteTargetHost = "";
+    mWriteTargetPort = 0;
+    mWriteTargetAddressSize = 0;
+    mWriteBatchPending = 0;
+    mReadUringState = -1;
+    mReadBuffers = NULL;
+    mReadBufferRing = NULL;
+    mReadBufferRingTail = 0;
+    mReadBufferRingRegistered = false;
+    mReceiveArmed = false;
+    mLastSourceAddressSize = 0;
+    memset(&mReadMessage, 0, sizeof(mReadMessage));
+    memset(&mLastSourceAddress, 0, sizeof(mLastSourceAddress));
+}
+
+bool UringConnection::IsDatagramSocket()
+{
+    if (mSocket == NULL)
+        return false;
+
+    return ((mSocket->GetTransportType() == SOCKET_UDP) || (mSocket->GetTransportType() == SOCKET_UDP_LITE));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool UringConnection::InitWriteUring()
+{
+    mWriteUringState = 0;
+
+    if (!IsDatagramSocket())
+        return false;
+
+    if (!mWriteQueue.Init(URING_QUEUE_ENTRIES))
+    {
+        LOG(LOG_WARN, "Falling back to Berkeley sending");
+        return false;
+    }
+
+    // the socket is referenced as fixed file 0
+    int tHandle = mSocket->GetHandle();
+    if (!mWriteQueue.RegisterFiles(&tHandle, 1))
+    {
+        LOG(LOG_WARN, "Falling back to Berkeley sending");
+        DestroyWriteUring();
+        return false;
+    }
+
+    // all write slots are part of one registered buffer
+    if (posix_memalign((void**)&mWriteBuffers, 4096, URING_WRITE_SLOTS * URING_WRITE_SLOT_SIZE) != 0)
+    {
+        LOG(LOG_ERROR, "Unable to allocate %d bytes for io_uring write slots", URING_WRITE_SLOTS * URING_WRITE_SLOT_SIZE);
+        mWriteBuffers = NULL;
+        DestroyWriteUring();
+        return false;
+    }
+    struct iovec tRegion;
+    tRegion.iov_base = mWriteBuffers;
+    tRegion.iov_len = URING_WRITE_SLOTS * URING_WRITE_SLOT_SIZE;
+    if (!mWriteQueue.RegisterBuffers(&tRegion, 1))
+    {
+        LOG(LOG_WARN, "Falling back to Berkeley sending");
+        DestroyWriteUring();
+        return false;
+    }
+
+    mWriteFreeSlotCount = 0;
+    for (int i = URING_WRITE_SLOTS - 1; i >= 0; i--)
+    {
+        mWriteVectors[i].iov_base = mWriteBuffers + i * URING_WRITE_SLOT_SIZE;
+        mWriteVectors[i].iov_len = 0;
+        memset(&mWriteMessages[i], 0, sizeof(mWriteMessages[i]));
+        mWriteMessages[i].msg_name = &mWriteAddresses[i];
+        mWriteMessages[i].msg_iov = &mWriteVectors[i];
+        mWriteMessages[i].msg_iovlen = 1;
+        mWriteFreeSlots[mWriteFreeSlotCount++] = i;
+    }
+
+    LOG(LOG_VERBOSE, "Sending via io_uring with %d registered write slots", URING_WRITE_SLOTS);
+    mWriteUringState = 1;
+
+    return true;
+}
+
+void UringConnection::ReapWriteCompletions()
+{
+    UringCompletion tCompletion;
+
+    while (mWriteQueue.PeekCompletion(tCompletion))
+    {
+        if (URING_USER_DATA_KIND(tCompletion.UserData) == URING_USER_DATA_WRITE)
+            mWriteFreeSlots[mWriteFreeSlotCount++] = URING_USER_DATA_SLOT(tCompletion.UserData);
+        else if (URING_USER_DATA_KIND(tCompletion.UserData) == URING_USER_DATA_WRITE_BATCH)
+            mWriteBatchPending--;
+        else
+            continue;
+
+        if (tCompletion.Result < 0)
+        {
+            // ICMP "port unreachable" for a previous datagram of a connected socket, the peer might start later
+            if (tCompletion.Result == -ECONNREFUSED)
+                continue;
+
+            LOG(LOG_ERROR, "Sending via io_uring failed because of \"%s\"", strerror(-tCompletion.Result));
+            if (!mIsClosed)
+            {
+                LOG(LOG_ERROR, "NAPI connection marked as closed");
+                mIsClosed = true;
+            }
+        }
+    }
+}
+
+void UringConnection::DestroyWriteUring()
+{
+    if (mWriteUringState == 1)
+    {
+        // registered buffers have to stay valid until all sends are finished
+        int tRounds = 0;
+        ReapWriteCompletions();
+        while ((mWriteFreeSlotCount < URING_WRITE_SLOTS) && (tRounds < URING_SHUTDOWN_TIMEOUT))
+        {
+            Thread::Suspend(1000);
+            ReapWriteCompletions();
+            tRounds++;
+        }
+        if (mWriteFreeSlotCount < URING_WRITE_SLOTS)
+            LOG(LOG_WARN, "%d datagrams are still in flight when closing io_uring", URING_WRITE_SLOTS - mWriteFreeSlotCount);
+    }
+
+    mWriteQueue.Close();
+    free(mWriteBuffers);
+    mWriteBuffers = NULL;
+    mWriteFreeSlotCount = 0;
+    mWriteUringState = 0;
+}
+
+bool UringConnection::PrepareWriteTarget()
+{
+    if (mPeerBound)
+        return true;
+
+    // target of an unbound association: the last known peer, the address descriptor is cached until the peer changes
+    if ((mPeerHost == "") || (mPeerPort == 0))
+        return false;
+    if ((mPeerHost != mWriteTargetHost) || (mPeerPort != mWriteTargetPort))
+    {
+        if (!Socket::FillAddrDescriptor(mPeerHost, mPeerPort, &mWriteTargetAddress, mWriteTargetAddressSize))
+        {
+            LOG(LOG_ERROR, "Could not process the target address %s:%u", mPeerHost.c_str(), mPeerPort);
+            return false;
+        }
+        mWriteTargetHost = mPeerHost;
+        mWriteTargetPort = mPeerPort;
+    }
+
+    return true;
+}
+
+void UringConnection::write(char* pBuffer, int pBufferSize)
+{
+    if (mSocket == NULL)
+    {
+        LOG(LOG_ERROR, "Invalid socket");
+        return;
+    }
+
+    mWriteMutex.lock();
+
+    if (mWriteUringState == -1)
+        InitWriteUring();
+
+    // oversized datagrams are rare, they don't justify larger write slots
+    if ((mWriteUringState != 1) || (pBufferSize > URING_WRITE_SLOT_SIZE) || (pBufferSize < 0))
+    {
+        mWriteMutex.unlock();
+        SocketConnection::write(pBuffer, pBufferSize);
+        return;
+    }
+
+    if ((mIsClosed) || (!PrepareWriteTarget()))
+    {
+        mWriteMutex.unlock();
+        return;
+    }
+
+    // get a free write slot, wait for a finished send if all slots are in flight
+    ReapWriteCompletions();
+    while (mWriteFreeSlotCount == 0)
+    {
+        if (!mWriteQueue.Wait())
+        {
+            LOG(LOG_ERROR, "NAPI connection marked as closed");
+            mIsClosed = true;
+            mWriteMutex.unlock();
+            return;
+        }
+        ReapWriteCompletions();
+    }
+    int tSlot = mWriteFreeSlots[--mWriteFreeSlotCount];
+    char *tSlotBuffer = mWriteBuffers + tSlot * URING_WRITE_SLOT_SIZE;
+    memcpy(tSlotBuffer, pBuffer, (size_t)pBufferSize);
+
+    // the submission queue is larger than the amount of write slots, we always get a SQE
+    struct io_uring_sqe *tSqe = mWriteQueue.GetSqe();
+    if (mPeerBound)
+    {
+        // connected socket: write from the registered buffer
+        tSqe->opcode = IORING_OP_WRITE_FIXED;
+        tSqe->addr = (uint64_t)(unsigned long)tSlotBuffer;
+        tSqe->len = (unsigned int)pBufferSize;
+        tSqe->off = 0;
+        tSqe->buf_index = 0;
+    }else
+    {
+        memcpy(&mWriteAddresses[tSlot], &mWriteTargetAddress, mWriteTargetAddressSize);
+        mWriteMessages[tSlot].msg_namelen = mWriteTargetAddressSize;
+        mWriteVectors[tSlot].iov_len = (size_t)pBufferSize;
+        tSqe->opcode = IORING_OP_SENDMSG;
+        tSqe->addr = (uint64_t)(unsigned long)&mWriteMessages[tSlot];
+        tSqe->len = 1;
+        tSqe->msg_flags = MSG_NOSIGNAL;
+    }
+    tSqe->fd = 0;
+    tSqe->flags = IOSQE_FIXED_FILE;
+    tSqe->user_data = URING_USER_DATA_WRITE | (uint64_t)tSlot;
+
+    if (mWriteQueue.Submit() < 0)
+    {
+        LOG(LOG_ERROR, "NAPI connection marked as closed");
+        mIsClosed = true;
+    }
+
+    mWriteMutex.unlock();
+}
+
+void UringConnection::writeBatch(char** pBuffers, int *pBufferSizes, int pBufferCount)
+{
+    if (mSocket == NULL)
+    {
+        LOG(LOG_ERROR, "Invalid socket");
+        return;
+    }
+
+    mWriteMutex.lock();
+
+    if (mWriteUringState == -1)
+        InitWriteUring();
+
+    if (mWriteUringState != 1)
+    {
+        mWriteMutex.unlock();
+        SocketConnection::writeBatch(pBuffers, pBufferSizes, pBufferCount);
+        return;
+    }
+
+    if ((mIsClosed) || (!PrepareWriteTarget()))
+    {
+        mWriteMutex.unlock();
+        return;
+    }
+
+    // the datagrams are sent directly from the given buffers, hence each chunk has to be finished before the call returns
+    int tFirstBuffer = 0;
+    while ((tFirstBuffer < pBufferCount) && (!mIsClosed))
+    {
+        int tBufferCount = (pBufferCount - tFirstBuffer > URING_WRITE_BATCH_SIZE) ? URING_WRITE_BATCH_SIZE : pBufferCount - tFirstBuffer;
+        int tPreparedCount = 0;
+        for (int i = 0; i < tBufferCount; i++)
+        {
+            struct io_uring_sqe *tSqe = mWriteQueue.GetSqe();
+            if (tSqe == NULL)
+                break;
+
+            char *tBuffer = pBuffers[tFirstBuffer + i];
+            int tBufferSize = pBufferSizes[tFirstBuffer + i];
+            if (mPeerBound)
+            {
+                tSqe->opcode = IORING_OP_SEND;
+                tSqe->addr = (uint64_t)(unsigned long)tBuffer;
+                tSqe->len = (unsigned int)tBufferSize;
+            }else
+            {
+                memset(&mWriteBatchMessages[i], 0, sizeof(mWriteBatchMessages[i]));
+                mWriteBatchVectors[i].iov_base = tBuffer;
+                mWriteBatchVectors[i].iov_len = (size_t)tBufferSize;
+                mWriteBatchMessages[i].msg_name = &mWriteTargetAddress;
+                mWriteBatchMessages[i].msg_namelen = mWriteTargetAddressSize;
+                mWriteBatchMessages[i].msg_iov = &mWriteBatchVectors[i];
+                mWriteBatchMessages[i].msg_iovlen = 1;
+                tSqe->opcode = IORING_OP_SENDMSG;
+                tSqe->addr = (uint64_t)(unsigned long)&mWriteBatchMessages[i];
+                tSqe->len = 1;
+            }
+            tSqe->msg_flags = MSG_NOSIGNAL;
+            tSqe->fd = 0;
+            tSqe->flags = IOSQE_FIXED_FILE;
+            tSqe->user_data = URING_USER_DATA_WRITE_BATCH | (uint64_t)(tFirstBuffer + i);
+            tPreparedCount++;
+        }
+        if (tPreparedCount == 0)
+        {
+            LOG(LOG_ERROR, "No free io_uring submission queue entries for a batch");
+            break;
+        }
+        mWriteBatchPending += tPreparedCount;
+
+        // one system call submits the entire chunk and usually also returns its completions because UDP sends finish inline
+        if (mWriteQueue.Submit(tPreparedCount) < 0)
+        {
+            LOG(LOG_ERROR, "NAPI connection marked as closed");
+            mIsClosed = true;
+            break;
+        }
+        ReapWriteCompletions();
+        while (mWriteBatchPending > 0)
+        {
+            if (!mWriteQueue.Wait())
+            {
+                LOG(LOG_ERROR, "NAPI connection marked as closed");
+                mIsClosed = true;
+                break;
+            }
+            ReapWriteCompletions();
+        }
+
+        tFirstBuffer += tPreparedCount;
+    }
+
+    mWriteMutex.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool UringConnection::InitReadUring()
+{
+    mReadUringState = 0;
+
+    if (!IsDatagramSocket())
+        return false;
+
+    if (!mReadQueue.Init(URING_QUEUE_ENTRIES))
+    {
+        LOG(LOG_WARN, "Falling back to Berkeley reception");
+        return false;
+    }
+
+    // the socket is referenced as fixed file 0
+    int tHandle = mSocket->GetHandle();
+    if (!mReadQueue.RegisterFiles(&tHandle, 1))
+    {
+        LOG(LOG_WARN, "Falling back to Berkeley reception");
+        DestroyReadUring();
+        return false;
+    }
+
+    if ((posix_memalign((void**)&mReadBufferRing, 4096, URING_READ_SLOTS * sizeof(struct io_uring_buf)) != 0) ||
+        (posix_memalign((void**)&mReadBuffers, 4096, URING_READ_SLOTS * URING_READ_SLOT_SIZE) != 0))
+    {
+        LOG(LOG_ERROR, "Unable to allocate memory for %d io_uring reception buffers", URING_READ_SLOTS);
+        DestroyReadUring();
+        return false;
+    }
+    memset(mReadBufferRing, 0, URING_READ_SLOTS * sizeof(struct io_uring_buf));
+
+    // provided buffers are available since Linux 5.19
+    if (!mReadQueue.RegisterBufferRing(mReadBufferRing, URING_READ_SLOTS, URING_READ_BUFFER_GROUP))
+    {
+        LOG(LOG_WARN, "Falling back to Berkeley reception");
+        DestroyReadUring();
+        return false;
+    }
+    mReadBufferRingRegistered = true;
+
+    mReadBufferRingTail = 0;
+    for (unsigned short i = 0; i < URING_READ_SLOTS; i++)
+        RecycleReadBuffer(i);
+
+    // each reception buffer starts with a header and the source address, followed by the payload
+    memset(&mReadMessage, 0, sizeof(mReadMessage));
+    mReadMessage.msg_namelen = sizeof(struct sockaddr_storage);
+
+    mReadUringState = 1;
+
+    if (!ArmReceive())
+    {
+        LOG(LOG_WARN, "Falling back to Berkeley reception");
+        DestroyReadUring();
+        return false;
+    }
+
+    LOG(LOG_VERBOSE, "Receiving via io_uring with %d provided buffers of %d bytes", URING_READ_SLOTS, URING_READ_SLOT_SIZE);
+
+    return true;
+}
+
+bool UringConnection::ArmReceive()
+{
+    struct io_uring_sqe *tSqe = mReadQueue.GetSqe();
+    if (tSqe == NULL)
+        return false;
+
+    // one request delivers datagrams as long as free provided buffers are available
+    tSqe->opcode = IORING_OP_RECVMSG;
+    tSqe->fd = 0;
+    tSqe->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+    tSqe->ioprio = IORING_RECV_MULTISHOT;
+    tSqe->addr = (uint64_t)(unsigned long)&mReadMessage;
+    tSqe->len = 1;
+    tSqe->buf_group = URING_READ_BUFFER_GROUP;
+    tSqe->user_data = URING_USER_DATA_RECEIVE;
+
+    if (mReadQueue.Submit() < 0)
+        return false;
+
+    mReceiveArmed = true;
+
+    return true;
+}
+
+void UringConnection::RecycleReadBuffer(unsigned short pBufferId)
+{
+    // HINT: don't use the "bufs" member of the ring, the flexible array declaration of the kernel header has an offset of 8 bytes in C++
+    struct io_uring_buf *tBuffer = (struct io_uring_buf*)mReadBufferRing + (mReadBufferRingTail & (URING_READ_SLOTS - 1));
+
+    tBuffer->addr = (uint64_t)(unsigned long)(mReadBuffers + pBufferId * URING_READ_SLOT_SIZE);
+    tBuffer->len = URING_READ_SLOT_SIZE;
+    tBuffer->bid = pBufferId;
+    mReadBufferRingTail++;
+
+    // publish the buffer before the new tail
+    __sync_synchronize();
+    mReadBufferRing->tail = mReadBufferRingTail;
+}
+
+void UringConnection::ReapReadCompletions()
+{
+    UringCompletion tCompletion;
+
+    while (mReadQueue.PeekCompletion(tCompletion))
+    {
+        if (URING_USER_DATA_KIND(tCompletion.UserData) != URING_USER_DATA_RECEIVE)
+            continue;
+
+        // multishot request has terminated, e.g., because all provided buffers are in use
+        if (!(tCompletion.Flags & IORING_CQE_F_MORE))
+            mReceiveArmed = false;
+
+        if ((tCompletion.Result >= 0) && (tCompletion.Flags & IORING_CQE_F_BUFFER))
+        {
+            UringReceivedDatagram tDatagram;
+            tDatagram.BufferId = (unsigned short)(tCompletion.Flags >> IORING_CQE_BUFFER_SHIFT);
+            tDatagram.Size = tCompletion.Result;
+            mReceivedDatagrams.push_back(tDatagram);
+            continue;
+        }
+
+        switch(-tCompletion.Result)
+        {
+            case ENOBUFS:
+                #ifdef NAPI_URING_DEBUG
+                    LOG(LOG_VERBOSE, "All io_uring reception buffers are in use");
+                #endif
+                break;
+            case ECANCELED:
+                break;
+            case EINVAL:
+            case EOPNOTSUPP:
+                // multishot reception isn't supported, the already received datagrams are delivered before the fallback takes place
+                LOG(LOG_WARN, "Multishot reception not supported by kernel, falling back to Berkeley reception");
+                mReadUringState = 0;
+                break;
+            default:
+                LOG(LOG_ERROR, "Receiving via io_uring failed because of \"%s\"", strerror(-tCompletion.Result));
+                break;
+        }
+    }
+}
+
+char* UringConnection::TakeDatagram(int &pPayloadSize)
+{
+    UringReceivedDatagram tDatagram = mReceivedDatagrams.front();
+    mReceivedDatagrams.pop_front();
+
+    char *tSlot = mReadBuffers + tDatagram.BufferId * URING_READ_SLOT_SIZE;
+    struct io_uring_recvmsg_out *tHeader = (struct io_uring_recvmsg_out*)tSlot;
+    char *tName = tSlot + sizeof(struct io_uring_recvmsg_out);
+    char *tPayload = tName + mReadMessage.msg_namelen + mReadMessage.msg_controllen;
+    int tAvailableSize = tDatagram.Size - (int)(tPayload - tSlot);
+
+    pPayloadSize = (int)tHeader->payloadlen;
+    if ((tHeader->flags & MSG_TRUNC) || (pPayloadSize > tAvailableSize))
+    {
+        LOG(LOG_WARN, "Received datagram of %d bytes was truncated to %d bytes", pPayloadSize, tAvailableSize);
+        pPayloadSize = tAvailableSize;
+    }
+
+    // source address: the string conversion is only done if the peer has changed
+    unsigned int tNameSize = tHeader->namelen;
+    if (tNameSize > sizeof(mLastSourceAddress))
+        tNameSize = sizeof(mLastSourceAddress);
+    if ((tNameSize != mLastSourceAddressSize) || (memcmp(&mLastSourceAddress, tName, tNameSize) != 0))
+    {
+        memset(&mLastSourceAddress, 0, sizeof(mLastSourceAddress));
+        memcpy(&mLastSourceAddress, tName, tNameSize);
+        mLastSourceAddressSize = tNameSize;
+        mPeerHost = Socket::GetAddrFromDescriptor(&mLastSourceAddress, &mPeerPort);
+        mSocket->SetPeerHost(mPeerHost);
+        mSocket->SetPeerPort(mPeerPort);
+    }
+
+    return tPayload;
+}
+
+void UringConnection::DestroyReadUring()
+{
+    if (mReadQueue.IsReady())
+    {
+        if (mReceiveArmed)
+        {
+            struct io_uring_sqe *tSqe = mReadQueue.GetSqe();
+            if (tSqe != NULL)
+            {
+                tSqe->opcode = IORING_OP_ASYNC_CANCEL;
+                tSqe->addr = URING_USER_DATA_RECEIVE;
+                tSqe->user_data = URING_USER_DATA_CANCEL;
+                mReadQueue.Submit();
+            }
+
+            // provided buffers have to stay valid until the reception request is gone
+            int tRounds = 0;
+            ReapReadCompletions();
+            while ((mReceiveArmed) && (tRounds < URING_SHUTDOWN_TIMEOUT))
+            {
+                Thread::Suspend(1000);
+                ReapReadCompletions();
+                tRounds++;
+            }
+            if (mReceiveArmed)
+                LOG(LOG_WARN, "Reception request is still active when closing io_uring");
+        }
+
+        if (mReadBufferRingRegistered)
+            mReadQueue.UnregisterBufferRing(URING_READ_BUFFER_GROUP);
+        mReadQueue.Close();
+    }
+
+    free(mReadBuffers);
+    mReadBuffers = NULL;
+    free(mReadBufferRing);
+    mReadBufferRing = NULL;
+    mReadBufferRingRegistered = false;
+    mReceiveArmed = false;
+    mReceivedDatagrams.clear();
+    mReadUringState = 0;
+}
+
+int UringConnection::WaitForDatagram()
+{
+    if (mReadUringState == -1)
+        InitReadUring();
+
+    while (true)
+    {
+        if ((mReadUringState == 1) && (mIsClosed))
+            return -1;
+
+        ReapReadCompletions();
+
+        if (!mReceivedDatagrams.empty())
+            return 1;
+
+        if (mReadUringState != 1)
+            return 0;
+
+        if ((!mReceiveArmed) && (!ArmReceive()))
+        {
+            LOG(LOG_ERROR, "NAPI connection marked as closed");
+            mIsClosed = true;
+            return -1;
+        }
+
+        // wait without lock, cancel() may wake us up
+        mReadMutex.unlock();
+        bool tWaitSucceeded = mReadQueue.Wait();
+        mReadMutex.lock();
+
+        if (!tWaitSucceeded)
+        {
+            LOG(LOG_ERROR, "NAPI connection marked as closed");
+            mIsClosed = true;
+        }
+    }
+}
+
+void UringConnection::read(char* pBuffer, int &pBufferSize)
+{
+    if (mSocket == NULL)
+    {
+        LOG(LOG_ERROR, "Invalid socket");
+        return;
+    }
+
+    mReadMutex.lock();
+
+    int tState = WaitForDatagram();
+    if (tState == 0)
+    {
+        mReadMutex.unlock();
+        SocketConnection::read(pBuffer, pBufferSize);
+        return;
+    }
+
+    if (tState == 1)
+    {
+        int tPayloadSize;
+        char *tPayload = TakeDatagram(tPayloadSize);
+        if (tPayloadSize > pBufferSize)
+        {
+            LOG(LOG_ERROR, "Given read buffer is too small (%d bytes) for the received datagram of %d bytes, truncating data", pBufferSize, tPayloadSize);
+            tPayloadSize = pBufferSize;
+        }
+        if (tPayloadSize > 0)
+            memcpy(pBuffer, tPayload, (size_t)tPayloadSize);
+        pBufferSize = tPayloadSize;
+        RecycleReadBuffer((unsigned short)((tPayload - mReadBuffers) / URING_READ_SLOT_SIZE));
+    }else
+        pBufferSize = 0;
+
+    mReadMutex.unlock();
+}
+
+bool UringConnection::readBuffer(char* &pBuffer, int &pBufferSize)
+{
+    if (mSocket == NULL)
+    {
+        LOG(LOG_ERROR, "Invalid socket");
+        return false;
+    }
+
+    mReadMutex.lock();
+
+    int tState = WaitForDatagram();
+    if (tState == 0)
+    {
+        mReadMutex.unlock();
+        return false;
+    }
+
+    // the provided buffer is handed out and recycled when the caller releases it
+    if (tState == 1)
+    {
+        pBuffer = TakeDatagram(pBufferSize);
+    }else
+    {
+        pBuffer = NULL;
+        pBufferSize = 0;
+    }
+
+    mReadMutex.unlock();
+
+    return true;
+}
+
+void UringConnection::releaseBuffer(char* pBuffer)
+{
+    if (pBuffer == NULL)
+        return;
+
+    mReadMutex.lock();
+    if ((mReadBuffers != NULL) && (pBuffer >= mReadBuffers) && (pBuffer < mReadBuffers + URING_READ_SLOTS * URING_READ_SLOT_SIZE))
+        RecycleReadBuffer((unsigned short)((pBuffer - mReadBuffers) / URING_READ_SLOT_SIZE));
+    mReadMutex.unlock();
+}
+
+void UringConnection::cancel()
+{
+    SocketConnection::cancel();
+
+    // wake up a blocked reader
+    mReadMutex.lock();
+    if (mReadUringState == 1)
+    {
+        struct io_uring_sqe *tSqe = mReadQueue.GetSqe();
+        if (tSqe != NULL)
+        {
+            tSqe->opcode = IORING_OP_NOP;
+            tSqe->user_data = URING_USER_DATA_WAKEUP;
+            mReadQueue.Submit();
+        }
+    }
+    mReadMutex.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
+
+#endif
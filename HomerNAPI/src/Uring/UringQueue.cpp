@@ -0,0 +1,362 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of a minimal io_uring queue wrapper
+ * Since:   2026-10-16
+ */
+
+#include <Uring/UringQueue.h>
+
+#ifdef NAPI_URING_SUPPORTED
+
+#include <Logger.h>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Homer { namespace Base {
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+int sUringSupported = -1;
+
+///////////////////////////////////////////////////////////////////////////////
+
+UringQueue::UringQueue()
+{
+    mRingHandle = -1;
+    mSqRing = MAP_FAILED;
+    mSqRingSize = 0;
+    mSqes = (struct io_uring_sqe*)MAP_FAILED;
+    mSqesSize = 0;
+    mSqHead = NULL;
+    mSqTail = NULL;
+    mSqArray = NULL;
+    mSqMask = 0;
+    mSqEntries = 0;
+    mSqLocalTail = 0;
+    mCqRing = MAP_FAILED;
+    mCqRingSize = 0;
+    mCqes = NULL;
+    mCqHead = NULL;
+    mCqTail = NULL;
+    mCqMask = 0;
+}
+
+UringQueue::~UringQueue()
+{
+    Close();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// HINT: called during static initialization of the NAPI service, hence no logging here
+bool UringQueue::IsSupported()
+{
+    if (sUringSupported != -1)
+        return (sUringSupported == 1);
+
+    sUringSupported = 0;
+
+    struct io_uring_params tParams;
+    memset(&tParams, 0, sizeof(tParams));
+    int tHandle = (int)syscall(__NR_io_uring_setup, 2, &tParams);
+    if (tHandle < 0)
+        return false;
+
+    if (!(tParams.features & IORING_FEAT_NODROP))
+    {
+        close(tHandle);
+        return false;
+    }
+
+    // make sure all operations which are used by the NAPI implementation are supported
+    size_t tProbeSize = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *tProbe = (struct io_uring_probe*)malloc(tProbeSize);
+    memset(tProbe, 0, tProbeSize);
+    if (syscall(__NR_io_uring_register, tHandle, IORING_REGISTER_PROBE, tProbe, 256) == 0)
+    {
+        const int tNeededOps[] = { IORING_OP_NOP, IORING_OP_WRITE_FIXED, IORING_OP_SENDMSG, IORING_OP_RECVMSG, IORING_OP_ASYNC_CANCEL };
+        sUringSupported = 1;
+        for (unsigned int i = 0; i < sizeof(tNeededOps) / sizeof(tNeededOps[0]); i++)
+        {
+            if ((tNeededOps[i] > tProbe->last_op) || (!(tProbe->ops[tNeededOps[i]].flags & IO_URING_OP_SUPPORTED)))
+                sUringSupported = 0;
+        }
+    }
+
+    free(tProbe);
+    close(tHandle);
+
+    return (sUringSupported == 1);
+}
+
+bool UringQueue::Init(unsigned int pEntries)
+{
+    struct io_uring_params tParams;
+
+    if (mRingHandle != -1)
+        return true;
+
+    memset(&tParams, 0, sizeof(tParams));
+    mRingHandle = (int)syscall(__NR_io_uring_setup, pEntries, &tParams);
+    if (mRingHandle < 0)
+    {
+        LOG(LOG_ERROR, "Unable to create io_uring with %u entries: %s", pEntries, strerror(errno));
+        mRingHandle = -1;
+        return false;
+    }
+
+    mSqRingSize = tParams.sq_off.array + tParams.sq_entries * sizeof(unsigned int);
+    mCqRingSize = tParams.cq_off.cqes + tParams.cq_entries * sizeof(struct io_uring_cqe);
+    mSqesSize = tParams.sq_entries * sizeof(struct io_uring_sqe);
+
+    mSqRing = mmap(NULL, mSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingHandle, IORING_OFF_SQ_RING);
+    mCqRing = mmap(NULL, mCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingHandle, IORING_OFF_CQ_RING);
+    mSqes = (struct io_uring_sqe*)mmap(NULL, mSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingHandle, IORING_OFF_SQES);
+    if ((mSqRing == MAP_FAILED) || (mCqRing == MAP_FAILED) || (mSqes == MAP_FAILED))
+    {
+        LOG(LOG_ERROR, "Unable to map io_uring memory: %s", strerror(errno));
+        Close();
+        return false;
+    }
+
+    char *tSqRing = (char*)mSqRing;
+    mSqHead = (volatile unsigned int*)(tSqRing + tParams.sq_off.head);
+    mSqTail = (volatile unsigned int*)(tSqRing + tParams.sq_off.tail);
+    mSqMask = *(unsigned int*)(tSqRing + tParams.sq_off.ring_mask);
+    mSqEntries = tParams.sq_entries;
+    mSqArray = (unsigned int*)(tSqRing + tParams.sq_off.array);
+    mSqLocalTail = *mSqTail;
+    // identity mapping: SQE i is always referenced by array slot i
+    for (unsigned int i = 0; i < mSqEntries; i++)
+        mSqArray[i] = i;
+
+    char *tCqRing = (char*)mCqRing;
+    mCqHead = (volatile unsigned int*)(tCqRing + tParams.cq_off.head);
+    mCqTail = (volatile unsigned int*)(tCqRing + tParams.cq_off.tail);
+    mCqMask = *(unsigned int*)(tCqRing + tParams.cq_off.ring_mask);
+    mCqes = (struct io_uring_cqe*)(tCqRing + tParams.cq_off.cqes);
+
+    LOG(LOG_VERBOSE, "Created io_uring %d with %u submission and %u completion entries", mRingHandle, tParams.sq_entries, tParams.cq_entries);
+
+    return true;
+}
+
+void UringQueue::Close()
+{
+    if (mSqes != MAP_FAILED)
+        munmap(mSqes, mSqesSize);
+    if (mCqRing != MAP_FAILED)
+        munmap(mCqRing, mCqRingSize);
+    if (mSqRing != MAP_FAILED)
+        munmap(mSqRing, mSqRingSize);
+    mSqes = (struct io_uring_sqe*)MAP_FAILED;
+    mCqRing = MAP_FAILED;
+    mSqRing = MAP_FAILED;
+
+    if (mRingHandle != -1)
+    {
+        LOG(LOG_VERBOSE, "Closing io_uring %d", mRingHandle);
+        close(mRingHandle);
+        mRingHandle = -1;
+    }
+}
+
+bool UringQueue::IsReady()
+{
+    return (mRingHandle != -1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int UringQueue::Enter(unsigned int pToSubmit, unsigned int pMinComplete, unsigned int pFlags)
+{
+    int tResult;
+
+    do{
+        tResult = (int)syscall(__NR_io_uring_enter, mRingHandle, pToSubmit, pMinComplete, pFlags, NULL, 0);
+    }while((tResult < 0) && (errno == EINTR));
+
+    return tResult;
+}
+
+int UringQueue::Register(unsigned int pOpcode, void *pArgs, unsigned int pArgsCount)
+{
+    return (int)syscall(__NR_io_uring_register, mRingHandle, pOpcode, pArgs, pArgsCount);
+}
+
+struct io_uring_sqe* UringQueue::GetSqe()
+{
+    struct io_uring_sqe *tResult;
+
+    if (mRingHandle == -1)
+        return NULL;
+
+    unsigned int tHead = *mSqHead;
+    __sync_synchronize();
+    if (mSqLocalTail - tHead >= mSqEntries)
+    {
+        #ifdef NAPI_URING_DEBUG
+            LOG(LOG_VERBOSE, "Submission queue of io_uring %d is full", mRingHandle);
+        #endif
+        return NULL;
+    }
+
+    tResult = &mSqes[mSqLocalTail & mSqMask];
+    mSqLocalTail++;
+    memset(tResult, 0, sizeof(*tResult));
+
+    return tResult;
+}
+
+int UringQueue::Submit(unsigned int pMinComplete)
+{
+    if (mRingHandle == -1)
+        return -1;
+
+    // publish the prepared SQEs before the new tail
+    __sync_synchronize();
+    *mSqTail = mSqLocalTail;
+    __sync_synchronize();
+
+    // includes SQEs which were published by a previous but failed call
+    unsigned int tToSubmit = mSqLocalTail - *mSqHead;
+    if ((tToSubmit == 0) && (pMinComplete == 0))
+        return 0;
+
+    int tResult = Enter(tToSubmit, pMinComplete, (pMinComplete > 0) ? IORING_ENTER_GETEVENTS : 0);
+    if (tResult < 0)
+        LOG(LOG_ERROR, "Unable to submit %u operations to io_uring %d: %s", tToSubmit, mRingHandle, strerror(errno));
+
+    #ifdef NAPI_URING_DEBUG
+        LOG(LOG_VERBOSE, "Submitted %d of %u operations to io_uring %d", tResult, tToSubmit, mRingHandle);
+    #endif
+
+    return tResult;
+}
+
+bool UringQueue::Wait()
+{
+    if (mRingHandle == -1)
+        return false;
+
+    if (Enter(0, 1, IORING_ENTER_GETEVENTS) < 0)
+    {
+        LOG(LOG_ERROR, "Unable to wait for completions of io_uring %d: %s", mRingHandle, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool UringQueue::PeekCompletion(UringCompletion &pCompletion)
+{
+    if (mRingHandle == -1)
+        return false;
+
+    unsigned int tHead = *mCqHead;
+    __sync_synchronize();
+    if (tHead == *mCqTail)
+        return false;
+    // make sure we see the CQE which was written before the tail was updated
+    __sync_synchronize();
+
+    struct io_uring_cqe *tCqe = &mCqes[tHead & mCqMask];
+    pCompletion.UserData = tCqe->user_data;
+    pCompletion.Result = tCqe->res;
+    pCompletion.Flags = tCqe->flags;
+
+    // hand the CQE back to the kernel
+    __sync_synchronize();
+    *mCqHead = tHead + 1;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool UringQueue::RegisterFiles(int *pHandles, unsigned int pCount)
+{
+    if (Register(IORING_REGISTER_FILES, pHandles, pCount) < 0)
+    {
+        LOG(LOG_ERROR, "Unable to register %u files at io_uring %d: %s", pCount, mRingHandle, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool UringQueue::RegisterBuffers(struct iovec *pBuffers, unsigned int pCount)
+{
+    if (Register(IORING_REGISTER_BUFFERS, pBuffers, pCount) < 0)
+    {
+        LOG(LOG_ERROR, "Unable to register %u buffers at io_uring %d: %s", pCount, mRingHandle, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool UringQueue::RegisterBufferRing(struct io_uring_buf_ring *pRing, unsigned int pEntries, unsigned short pGroup)
+{
+    struct io_uring_buf_reg tRegistration;
+
+    memset(&tRegistration, 0, sizeof(tRegistration));
+    tRegistration.ring_addr = (uint64_t)(unsigned long)pRing;
+    tRegistration.ring_entries = pEntries;
+    tRegistration.bgid = pGroup;
+    if (Register(IORING_REGISTER_PBUF_RING, &tRegistration, 1) < 0)
+    {
+        LOG(LOG_WARN, "Unable to register buffer ring with %u entries at io_uring %d: %s", pEntries, mRingHandle, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool UringQueue::UnregisterBufferRing(unsigned short pGroup)
+{
+    struct io_uring_buf_reg tRegistration;
+
+    memset(&tRegistration, 0, sizeof(tRegistration));
+    tRegistration.bgid = pGroup;
+    if (Register(IORING_UNREGISTER_PBUF_RING, &tRegistration, 1) < 0)
+    {
+        LOG(LOG_WARN, "Unable to unregister buffer ring %u from io_uring %d: %s", (unsigned int)pGroup, mRingHandle, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
+
+#endif
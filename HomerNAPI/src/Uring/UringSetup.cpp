@@ -0,0 +1,80 @@
+/*****************************************************************************
+ *
+ * Copyright (C) 2026 Thomas Volkert <thomas@homer-conferencing.com>
+ *
+ * This software is free software.
+ * Your are allowed to redistribute it and/or modify it under the terms of
+ * the GNU General Public License version 2 as published by the Free Software
+ * Foundation.
+ *
+ * This source is published in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License version 2
+ * along with this program. Otherwise, you can write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02111, USA.
+ * Alternatively, you find an online version of the license text under
+ * http://www.gnu.org/licenses/gpl-2.0.html.
+ *
+ *****************************************************************************/
+
+/*
+ * Purpose: Implementation of an io_uring based NAPI backend
+ * Since:   2026-10-16
+ */
+
+#include <Uring/UringQueue.h>
+
+#ifdef NAPI_URING_SUPPORTED
+
+#include <NAPI.h>
+#include <Uring/UringSetup.h>
+#include <Uring/UringBinding.h>
+#include <Uring/UringConnection.h>
+
+#include <Logger.h>
+
+#include <string>
+
+namespace Homer { namespace Base {
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+UringSetup::UringSetup()
+{
+}
+
+UringSetup::~UringSetup()
+{
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+IConnection* UringSetup::connect(Name *pName, Requirements *pRequirements)
+{
+	return new UringConnection(pName->toString(), pRequirements);
+}
+
+ICEPBinding* UringSetup::bind(Name *pName, Requirements *pRequirements)
+{
+    return new UringBinding(pName->toString(), pRequirements);
+}
+
+Requirements UringSetup::getCapabilities(Name *pName, Requirements *pImportantRequirements)
+{
+	Requirements tResult;
+
+	//TODO:
+
+	return tResult;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+}} //namespace
+
+#endif